@@ -0,0 +1,342 @@
+"""
+Microbenchmarks of the module against the stub libdvdread in tests/stub, so they measure the module's own costs
+(parsing, object creation, getters) with disc latency injected through STUBDVD_* rather than a drive's.
+
+	python3 bench/bench.py [section ...]
+
+Runs every section, or those named. Each result is the best of several runs. Set PYDVD_TEST_TREE to a checkout
+of another revision to benchmark it the same way (see tests/support.py); sections that need something the
+revision lacks print n/a.
+"""
+
+import os
+import sys
+import tempfile
+import threading
+import time
+import timeit
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))), 'tests'))
+import support
+
+_dvdread = support.Load()
+
+SECTIONS = []
+
+def Section(fn):
+	SECTIONS.append(fn)
+	return fn
+
+def Best(fn, repeat=5, number=1):
+	"""
+	Best time of @repeat runs of @number calls to @fn, per call in seconds.
+	"""
+
+	best = None
+	for _ in range(repeat):
+		t = time.perf_counter()
+		for _ in range(number):
+			fn()
+		t = (time.perf_counter() - t) / number
+		best = (t if best is None or t < best else best)
+	return best
+
+def PerCall(stmt, ns, number=20000):
+	"""
+	Best time per execution of @stmt with globals @ns, in seconds.
+	"""
+
+	return min(timeit.Timer(stmt, globals=ns).repeat(5, number)) / number
+
+def Report(section, name, value, unit):
+	if value is None:
+		print('%-10s %-40s %12s' % (section, name, 'n/a'))
+	elif isinstance(value, int):
+		print('%-10s %-40s %12d %s' % (section, name, value, unit))
+	else:
+		print('%-10s %-40s %12.3f %s' % (section, name, value, unit))
+
+# Library-style wrappers as in dvdread/objects.py; unlike the bare C types they are accepted by every revision
+class Title(_dvdread.Title):
+	def __init__(self, DVD, IFONum, TitleNum):
+		_dvdread.Title.__init__(self, DVD, IFONum, TitleNum, AudioClass=_dvdread.Audio, ChapterClass=_dvdread.Chapter, SubpictureClass=_dvdread.Subpicture)
+
+def OpenDVD(path, **kwargs):
+	dvd = _dvdread.DVD(path, TitleClass=Title)
+	dvd.Open(**kwargs)
+	return dvd
+
+# --------------------------------------------------------------------------------
+# --------------------------------------------------------------------------------
+# Open latency against the number of title sets
+#
+# Every IFO takes STUBDVD_IFO_US to parse, about what an image on a fast disk costs. Open() reads only the VMG
+# and the title sets load when first used; parallel=N parses them all up front on N threads.
+
+@Section
+def open(path):
+	for nvts in (4, 16, 64):
+		with support.StubEnv(VTS=nvts, IFO_US=2000):
+			def lazy():
+				OpenDVD(path).Close()
+
+			def all(**kwargs):
+				def run():
+					dvd = OpenDVD(path, **kwargs)
+					for i in range(1, dvd.NumberOfTitles + 1):
+						dvd.GetTitle(i).PlaybackTime
+					dvd.Close()
+				return run
+
+			Report('open', '%d VTS Open()' % nvts, Best(lazy) * 1e3, 'ms')
+			Report('open', '%d VTS Open() + every title' % nvts, Best(all(), 3) * 1e3, 'ms')
+			for n in (4, 8):
+				try:
+					t = Best(all(parallel=n), 3) * 1e3
+				except TypeError:
+					t = None
+				Report('open', '%d VTS Open(parallel=%d) + every title' % (nvts, n), t, 'ms')
+
+# --------------------------------------------------------------------------------
+# --------------------------------------------------------------------------------
+# Title records and cell time sums
+#
+# Getters on titles of a 64 title set disc, and the chapter list exporters build: every chapter's length of every
+# title. With MaxResidentIFOs=1 the title sets take turns being loaded, each IFO taking 2 ms.
+
+@Section
+def records(path):
+	with support.StubEnv(VTS=64):
+		dvd = OpenDVD(path)
+		n = dvd.NumberOfTitles
+		t = dvd.GetTitle(n)
+		c = t.GetChapter(1)
+		ns = {'dvd': dvd, 't': t, 'c': c, 'n': n}
+
+		for stmt in ('t.PlaybackTime', 't.PlaybackTimeFancy', 't.FrameRate', 't.AspectRatio', 't.NumberOfChapters', 'c.Length', 't.GetChapter(1)', 'dvd.GetTitle(n)'):
+			Report('records', stmt, PerCall(stmt, ns) * 1e9, 'ns')
+
+		def chapters():
+			for i in range(1, n + 1):
+				t = dvd.GetTitle(i)
+				for j in range(1, t.NumberOfChapters + 1):
+					t.GetChapter(j).Length
+		Report('records', 'every chapter length', Best(chapters) * 1e3, 'ms')
+
+		# What a caller had before ChapterAtTime(): add up chapter lengths
+		def walk(t, ms):
+			end = 0
+			for j in range(1, t.NumberOfChapters + 1):
+				end += t.GetChapter(j).Length
+				if ms < end:
+					return j
+			return None
+		ms = t.PlaybackTime - 1
+		ns.update(walk=walk, ms=ms)
+		Report('records', 'chapter at time, Python walk', PerCall('walk(t, ms)', ns) * 1e9, 'ns')
+		for stmt in ('t.ChapterAtTime(ms)', 't.CellAtTime(ms)'):
+			Report('records', stmt, (PerCall(stmt, ns) * 1e9 if hasattr(t, 'CellAtTime') else None), 'ns')
+		dvd.Close()
+
+		with support.StubEnv(IFO_US=2000):
+			dvd = OpenDVD(path)
+			dvd.MaxResidentIFOs = 1
+			# Warm once so title sets parsed for the records stay parsed, as they would in a long running process
+			chapters()
+			Report('records', 'every chapter length, 1 resident IFO', Best(chapters, 3) * 1e3, 'ms')
+			dvd.Close()
+
+# --------------------------------------------------------------------------------
+# --------------------------------------------------------------------------------
+# Whole disc in one call
+#
+# Snapshot() against the per-object walk of DVDToXML() (minus the XML) on a 98 title disc. Interned strings show as
+# the number of distinct objects among the disc's Language values, one per language when they are shared.
+
+def Walk(dvd):
+	titles = []
+	for i in range(1, dvd.NumberOfTitles + 1):
+		t = dvd.GetTitle(i)
+		audios = []
+		for j in range(1, t.NumberOfAudios + 1):
+			a = t.GetAudio(j)
+			audios.append((a.LangCode, a.Language, a.Format, a.SamplingRate))
+		chapters = []
+		for j in range(1, t.NumberOfChapters + 1):
+			c = t.GetChapter(j)
+			chapters.append((c.Length, c.LengthFancy, c.StartCell, c.EndCell))
+		subpictures = []
+		for j in range(1, t.NumberOfSubpictures + 1):
+			s = t.GetSubpicture(j)
+			subpictures.append((s.LangCode, s.Language))
+		titles.append((t.TitleNum, t.PlaybackTime, t.PlaybackTimeFancy, t.AspectRatio, t.FrameRate, t.Width, t.Height, t.NumberOfAngles, audios, chapters, subpictures))
+	return (dvd.VMGID, dvd.ProviderID, titles)
+
+@Section
+def snapshot(path):
+	with support.StubEnv(VTS=49):
+		dvd = OpenDVD(path)
+		Walk(dvd)
+
+		Report('snapshot', 'per-object walk', Best(lambda: Walk(dvd), 10) * 1e3, 'ms')
+		w = Walk(dvd)
+		Report('snapshot', 'distinct Language, walk', len(set(id(a[1]) for t in w[2] for a in t[8])), 'objects')
+
+		if hasattr(dvd, 'Snapshot'):
+			Report('snapshot', 'Snapshot()', Best(dvd.Snapshot, 10) * 1e3, 'ms')
+			s = dvd.Snapshot()
+			Report('snapshot', 'distinct Language, Snapshot()', len(set(id(a.Language) for t in s.Titles for a in t.Audios)), 'objects')
+		else:
+			Report('snapshot', 'Snapshot()', None, 'ms')
+		dvd.Close()
+
+# --------------------------------------------------------------------------------
+# --------------------------------------------------------------------------------
+# Child object creation
+#
+# Cost per call of the methods that create Title, Audio, Chapter and Subpicture objects, through the library-style
+# classes with a Python __init__ and through the bare C types (which only revisions with optional classes accept).
+
+@Section
+def children(path):
+	try:
+		plain = _dvdread.DVD(path)
+	except TypeError:
+		plain = None
+
+	for name, dvd in (('wrapped', OpenDVD(path)), ('plain', plain)):
+		if dvd is None:
+			for stmt in ('dvd.GetTitle(1)', 't.GetAudio(1)', 't.GetChapter(1)', 't.GetSubpicture(1)'):
+				Report('children', '%s %s' % (name, stmt), None, 'ns')
+			continue
+
+		if not dvd.IsOpen:
+			dvd.Open()
+		ns = {'dvd': dvd, 't': dvd.GetTitle(1)}
+		for stmt in ('dvd.GetTitle(1)', 't.GetAudio(1)', 't.GetChapter(1)', 't.GetSubpicture(1)'):
+			Report('children', '%s %s' % (name, stmt), PerCall(stmt, ns) * 1e9, 'ns')
+		dvd.Close()
+
+# --------------------------------------------------------------------------------
+# --------------------------------------------------------------------------------
+# Module state and sub-interpreters
+#
+# Getters that reach the interned strings through the module state, then N scans of a 16 title set disc run one
+# after another, on N threads, and on N threads each in its own sub-interpreter. Sub-interpreters only run in
+# parallel where each has its own GIL (3.12+); before that they measure what switching interpreters costs.
+
+# Self-contained so it can be run in a sub-interpreter, which must not build the module again
+SCAN = '''
+import sys
+sys.path.insert(0, %r)
+import _dvdread
+
+class Title(_dvdread.Title):
+	def __init__(self, DVD, IFONum, TitleNum):
+		_dvdread.Title.__init__(self, DVD, IFONum, TitleNum, AudioClass=_dvdread.Audio, ChapterClass=_dvdread.Chapter, SubpictureClass=_dvdread.Subpicture)
+
+def Scan(path, times):
+	for _ in range(times):
+		dvd = _dvdread.DVD(path, TitleClass=Title)
+		dvd.Open()
+		for i in range(1, dvd.NumberOfTitles + 1):
+			t = dvd.GetTitle(i)
+			t.FrameRate, t.AspectRatio, t.PlaybackTimeFancy
+			for j in range(1, t.NumberOfAudios + 1):
+				a = t.GetAudio(j)
+				a.Language, a.LangCode, a.Format, a.SamplingRate
+			for j in range(1, t.NumberOfSubpictures + 1):
+				s = t.GetSubpicture(j)
+				s.Language, s.LangCode
+			for j in range(1, t.NumberOfChapters + 1):
+				t.GetChapter(j).Length
+		dvd.Close()
+'''
+
+def RunThreads(fns):
+	"""
+	Runs each of @fns on its own thread and waits for them, raising the first exception any of them raised.
+	"""
+
+	errors = []
+	def run(fn):
+		try:
+			fn()
+		except Exception as e:
+			errors.append(e)
+
+	threads = [threading.Thread(target=run, args=(fn,)) for fn in fns]
+	for th in threads:
+		th.start()
+	for th in threads:
+		th.join()
+	if errors:
+		raise errors[0]
+
+def SubInterpreters():
+	for name in ('_interpreters', '_xxsubinterpreters'):
+		try:
+			return __import__(name)
+		except ImportError:
+			pass
+	return None
+
+@Section
+def interp(path):
+	dvd = OpenDVD(path)
+	t = dvd.GetTitle(1)
+	ns = {'t': t, 'a': t.GetAudio(1), 's': t.GetSubpicture(1)}
+	for stmt in ('a.Language', 'a.LangCode', 'a.Format', 's.Language', 't.FrameRate'):
+		Report('interp', stmt, PerCall(stmt, ns) * 1e9, 'ns')
+	dvd.Close()
+
+	lib = os.path.dirname(_dvdread.__file__)
+	code = SCAN % lib
+	scan = {}
+	exec(code, scan)
+	Scan = scan['Scan']
+
+	N, TIMES = 4, 50
+	with support.StubEnv(VTS=16):
+		Report('interp', '1 scan', Best(lambda: Scan(path, TIMES), 3) * 1e3, 'ms')
+		Report('interp', '%d scans in turn' % N, Best(lambda: [Scan(path, TIMES) for _ in range(N)], 3) * 1e3, 'ms')
+		Report('interp', '%d scans on threads' % N, Best(lambda: RunThreads([lambda: Scan(path, TIMES)] * N), 3) * 1e3, 'ms')
+
+		interpreters = SubInterpreters()
+		t = None
+		if interpreters is not None:
+			def runner(id, code):
+				def run():
+					# Failures are raised on 3.12 and returned from 3.13
+					err = interpreters.run_string(id, code)
+					if err is not None:
+						raise RuntimeError(err)
+				return run
+
+			ids = [interpreters.create() for _ in range(N)]
+			try:
+				RunThreads([runner(id, code) for id in ids])
+				call = 'Scan(%r, %d)' % (path, TIMES)
+				t = Best(lambda: RunThreads([runner(id, call) for id in ids]), 3) * 1e3
+			except Exception as e:
+				print('interp     sub-interpreters failed: %s' % e)
+			finally:
+				for id in ids:
+					interpreters.destroy(id)
+		Report('interp', '%d scans in sub-interpreters' % N, t, 'ms')
+
+def main(names):
+	unknown = set(names) - set(fn.__name__ for fn in SECTIONS)
+	if unknown:
+		sys.exit('Unknown sections: %s' % ' '.join(sorted(unknown)))
+
+	with tempfile.TemporaryDirectory() as tmp:
+		path = os.path.join(tmp, 'disc.iso')
+		support.MakeImage(path, 32)
+
+		for fn in SECTIONS:
+			if not names or fn.__name__ in names:
+				fn(path)
+
+if __name__ == '__main__':
+	main(sys.argv[1:])
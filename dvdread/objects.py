@@ -7,7 +7,6 @@ Note that these classes are passed back to the C objects to be created (see the
 import _dvdread
 
 import glob
-import os
 import subprocess
 
 class Disc:
@@ -119,128 +118,83 @@ class Disc:
 	def dvd_discid(path):
 		"""
 		Gets the ID of the DVD disc.
-		This is the Volume id and volume size from the output of isoinfo.
-		Volume id is not always sufficient to be unique enough to be usable.
+		This is the Volume id, volume set id, and volume size from the ISO9660 primary volume descriptor.
+		Volume id is not always sufficient to be unique enough to be usable, DVD.Fingerprint is once the disc is opened.
 		"""
 
-		vid = None
-		vsid = None
-		sz = None
+		info = _dvdread.ReadVolumeInfo(path)
+		if info.VolumeID is None:	raise ValueError("Did not find ISO9660 volume descriptor on '%s'" % path)
 
-		lines = subprocess.check_output(['isoinfo', '-d', '-i', path]).decode('latin-1').split('\n')
-		for line in lines:
-			parts = line.split(':')
-			if parts[0].lower().startswith('volume id'): vid = parts[1].strip()
-			if parts[0].lower().startswith('volume set id'): vsid = parts[1].strip()
-			if parts[0].lower().startswith('volume size'): sz = parts[1].strip()
-
-		if vid == None:		raise ValueError("Did not find volume id in isoinfo output")
-		if vsid == None:	raise ValueError("Did not find volume set id in isoinfo output")
-		if sz == None:		raise ValueError("Did not find volume size in isoinfo output")
-
-		return "%s - %s - %s" % (vid,vsid,sz)
+		return "%s - %s - %s" % (info.VolumeID, info.VolumeSetID, info.Blocks)
 
 	@staticmethod
 	def br_discid(path):
-		lines = subprocess.check_output(['blkid', '-s', 'LABEL', '-o', 'value', path]).decode('latin-1').split('\n')
-		label = lines[0].strip()
-		if not len(label):
+		"""
+		Gets the ID of the Blu-ray disc.
+		This is the UDF label and UUID (as blkid reports them) from the UDF volume descriptors.
+		"""
+
+		info = _dvdread.ReadVolumeInfo(path)
+
+		label = info.UDFLabel
+		if not label:
 			raise ValueError("Failed to get LABEL for '%s'" % path)
 
-		lines = subprocess.check_output(['blkid', '-s', 'UUID', '-o', 'value', path]).decode('latin-1').split('\n')
-		uuid = lines[0].strip()
-		if not len(uuid):
+		uuid = info.UDFUUID
+		if not uuid:
 			raise ValueError("Failed to get UUID for '%s'" % path)
 
 		return "%s - %s" % (label, uuid)
 
 	@staticmethod
 	def br_getSize(path):
-		label,uuid = __class__.br_discid(path).split(' - ')
+		"""
+		Get label, block size, and # of blocks from the disc (returned as a tuple in that order).
+		Number of blocks is the size of the device divided by the UDF logical block size.
+		"""
 
-		lines = subprocess.check_output(['blockdev', '--getbsz', path]).decode('latin-1').split('\n')
-		blocksize = int(lines[0])
+		info = _dvdread.ReadVolumeInfo(path)
 
-		lines = subprocess.check_output(['blockdev', '--getsize64', path]).decode('latin-1').split('\n')
-		size = int(lines[0])
+		label = info.UDFLabel
+		if not label:
+			raise ValueError("Failed to get LABEL for '%s'" % path)
+		if info.Size is None:
+			raise ValueError("Failed to get size of '%s'" % path)
 
-		blocks = int(size / blocksize)
+		blocksize = info.UDFBlockSize or 2048
+		blocks = int(info.Size / blocksize)
 
 		return (label,blocksize,blocks)
 
 	@staticmethod
-	def dd(inf, outf, blocksize, blocks, label):
+	def dd(inf, outf, blocksize, blocks, label, progress=None, direct=False, hash=False):
 		"""
-		Perform a 'resumable' dd copy from @inf to @ouf using the given blocksize and number of blocks.
+		Perform a 'resumable' copy from @inf to @ouf using the given blocksize and number of blocks.
 		The @label is used in exceptions to be descriptive.
+		@progress: optional callable(copied, total, rate) called about once a second with byte counts and bytes per second.
+		@direct: bypass the page cache with O_DIRECT where the file system allows it.
+		@hash: hash the image and its VIDEO_TS files while copying and return the _dvdread.ImageResult.
 
 		The resumable aspect:
-		1) If @outf exists, then the sizes are compared
-		2) If the @outf size is the same as what is expected then nothing is done
-		3) If the @outf size is not a multiple of @blocksize, the remainder of the block is copied with blocksize=1
-		4) If the @outf size is a multiple of @blocksize, the remainder of the blocks are copied by seek and skip appropriately.
-		5) If @outf does not exist, then the entire @inf is copied.
-
-		Commands used:
-			Partial block copy:   ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=1', 'count=%d' % (blocksize - (cursize % blocksize)), 'skip=%d'%cursize, 'seek=%d'%cursize]
-			Remaining block copy: ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=1', 'count=%d' % (blocksize - (cursize % blocksize)), 'skip=%d'%cursize, 'seek=%d'%cursize]
-			Remaining block copy: ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=%d' % blocksize, 'count=%d' % (blocksize - (cursize % blocksize)), 'skip=%d'%cursize, 'seek=%d'%cursize]
-			Full block copy:      ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=%d'%blocksize, 'count=%d'%blocks]
-
-		Where cursize is given by os.path.getsize().
+		1) While copying, @outf.journal records how much of @outf is known to be on disk and copying resumes from there
+		2) If there is no journal and the @outf size is at least what is expected then nothing is done
+		3) If there is no journal and @outf is shorter, the remainder of the blocks are copied after the last whole block in @outf
+		4) If @outf does not exist, then the entire @inf is copied.
+
+		Copying is done by _dvdread.CopyImage() with large aligned reads on one thread and writes on another.
 		"""
 
-		# Get expected total size
-		expectedsize = blocksize * blocks
-
-		if os.path.exists(outf):
-			cursize = os.path.getsize(outf)
-
-			# If sizes are the same, then no need to copy
-			if expectedsize == cursize:
-				print("Disc already copied")
-				return
-
-			elif expectedsize < cursize:
-				print("Disc already copied")
-				# Um, ok, I guess it's done copying
-				return
-
-			else:
-				# Partial copy
-				print("Partial copy: blocksize=%d, blocks=%d, mod=%d" % (blocksize, blocks, blocksize - (cursize % blocksize)))
-
-				# First, need to copy remaining block
-				if cursize % blocksize != 0:
-					print("Partial block copy")
-					# Finish remainder of block
-					args = ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=1', 'count=%d' % (blocksize - (cursize % blocksize)), 'skip=%d'%cursize, 'seek=%d'%cursize]
-					print(" ".join(args))
-					ret = subprocess.call(args)
-					if ret != 0:
-						raise Exception("Failed to partial copy remaining block %d of disc '%s' to drive" % (int(cursize/blocksize)+1, label))
-
-				# Get [possibly] updated size
-				cursize = os.path.getsize(outf)
-
-				print("Partial copy")
-				# Finish remainder of disc
-				#   * Blocks written: int(cursize / blocksize)
-				#   * Remaining blocks: blocks - int(cursize / blocksize)
-				#   * Starting block: int(cursize / blocksize)
-				args = ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=%d' % blocksize, 'count=%d' % (blocks - int(cursize / blocksize)), 'skip=%d'%int(cursize/blocksize), 'seek=%d'%int(cursize/blocksize)]
-				print(" ".join(args))
-				ret = subprocess.call(args)
-				if ret != 0:
-					raise Exception("Failed to copy remaining %d blocks (total %d) of disc '%s' to drive" % (blocks - int(cursize/blocksize)+1, blocks, label))
-
-		else:
-			# Dup entire disc to drive
-			args = ['dd', 'if=%s'%inf, 'of=%s'%outf, 'bs=%d'%blocksize, 'count=%d'%blocks]
-			print(" ".join(args))
-			ret = subprocess.call(args)
-			if ret != 0:
-				raise Exception("Failed to copy disc '%s' to drive" % label)
+		try:
+			ret = _dvdread.CopyImage(inf, outf, blocksize, blocks, progress=progress, direct=direct, hash=hash)
+		except OSError as e:
+			raise Exception("Failed to copy disc '%s' to drive: %s" % (label, e))
+
+		copied = ret.Copied if hash else ret
+		if copied == 0:
+			print("Disc already copied")
+
+		if hash:
+			return ret
 
 	@staticmethod
 	def dvd_GetSize(path):
@@ -251,30 +205,16 @@ class Disc:
 		Seems the more prudent choice.
 		"""
 
-		# Get information from isoinfo
-		ret = subprocess.check_output(["isoinfo", "-d", "-i",path], universal_newlines=True)
-		lines = ret.split("\n")
-
-		label = None
-		blocksize = None
-		blocks = None
-
-		# Have to iterate through the output to find the desired lines
-		for line in lines:
-			parts = line.split(':')
-			parts = [p.strip() for p in parts]
-
-			if parts[0] == 'Volume id':						label = parts[1]
-			elif parts[0] == 'Logical block size is':		blocksize = int(parts[1])
-			elif parts[0] == 'Volume size is':				blocks = int(parts[1])
-			else:
-				# Don't care
-				pass
+		info = _dvdread.ReadVolumeInfo(path)
 
 		# Make sure all three are present
-		if label is None:		raise Exception("Could not find volume label")
-		if blocksize is None:	raise Exception("Could not find block size")
-		if blocks is None:		raise Exception("Could not find number of blocks")
+		if info.VolumeID is None:	raise Exception("Could not find volume label")
+		if not info.BlockSize:		raise Exception("Could not find block size")
+		if not info.Blocks:			raise Exception("Could not find number of blocks")
+
+		label = info.VolumeID
+		blocksize = info.BlockSize
+		blocks = info.Blocks
 
 		return (label,blocksize,blocks)
 
@@ -298,8 +238,6 @@ class DVD(_dvdread.DVD):
 		if TitleClass is None: TitleClass = Title
 
 		_dvdread.DVD.__init__(self, Path, TitleClass=TitleClass)
-		self.titles = {}
-		self.name = None
 
 	def __enter__(self):
 		return self
@@ -316,37 +254,26 @@ class DVD(_dvdread.DVD):
 
 	def GetTitle(self, titlenum):
 		"""
-		Get the object for the given title. Title objects are cached.
+		Get the object for the given title. The same Title is returned while one is alive, until Close().
 		@titlenum: the title number to query starting with one.
 		"""
 
 		if not self.IsOpen:
 			raise AttributeError("GetTitle: disc is not open")
 
-		if titlenum in self.titles:
-			return self.titles[titlenum]
-
-		i = _dvdread.DVD.GetTitle(self, titlenum)
-		self.titles[titlenum] = i
-		return i;
+		return _dvdread.DVD.GetTitle(self, titlenum)
 
 	def GetName(self):
 		"""
 		Get the name of the DVD disc in UTF-8.
+		This is the volume label, or the directory name if opened from a VIDEO_TS directory.
 		"""
 
 		if not self.IsOpen:
 			raise AttributeError("GetName: disc is not open")
 
-		if self.name is not None:
-			return self.name
-
-		with open(self.Path, 'rb') as f:
-			# Random seek location I found in lsdvd...no idea what it means or where it is
-			f.seek(32808, os.SEEK_SET)
-			self.name = f.read(32).decode('utf-8').strip()
-
-		return self.name
+		# Read from the volume descriptor by Open()
+		return self.VolumeID
 
 	def GetNameTitleCase(self):
 		"""
@@ -389,26 +316,20 @@ class Audio(_dvdread.Audio):
 	Class that represents a DVD title's audio track.
 	It should be invoked only by calling Title.GetAudio() and never manually.
 	This class is presumed unless a different one is supplied to the Title initializer method.
-	"""
 
-	def __init__(self, Title, AudioNum):
-		"""
-		Initializes an audio track object and should never be called manually.
-		@Title: DVD title object this audio track belongs to.
-		@AudioNum: audio track number (starts with one)
-		"""
-
-		_dvdread.Audio.__init__(self, Title, AudioNum)
+	It takes (Title, AudioNum) like _dvdread.Audio. There is no __init__ here so Title.GetAudio() can fill
+	instances in directly; subclasses that define __init__ or __new__ are called instead.
+	"""
 
 class Chapter(_dvdread.Chapter):
 	"""
 	Class that represents a DVD title's chapter.
 	It should be invoked only by calling Title.GetChapter() and never manually.
 	This class is presumed unless a different one is supplied to the Title initializer method.
-	"""
 
-	def __init__(self, Title, ChapterNum, StartCell, EndCell, LenMS, LenFancy):
-		_dvdread.Chapter.__init__(self, Title, ChapterNum, StartCell, EndCell, LenMS, LenFancy)
+	It takes (Title, ChapterNum, StartCell, EndCell, LenMS, LenFancy) like _dvdread.Chapter, with no __init__
+	here for the same reason as Audio.
+	"""
 
 class Subpicture(_dvdread.Subpicture):
 	"""
@@ -416,8 +337,7 @@ class Subpicture(_dvdread.Subpicture):
 	Class that represents a DVD title's audio track.
 	It should be invoked only by calling Title.GetSubpicture() and never manually.
 	This class is presumed unless a different one is supplied to the Title initializer method.
-	"""
 
-	def __init__(self, Title, SubpictureNum):
-		_dvdread.Subpicture.__init__(self, Title, SubpictureNum)
+	It takes (Title, SubpictureNum) like _dvdread.Subpicture, with no __init__ here for the same reason as Audio.
+	"""
 
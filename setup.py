@@ -4,8 +4,8 @@ from distutils.core import setup, Extension
 majv = 1
 minv = 1
 
-if sys.version_info < (3,):
-	print("This library is only tested with Python 3.4")
+if sys.version_info < (3,9):
+	print("This library requires Python 3.9 or later")
 	sys.exit(1)
 
 dvdread4 = Extension(
@@ -15,8 +15,8 @@ dvdread4 = Extension(
 		('MINOR_VERSION', str(minv))
 	],
         include_dirs = ['/usr/include'],
-	libraries = ['dvdread'],
-	sources = ['src/dvdread.c'],
+	libraries = ['dvdread', 'pthread'],
+	sources = ['src/dvdread.c', 'src/blockcache.c', 'src/cache.c', 'src/hash.c', 'src/imager.c', 'src/merge.c', 'src/readahead.c', 'src/rescue.c', 'src/volume.c', 'src/writer.c'],
 	extra_compile_args = ['-std=c99']
 )
 
@@ -32,7 +32,7 @@ setup(
 	ext_modules = [dvdread4],
 	requires = ['crudexml'],
 	classifiers = [
-		'Programming Language :: Python :: 3.4'
+		'Programming Language :: Python :: 3.9'
 	]
 )
 
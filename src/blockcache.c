@@ -0,0 +1,280 @@
+#include "dvdread.h"
+
+#include <stdlib.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Block cache
+//
+// Keeps recently read blocks of a disc in memory, keyed by file and block, so reads that cover the same cells
+// again are served without going back to the drive. Not locked itself: the DVD lock serializes every use.
+// None of these touch Python objects so they can be called with the GIL released.
+//
+// Entries live in one array with the block data alongside; a chained hash finds them and either a recency
+// list (LRU) or a reference bit swept by a clock hand (CLOCK) picks which to evict.
+// Memory is allocated on the first insert, so a configured but unused cache costs nothing.
+
+#define PYDVD_BLOCKCACHE_NONE -1
+
+static uint32_t
+_pydvd_blockcache_hash(const pydvd_blockcache_t *c, uint32_t key, uint32_t block)
+{
+	uint32_t h = (block * 2654435761u) ^ (key * 2246822519u);
+	return (h ^ (h >> 15)) & (c->numbuckets - 1);
+}
+
+void
+pydvd_blockcache_setup(pydvd_blockcache_t *c, size_t bytes, int policy)
+{
+	// Sets the byte budget and eviction policy, emptying the cache; counters are kept
+	pydvd_blockcache_empty(c);
+	c->bytes = bytes;
+	c->policy = policy;
+	c->capacity = (uint32_t)(bytes / DVD_VIDEO_LB_LEN < UINT32_MAX / 2 ? bytes / DVD_VIDEO_LB_LEN : UINT32_MAX / 2);
+}
+
+void
+pydvd_blockcache_empty(pydvd_blockcache_t *c)
+{
+	// Drops every block and frees the memory, keeping the configuration and counters
+	free(c->entries);
+	free(c->buckets);
+	free(c->data);
+	c->entries = NULL;
+	c->buckets = NULL;
+	c->data = NULL;
+	c->numbuckets = 0;
+	c->count = 0;
+	c->head = PYDVD_BLOCKCACHE_NONE;
+	c->tail = PYDVD_BLOCKCACHE_NONE;
+	c->hand = 0;
+}
+
+void
+pydvd_blockcache_resetstats(pydvd_blockcache_t *c)
+{
+	c->hits = 0;
+	c->misses = 0;
+	c->evictions = 0;
+}
+
+static int
+_pydvd_blockcache_alloc(pydvd_blockcache_t *c)
+{
+	// Returns zero once the memory for @capacity blocks is there
+	if (c->entries)
+	{
+		return 0;
+	}
+
+	uint32_t buckets = 1;
+	while (buckets < c->capacity)
+	{
+		buckets <<= 1;
+	}
+
+	c->entries = (pydvd_blockcache_entry_t*)malloc(sizeof(pydvd_blockcache_entry_t) * c->capacity);
+	c->buckets = (int32_t*)malloc(sizeof(int32_t) * buckets);
+	c->data = (unsigned char*)malloc((size_t)c->capacity * DVD_VIDEO_LB_LEN);
+	if (c->entries == NULL || c->buckets == NULL || c->data == NULL)
+	{
+		pydvd_blockcache_empty(c);
+		return -1;
+	}
+
+	for (uint32_t i=0; i < buckets; i++)
+	{
+		c->buckets[i] = PYDVD_BLOCKCACHE_NONE;
+	}
+	c->numbuckets = buckets;
+	return 0;
+}
+
+static int32_t
+_pydvd_blockcache_find(const pydvd_blockcache_t *c, uint32_t key, uint32_t block)
+{
+	if (c->entries == NULL)
+	{
+		return PYDVD_BLOCKCACHE_NONE;
+	}
+
+	int32_t i = c->buckets[_pydvd_blockcache_hash(c, key, block)];
+	while (i != PYDVD_BLOCKCACHE_NONE && (c->entries[i].key != key || c->entries[i].block != block))
+	{
+		i = c->entries[i].hnext;
+	}
+	return i;
+}
+
+static void
+_pydvd_blockcache_unlink(pydvd_blockcache_t *c, int32_t i)
+{
+	// Takes entry @i out of the recency list
+	pydvd_blockcache_entry_t *e = &c->entries[i];
+	if (e->prev != PYDVD_BLOCKCACHE_NONE)
+	{
+		c->entries[e->prev].next = e->next;
+	}
+	else
+	{
+		c->head = e->next;
+	}
+	if (e->next != PYDVD_BLOCKCACHE_NONE)
+	{
+		c->entries[e->next].prev = e->prev;
+	}
+	else
+	{
+		c->tail = e->prev;
+	}
+}
+
+static void
+_pydvd_blockcache_pushFront(pydvd_blockcache_t *c, int32_t i)
+{
+	pydvd_blockcache_entry_t *e = &c->entries[i];
+	e->prev = PYDVD_BLOCKCACHE_NONE;
+	e->next = c->head;
+	if (c->head != PYDVD_BLOCKCACHE_NONE)
+	{
+		c->entries[c->head].prev = i;
+	}
+	c->head = i;
+	if (c->tail == PYDVD_BLOCKCACHE_NONE)
+	{
+		c->tail = i;
+	}
+}
+
+static void
+_pydvd_blockcache_touch(pydvd_blockcache_t *c, int32_t i)
+{
+	if (c->policy == PYDVD_BLOCKCACHE_CLOCK)
+	{
+		c->entries[i].ref = 1;
+	}
+	else if (c->head != i)
+	{
+		_pydvd_blockcache_unlink(c, i);
+		_pydvd_blockcache_pushFront(c, i);
+	}
+}
+
+static int32_t
+_pydvd_blockcache_victim(pydvd_blockcache_t *c)
+{
+	// Entry to reuse once the cache is full
+	if (c->policy == PYDVD_BLOCKCACHE_CLOCK)
+	{
+		// Second chance: clear reference bits until one is found already clear
+		while (c->entries[c->hand].ref)
+		{
+			c->entries[c->hand].ref = 0;
+			c->hand = (c->hand + 1) % c->count;
+		}
+		int32_t i = (int32_t)c->hand;
+		c->hand = (c->hand + 1) % c->count;
+		return i;
+	}
+
+	int32_t i = c->tail;
+	_pydvd_blockcache_unlink(c, i);
+	return i;
+}
+
+static void
+_pydvd_blockcache_insert(pydvd_blockcache_t *c, uint32_t key, uint32_t block, const unsigned char *buf)
+{
+	if (c->capacity == 0 || _pydvd_blockcache_alloc(c))
+	{
+		return;
+	}
+
+	int32_t i;
+	if (c->count < c->capacity)
+	{
+		i = (int32_t)c->count++;
+	}
+	else
+	{
+		i = _pydvd_blockcache_victim(c);
+		c->evictions++;
+
+		// Unchain from its hash bucket
+		pydvd_blockcache_entry_t *old = &c->entries[i];
+		int32_t *p = &c->buckets[_pydvd_blockcache_hash(c, old->key, old->block)];
+		while (*p != i)
+		{
+			p = &c->entries[*p].hnext;
+		}
+		*p = old->hnext;
+	}
+
+	pydvd_blockcache_entry_t *e = &c->entries[i];
+	e->key = key;
+	e->block = block;
+	e->ref = 0;
+
+	uint32_t h = _pydvd_blockcache_hash(c, key, block);
+	e->hnext = c->buckets[h];
+	c->buckets[h] = i;
+
+	if (c->policy != PYDVD_BLOCKCACHE_CLOCK)
+	{
+		_pydvd_blockcache_pushFront(c, i);
+	}
+
+	memcpy(c->data + (size_t)i * DVD_VIDEO_LB_LEN, buf, DVD_VIDEO_LB_LEN);
+}
+
+ssize_t
+pydvd_blockcache_read(pydvd_blockcache_t *c, dvd_file_t *file, uint32_t key, int block, size_t n, unsigned char *buf)
+{
+	// Same as DVDReadBlocks(file, block, n, buf) for the file identified by @key, going to the drive only for
+	// the runs of blocks not in the cache
+	if (c->capacity == 0)
+	{
+		return DVDReadBlocks(file, block, n, buf);
+	}
+
+	size_t got = 0;
+	while (got < n)
+	{
+		int32_t i = _pydvd_blockcache_find(c, key, (uint32_t)block + (uint32_t)got);
+		if (i != PYDVD_BLOCKCACHE_NONE)
+		{
+			memcpy(buf + got * DVD_VIDEO_LB_LEN, c->data + (size_t)i * DVD_VIDEO_LB_LEN, DVD_VIDEO_LB_LEN);
+			_pydvd_blockcache_touch(c, i);
+			c->hits++;
+			got++;
+			continue;
+		}
+
+		// Read the whole run of missing blocks in one request
+		size_t run = 1;
+		while (got + run < n && _pydvd_blockcache_find(c, key, (uint32_t)block + (uint32_t)(got + run)) == PYDVD_BLOCKCACHE_NONE)
+		{
+			run++;
+		}
+
+		ssize_t r = DVDReadBlocks(file, block + (int)got, run, buf + got * DVD_VIDEO_LB_LEN);
+		if (r <= 0)
+		{
+			return (got ? (ssize_t)got : r);
+		}
+
+		c->misses += (uint64_t)r;
+		for (ssize_t j=0; j < r; j++)
+		{
+			_pydvd_blockcache_insert(c, key, (uint32_t)block + (uint32_t)(got + j), buf + (got + j) * DVD_VIDEO_LB_LEN);
+		}
+
+		got += (size_t)r;
+		if ((size_t)r < run)
+		{
+			break;
+		}
+	}
+
+	return (ssize_t)got;
+}
@@ -0,0 +1,259 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// On-disk cache of flattened disc tables
+//
+// None of these touch Python objects so they can be called with the GIL released.
+// Files are written to a temporary name and renamed into place, so readers only ever see complete files
+// and concurrent writers of the same disc simply replace each other's identical result.
+
+// Refuse anything silly large; real discs produce a few tens of KB
+#define PYDVD_CACHE_MAXSIZE (64*1024*1024)
+
+uint32_t
+pydvd_table_checksum(const pydvd_table_t *tbl)
+{
+	// FNV-1a over everything past the header
+	const unsigned char *p = (const unsigned char*)tbl + sizeof(pydvd_table_t);
+	const unsigned char *end = (const unsigned char*)tbl + tbl->size;
+
+	uint32_t h = 2166136261u;
+	for ( ; p < end; p++)
+	{
+		h ^= *p;
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+static int
+_pydvd_table_arrayOK(const pydvd_table_t *tbl, uint32_t offset, uint32_t count, size_t recsize)
+{
+	if (offset < sizeof(pydvd_table_t) || offset % 4 != 0 || offset > tbl->size)
+	{
+		return 0;
+	}
+
+	return (uint64_t)count * recsize <= (uint64_t)(tbl->size - offset);
+}
+
+int
+pydvd_table_validate(const pydvd_table_t *tbl, size_t size)
+{
+	// Returns non-zero if @tbl is a well formed table of @size bytes, safe to index without further bounds checks
+	if (size < sizeof(pydvd_table_t) || size > PYDVD_CACHE_MAXSIZE)
+	{
+		return 0;
+	}
+	if (memcmp(tbl->magic, PYDVD_TABLE_MAGIC, sizeof(tbl->magic)) != 0)
+	{
+		return 0;
+	}
+	if (tbl->version != PYDVD_TABLE_VERSION || tbl->byteorder != PYDVD_TABLE_BYTEORDER || tbl->size != size)
+	{
+		return 0;
+	}
+	if (pydvd_table_checksum(tbl) != tbl->checksum)
+	{
+		return 0;
+	}
+
+	if (!_pydvd_table_arrayOK(tbl, tbl->titles, tbl->numtitles, sizeof(pydvd_title_t))) { return 0; }
+	if (!_pydvd_table_arrayOK(tbl, tbl->chapters, tbl->numchapters, sizeof(pydvd_chapter_t))) { return 0; }
+	if (!_pydvd_table_arrayOK(tbl, tbl->audios, tbl->numaudios, sizeof(pydvd_audio_t))) { return 0; }
+	if (!_pydvd_table_arrayOK(tbl, tbl->subpictures, tbl->numsubpictures, sizeof(pydvd_subpicture_t))) { return 0; }
+	if (!_pydvd_table_arrayOK(tbl, tbl->celltimes, tbl->numcelltimes, sizeof(pydvd_celltime_t)) || tbl->celltimes % 8 != 0) { return 0; }
+
+	const pydvd_title_t *titles = PYDVD_TABLE_ARRAY(tbl, pydvd_title_t, titles);
+	for (uint32_t i=0; i < tbl->numtitles; i++)
+	{
+		const pydvd_title_t *t = &titles[i];
+
+		if (t->ifonum > tbl->numifos) { return 0; }
+		if ((uint64_t)t->chapters + t->numchapters > tbl->numchapters) { return 0; }
+		if ((uint64_t)t->audios + t->numaudios > tbl->numaudios) { return 0; }
+		if ((uint64_t)t->subpictures + t->numsubpictures > tbl->numsubpictures) { return 0; }
+		if ((uint64_t)t->celltimes + t->numcells + 1 > tbl->numcelltimes) { return 0; }
+
+		// Chapters index into the title's cells
+		const pydvd_chapter_t *chapters = PYDVD_TABLE_ARRAY(tbl, pydvd_chapter_t, chapters) + t->chapters;
+		for (uint16_t j=0; j < t->numchapters; j++)
+		{
+			if (chapters[j].startcell > t->numcells || chapters[j].endcell > t->numcells) { return 0; }
+		}
+	}
+
+	return 1;
+}
+
+int
+pydvd_cache_load(const char *path, const pydvd_table_t *key, pydvd_table_t **tbl, size_t *size)
+{
+	// Maps the cache file at @path if it holds a valid table for the disc described by @key
+	// Returns zero on a hit, with the mapping in @tbl/@size to be released by pydvd_cache_release()
+	*tbl = NULL;
+	*size = 0;
+
+	int fd = open(path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	struct stat s;
+	if (fstat(fd, &s) || !S_ISREG(s.st_mode) || s.st_size < (off_t)sizeof(pydvd_table_t) || s.st_size > PYDVD_CACHE_MAXSIZE)
+	{
+		close(fd);
+		return -1;
+	}
+
+	void *map = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		return -1;
+	}
+
+	pydvd_table_t *t = (pydvd_table_t*)map;
+	if (!pydvd_table_validate(t, (size_t)s.st_size)
+		|| memcmp(t->fingerprint, key->fingerprint, sizeof(t->fingerprint)) != 0)
+	{
+		munmap(map, (size_t)s.st_size);
+		return -1;
+	}
+
+	*tbl = t;
+	*size = (size_t)s.st_size;
+	return 0;
+}
+
+static int
+_pydvd_cache_mkdirs(char *path)
+{
+	// Creates every missing directory leading up to the last '/' of @path (mkdir -p of its parent), which is
+	// modified while walking it but restored; returns zero, or -1 with errno set
+	// Another process creating the same directories meanwhile is fine, EEXIST is not an error
+	for (char *p = strchr(path + 1, '/'); p; p = strchr(p + 1, '/'))
+	{
+		*p = '\0';
+		int r = mkdir(path, 0755);
+		int e = errno;
+		*p = '/';
+		if (r && e != EEXIST)
+		{
+			errno = e;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int
+pydvd_cache_store(const char *path, const pydvd_table_t *tbl)
+{
+	// Atomically writes @tbl to @path, returns zero on success with errno set otherwise
+	size_t len = strlen(path);
+	char *tmp = (char*)malloc(len + 8);
+	if (tmp == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	memcpy(tmp, path, len);
+	memcpy(tmp + len, ".XXXXXX", 8);
+
+	// The cache directory is created on first use
+	int fd = mkstemp(tmp);
+	if (fd < 0 && errno == ENOENT)
+	{
+		memcpy(tmp + len, ".XXXXXX", 8);
+		if (_pydvd_cache_mkdirs(tmp) == 0)
+		{
+			fd = mkstemp(tmp);
+		}
+	}
+	if (fd < 0)
+	{
+		int e = errno;
+		free(tmp);
+		errno = e;
+		return -1;
+	}
+
+	const char *p = (const char*)tbl;
+	size_t remain = tbl->size;
+	while (remain > 0)
+	{
+		ssize_t n = write(fd, p, remain);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			goto error;
+		}
+		p += n;
+		remain -= (size_t)n;
+	}
+
+	// mkstemp() creates 0600, other users of a shared cache directory need to read it
+	if (fchmod(fd, 0644) || fsync(fd))
+	{
+		goto error;
+	}
+	if (close(fd))
+	{
+		fd = -1;
+		goto error;
+	}
+	fd = -1;
+
+	if (rename(tmp, path))
+	{
+		goto error;
+	}
+
+	free(tmp);
+	return 0;
+
+error:
+	{
+		int e = errno;
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		unlink(tmp);
+		free(tmp);
+		errno = e;
+	}
+	return -1;
+}
+
+void
+pydvd_cache_release(pydvd_table_t *tbl, size_t size, int mapped)
+{
+	if (tbl == NULL)
+	{
+		return;
+	}
+
+	if (mapped)
+	{
+		munmap(tbl, size);
+	}
+	else
+	{
+		free(tbl);
+	}
+}
@@ -35,8 +35,31 @@ dvdtimetoms(dvd_time_t *t)
 	return ms;
 }
 
-static PyObject*
-dvdtimetofancy(long ms, int framerate)
+static uint64_t
+dvdtimeto90k(dvd_time_t *t)
+{
+	// Same as dvdtimetoms() in 90 kHz ticks, which both frame rates divide exactly
+	uint64_t s = 0;
+	s += ((t->hour & 0x0F) >> 0) * 3600 + ((t->hour & 0xF0) >> 4) * 3600 * 10;
+	s += ((t->minute & 0x0F) >> 0) * 60 + ((t->minute & 0xF0) >> 4) * 60 * 10;
+	s += ((t->second & 0x0F) >> 0) + ((t->second & 0xF0) >> 4) * 10;
+
+	uint64_t frames = ((t->frame_u & 0x0F) >> 0) + ((t->frame_u & 0x30) >> 4) * 10;
+	int f = t->frame_u >> 6;
+	if (f == 1) // 25 fps = 3600 ticks per frame
+	{
+		return s * 90000 + frames * 3600;
+	}
+	else if (f == 3) // 29.97 fps = 3003 ticks per frame
+	{
+		return s * 90000 + frames * 3003;
+	}
+
+	return s * 90000;
+}
+
+static void
+dvdtimetofancystr(long ms, int framerate, char *buf, size_t len)
 {
 	long h,m,s,f;
 
@@ -68,2089 +91,8039 @@ dvdtimetofancy(long ms, int framerate)
 	h = ms;
 
 	// Format as string
-	return PyUnicode_FromFormat("%02d:%02d:%02d.%02d", h, m, s, f);
-}
-
-#define SC(a,b) ((((uint16_t)a)<<8)+((uint16_t)b))
-static PyObject*
-LangCodeToName(uint16_t langcode)
-{
-	switch(langcode)
-	{
-		case SC('\0','\0'): return PyUnicode_FromString("Unknown");
-		case SC(' ',' '): return PyUnicode_FromString("Not Specified");
-		case SC('a','a'): return PyUnicode_FromString("Afar");
-		case SC('a','b'): return PyUnicode_FromString("Abkhazian");
-		case SC('a','f'): return PyUnicode_FromString("Afrikaans");
-		case SC('a','m'): return PyUnicode_FromString("Amharic");
-		case SC('a','r'): return PyUnicode_FromString("Arabic");
-		case SC('a','s'): return PyUnicode_FromString("Assamese");
-		case SC('a','y'): return PyUnicode_FromString("Aymara");
-		case SC('a','z'): return PyUnicode_FromString("Azerbaijani");
-		case SC('b','a'): return PyUnicode_FromString("Bashkir");
-		case SC('b','e'): return PyUnicode_FromString("Byelorussian");
-		case SC('b','g'): return PyUnicode_FromString("Bulgarian");
-		case SC('b','h'): return PyUnicode_FromString("Bihari");
-		case SC('b','i'): return PyUnicode_FromString("Bislama");
-		case SC('b','n'): return PyUnicode_FromString("Bengali; Bangla");
-		case SC('b','o'): return PyUnicode_FromString("Tibetan");
-		case SC('b','r'): return PyUnicode_FromString("Breton");
-		case SC('c','a'): return PyUnicode_FromString("Catalan");
-		case SC('c','o'): return PyUnicode_FromString("Corsican");
-		case SC('c','s'): return PyUnicode_FromString("Czech");
-		case SC('c','y'): return PyUnicode_FromString("Welsh");
-		case SC('d','a'): return PyUnicode_FromString("Dansk");
-		case SC('d','e'): return PyUnicode_FromString("Deutsch");
-		case SC('d','z'): return PyUnicode_FromString("Bhutani");
-		case SC('e','l'): return PyUnicode_FromString("Greek");
-		case SC('e','n'): return PyUnicode_FromString("English");
-		case SC('e','o'): return PyUnicode_FromString("Esperanto");
-		case SC('e','s'): return PyUnicode_FromString("Espanol");
-		case SC('e','t'): return PyUnicode_FromString("Estonian");
-		case SC('e','u'): return PyUnicode_FromString("Basque");
-		case SC('f','a'): return PyUnicode_FromString("Persian");
-		case SC('f','i'): return PyUnicode_FromString("Suomi");
-		case SC('f','j'): return PyUnicode_FromString("Fiji");
-		case SC('f','o'): return PyUnicode_FromString("Faroese");
-		case SC('f','r'): return PyUnicode_FromString("Francais");
-		case SC('f','y'): return PyUnicode_FromString("Frisian");
-		case SC('g','a'): return PyUnicode_FromString("Gaelic");
-		case SC('g','d'): return PyUnicode_FromString("Scots Gaelic");
-		case SC('g','l'): return PyUnicode_FromString("Galician");
-		case SC('g','n'): return PyUnicode_FromString("Guarani");
-		case SC('g','u'): return PyUnicode_FromString("Gujarati");
-		case SC('h','a'): return PyUnicode_FromString("Hausa");
-		case SC('h','e'): return PyUnicode_FromString("Hebrew");
-		case SC('h','i'): return PyUnicode_FromString("Hindi");
-		case SC('h','r'): return PyUnicode_FromString("Hrvatski");
-		case SC('h','u'): return PyUnicode_FromString("Magyar");
-		case SC('h','y'): return PyUnicode_FromString("Armenian");
-		case SC('i','a'): return PyUnicode_FromString("Interlingua");
-		case SC('i','d'): return PyUnicode_FromString("Indonesian");
-		case SC('i','e'): return PyUnicode_FromString("Interlingue");
-		case SC('i','k'): return PyUnicode_FromString("Inupiak");
-		case SC('i','n'): return PyUnicode_FromString("Indonesian");
-		case SC('i','s'): return PyUnicode_FromString("Islenska");
-		case SC('i','t'): return PyUnicode_FromString("Italiano");
-		case SC('i','u'): return PyUnicode_FromString("Inuktitut");
-		case SC('i','w'): return PyUnicode_FromString("Hebrew");
-		case SC('j','a'): return PyUnicode_FromString("Japanese");
-		case SC('j','i'): return PyUnicode_FromString("Yiddish");
-		case SC('j','w'): return PyUnicode_FromString("Javanese");
-		case SC('k','a'): return PyUnicode_FromString("Georgian");
-		case SC('k','k'): return PyUnicode_FromString("Kazakh");
-		case SC('k','l'): return PyUnicode_FromString("Greenlandic");
-		case SC('k','m'): return PyUnicode_FromString("Cambodian");
-		case SC('k','n'): return PyUnicode_FromString("Kannada");
-		case SC('k','o'): return PyUnicode_FromString("Korean");
-		case SC('k','s'): return PyUnicode_FromString("Kashmiri");
-		case SC('k','u'): return PyUnicode_FromString("Kurdish");
-		case SC('k','y'): return PyUnicode_FromString("Kirghiz");
-		case SC('l','a'): return PyUnicode_FromString("Latin");
-		case SC('l','n'): return PyUnicode_FromString("Lingala");
-		case SC('l','o'): return PyUnicode_FromString("Laothian");
-		case SC('l','t'): return PyUnicode_FromString("Lithuanian");
-		case SC('l','v'): return PyUnicode_FromString("Latvian, Lettish");
-		case SC('m','g'): return PyUnicode_FromString("Malagasy");
-		case SC('m','i'): return PyUnicode_FromString("Maori");
-		case SC('m','k'): return PyUnicode_FromString("Macedonian");
-		case SC('m','l'): return PyUnicode_FromString("Malayalam");
-		case SC('m','n'): return PyUnicode_FromString("Mongolian");
-		case SC('m','o'): return PyUnicode_FromString("Moldavian");
-		case SC('m','r'): return PyUnicode_FromString("Marathi");
-		case SC('m','s'): return PyUnicode_FromString("Malay");
-		case SC('m','t'): return PyUnicode_FromString("Maltese");
-		case SC('m','y'): return PyUnicode_FromString("Burmese");
-		case SC('n','a'): return PyUnicode_FromString("Nauru");
-		case SC('n','e'): return PyUnicode_FromString("Nepali");
-		case SC('n','l'): return PyUnicode_FromString("Nederlands");
-		case SC('n','o'): return PyUnicode_FromString("Norsk");
-		case SC('o','c'): return PyUnicode_FromString("Occitan");
-		case SC('o','m'): return PyUnicode_FromString("Oromo");
-		case SC('o','r'): return PyUnicode_FromString("Oriya");
-		case SC('p','a'): return PyUnicode_FromString("Punjabi");
-		case SC('p','l'): return PyUnicode_FromString("Polish");
-		case SC('p','s'): return PyUnicode_FromString("Pashto, Pushto");
-		case SC('p','t'): return PyUnicode_FromString("Portugues");
-		case SC('q','u'): return PyUnicode_FromString("Quechua");
-		case SC('r','m'): return PyUnicode_FromString("Rhaeto-Romance");
-		case SC('r','n'): return PyUnicode_FromString("Kirundi");
-		case SC('r','o'): return PyUnicode_FromString("Romanian");
-		case SC('r','u'): return PyUnicode_FromString("Russian");
-		case SC('r','w'): return PyUnicode_FromString("Kinyarwanda");
-		case SC('s','a'): return PyUnicode_FromString("Sanskrit");
-		case SC('s','d'): return PyUnicode_FromString("Sindhi");
-		case SC('s','g'): return PyUnicode_FromString("Sangho");
-		case SC('s','h'): return PyUnicode_FromString("Serbo-Croatian");
-		case SC('s','i'): return PyUnicode_FromString("Sinhalese");
-		case SC('s','k'): return PyUnicode_FromString("Slovak");
-		case SC('s','l'): return PyUnicode_FromString("Slovenian");
-		case SC('s','m'): return PyUnicode_FromString("Samoan");
-		case SC('s','n'): return PyUnicode_FromString("Shona");
-		case SC('s','o'): return PyUnicode_FromString("Somali");
-		case SC('s','q'): return PyUnicode_FromString("Albanian");
-		case SC('s','r'): return PyUnicode_FromString("Serbian");
-		case SC('s','s'): return PyUnicode_FromString("Siswati");
-		case SC('s','t'): return PyUnicode_FromString("Sesotho");
-		case SC('s','u'): return PyUnicode_FromString("Sundanese");
-		case SC('s','v'): return PyUnicode_FromString("Svenska");
-		case SC('s','w'): return PyUnicode_FromString("Swahili");
-		case SC('t','a'): return PyUnicode_FromString("Tamil");
-		case SC('t','e'): return PyUnicode_FromString("Telugu");
-		case SC('t','g'): return PyUnicode_FromString("Tajik");
-		case SC('t','h'): return PyUnicode_FromString("Thai");
-		case SC('t','i'): return PyUnicode_FromString("Tigrinya");
-		case SC('t','k'): return PyUnicode_FromString("Turkmen");
-		case SC('t','l'): return PyUnicode_FromString("Tagalog");
-		case SC('t','n'): return PyUnicode_FromString("Setswana");
-		case SC('t','o'): return PyUnicode_FromString("Tonga");
-		case SC('t','r'): return PyUnicode_FromString("Turkish");
-		case SC('t','s'): return PyUnicode_FromString("Tsonga");
-		case SC('t','t'): return PyUnicode_FromString("Tatar");
-		case SC('t','w'): return PyUnicode_FromString("Twi");
-		case SC('u','g'): return PyUnicode_FromString("Uighur");
-		case SC('u','k'): return PyUnicode_FromString("Ukrainian");
-		case SC('u','r'): return PyUnicode_FromString("Urdu");
-		case SC('u','z'): return PyUnicode_FromString("Uzbek");
-		case SC('v','i'): return PyUnicode_FromString("Vietnamese");
-		case SC('v','o'): return PyUnicode_FromString("Volapuk");
-		case SC('w','o'): return PyUnicode_FromString("Wolof");
-		case SC('x','h'): return PyUnicode_FromString("Xhosa");
-		case SC('y','i'): return PyUnicode_FromString("Yiddish");
-		case SC('y','o'): return PyUnicode_FromString("Yoruba");
-		case SC('z','a'): return PyUnicode_FromString("Zhuang");
-		case SC('z','h'): return PyUnicode_FromString("Chinese");
-		case SC('z','u'): return PyUnicode_FromString("Zulu");
-		case SC('x','x'): return PyUnicode_FromString("Unknown");
-	}
-
-	return PyUnicode_FromString("Not Specified");
-}
-#undef SC
+	snprintf(buf, len, "%02ld:%02ld:%02ld.%02ld", h, m, s, f);
+}
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// PyObject types structs
+static PyObject*
+dvdtimetofancy(long ms, int framerate)
+{
+	char buf[64];
+	dvdtimetofancystr(ms, framerate, buf, sizeof(buf));
+	return PyUnicode_FromString(buf);
+}
 
-typedef struct {
-	PyObject_HEAD
-	PyObject *path;
-	dvd_reader_t *dvd;
+static int
+ParseIntArgs(const char *name, PyObject *const *args, Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max, int *vals)
+{
+	// Positional int arguments of a METH_FASTCALL method into @vals, which holds the defaults of those not given
+	// Returns zero, or -1 with an exception set
+	if (nargs < min || nargs > max)
+	{
+		if (min == max)
+		{
+			PyErr_Format(PyExc_TypeError, "%s() takes exactly %zd argument%s (%zd given)", name, min, (min == 1 ? "" : "s"), nargs);
+		}
+		else
+		{
+			PyErr_Format(PyExc_TypeError, "%s() takes %zd to %zd arguments (%zd given)", name, min, max, nargs);
+		}
+		return -1;
+	}
 
-	PyObject *TitleClass;
+	for (Py_ssize_t i=0; i < nargs; i++)
+	{
+		long v = PyLong_AsLong(args[i]);
+		if (v == -1 && PyErr_Occurred())
+		{
+			return -1;
+		}
+		if (v < INT_MIN || v > INT_MAX)
+		{
+			PyErr_Format(PyExc_OverflowError, "%s() argument %zd out of range", name, i+1);
+			return -1;
+		}
+		vals[i] = (int)v;
+	}
+	return 0;
+}
 
-	int numifos;
-	ifo_handle_t **ifos;
+static int
+IsPlainSubtype(PyObject *cls, PyTypeObject *type)
+{
+	// Non-zero if @cls is @type or a subclass overriding neither __new__ nor __init__, so an instance can be
+	// allocated and filled in directly rather than by calling @cls
+	if (!PyType_Check(cls))
+	{
+		return 0;
+	}
 
-	int numtitles;
-} DVD;
+	PyTypeObject *t = (PyTypeObject*)cls;
+	return t == type || (PyType_IsSubtype(t, type) && t->tp_new == type->tp_new && t->tp_init == type->tp_init);
+}
 
-typedef struct {
-	PyObject_HEAD
-	int ifonum;
-	int titlenum;
+static pgc_t*
+_ifo_getTitlePGC(ifo_handle_t *zero, ifo_handle_t *ifo, int titlenum)
+{
+	// Follows the title search pointer to the title's program chain in its title set IFO
+	pgcit_t *vts_pgcit = ifo->vts_pgcit;
+	int vts_ttn = zero->tt_srpt->title[titlenum-1].vts_ttn;
+	int pgcidx = ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
 
-	PyObject *AudioClass;
-	PyObject *ChapterClass;
-	PyObject *SubpictureClass;
+	return vts_pgcit->pgci_srp[ pgcidx ].pgc;
+}
 
-	DVD *dvd;
+static void
+_pydvd_fillTitle(pydvd_title_t *t, ifo_handle_t *zero, ifo_handle_t *ifo, pgc_t *pgc, int titlenum)
+{
+	memset(t, 0, sizeof(pydvd_title_t));
 
-	ifo_handle_t *ifo;
+	t->ifonum = zero->tt_srpt->title[ titlenum-1 ].title_set_nr;
 
-	int numangles;
-	int numaudios;
-	int numsubpictures;
-	int numchapters;
-} Title;
+	// Cache these values since the struct constant isn't always correct
+	t->numangles = zero->tt_srpt->title[ titlenum-1 ].nr_of_angles;
+	t->numchapters = pgc->nr_of_programs;
+	t->numcells = pgc->nr_of_cells;
 
-typedef struct {
-	PyObject_HEAD
-	int audionum;
+	// Reported doesn't always match wath the program says
+	for (int i=0; i < ifo->vtsi_mat->nr_of_vts_audio_streams; i++)
+	{
+		if (pgc->audio_control[i] & 0x8000)
+		{
+			t->numaudios++;
+		}
+	}
+	for (int i=0; i < ifo->vtsi_mat->nr_of_vts_subp_streams; i++)
+	{
+		if (pgc->subp_control[i] & 0x80000000)
+		{
+			t->numsubpictures++;
+		}
+	}
 
-	Title *title;
+	t->framerate = pgc->playback_time.frame_u >> 6;
+	t->aspectratio = ifo->vtsi_mat->vts_video_attr.display_aspect_ratio;
+	t->picturesize = ifo->vtsi_mat->vts_video_attr.picture_size;
+	t->videoformat = ifo->vtsi_mat->vts_video_attr.video_format;
+	t->playbackms = dvdtimetoms( &pgc->playback_time );
+}
 
-	audio_attr_t *audio;
-} Audio;
+static void
+_pydvd_fillCellTimes(pydvd_celltime_t *cells, pgc_t *pgc)
+{
+	// Prefix sums of the cell playback times into nr_of_cells+1 records
+	memset(cells, 0, (pgc->nr_of_cells + 1) * sizeof(pydvd_celltime_t));
+	for (int i=0; i < pgc->nr_of_cells; i++)
+	{
+		cells[i+1].startms = cells[i].startms + dvdtimetoms( &pgc->cell_playback[i].playback_time );
+		cells[i+1].start90k = cells[i].start90k + dvdtimeto90k( &pgc->cell_playback[i].playback_time );
+	}
+}
 
-typedef struct {
-	PyObject_HEAD
-	int chapternum;
+static void
+_pydvd_fillChapter(pydvd_chapter_t *c, pgc_t *pgc, int chapternum, int numchapters, const pydvd_celltime_t *cells)
+{
+	int startcell, endcell;
 
-	Title *title;
+	memset(c, 0, sizeof(pydvd_chapter_t));
 
-	int startcell;
-	int endcell;
-	long lenms;
-	PyObject *lenfancy;
-} Chapter;
+	// Start and end cells are easy
+	startcell = pgc->program_map[ chapternum-1 ];
 
-typedef struct {
-	PyObject_HEAD
-	int subpicturenum;
+	if (chapternum == numchapters)
+	{
+		endcell = pgc->nr_of_cells;
+	}
+	else
+	{
+		endcell = pgc->program_map[ chapternum-1 + 1] - 1;
+	}
 
-	Title *title;
+	// It's possible that the endcell can be calculated to be negative...so just assume zero???
+	if (endcell < 0)
+	{
+		endcell = 0;
+	}
 
-	subp_attr_t *subpicture;
-} Subpicture;
+	// Damaged program maps can point past the cells
+	if (startcell > pgc->nr_of_cells)
+	{
+		startcell = pgc->nr_of_cells;
+	}
+	if (endcell > pgc->nr_of_cells)
+	{
+		endcell = pgc->nr_of_cells;
+	}
 
-// Predefine them so they can be used below since their full definition references the functions below
-static PyTypeObject DvdType;
-static PyTypeObject TitleType;
-static PyTypeObject AudioType;
-static PyTypeObject ChapterType;
-static PyTypeObject SubpictureType;
+	c->startcell = startcell;
+	c->endcell = endcell;
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Administrative functions for DVD
+	// Length is the span of its cells from the prefix sums
+	if (startcell >= 1 && endcell >= startcell)
+	{
+		c->lenms = cells[endcell].startms - cells[startcell-1].startms;
+	}
+	if (startcell >= 1)
+	{
+		c->framerate = pgc->cell_playback[startcell-1].playback_time.frame_u >> 6;
+	}
+}
 
-static PyObject*
-DVD_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+static const audio_attr_t*
+_ifo_findAudio(ifo_handle_t *ifo, pgc_t *pgc, int audionum)
 {
-	DVD *self;
-
-	self = (DVD*)type->tp_alloc(type, 0);
-	if (self != NULL)
+	// Audio tracks are numbered over the streams the program chain enables
+	for (int i=0; i < ifo->vtsi_mat->nr_of_vts_audio_streams; i++)
 	{
-		Py_INCREF(Py_None);
-		self->path = Py_None;
-		self->dvd = NULL;
-
-		Py_INCREF(Py_None);
-		self->TitleClass = Py_None;
-
-		self->numifos = 0;
-		self->ifos = NULL;
-		self->numtitles = 0;
+		if (pgc->audio_control[i] & 0x8000)
+		{
+			audionum--;
+			if (audionum == 0)
+			{
+				return &ifo->vtsi_mat->vts_audio_attr[i];
+			}
+		}
 	}
 
-	return (PyObject *)self;
+	return NULL;
 }
 
-static int
-DVD_init(DVD *self, PyObject *args, PyObject *kwds)
+static const subp_attr_t*
+_ifo_findSubpicture(ifo_handle_t *ifo, pgc_t *pgc, int subpicturenum)
 {
-	PyObject *path=NULL, *titleclass=NULL, *tmp;
-	static char *kwlist[] = {"Path", "TitleClass", NULL};
-
-	if (! PyArg_ParseTupleAndKeywords(args,kwds, "OO", kwlist, &path, &titleclass))
+	// Subpictures are numbered over the streams the program chain enables, like audio tracks
+	for (int i=0; i < ifo->vtsi_mat->nr_of_vts_subp_streams; i++)
 	{
-		return -1;
+		if (pgc->subp_control[i] & 0x80000000)
+		{
+			subpicturenum--;
+			if (subpicturenum == 0)
+			{
+				return &ifo->vtsi_mat->vts_subp_attr[i];
+			}
+		}
 	}
 
-	// Path
-	tmp = self->path;
-	Py_INCREF(path);
-	self->path = path;
-	Py_CLEAR(tmp);
-
-	// TitleClass
-	tmp = self->TitleClass;
-	Py_INCREF(titleclass);
-	self->TitleClass = titleclass;
-	Py_CLEAR(tmp);
+	return NULL;
+}
 
-	return 0;
+static void
+_pydvd_fillAudio(pydvd_audio_t *a, const audio_attr_t *attr)
+{
+	memset(a, 0, sizeof(pydvd_audio_t));
+	a->lang_code = attr->lang_code;
+	a->format = attr->audio_format;
+	a->channels = attr->channels;
+	a->quantization = attr->quantization;
+	a->sample_frequency = attr->sample_frequency;
 }
 
 static void
-DVD_dealloc(DVD *self)
+_pydvd_fillSubpicture(pydvd_subpicture_t *sp, const subp_attr_t *attr)
 {
-	Py_CLEAR(self->path);
-	Py_CLEAR(self->TitleClass);
+	memset(sp, 0, sizeof(pydvd_subpicture_t));
+	sp->lang_code = attr->lang_code;
+	sp->code_mode = attr->code_mode;
+}
 
-	if (self->ifos)
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Shared strings
+//
+// The getters return a handful of fixed strings and language names over and over, so they are interned once per
+// module by InitStrings() and every call hands out the same objects. The Str functions give the same text as C strings.
+
+enum {
+	STR_UNKNOWN,
+	STR_NOTSPECIFIED,
+	STR_QUESTION,
+	STR_FPS25,
+	STR_FPS2997,
+	STR_ASPECT43,
+	STR_ASPECT169,
+	STR_AC3,
+	STR_MPEG1,
+	STR_MPEG2,
+	STR_LPCM,
+	STR_SDDS,
+	STR_DTS,
+	STR_48000,
+	NUM_STRS
+};
+
+static const char *const Strs[NUM_STRS] = {
+	"Unknown", "Not Specified", "?", "25.00", "29.97", "4:3", "16:9", "AC3", "MPEG1", "MPEG2", "LPCM", "SDDS", "DTS", "48000"
+};
+
+// ISO 639-1 codes as found in the IFOs (including the withdrawn in, iw, ji, jw and mo), their ISO 639-2/B code
+// and the name reported for them
+typedef struct {
+	const char *code;
+	const char *code3;        // NULL if there is none
+	const char *name;
+} Language_t;
+
+static const Language_t Languages[] = {
+	{"aa", "aar", "Afar"},
+	{"ab", "abk", "Abkhazian"},
+	{"af", "afr", "Afrikaans"},
+	{"am", "amh", "Amharic"},
+	{"ar", "ara", "Arabic"},
+	{"as", "asm", "Assamese"},
+	{"ay", "aym", "Aymara"},
+	{"az", "aze", "Azerbaijani"},
+	{"ba", "bak", "Bashkir"},
+	{"be", "bel", "Byelorussian"},
+	{"bg", "bul", "Bulgarian"},
+	{"bh", "bih", "Bihari"},
+	{"bi", "bis", "Bislama"},
+	{"bn", "ben", "Bengali; Bangla"},
+	{"bo", "tib", "Tibetan"},
+	{"br", "bre", "Breton"},
+	{"ca", "cat", "Catalan"},
+	{"co", "cos", "Corsican"},
+	{"cs", "cze", "Czech"},
+	{"cy", "wel", "Welsh"},
+	{"da", "dan", "Dansk"},
+	{"de", "ger", "Deutsch"},
+	{"dz", "dzo", "Bhutani"},
+	{"el", "gre", "Greek"},
+	{"en", "eng", "English"},
+	{"eo", "epo", "Esperanto"},
+	{"es", "spa", "Espanol"},
+	{"et", "est", "Estonian"},
+	{"eu", "baq", "Basque"},
+	{"fa", "per", "Persian"},
+	{"fi", "fin", "Suomi"},
+	{"fj", "fij", "Fiji"},
+	{"fo", "fao", "Faroese"},
+	{"fr", "fre", "Francais"},
+	{"fy", "fry", "Frisian"},
+	{"ga", "gle", "Gaelic"},
+	{"gd", "gla", "Scots Gaelic"},
+	{"gl", "glg", "Galician"},
+	{"gn", "grn", "Guarani"},
+	{"gu", "guj", "Gujarati"},
+	{"ha", "hau", "Hausa"},
+	{"he", "heb", "Hebrew"},
+	{"hi", "hin", "Hindi"},
+	{"hr", "hrv", "Hrvatski"},
+	{"hu", "hun", "Magyar"},
+	{"hy", "arm", "Armenian"},
+	{"ia", "ina", "Interlingua"},
+	{"id", "ind", "Indonesian"},
+	{"ie", "ile", "Interlingue"},
+	{"ik", "ipk", "Inupiak"},
+	{"in", "ind", "Indonesian"},
+	{"is", "ice", "Islenska"},
+	{"it", "ita", "Italiano"},
+	{"iu", "iku", "Inuktitut"},
+	{"iw", "heb", "Hebrew"},
+	{"ja", "jpn", "Japanese"},
+	{"ji", "yid", "Yiddish"},
+	{"jw", "jav", "Javanese"},
+	{"ka", "geo", "Georgian"},
+	{"kk", "kaz", "Kazakh"},
+	{"kl", "kal", "Greenlandic"},
+	{"km", "khm", "Cambodian"},
+	{"kn", "kan", "Kannada"},
+	{"ko", "kor", "Korean"},
+	{"ks", "kas", "Kashmiri"},
+	{"ku", "kur", "Kurdish"},
+	{"ky", "kir", "Kirghiz"},
+	{"la", "lat", "Latin"},
+	{"ln", "lin", "Lingala"},
+	{"lo", "lao", "Laothian"},
+	{"lt", "lit", "Lithuanian"},
+	{"lv", "lav", "Latvian, Lettish"},
+	{"mg", "mlg", "Malagasy"},
+	{"mi", "mao", "Maori"},
+	{"mk", "mac", "Macedonian"},
+	{"ml", "mal", "Malayalam"},
+	{"mn", "mon", "Mongolian"},
+	{"mo", "mol", "Moldavian"},
+	{"mr", "mar", "Marathi"},
+	{"ms", "may", "Malay"},
+	{"mt", "mlt", "Maltese"},
+	{"my", "bur", "Burmese"},
+	{"na", "nau", "Nauru"},
+	{"ne", "nep", "Nepali"},
+	{"nl", "dut", "Nederlands"},
+	{"no", "nor", "Norsk"},
+	{"oc", "oci", "Occitan"},
+	{"om", "orm", "Oromo"},
+	{"or", "ori", "Oriya"},
+	{"pa", "pan", "Punjabi"},
+	{"pl", "pol", "Polish"},
+	{"ps", "pus", "Pashto, Pushto"},
+	{"pt", "por", "Portugues"},
+	{"qu", "que", "Quechua"},
+	{"rm", "roh", "Rhaeto-Romance"},
+	{"rn", "run", "Kirundi"},
+	{"ro", "rum", "Romanian"},
+	{"ru", "rus", "Russian"},
+	{"rw", "kin", "Kinyarwanda"},
+	{"sa", "san", "Sanskrit"},
+	{"sd", "snd", "Sindhi"},
+	{"sg", "sag", "Sangho"},
+	{"sh", NULL, "Serbo-Croatian"},
+	{"si", "sin", "Sinhalese"},
+	{"sk", "slo", "Slovak"},
+	{"sl", "slv", "Slovenian"},
+	{"sm", "smo", "Samoan"},
+	{"sn", "sna", "Shona"},
+	{"so", "som", "Somali"},
+	{"sq", "alb", "Albanian"},
+	{"sr", "srp", "Serbian"},
+	{"ss", "ssw", "Siswati"},
+	{"st", "sot", "Sesotho"},
+	{"su", "sun", "Sundanese"},
+	{"sv", "swe", "Svenska"},
+	{"sw", "swa", "Swahili"},
+	{"ta", "tam", "Tamil"},
+	{"te", "tel", "Telugu"},
+	{"tg", "tgk", "Tajik"},
+	{"th", "tha", "Thai"},
+	{"ti", "tir", "Tigrinya"},
+	{"tk", "tuk", "Turkmen"},
+	{"tl", "tgl", "Tagalog"},
+	{"tn", "tsn", "Setswana"},
+	{"to", "ton", "Tonga"},
+	{"tr", "tur", "Turkish"},
+	{"ts", "tso", "Tsonga"},
+	{"tt", "tat", "Tatar"},
+	{"tw", "twi", "Twi"},
+	{"ug", "uig", "Uighur"},
+	{"uk", "ukr", "Ukrainian"},
+	{"ur", "urd", "Urdu"},
+	{"uz", "uzb", "Uzbek"},
+	{"vi", "vie", "Vietnamese"},
+	{"vo", "vol", "Volapuk"},
+	{"wo", "wol", "Wolof"},
+	{"xh", "xho", "Xhosa"},
+	{"yi", "yid", "Yiddish"},
+	{"yo", "yor", "Yoruba"},
+	{"za", "zha", "Zhuang"},
+	{"zh", "chi", "Chinese"},
+	{"zu", "zul", "Zulu"},
+};
+
+#define NUM_LANGUAGES ((int)(sizeof(Languages) / sizeof(Languages[0])))
+
+// Index into Languages plus one of each two letter code, zero if not a known code
+// Plain C data shared by every interpreter, filled once by _InitLangIndex()
+static uint8_t LangIndex[26][26];
+static pthread_once_t LangIndexOnce = PTHREAD_ONCE_INIT;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Module state
+//
+// Every module object (one per interpreter that imports it) has its own types and shared strings, so no Python
+// object is shared between interpreters. DVD objects keep a pointer to the state of the module their type comes
+// from, which their type keeps alive; Title, Audio, Chapter and Subpicture objects reach it through their DVD.
+
+typedef struct {
+	PyTypeObject *DvdType;
+	PyTypeObject *TitleType;
+	PyTypeObject *AudioType;
+	PyTypeObject *ChapterType;
+	PyTypeObject *SubpictureType;
+	PyTypeObject *StreamType;
+
+	// Structseqs
+	PyTypeObject *VolumeInfoType;
+	PyTypeObject *ReadAheadStatsType;
+	PyTypeObject *DigestType;
+	PyTypeObject *DiscSnapshotType;
+	PyTypeObject *TitleSnapshotType;
+	PyTypeObject *AudioSnapshotType;
+	PyTypeObject *ChapterSnapshotType;
+	PyTypeObject *SubpictureSnapshotType;
+	PyTypeObject *ImageResultType;
+	PyTypeObject *MergeResultType;
+	PyTypeObject *MergeSourceType;
+
+	// Interned Strs
+	PyObject *strs[NUM_STRS];
+
+	// Interned code, ISO 639-2 code (NULL if none) and name of each of Languages
+	PyObject *langs[NUM_LANGUAGES][3];
+
+	// Code to name and name to codes, exposed read-only as LANGUAGES and LANGUAGE_CODES
+	PyObject *LangByCode;
+	PyObject *CodesByLang;
+} ModuleState_t;
+
+static struct PyModuleDef DvdReadmodule;
+
+static ModuleState_t*
+GetState(PyTypeObject *type)
+{
+	// State of the module @type or the _dvdread type it derives from was made by, NULL with an exception set if none
+#if PY_VERSION_HEX >= 0x030B0000
+	PyObject *m = PyType_GetModuleByDef(type, &DvdReadmodule);
+#else
+	// Walk the MRO as PyType_GetModuleByDef() does from 3.11
+	PyObject *m = NULL;
+	PyObject *mro = type->tp_mro;
+	for (Py_ssize_t i=0; mro && i < PyTuple_GET_SIZE(mro) && m == NULL; i++)
 	{
-		for (int i=0; i < self->numifos; i++)
+		PyTypeObject *t = (PyTypeObject*)PyTuple_GET_ITEM(mro, i);
+		if ((t->tp_flags & Py_TPFLAGS_HEAPTYPE) && ((PyHeapTypeObject*)t)->ht_module
+			&& PyModule_GetDef(((PyHeapTypeObject*)t)->ht_module) == &DvdReadmodule)
 		{
-			if (self->ifos[i])
-			{
-				ifoClose(self->ifos[i]);
-				self->ifos[i] = NULL;
-			}
+			m = ((PyHeapTypeObject*)t)->ht_module;
 		}
-		free(self->ifos);
 	}
-
-	if (self->dvd)
+	if (m == NULL)
 	{
-		DVDClose(self->dvd);
+		PyErr_Format(PyExc_TypeError, "'%s' is not a _dvdread type", type->tp_name);
 	}
-	self->dvd = NULL;
-
-	self->numifos = 0;
-	self->numtitles = 0;
-
-	Py_TYPE(self)->tp_free((PyObject*)self);
+#endif
+	return (m ? (ModuleState_t*)PyModule_GetState(m) : NULL);
 }
 
 // --------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------
-// Interface stuff for DVD
+// Shared string lookups
 
 static PyObject*
-DVD_getPath(DVD *self)
+SharedStr(ModuleState_t *st, int id)
+{
+	Py_INCREF(st->strs[id]);
+	return st->strs[id];
+}
+
+static void
+_InitLangIndex(void)
 {
-	if (self->path == NULL)
+	for (int i=0; i < NUM_LANGUAGES; i++)
 	{
-		PyErr_SetString(PyExc_AttributeError, "_path");
-		return NULL;
+		const Language_t *l = &Languages[i];
+		LangIndex[ l->code[0]-'a' ][ l->code[1]-'a' ] = (uint8_t)(i + 1);
 	}
-
-	Py_INCREF(self->path);
-	return self->path;
 }
 
 static int
-_DVD_getIsOpen(DVD *self)
+InitStrings(ModuleState_t *st)
 {
-	return !!self->dvd;
-}
+	// Called from the exec function of each module object; returns zero, or -1 with an exception set
+	pthread_once(&LangIndexOnce, _InitLangIndex);
 
-static PyObject*
-DVD_getIsOpen(DVD *self)
-{
-	if ( _DVD_getIsOpen(self) )
+	for (int i=0; i < NUM_STRS; i++)
 	{
-		Py_INCREF(Py_True);
-		return Py_True;
+		st->strs[i] = PyUnicode_InternFromString(Strs[i]);
+		if (st->strs[i] == NULL)
+		{
+			return -1;
+		}
 	}
-	else
+
+	PyObject *bycode = PyDict_New();
+	PyObject *bylang = PyDict_New();
+	if (bycode == NULL || bylang == NULL)
 	{
-		Py_INCREF(Py_False);
-		return Py_False;
+		goto fail;
 	}
-}
 
-static PyObject*
-DVD_GetVMGID(DVD *self)
-{
-	if (!_DVD_getIsOpen(self))
+	for (int i=0; i < NUM_LANGUAGES; i++)
 	{
-		PyErr_SetString(PyExc_AttributeError, "VMGID: disc not open");
-		return NULL;
-	}
+		const Language_t *l = &Languages[i];
+		PyObject **objs = st->langs[i];
 
-	char buf[13];
+		objs[0] = PyUnicode_InternFromString(l->code);
+		objs[1] = (l->code3 ? PyUnicode_InternFromString(l->code3) : NULL);
+		objs[2] = PyUnicode_InternFromString(l->name);
+		if (objs[0] == NULL || objs[2] == NULL || (l->code3 && objs[1] == NULL))
+		{
+			goto fail;
+		}
+
+		if (PyDict_SetItem(bycode, objs[0], objs[2]))
+		{
+			goto fail;
+		}
+
+		// Names with more than one code (withdrawn codes) get all of them, current code first
+		PyObject *codes = PyDict_GetItem(bylang, objs[2]);
+		PyObject *more;
+		if (codes)
+		{
+			more = PyTuple_New(PyTuple_GET_SIZE(codes) + 1);
+			if (more)
+			{
+				for (Py_ssize_t j=0; j < PyTuple_GET_SIZE(codes); j++)
+				{
+					Py_INCREF(PyTuple_GET_ITEM(codes, j));
+					PyTuple_SET_ITEM(more, j, PyTuple_GET_ITEM(codes, j));
+				}
+				Py_INCREF(objs[0]);
+				PyTuple_SET_ITEM(more, PyTuple_GET_SIZE(codes), objs[0]);
+			}
+		}
+		else
+		{
+			more = PyTuple_Pack(1, objs[0]);
+		}
+		if (more == NULL || PyDict_SetItem(bylang, objs[2], more))
+		{
+			Py_XDECREF(more);
+			goto fail;
+		}
+		Py_DECREF(more);
+	}
+
+	st->LangByCode = PyDictProxy_New(bycode);
+	st->CodesByLang = PyDictProxy_New(bylang);
+	Py_DECREF(bycode);
+	Py_DECREF(bylang);
+	if (st->LangByCode == NULL || st->CodesByLang == NULL)
+	{
+		return -1;
+	}
+	return 0;
+
+fail:
+	Py_XDECREF(bycode);
+	Py_XDECREF(bylang);
+	return -1;
+}
+
+static int
+LangCodeId(uint16_t langcode)
+{
+	// Index of @langcode in Languages, or -1 if it is not a known code
+	unsigned a = (unsigned)(langcode >> 8) - 'a';
+	unsigned b = (unsigned)(langcode & 0xFF) - 'a';
+	if (a >= 26 || b >= 26)
+	{
+		return -1;
+	}
+	return LangIndex[a][b] - 1;
+}
+
+static int
+LangNameId(uint16_t langcode)
+{
+	// Shared string for a code that is not in Languages
+	if (langcode == 0 || langcode == (('x' << 8) | 'x'))
+	{
+		return STR_UNKNOWN;
+	}
+	return STR_NOTSPECIFIED;
+}
+
+static const char*
+LangCodeToNameStr(uint16_t langcode)
+{
+	int i = LangCodeId(langcode);
+	if (i >= 0)
+	{
+		return Languages[i].name;
+	}
+	return Strs[LangNameId(langcode)];
+}
+
+static PyObject*
+LangCodeToName(ModuleState_t *st, uint16_t langcode)
+{
+	int i = LangCodeId(langcode);
+	if (i >= 0)
+	{
+		Py_INCREF(st->langs[i][2]);
+		return st->langs[i][2];
+	}
+	return SharedStr(st, LangNameId(langcode));
+}
+
+static int
+LangCodeToStr(uint16_t langcode, char *buf)
+{
+	// Two letter code into @buf (3 bytes); zero if the code is 0xFFFF, which I guess means "hidden" or something
+	char a = langcode >> 8;
+	char b = langcode & 0xFF;
+	if (a == -1 && b == -1)
+	{
+		return 0;
+	}
+
+	buf[0] = a;
+	buf[1] = b;
+	buf[2] = '\0';
+	return 1;
+}
+
+static int
+LangCodeToUTF8(uint16_t langcode, char *buf)
+{
+	// The two letter code as the LangCode getters give it (each byte a Latin-1 character) in UTF-8 into @buf
+	// (4 bytes, not terminated as a byte may be NUL); returns the length, or -1 if the code is 0xFFFF
+	char code[3];
+	if (!LangCodeToStr(langcode, code))
+	{
+		return -1;
+	}
+
+	int n = 0;
+	for (int i=0; i < 2; i++)
+	{
+		unsigned char c = (unsigned char)code[i];
+		if (c < 0x80)
+		{
+			buf[n++] = (char)c;
+		}
+		else
+		{
+			buf[n++] = (char)(0xC0 | (c >> 6));
+			buf[n++] = (char)(0x80 | (c & 0x3F));
+		}
+	}
+	return n;
+}
+
+static PyObject*
+LangCodeToCode(ModuleState_t *st, uint16_t langcode)
+{
+	// Two letter code, None if the code is 0xFFFF
+	char code[3];
+	if (!LangCodeToStr(langcode, code))
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int i = LangCodeId(langcode);
+	if (i >= 0)
+	{
+		Py_INCREF(st->langs[i][0]);
+		return st->langs[i][0];
+	}
+	return PyUnicode_DecodeLatin1(code, 2, NULL);
+}
+
+static PyObject*
+LangCodeToCode3(ModuleState_t *st, uint16_t langcode)
+{
+	// ISO 639-2 code, None if there isn't one
+	int i = LangCodeId(langcode);
+	if (i < 0 || st->langs[i][1] == NULL)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+	Py_INCREF(st->langs[i][1]);
+	return st->langs[i][1];
+}
+
+static int
+FrameRateId(int framerate)
+{
+	switch(framerate)
+	{
+		case 1: return STR_FPS25;
+		case 3: return STR_FPS2997;
+	}
+	return STR_QUESTION;
+}
+
+static const char*
+FrameRateStr(int framerate)
+{
+	return Strs[FrameRateId(framerate)];
+}
+
+static int
+AspectRatioId(int aspectratio)
+{
+	// -1 if invalid
+	switch(aspectratio)
+	{
+		case 0: return STR_ASPECT43;
+		case 1: return STR_ASPECT169;
+		case 3: return STR_ASPECT169;
+	}
+	return -1;
+}
+
+static const char*
+AspectRatioStr(int aspectratio)
+{
+	// NULL if invalid
+	int id = AspectRatioId(aspectratio);
+	return (id < 0 ? NULL : Strs[id]);
+}
+
+static int
+PictureWidth(int picturesize)
+{
+	// Zero if invalid
+	switch(picturesize)
+	{
+		case 0: return 720;
+		case 1: return 704;
+		case 2: return 352;
+		case 3: return 352;
+	}
+	return 0;
+}
+
+static int
+PictureHeight(int videoformat)
+{
+	// Zero if invalid
+	switch(videoformat)
+	{
+		case 0: return 480;
+		case 1: return 576;
+		case 3: return 576;
+	}
+	return 0;
+}
+
+static int
+AudioFormatId(int format)
+{
+	switch(format)
+	{
+		case 0: return STR_AC3;
+		case 2: return STR_MPEG1;
+		case 3: return STR_MPEG2;
+		case 4: return STR_LPCM;
+		case 5: return STR_SDDS;
+		case 6: return STR_DTS;
+	}
+	return STR_QUESTION;
+}
+
+static const char*
+AudioFormatStr(int format)
+{
+	return Strs[AudioFormatId(format)];
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// PyObject types structs
+
+// Records of the titles of one title set, indices in their pydvd_title_t are into these arrays
+typedef struct {
+	int filled;
+	pydvd_chapter_t *chapters;
+	pydvd_audio_t *audios;
+	pydvd_subpicture_t *subpictures;
+	pydvd_celltime_t *celltimes;
+} _DVD_titleset_t;
+
+// A title's record and its first record in each of the arrays, see _DVD_getTitleRecord()
+typedef struct {
+	const pydvd_title_t *title;
+	const pydvd_chapter_t *chapters;
+	const pydvd_audio_t *audios;
+	const pydvd_subpicture_t *subpictures;
+	const pydvd_celltime_t *celltimes;
+} _DVD_titlerecs_t;
+
+// Child objects of a DVD or Title handed out again while they are alive, see _Children_get()
+// @objs has a borrowed pointer per child, NULL until it is made and again once it is gone
+typedef struct {
+	int num;
+	PyObject **objs;
+} _Children_t;
+
+typedef struct {
+	PyObject_HEAD
+	PyObject *path;
+	dvd_reader_t *dvd;
+
+	// Of the module the type comes from, see ModuleState_t
+	ModuleState_t *state;
+
+	PyObject *TitleClass;
+
+	int numifos;
+	ifo_handle_t **ifos;
+
+	// Extra readers opened by Open(parallel=N), kept until Close() as their IFOs reference them
+	int numreaders;
+	dvd_reader_t **readers;
+
+	// Title set IFOs are loaded on demand; @ifotick holds the last-use stamp of each for LRU eviction
+	// @maxifos caps the number of resident VTS IFOs (zero is unlimited), IFO zero is always resident
+	unsigned long *ifotick;
+	unsigned long tick;
+	int maxifos;
+	int numresident;
+	long numloaded;
+	long numevicted;
+
+	int numtitles;
+
+	// Volume label and volume set ID read by Open(), or the directory name for a VIDEO_TS directory
+	char volumeid[256];
+	char volumesetid[128*3+1];
+
+	// SHA-256 of the DVDDiscID() MD5, VMG and provider IDs and volume size, computed by Open()
+	unsigned char fingerprint[32];
+	int hasfingerprint;
+
+	// Flattened metadata for all titles, from the cache directory passed to Open() (heap or mmap)
+	// When set, getters read from it instead of the IFOs
+	pydvd_table_t *table;
+	size_t tablesize;
+	int tablemapped;
+	int fromcache;
+
+	// Without a table, records of every title (indexed by title number - 1) and of each title set's chapters,
+	// audios, subpictures and cells (indexed by IFO number), filled a title set at a time by _DVD_getTitleRecord()
+	pydvd_title_t *titles;
+	_DVD_titleset_t *titlesets;
+
+	// Titles handed out by GetTitle() and the sequence protocol, emptied by Close() (titles still held are of the
+	// disc that was open, not of one opened after)
+	_Children_t titleobjs;
+
+	// Streams opened by OpenFile()/Title.OpenStream(), which hold a reference to this
+	struct _Stream *streams;
+
+	// Recently read blocks, sized by BlockCacheSize; only used with @lock held
+	pydvd_blockcache_t blockcache;
+
+	// Rescue mode: stream reads fill unreadable blocks instead of failing, and record what they read in a map
+	// per file; the maps are kept after Close() until the next Open() and only used with @lock held
+	int rescue;
+	int rescuefill;
+	long rescuefailures;
+	long rescuefilled;
+	pydvd_rescue_map_t **rescuemaps;
+	int numrescuemaps;
+
+	// Serializes libdvdread calls on @dvd; @dvd, @ifos, the title records and the disc information Open() fills in
+	// only change with this held, and are read with it held (see _DVD_lockOpen()) as free-threaded builds have
+	// no GIL to keep Close() out; counters and settings are read without it
+	// Recursive so Open() can load IFOs through _DVD_getIFO() while holding it
+	pthread_mutex_t lock;
+} DVD;
+
+typedef struct {
+	PyObject_HEAD
+	int ifonum;
+	int titlenum;
+
+	PyObject *AudioClass;
+	PyObject *ChapterClass;
+	PyObject *SubpictureClass;
+
+	DVD *dvd;
+
+	int numangles;
+	int numaudios;
+	int numsubpictures;
+	int numchapters;
+
+	// Everything else about the title, resolved once by Title_init
+	pydvd_title_t info;
+
+	// Children handed out by GetChapter()/GetAudio()/GetSubpicture() and the Chapters/Audios/Subpictures tuples,
+	// guarded by the DVD's lock
+	_Children_t chapterobjs;
+	_Children_t audioobjs;
+	_Children_t subpictureobjs;
+
+	// Set by Detach() once it has copied the title's chapter, audio and subpicture records, which children are
+	// then made from so that the getters no longer need the disc open
+	int detached;
+	pydvd_chapter_t *chapters;
+	pydvd_audio_t *audios;
+	pydvd_subpicture_t *subpictures;
+} Title;
+
+typedef struct {
+	PyObject_HEAD
+	int audionum;
+
+	Title *title;
+
+	// Copied so that evicting the title set IFO cannot leave this dangling
+	pydvd_audio_t audio;
+} Audio;
+
+typedef struct {
+	PyObject_HEAD
+	int chapternum;
+
+	Title *title;
+
+	int startcell;
+	int endcell;
+	long lenms;
+	PyObject *lenfancy;
+} Chapter;
+
+typedef struct {
+	PyObject_HEAD
+	int subpicturenum;
+
+	Title *title;
+
+	// Copied so that evicting the title set IFO cannot leave this dangling
+	pydvd_subpicture_t subpicture;
+} Subpicture;
+
+// Cell of a program chain to be read by a Stream, in blocks of the title set VOBs
+typedef struct {
+	uint32_t first;
+	uint32_t last;
+	int interleaved;
+} pydvd_cell_t;
+
+// Run of contiguous blocks in a Stream; @offset is its position within the stream
+typedef struct {
+	uint32_t first;
+	uint32_t blocks;
+	uint32_t offset;
+} pydvd_extent_t;
+
+typedef struct _Stream {
+	PyObject_HEAD
+	DVD *dvd;
+	dvd_file_t *file;
+	int vts;
+	int domain;
+
+	// Runs of file blocks that make up the stream in order, @blocks in total; @pos is the next to read
+	// @pos, @curextent, @ringpos and the order blocks are fed to @hasher only change with @readlock held, which
+	// serializes reads, Seek() and switching read-ahead or hashing on; a read waiting on the read-ahead thread
+	// holds it, so it is taken before the DVD lock and never while holding that
+	pthread_mutex_t readlock;
+	pydvd_extent_t *extents;
+	int numextents;
+	int curextent;
+	int blocks;
+	int pos;
+	int fileblocks;
+
+	// Rescue mode reads: blocks still to be passed over after a failure, and failures in a row
+	int rescueskip;
+	int rescuefailures;
+
+	// Read() returns views of this ring of @ringblocks blocks; @ringpos is where the next read lands
+	unsigned char *ring;
+	int ringblocks;
+	int ringpos;
+
+	// With @readahead set a thread keeps the ring filled past @pos instead; @raextent is its extent cursor
+	pydvd_readahead_t ra;
+	int readahead;
+	int raextent;
+
+	// With @hash set blocks are fed to @hasher as they are read; @hashlock guards both and @digest
+	pthread_mutex_t hashlock;
+	pydvd_hasher_t hasher;
+	pydvd_digest_t digest;
+	int hash;
+	int hasdigest;
+
+	// Other streams open on the same DVD, so Close() can close their files before the reader
+	struct _Stream *prev;
+	struct _Stream *next;
+} Stream;
+
+// Create and fill in objects directly, defined with each type below
+static PyObject* _Title_create(DVD *dvd, int ifonum, int titlenum);
+static PyObject* _Title_makeAudio(PyObject *owner, int audionum, int *own);
+static PyObject* _Title_makeChapter(PyObject *owner, int chapternum, int *own);
+static PyObject* _Title_makeSubpicture(PyObject *owner, int subpicturenum, int *own);
+static int _Audio_fill(Audio *self, Title *title, int audionum);
+static void _Chapter_fill(Chapter *self, Title *title, int chapternum, int start, int end, long lenms, PyObject *lenfancy);
+static int _Subpicture_fill(Subpicture *self, Title *title, int subpicturenum);
+
+static PyObject* _Stream_open(DVD *dvd, int vts, dvd_read_domain_t domain, const pydvd_cell_t *cells, int numcells, int ringblocks, int readahead);
+
+// DVD lock, defined with the other DVD helpers below
+static void _DVD_lock(DVD *self);
+static void _DVD_unlock(DVD *self);
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Administrative functions for DVD
+
+static PyObject*
+DVD_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	DVD *self;
+
+	ModuleState_t *st = GetState(type);
+	if (st == NULL)
+	{
+		return NULL;
+	}
+
+	self = (DVD*)type->tp_alloc(type, 0);
+	if (self != NULL)
+	{
+		Py_INCREF(Py_None);
+		self->path = Py_None;
+		self->dvd = NULL;
+		self->state = st;
+
+		Py_INCREF(Py_None);
+		self->TitleClass = Py_None;
+
+		self->numifos = 0;
+		self->ifos = NULL;
+		self->numtitles = 0;
+		self->volumeid[0] = '\0';
+		self->volumesetid[0] = '\0';
+
+		self->numreaders = 0;
+		self->readers = NULL;
+
+		self->ifotick = NULL;
+		self->tick = 0;
+		self->maxifos = 0;
+		self->numresident = 0;
+		self->numloaded = 0;
+		self->numevicted = 0;
+
+		self->table = NULL;
+		self->tablesize = 0;
+		self->tablemapped = 0;
+		self->fromcache = 0;
+
+		self->titles = NULL;
+		self->titlesets = NULL;
+
+		self->hasfingerprint = 0;
+
+		memset(&self->titleobjs, 0, sizeof(_Children_t));
+
+		self->streams = NULL;
+
+		memset(&self->blockcache, 0, sizeof(pydvd_blockcache_t));
+		pydvd_blockcache_setup(&self->blockcache, 0, PYDVD_BLOCKCACHE_LRU);
+
+		self->rescue = 0;
+		self->rescuefill = PYDVD_RESCUE_FILL_ZERO;
+		self->rescuefailures = 0;
+		self->rescuefilled = 0;
+		self->rescuemaps = NULL;
+		self->numrescuemaps = 0;
+
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&self->lock, &attr);
+		pthread_mutexattr_destroy(&attr);
+	}
+
+	return (PyObject *)self;
+}
+
+static int
+DVD_init(DVD *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *path=NULL, *titleclass=(PyObject*)self->state->TitleType, *tmp;
+	static char *kwlist[] = {"Path", "TitleClass", NULL};
+
+	// TitleClass defaults to the plain type
+	if (! PyArg_ParseTupleAndKeywords(args,kwds, "O|O", kwlist, &path, &titleclass))
+	{
+		return -1;
+	}
+
+	// Path, swapped under the lock as Open() and the Path getter may be reading it on another thread
+	Py_INCREF(path);
+	_DVD_lock(self);
+	tmp = self->path;
+	self->path = path;
+	_DVD_unlock(self);
+	Py_CLEAR(tmp);
+
+	// TitleClass
+	tmp = self->TitleClass;
+	Py_INCREF(titleclass);
+	self->TitleClass = titleclass;
+	Py_CLEAR(tmp);
+
+	return 0;
+}
+
+static void
+_DVD_closeReaders(dvd_reader_t **readers, int numreaders)
+{
+	if (readers)
+	{
+		for (int i=0; i < numreaders; i++)
+		{
+			if (readers[i])
+			{
+				DVDClose(readers[i]);
+			}
+		}
+		free(readers);
+	}
+}
+
+static void
+_DVD_releaseTable(DVD *self)
+{
+	pydvd_cache_release(self->table, self->tablesize, self->tablemapped);
+	self->table = NULL;
+	self->tablesize = 0;
+	self->tablemapped = 0;
+	self->fromcache = 0;
+}
+
+static void
+_DVD_freeTitleSets(DVD *self)
+{
+	if (self->titlesets)
+	{
+		for (int i=0; i <= self->numifos; i++)
+		{
+			free(self->titlesets[i].chapters);
+			free(self->titlesets[i].audios);
+			free(self->titlesets[i].subpictures);
+			free(self->titlesets[i].celltimes);
+		}
+		free(self->titlesets);
+	}
+	self->titlesets = NULL;
+
+	free(self->titles);
+	self->titles = NULL;
+}
+
+static void
+_DVD_freeRescueMaps(DVD *self)
+{
+	for (int i=0; i < self->numrescuemaps; i++)
+	{
+		pydvd_rescue_free(self->rescuemaps[i]);
+	}
+	free(self->rescuemaps);
+	self->rescuemaps = NULL;
+	self->numrescuemaps = 0;
+}
+
+static pydvd_rescue_map_t*
+_DVD_rescueMap(DVD *self, uint32_t key, uint32_t size)
+{
+	// Rescue map of the file identified by @key, created for @size blocks if there is none yet
+	// Called with the lock held and possibly without the GIL; NULL if out of memory
+	for (int i=0; i < self->numrescuemaps; i++)
+	{
+		if (self->rescuemaps[i]->key == key)
+		{
+			return self->rescuemaps[i];
+		}
+	}
+
+	pydvd_rescue_map_t **maps = (pydvd_rescue_map_t**)realloc(self->rescuemaps, sizeof(pydvd_rescue_map_t*) * (self->numrescuemaps + 1));
+	if (maps == NULL)
+	{
+		return NULL;
+	}
+	self->rescuemaps = maps;
+
+	pydvd_rescue_map_t *map = pydvd_rescue_new(key, size);
+	if (map)
+	{
+		self->rescuemaps[self->numrescuemaps++] = map;
+	}
+	return map;
+}
+
+static void
+_DVD_lock(DVD *self)
+{
+	// Never block on the lock while holding the GIL: the holder may be waiting to reacquire it
+	if (pthread_mutex_trylock(&self->lock) != 0)
+	{
+		Py_BEGIN_ALLOW_THREADS
+		pthread_mutex_lock(&self->lock);
+		Py_END_ALLOW_THREADS
+	}
+}
+
+static void
+_DVD_unlock(DVD *self)
+{
+	pthread_mutex_unlock(&self->lock);
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Child object caches
+//
+// Titles of a DVD, and chapters, audios and subpictures of a Title, are handed out again for as long as something
+// holds them. The cache only borrows them and each clears its slot as it goes (see _Children_forget()), so it keeps
+// nothing alive and makes no cycle with the reference every child holds to its parent. The cache is guarded by the
+// DVD's lock, but objects are made and released without it as that can call back into Python (TitleClass and
+// friends may be Python classes).
+
+// Makes child @num (one based, bounds checked) of @owner, setting @own if the result is that child, which clears
+// its slot when it goes, rather than whatever a class changing how it is constructed returned
+typedef PyObject* (*_Children_make_t)(PyObject *owner, int num, int *own);
+
+static int
+_Children_tryIncRef(PyObject *obj)
+{
+	// Takes a reference to a cached child unless it is being deallocated and waiting for the lock to leave its
+	// slot; called with the lock held
+#ifdef Py_GIL_DISABLED
+#if PY_VERSION_HEX >= 0x030E0000
+	return PyUnstable_TryIncRef(obj);
+#else
+	// No safe way to tell before 3.14, so every call makes a new object
+	return 0;
+#endif
+#else
+	if (Py_REFCNT(obj) == 0)
+	{
+		return 0;
+	}
+	Py_INCREF(obj);
+	return 1;
+#endif
+}
+
+static PyObject*
+_Children_get(DVD *dvd, _Children_t *c, int count, PyObject *owner, int num, _Children_make_t make)
+{
+	// Child @num of @count of @owner: the one still alive from the cache, or one made by @make and added to it
+	PyObject *ret = NULL;
+	_DVD_lock(dvd);
+	if (c->objs && num <= c->num && c->objs[num-1] && _Children_tryIncRef(c->objs[num-1]))
+	{
+		ret = c->objs[num-1];
+	}
+	_DVD_unlock(dvd);
+	if (ret)
+	{
+		return ret;
+	}
+
+	int own = 0;
+	ret = make(owner, num, &own);
+	if (ret == NULL || !own)
+	{
+		return ret;
+	}
+
+	// Another thread may have made it meanwhile, then everyone gets that one; titles of a disc closed meanwhile
+	// are not kept, as Close() has emptied the title cache (failing to allocate the slots only costs the caching)
+	PyObject *drop = NULL;
+	_DVD_lock(dvd);
+	if (dvd->dvd || c != &dvd->titleobjs)
+	{
+		if (c->objs == NULL)
+		{
+			c->objs = (PyObject**)calloc(count, sizeof(PyObject*));
+			c->num = (c->objs ? count : 0);
+		}
+		if (num <= c->num)
+		{
+			PyObject *cached = c->objs[num-1];
+			if (cached && _Children_tryIncRef(cached))
+			{
+				drop = ret;
+				ret = cached;
+			}
+			else
+			{
+#if defined(Py_GIL_DISABLED) && PY_VERSION_HEX >= 0x030E0000
+				PyUnstable_EnableTryIncRef(ret);
+#endif
+				c->objs[num-1] = ret;
+			}
+		}
+	}
+	_DVD_unlock(dvd);
+
+	Py_XDECREF(drop);
+	return ret;
+}
+
+static void
+_Children_forget(DVD *dvd, _Children_t *c, int num, PyObject *obj)
+{
+	// Called as child @num goes to clear its slot, unless another has taken it meanwhile
+	if (dvd == NULL)
+	{
+		return;
+	}
+
+	_DVD_lock(dvd);
+	if (c->objs && num >= 1 && num <= c->num && c->objs[num-1] == obj)
+	{
+		c->objs[num-1] = NULL;
+	}
+	_DVD_unlock(dvd);
+}
+
+static PyObject*
+_Children_view(DVD *dvd, _Children_t *c, int count, PyObject *owner, _Children_make_t make)
+{
+	// Tuple of all @count children of @owner, the same objects _Children_get() hands out
+	PyObject *ret = PyTuple_New(count);
+	if (ret == NULL)
+	{
+		return NULL;
+	}
+	for (int i=0; i < count; i++)
+	{
+		PyObject *child = _Children_get(dvd, c, count, owner, i+1, make);
+		if (child == NULL)
+		{
+			Py_DECREF(ret);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(ret, i, child);
+	}
+	return ret;
+}
+
+static void
+_Children_release(_Children_t *c)
+{
+	// Frees the slots, which only borrow the children
+	free(c->objs);
+	memset(c, 0, sizeof(_Children_t));
+}
+
+static PyObject*
+_Children_subscript(PyObject *owner, PyObject *key, lenfunc length, ssizeargfunc item, PyObject *(*view)(PyObject*))
+{
+	// obj[key] of a DVD or Title: an index goes through @item and a slice is taken of the tuple from @view
+	if (PyIndex_Check(key))
+	{
+		Py_ssize_t i = PyNumber_AsSsize_t(key, PyExc_IndexError);
+		if (i == -1 && PyErr_Occurred())
+		{
+			return NULL;
+		}
+		if (i < 0)
+		{
+			i += length(owner);
+		}
+		return item(owner, i);
+	}
+
+	if (PySlice_Check(key))
+	{
+		PyObject *all = view(owner);
+		if (all == NULL)
+		{
+			return NULL;
+		}
+		PyObject *ret = PyObject_GetItem(all, key);
+		Py_DECREF(all);
+		return ret;
+	}
+
+	PyErr_Format(PyExc_TypeError, "indices must be integers or slices, not %.200s", Py_TYPE(key)->tp_name);
+	return NULL;
+}
+
+static PyObject*
+_Children_iter(PyObject *(*view)(PyObject*), PyObject *owner)
+{
+	// iter(obj) of a DVD or Title walks the tuple from @view
+	PyObject *all = view(owner);
+	if (all == NULL)
+	{
+		return NULL;
+	}
+	PyObject *ret = PyObject_GetIter(all);
+	Py_DECREF(all);
+	return ret;
+}
+
+static void
+_DVD_closeIFOs(DVD *self)
+{
+	if (self->ifos)
+	{
+		// Close and null each open IFO (zero through numifos inclusive)
+		for (int i=0; i <= self->numifos; i++)
+		{
+			if (self->ifos[i])
+			{
+				ifoClose(self->ifos[i]);
+				self->ifos[i] = NULL;
+			}
+		}
+		// Free the array
+		free(self->ifos);
+	}
+	self->ifos = NULL;
+
+	free(self->ifotick);
+	self->ifotick = NULL;
+
+	self->numresident = 0;
+
+	// Parallel readers can only go once their IFOs are closed
+	_DVD_closeReaders(self->readers, self->numreaders);
+	self->readers = NULL;
+	self->numreaders = 0;
+}
+
+static void
+DVD_dealloc(DVD *self)
+{
+	// No title is left to clear its slot, as each holds its DVD
+	_Children_release(&self->titleobjs);
+	Py_CLEAR(self->path);
+	Py_CLEAR(self->TitleClass);
+
+	// Nothing else can reference self now, so no need for the lock
+	Py_BEGIN_ALLOW_THREADS
+	_DVD_freeTitleSets(self);
+	_DVD_closeIFOs(self);
+	_DVD_releaseTable(self);
+
+	if (self->dvd)
+	{
+		DVDClose(self->dvd);
+	}
+	pydvd_blockcache_empty(&self->blockcache);
+	_DVD_freeRescueMaps(self);
+	Py_END_ALLOW_THREADS
+	self->dvd = NULL;
+
+	self->numifos = 0;
+	self->numtitles = 0;
+
+	pthread_mutex_destroy(&self->lock);
+
+	// Instances of heap types hold a reference to their type
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for DVD
+
+static PyObject*
+DVD_getPath(DVD *self)
+{
+	// Referenced under the lock, see DVD_init()
+	_DVD_lock(self);
+	PyObject *path = self->path;
+	Py_XINCREF(path);
+	_DVD_unlock(self);
+
+	if (path == NULL)
+	{
+		PyErr_SetString(PyExc_AttributeError, "_path");
+		return NULL;
+	}
+	return path;
+}
+
+static int
+_DVD_getIsOpen(DVD *self)
+{
+	return !!self->dvd;
+}
+
+static void
+_DVD_evictIFO(DVD *self, int keep)
+{
+	// Find the least recently used VTS IFO other than @keep (IFO zero is never evicted)
+	int lru = 0;
+	for (int i=1; i <= self->numifos; i++)
+	{
+		if (i == keep || !self->ifos[i])
+		{
+			continue;
+		}
+		if (lru == 0 || self->ifotick[i] < self->ifotick[lru])
+		{
+			lru = i;
+		}
+	}
+
+	if (lru)
+	{
+		ifoClose(self->ifos[lru]);
+		self->ifos[lru] = NULL;
+		self->numresident--;
+		self->numevicted++;
+	}
+}
+
+static int
+_DVD_lockOpen(DVD *self)
+{
+	// Takes the lock for reading the IFOs and title records, which Close() frees while holding it
+	// Returns zero with the lock held, or -1 with an exception set if the disc is not open
+	_DVD_lock(self);
+
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		return -1;
+	}
+	return 0;
+}
+
+static ifo_handle_t*
+_DVD_getIFO(DVD *self, int ifonum)
+{
+	// Returns the IFO handle for @ifonum, loading it on first use
+	// Called with the lock held; the returned pointer is only valid until it is released or the next call,
+	// as that may evict other IFOs
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		return NULL;
+	}
+	if (ifonum < 0 || ifonum > self->numifos)
+	{
+		PyErr_Format(PyExc_ValueError, "IFO number out of range (%d)", ifonum);
+		return NULL;
+	}
+
+	self->ifotick[ifonum] = ++self->tick;
+
+	if (self->ifos[ifonum])
+	{
+		return self->ifos[ifonum];
+	}
+
+	ifo_handle_t *ifo;
+	Py_BEGIN_ALLOW_THREADS
+	ifo = ifoOpen(self->dvd, ifonum);
+	Py_END_ALLOW_THREADS
+
+	if (!ifo)
+	{
+		PyErr_Format(PyExc_Exception, "Could not open IFO %d", ifonum);
+		return NULL;
+	}
+	self->ifos[ifonum] = ifo;
+	self->numloaded++;
+	self->numresident++;
+
+	// Enforce residency budget
+	while (self->maxifos > 0 && self->numresident > self->maxifos)
+	{
+		_DVD_evictIFO(self, ifonum);
+	}
+
+	return ifo;
+}
+
+static PyObject*
+DVD_getIsOpen(DVD *self)
+{
+	if ( _DVD_getIsOpen(self) )
+	{
+		Py_INCREF(Py_True);
+		return Py_True;
+	}
+	else
+	{
+		Py_INCREF(Py_False);
+		return Py_False;
+	}
+}
+
+static PyObject*
+DVD_GetVMGID(DVD *self)
+{
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_AttributeError, "VMGID: disc not open");
+		return NULL;
+	}
+
+	char buf[13];
 	strncpy(buf, self->ifos[0]->vmgi_mat->vmg_identifier, 12);
 	buf[12] = '\0';
+	_DVD_unlock(self);
+
+	return PyUnicode_FromString(buf);
+}
+
+static PyObject*
+DVD_GetProviderID(DVD *self)
+{
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_AttributeError, "ProviderID: disc not open");
+		return NULL;
+	}
+
+	char buf[33];
+	strncpy(buf, self->ifos[0]->vmgi_mat->provider_identifier, 32);
+	buf[32] = '\0';
+	_DVD_unlock(self);
+
+	return PyUnicode_FromString(buf);
+}
+
+static int
+_DVD_copyFingerprint(DVD *self, const char *notopen, unsigned char *fingerprint)
+{
+	// Copies the fingerprint out under the lock, as the next Open() rewrites it; returns one, zero if there is
+	// none, or -1 with AttributeError @notopen if the disc is not open
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_AttributeError, notopen);
+		return -1;
+	}
+	int has = self->hasfingerprint;
+	memcpy(fingerprint, self->fingerprint, sizeof(self->fingerprint));
+	_DVD_unlock(self);
+	return has;
+}
+
+static PyObject*
+DVD_GetFingerprint(DVD *self)
+{
+	unsigned char fingerprint[sizeof(self->fingerprint)];
+	int has = _DVD_copyFingerprint(self, "Fingerprint: disc not open", fingerprint);
+	if (has < 0)
+	{
+		return NULL;
+	}
+
+	// None if libdvdread could not read the IFO files to hash them
+	if (!has)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	return PyBytes_FromStringAndSize((const char*)fingerprint, sizeof(fingerprint));
+}
+
+static PyObject*
+DVD_GetFingerprintHex(DVD *self)
+{
+	unsigned char fingerprint[sizeof(self->fingerprint)];
+	int has = _DVD_copyFingerprint(self, "FingerprintHex: disc not open", fingerprint);
+	if (has < 0)
+	{
+		return NULL;
+	}
+
+	if (!has)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	char buf[2 * sizeof(fingerprint) + 1];
+	for (size_t i=0; i < sizeof(fingerprint); i++)
+	{
+		sprintf(buf + 2 * i, "%02x", fingerprint[i]);
+	}
+
+	return PyUnicode_FromString(buf);
+}
+
+static PyObject*
+DVD_GetNumberOfTitles(DVD *self)
+{
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_AttributeError, "NumberOfTitles: disc not open");
+		return NULL;
+	}
+
+	return PyLong_FromLong((long)self->numtitles);
+}
+
+static PyObject*
+DVD_getMaxResidentIFOs(DVD *self)
+{
+	return PyLong_FromLong((long)self->maxifos);
+}
+
+static int
+DVD_setMaxResidentIFOs(DVD *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete MaxResidentIFOs");
+		return -1;
+	}
+
+	long max = PyLong_AsLong(value);
+	if (max == -1 && PyErr_Occurred())
+	{
+		return -1;
+	}
+	if (max < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "MaxResidentIFOs cannot be negative (%ld)", max);
+		return -1;
+	}
+
+	// Shrink immediately if already over budget
+	_DVD_lock(self);
+	self->maxifos = (int)max;
+	if (self->ifos)
+	{
+		while (self->maxifos > 0 && self->numresident > self->maxifos)
+		{
+			_DVD_evictIFO(self, 0);
+		}
+	}
+	_DVD_unlock(self);
+
+	return 0;
+}
+
+static PyObject*
+DVD_getIFOsLoaded(DVD *self)
+{
+	return PyLong_FromLong(self->numloaded);
+}
+
+static PyObject*
+DVD_getIFOsResident(DVD *self)
+{
+	// Include IFO zero when open
+	_DVD_lock(self);
+	long resident = (long)self->numresident + (self->ifos && self->ifos[0] ? 1 : 0);
+	_DVD_unlock(self);
+
+	return PyLong_FromLong(resident);
+}
+
+static PyObject*
+DVD_getIFOsEvicted(DVD *self)
+{
+	return PyLong_FromLong(self->numevicted);
+}
+
+static PyObject*
+DVD_getBlockCacheSize(DVD *self)
+{
+	return PyLong_FromSize_t(self->blockcache.bytes);
+}
+
+static void
+_DVD_setupBlockCache(DVD *self, size_t bytes, int policy)
+{
+	// Readers may be using the cache, so swap it under the lock; freeing a big cache is worth dropping the GIL
+	_DVD_lock(self);
+	pydvd_blockcache_t *cache = &self->blockcache;
+	Py_BEGIN_ALLOW_THREADS
+	pydvd_blockcache_setup(cache, bytes, policy);
+	Py_END_ALLOW_THREADS
+	_DVD_unlock(self);
+}
+
+static int
+DVD_setBlockCacheSize(DVD *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete BlockCacheSize");
+		return -1;
+	}
+
+	Py_ssize_t bytes = PyLong_AsSsize_t(value);
+	if (bytes == -1 && PyErr_Occurred())
+	{
+		return -1;
+	}
+	if (bytes < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "BlockCacheSize cannot be negative (%zd)", bytes);
+		return -1;
+	}
+
+	_DVD_setupBlockCache(self, (size_t)bytes, self->blockcache.policy);
+	return 0;
+}
+
+static PyObject*
+DVD_getBlockCachePolicy(DVD *self)
+{
+	return PyLong_FromLong(self->blockcache.policy);
+}
+
+static int
+DVD_setBlockCachePolicy(DVD *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete BlockCachePolicy");
+		return -1;
+	}
+
+	long policy = PyLong_AsLong(value);
+	if (policy == -1 && PyErr_Occurred())
+	{
+		return -1;
+	}
+	if (policy != PYDVD_BLOCKCACHE_LRU && policy != PYDVD_BLOCKCACHE_CLOCK)
+	{
+		PyErr_Format(PyExc_ValueError, "Unknown block cache policy (%ld)", policy);
+		return -1;
+	}
+
+	_DVD_setupBlockCache(self, self->blockcache.bytes, (int)policy);
+	return 0;
+}
+
+static PyObject*
+DVD_getBlockCacheBlocks(DVD *self)
+{
+	return PyLong_FromUnsignedLong(self->blockcache.count);
+}
+
+static PyObject*
+DVD_getBlockCacheHits(DVD *self)
+{
+	return PyLong_FromUnsignedLongLong(self->blockcache.hits);
+}
+
+static PyObject*
+DVD_getBlockCacheMisses(DVD *self)
+{
+	return PyLong_FromUnsignedLongLong(self->blockcache.misses);
+}
+
+static PyObject*
+DVD_getBlockCacheEvictions(DVD *self)
+{
+	return PyLong_FromUnsignedLongLong(self->blockcache.evictions);
+}
+
+static PyObject*
+DVD_getRescue(DVD *self)
+{
+	return PyBool_FromLong(self->rescue);
+}
+
+static int
+DVD_setRescue(DVD *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete Rescue");
+		return -1;
+	}
+
+	int on = PyObject_IsTrue(value);
+	if (on < 0)
+	{
+		return -1;
+	}
+
+	// Not halfway through a read
+	_DVD_lock(self);
+	self->rescue = on;
+	_DVD_unlock(self);
+
+	return 0;
+}
+
+static PyObject*
+DVD_getRescueFill(DVD *self)
+{
+	return PyLong_FromLong(self->rescuefill);
+}
+
+static int
+DVD_setRescueFill(DVD *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete RescueFill");
+		return -1;
+	}
+
+	long fill = PyLong_AsLong(value);
+	if (fill == -1 && PyErr_Occurred())
+	{
+		return -1;
+	}
+	if (fill != PYDVD_RESCUE_FILL_ZERO && fill != PYDVD_RESCUE_FILL_PAD)
+	{
+		PyErr_Format(PyExc_ValueError, "Unknown rescue fill (%ld)", fill);
+		return -1;
+	}
+	// Read by stream reads with the lock held
+	_DVD_lock(self);
+	self->rescuefill = (int)fill;
+	_DVD_unlock(self);
+
+	return 0;
+}
+
+static PyObject*
+DVD_getRescueFailures(DVD *self)
+{
+	return PyLong_FromLong(self->rescuefailures);
+}
+
+static PyObject*
+DVD_getRescueFilled(DVD *self)
+{
+	return PyLong_FromLong(self->rescuefilled);
+}
+
+static PyObject*
+DVD_getFromCache(DVD *self)
+{
+	return PyBool_FromLong(self->fromcache);
+}
+
+static PyObject*
+DVD_getVolumeID(DVD *self)
+{
+	char buf[sizeof(self->volumeid)];
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_AttributeError, "VolumeID: disc not open");
+		return NULL;
+	}
+	memcpy(buf, self->volumeid, sizeof(buf));
+	_DVD_unlock(self);
+
+	return PyUnicode_DecodeUTF8(buf, strlen(buf), "replace");
+}
+
+static PyObject*
+DVD_getVolumeSetID(DVD *self)
+{
+	char buf[sizeof(self->volumesetid)];
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_AttributeError, "VolumeSetID: disc not open");
+		return NULL;
+	}
+	memcpy(buf, self->volumesetid, sizeof(buf));
+	_DVD_unlock(self);
+
+	return PyUnicode_DecodeUTF8(buf, strlen(buf), "replace");
+}
+
+static void
+_DVD_readVolumeInfo(dvd_reader_t *dvd, const char *path, const struct stat *s, char *volumeid, char *volumesetid)
+{
+	// Fills @volumeid (256 bytes) and @volumesetid (128*3+1 bytes) from the ISO9660 or UDF volume descriptors
+	// A VIDEO_TS directory has neither, so its name (or its parent's if named VIDEO_TS) stands in as the label
+	unsigned char vsid[128];
+
+	volumeid[0] = '\0';
+	volumesetid[0] = '\0';
+
+	if (DVDISOVolumeInfo(dvd, volumeid, 33, vsid, sizeof(vsid)) == 0)
+	{
+		size_t len = sizeof(vsid);
+		while (len > 0 && (vsid[len-1] == ' ' || vsid[len-1] == '\0'))
+		{
+			len--;
+		}
+		memcpy(volumesetid, vsid, len);
+		volumesetid[len] = '\0';
+	}
+	else if (DVDUDFVolumeInfo(dvd, volumeid, 33, vsid, sizeof(vsid)) == 0)
+	{
+		// UDF volume set identifier is the raw dstring
+		pydvd_udf_dstring(vsid, sizeof(vsid), volumesetid);
+	}
+	else if (S_ISDIR(s->st_mode))
+	{
+		volumeid[0] = '\0';
+
+		const char *end = path + strlen(path);
+		for (int pass=0; pass < 2; pass++)
+		{
+			while (end > path && end[-1] == '/')
+			{
+				end--;
+			}
+			const char *start = end;
+			while (start > path && start[-1] != '/')
+			{
+				start--;
+			}
+
+			if (pass == 0 && end - start == 8 && strncasecmp(start, "VIDEO_TS", 8) == 0 && start > path)
+			{
+				end = start;
+				continue;
+			}
+
+			size_t len = (size_t)(end - start);
+			if (len > 255)
+			{
+				len = 255;
+			}
+			memcpy(volumeid, start, len);
+			volumeid[len] = '\0';
+			break;
+		}
+	}
+	else
+	{
+		volumeid[0] = '\0';
+	}
+
+	// Same as the old Python GetName(), which stripped the raw 32 bytes
+	size_t len = strlen(volumeid);
+	while (len > 0 && volumeid[len-1] == ' ')
+	{
+		volumeid[--len] = '\0';
+	}
+}
+
+
+
+static int
+_DVD_fillTitleSet(DVD *self, int ifonum, ifo_handle_t *ifo)
+{
+	// Flattens every title of title set @ifonum into self->titles and the set's own arrays, so getters read
+	// records instead of following the title search pointers into the IFOs on every access
+	// Returns zero, or -1 with an exception set
+	ifo_handle_t *zero = self->ifos[0];
+	_DVD_titleset_t *set = &self->titlesets[ifonum];
+	uint32_t numchapters = 0, numaudios = 0, numsubpictures = 0, numcelltimes = 0;
+
+	for (int t=1; t <= self->numtitles; t++)
+	{
+		if (zero->tt_srpt->title[t-1].title_set_nr != ifonum)
+		{
+			continue;
+		}
+
+		pydvd_title_t *rec = &self->titles[t-1];
+		_pydvd_fillTitle(rec, zero, ifo, _ifo_getTitlePGC(zero, ifo, t), t);
+		rec->chapters = numchapters;
+		rec->audios = numaudios;
+		rec->subpictures = numsubpictures;
+		rec->celltimes = numcelltimes;
+		numchapters += rec->numchapters;
+		numaudios += rec->numaudios;
+		numsubpictures += rec->numsubpictures;
+		numcelltimes += rec->numcells + 1;
+	}
+
+	pydvd_chapter_t *chapters = (pydvd_chapter_t*)calloc(numchapters + 1, sizeof(pydvd_chapter_t));
+	pydvd_audio_t *audios = (pydvd_audio_t*)calloc(numaudios + 1, sizeof(pydvd_audio_t));
+	pydvd_subpicture_t *subpictures = (pydvd_subpicture_t*)calloc(numsubpictures + 1, sizeof(pydvd_subpicture_t));
+	pydvd_celltime_t *celltimes = (pydvd_celltime_t*)calloc(numcelltimes + 1, sizeof(pydvd_celltime_t));
+	if (chapters == NULL || audios == NULL || subpictures == NULL || celltimes == NULL)
+	{
+		free(chapters);
+		free(audios);
+		free(subpictures);
+		free(celltimes);
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	for (int t=1; t <= self->numtitles; t++)
+	{
+		if (zero->tt_srpt->title[t-1].title_set_nr != ifonum)
+		{
+			continue;
+		}
+
+		const pydvd_title_t *rec = &self->titles[t-1];
+		pgc_t *pgc = _ifo_getTitlePGC(zero, ifo, t);
+		_pydvd_fillCellTimes(&celltimes[rec->celltimes], pgc);
+		for (int i=1; i <= rec->numchapters; i++)
+		{
+			_pydvd_fillChapter(&chapters[rec->chapters + i-1], pgc, i, rec->numchapters, &celltimes[rec->celltimes]);
+		}
+		for (int i=1; i <= rec->numaudios; i++)
+		{
+			_pydvd_fillAudio(&audios[rec->audios + i-1], _ifo_findAudio(ifo, pgc, i));
+		}
+		for (int i=1; i <= rec->numsubpictures; i++)
+		{
+			_pydvd_fillSubpicture(&subpictures[rec->subpictures + i-1], _ifo_findSubpicture(ifo, pgc, i));
+		}
+	}
+
+	set->chapters = chapters;
+	set->audios = audios;
+	set->subpictures = subpictures;
+	set->celltimes = celltimes;
+	set->filled = 1;
+	return 0;
+}
+
+static int
+_DVD_getTitleRecord(DVD *self, int titlenum, _DVD_titlerecs_t *recs)
+{
+	// Record of @titlenum and the first of its chapter, audio, subpicture and cell time records, from the cache
+	// table or from its title set's records, which are filled the first time any of its titles is asked for
+	// Called with the lock held (see _DVD_lockOpen()), and the records are only valid until it is released
+	// Returns zero, or -1 with an exception set
+	if (titlenum < 1 || titlenum > self->numtitles)
+	{
+		PyErr_Format(PyExc_ValueError, "Title number out of range (%d)", titlenum);
+		return -1;
+	}
+
+	if (self->table)
+	{
+		const pydvd_title_t *rec = &PYDVD_TABLE_ARRAY(self->table, pydvd_title_t, titles)[ titlenum-1 ];
+		recs->title = rec;
+		recs->chapters = PYDVD_TABLE_ARRAY(self->table, pydvd_chapter_t, chapters) + rec->chapters;
+		recs->audios = PYDVD_TABLE_ARRAY(self->table, pydvd_audio_t, audios) + rec->audios;
+		recs->subpictures = PYDVD_TABLE_ARRAY(self->table, pydvd_subpicture_t, subpictures) + rec->subpictures;
+		recs->celltimes = PYDVD_TABLE_ARRAY(self->table, pydvd_celltime_t, celltimes) + rec->celltimes;
+		return 0;
+	}
+
+	int ifonum = self->ifos[0]->tt_srpt->title[ titlenum-1 ].title_set_nr;
+	if (ifonum < 1 || ifonum > self->numifos)
+	{
+		PyErr_Format(PyExc_ValueError, "IFO number out of range (%d)", ifonum);
+		return -1;
+	}
+
+	_DVD_titleset_t *set = &self->titlesets[ifonum];
+	if (!set->filled)
+	{
+		ifo_handle_t *ifo = _DVD_getIFO(self, ifonum);
+		if (ifo == NULL || _DVD_fillTitleSet(self, ifonum, ifo))
+		{
+			return -1;
+		}
+	}
+
+	const pydvd_title_t *rec = &self->titles[titlenum-1];
+	recs->title = rec;
+	recs->chapters = set->chapters + rec->chapters;
+	recs->audios = set->audios + rec->audios;
+	recs->subpictures = set->subpictures + rec->subpictures;
+	recs->celltimes = set->celltimes + rec->celltimes;
+	return 0;
+}
+
+static pydvd_table_t*
+_DVD_buildTable(DVD *self, const pydvd_table_t *key)
+{
+	// Flattens every title into a single table, filling the records of each title set along the way
+	// Returns a malloc'ed table, or NULL with an exception set
+	int numtitles = self->numtitles;
+	uint32_t numchapters = 0, numaudios = 0, numsubpictures = 0, numcelltimes = 0;
+
+	_DVD_titlerecs_t recs;
+	for (int t=1; t <= numtitles; t++)
+	{
+		if (_DVD_getTitleRecord(self, t, &recs))
+		{
+			return NULL;
+		}
+		numchapters += recs.title->numchapters;
+		numaudios += recs.title->numaudios;
+		numsubpictures += recs.title->numsubpictures;
+		numcelltimes += recs.title->numcells + 1;
+	}
+
+	// Cell times come first as they hold 64 bit fields, every other record size is a multiple of 4 so each array
+	// stays aligned
+	size_t offcelltimes = (sizeof(pydvd_table_t) + 7) & ~(size_t)7;
+	size_t offtitles = offcelltimes + numcelltimes * sizeof(pydvd_celltime_t);
+	size_t offchapters = offtitles + numtitles * sizeof(pydvd_title_t);
+	size_t offaudios = offchapters + numchapters * sizeof(pydvd_chapter_t);
+	size_t offsubpictures = offaudios + numaudios * sizeof(pydvd_audio_t);
+	size_t size = offsubpictures + numsubpictures * sizeof(pydvd_subpicture_t);
+
+	pydvd_table_t *tbl = (pydvd_table_t*)calloc(1, size);
+	if (tbl == NULL)
+	{
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	memcpy(tbl->magic, PYDVD_TABLE_MAGIC, sizeof(tbl->magic));
+	tbl->version = PYDVD_TABLE_VERSION;
+	tbl->byteorder = PYDVD_TABLE_BYTEORDER;
+	tbl->size = size;
+	memcpy(tbl->fingerprint, key->fingerprint, sizeof(tbl->fingerprint));
+
+	tbl->numifos = self->numifos;
+	tbl->numtitles = numtitles;
+	tbl->numchapters = numchapters;
+	tbl->numaudios = numaudios;
+	tbl->numsubpictures = numsubpictures;
+	tbl->numcelltimes = numcelltimes;
+	tbl->titles = offtitles;
+	tbl->chapters = offchapters;
+	tbl->audios = offaudios;
+	tbl->subpictures = offsubpictures;
+	tbl->celltimes = offcelltimes;
+
+	// Title sets each number their records from zero, the table numbers them across the whole disc
+	numchapters = numaudios = numsubpictures = numcelltimes = 0;
+	for (int t=1; t <= numtitles; t++)
+	{
+		_DVD_getTitleRecord(self, t, &recs);
+		pydvd_title_t *rec = (pydvd_title_t*)((char*)tbl + offtitles) + (t-1);
+		*rec = *recs.title;
+
+		rec->chapters = numchapters;
+		rec->audios = numaudios;
+		rec->subpictures = numsubpictures;
+		rec->celltimes = numcelltimes;
+		memcpy((pydvd_chapter_t*)((char*)tbl + offchapters) + numchapters, recs.chapters, rec->numchapters * sizeof(pydvd_chapter_t));
+		memcpy((pydvd_audio_t*)((char*)tbl + offaudios) + numaudios, recs.audios, rec->numaudios * sizeof(pydvd_audio_t));
+		memcpy((pydvd_subpicture_t*)((char*)tbl + offsubpictures) + numsubpictures, recs.subpictures, rec->numsubpictures * sizeof(pydvd_subpicture_t));
+		memcpy((pydvd_celltime_t*)((char*)tbl + offcelltimes) + numcelltimes, recs.celltimes, (rec->numcells + 1) * sizeof(pydvd_celltime_t));
+		numchapters += rec->numchapters;
+		numaudios += rec->numaudios;
+		numsubpictures += rec->numsubpictures;
+		numcelltimes += rec->numcells + 1;
+	}
+
+	tbl->checksum = pydvd_table_checksum(tbl);
+
+	return tbl;
+}
+
+static void
+_DVD_fingerprint(ifo_handle_t *zero, const unsigned char *discid, uint64_t volumeblocks, unsigned char *out)
+{
+	// SHA-256 over the DVDDiscID() MD5, the VMG and provider IDs and the volume size in blocks (little endian)
+	// Pressings that share IFOs but not the rest of the disc still differ by size
+	pydvd_sha256_t ctx;
+	unsigned char blocks[8];
+	for (int i=0; i < 8; i++)
+	{
+		blocks[i] = (unsigned char)(volumeblocks >> (8 * i));
+	}
+
+	pydvd_sha256_init(&ctx);
+	pydvd_sha256_update(&ctx, discid, 16);
+	pydvd_sha256_update(&ctx, (const unsigned char*)zero->vmgi_mat->vmg_identifier, 12);
+	pydvd_sha256_update(&ctx, (const unsigned char*)zero->vmgi_mat->provider_identifier, 32);
+	pydvd_sha256_update(&ctx, blocks, sizeof(blocks));
+	pydvd_sha256_final(&ctx, out);
+}
+
+static char*
+_DVD_cachePath(const char *cachedir, const pydvd_table_t *key)
+{
+	// Cache file name is the disc fingerprint in hex
+	size_t len = strlen(cachedir) + 1 + 2 * sizeof(key->fingerprint) + 7 + 1;
+	char *path = (char*)malloc(len);
+	if (path == NULL)
+	{
+		return NULL;
+	}
+
+	char *p = path + sprintf(path, "%s/", cachedir);
+	for (size_t i=0; i < sizeof(key->fingerprint); i++)
+	{
+		p += sprintf(p, "%02x", key->fingerprint[i]);
+	}
+	strcpy(p, ".dvdtbl");
+
+	return path;
+}
+
+// State shared by the Open(parallel=N) workers, each parses IFOs off a common counter with its own reader
+typedef struct {
+	pthread_mutex_t lock;
+	int next;
+	int last;
+	ifo_handle_t **ifos;
+	int failed;
+} _DVD_openpool_t;
+
+typedef struct {
+	_DVD_openpool_t *pool;
+	dvd_reader_t *dvd;
+	pthread_t thread;
+	int started;
+} _DVD_openworker_t;
+
+static void*
+_DVD_openWorker(void *arg)
+{
+	_DVD_openworker_t *w = (_DVD_openworker_t*)arg;
+	_DVD_openpool_t *pool = w->pool;
+
+	while (1)
+	{
+		pthread_mutex_lock(&pool->lock);
+		int i = pool->next++;
+		int stop = (pool->failed != 0);
+		pthread_mutex_unlock(&pool->lock);
+
+		if (stop || i > pool->last)
+		{
+			break;
+		}
+
+		pool->ifos[i] = ifoOpen(w->dvd, i);
+		if (!pool->ifos[i])
+		{
+			// Keep the lowest failing IFO number for the error
+			pthread_mutex_lock(&pool->lock);
+			if (pool->failed == 0 || i < pool->failed)
+			{
+				pool->failed = i;
+			}
+			pthread_mutex_unlock(&pool->lock);
+		}
+	}
+
+	return NULL;
+}
+
+static int
+_DVD_openParallel(const char *path, dvd_reader_t *dvd, ifo_handle_t **ifos, int last, int parallel, dvd_reader_t ***readers, int *numreaders)
+{
+	// Parses IFOs 1 through @last into @ifos using up to @parallel threads, called without the GIL
+	// Returns zero on success or the first IFO number that failed to open
+	// Extra readers opened are returned in @readers and must outlive the IFOs parsed with them
+	int extra = (parallel < last ? parallel : last) - 1;
+
+	_DVD_openpool_t pool;
+	pthread_mutex_init(&pool.lock, NULL);
+	pool.next = 1;
+	pool.last = last;
+	pool.ifos = ifos;
+	pool.failed = 0;
+
+	*numreaders = 0;
+	*readers = NULL;
+	_DVD_openworker_t *workers = NULL;
+	if (extra > 0)
+	{
+		workers = (_DVD_openworker_t*)calloc(extra, sizeof(_DVD_openworker_t));
+		*readers = (dvd_reader_t**)calloc(extra, sizeof(dvd_reader_t*));
+		if (workers == NULL || *readers == NULL)
+		{
+			// Just parse serially on the calling thread
+			free(workers);
+			free(*readers);
+			workers = NULL;
+			*readers = NULL;
+			extra = 0;
+		}
+	}
+
+	// A dvd_reader_t is not safe to share across threads, so each extra worker opens its own
+	// Work is handed out off a shared counter so a reader or thread that fails to start just means fewer workers
+	for (int i=0; i < extra; i++)
+	{
+		workers[i].pool = &pool;
+		workers[i].dvd = DVDOpen(path);
+		if (workers[i].dvd == NULL)
+		{
+			break;
+		}
+		(*readers)[(*numreaders)++] = workers[i].dvd;
+
+		workers[i].started = !pthread_create(&workers[i].thread, NULL, _DVD_openWorker, &workers[i]);
+	}
+
+	// Calling thread works too, on the main reader
+	_DVD_openworker_t self = { &pool, dvd, 0, 1 };
+	_DVD_openWorker(&self);
+
+	for (int i=0; i < *numreaders; i++)
+	{
+		if (workers[i].started)
+		{
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+
+	free(workers);
+	pthread_mutex_destroy(&pool.lock);
+
+	return pool.failed;
+}
+
+static PyObject*
+DVD_Open(DVD *self, PyObject *args, PyObject *kwds)
+{
+	int parallel = 0;
+	PyObject *cachedirobj = NULL;
+	static char *kwlist[] = {"parallel", "cachedir", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "|iO&", kwlist, &parallel, PyUnicode_FSConverter, &cachedirobj))
+	{
+		return NULL;
+	}
+	if (parallel < 0)
+	{
+		Py_XDECREF(cachedirobj);
+		PyErr_Format(PyExc_ValueError, "parallel cannot be negative (%d)", parallel);
+		return NULL;
+	}
+
+	// Bytes object is immutable and held until return, so this is safe to use without the GIL
+	const char *cachedir = cachedirobj ? PyBytes_AS_STRING(cachedirobj) : NULL;
+	pydvd_table_t key;
+	char *cachepath = NULL;
+	int haveid = 0;
+	unsigned char discid[16];
+	uint64_t volumeblocks = 0;
+
+	// Ensure not already open
+	if (_DVD_getIsOpen(self))
+	{
+		Py_XDECREF(cachedirobj);
+		PyErr_SetString(PyExc_Exception, "Device is already open, first Close() it to re-open");
+		return NULL;
+	}
+
+	// Ensure path is present
+	PyObject *pathobj = DVD_getPath(self);
+	if (pathobj == NULL)
+	{
+		Py_XDECREF(cachedirobj);
+		return NULL;
+	}
+
+
+	// Copy the path as the GIL is released below and self->path could be replaced meanwhile
+	const char *upath = PyUnicode_AsUTF8(pathobj);
+	if (upath == NULL)
+	{
+		// Not responsible for clearing char*
+		Py_DECREF(pathobj);
+		Py_XDECREF(cachedirobj);
+		return NULL;
+	}
+	char *path = strdup(upath);
+	Py_DECREF(pathobj);
+	if (path == NULL)
+	{
+		Py_XDECREF(cachedirobj);
+		return PyErr_NoMemory();
+	}
+
+	_DVD_lock(self);
+
+	// Another thread may have opened it while waiting on the lock
+	if (_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		free(path);
+		Py_XDECREF(cachedirobj);
+		PyErr_SetString(PyExc_Exception, "Device is already open, first Close() it to re-open");
+		return NULL;
+	}
+
+	dvd_reader_t *dvd = NULL;
+	ifo_handle_t *zero = NULL;
+	int found;
+	char volumeid[sizeof(self->volumeid)];
+	char volumesetid[sizeof(self->volumesetid)];
+
+	// Device I/O can take seconds on a spinning-up drive so let other threads run
+	Py_BEGIN_ALLOW_THREADS
+	struct stat s;
+	found = !stat(path, &s);
+	if (found)
+	{
+		// Open the DVD and get the root IFO
+		dvd = DVDOpen(path);
+		if (dvd)
+		{
+			zero = ifoOpen(dvd, 0);
+		}
+
+		// Read the label now while the device is already open and spun up
+		if (zero)
+		{
+			_DVD_readVolumeInfo(dvd, path, &s, volumeid, volumesetid);
+		}
+
+		// Hash of the raw IFO files identifies the disc, along with the volume size when there is a volume
+		if (zero)
+		{
+			haveid = !DVDDiscID(dvd, discid);
+		}
+		if (haveid && !S_ISDIR(s.st_mode))
+		{
+			pydvd_volume_t vol;
+			if (pydvd_volume_read(path, &vol) == 0)
+			{
+				volumeblocks = (vol.iso ? vol.blocks : vol.size / DVD_VIDEO_LB_LEN);
+			}
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!found)
+	{
+		PyErr_SetString(PyExc_ValueError, "Device/file not found");
+		goto error;
+	}
+	if (dvd == NULL)
+	{
+		PyErr_SetString(PyExc_Exception, "Could not open device");
+		goto error;
+	}
+	if (zero == NULL)
+	{
+		PyErr_SetString(PyExc_Exception, "Could not open IFO zero");
+		goto error;
+	}
+
+	// Get number of IFOs and create pointer space for the ifo_handle_t pointers
+	// Title set IFOs are opened on first use by _DVD_getIFO() unless preloaded in parallel below
+	self->numifos = zero->vts_atrt->nr_of_vtss;
+	self->ifos = (ifo_handle_t**)calloc(self->numifos+1, sizeof(ifo_handle_t*));
+	self->ifotick = (unsigned long*)calloc(self->numifos+1, sizeof(unsigned long));
+	self->titles = (pydvd_title_t*)calloc(zero->tt_srpt->nr_of_srpts+1, sizeof(pydvd_title_t));
+	self->titlesets = (_DVD_titleset_t*)calloc(self->numifos+1, sizeof(_DVD_titleset_t));
+	if (self->ifos == NULL || self->ifotick == NULL || self->titles == NULL || self->titlesets == NULL)
+	{
+		PyErr_NoMemory();
+		goto error;
+	}
+	self->ifos[0] = zero;
+	zero = NULL;
+
+	self->tick = 0;
+	self->numloaded = 1;
+	self->numevicted = 0;
+	self->numresident = 0;
+	pydvd_blockcache_resetstats(&self->blockcache);
+	_DVD_freeRescueMaps(self);
+	self->rescuefailures = 0;
+	self->rescuefilled = 0;
+
+	if (parallel > 0 && self->numifos > 0)
+	{
+		// Preload title sets, but no more than the residency cap allows
+		int last = self->numifos;
+		if (self->maxifos > 0 && self->maxifos < last)
+		{
+			last = self->maxifos;
+		}
+
+		int failed;
+		Py_BEGIN_ALLOW_THREADS
+		failed = _DVD_openParallel(path, dvd, self->ifos, last, parallel, &self->readers, &self->numreaders);
+		Py_END_ALLOW_THREADS
+
+		for (int i=1; i <= last; i++)
+		{
+			if (self->ifos[i])
+			{
+				self->ifotick[i] = ++self->tick;
+				self->numloaded++;
+				self->numresident++;
+			}
+		}
+
+		if (failed)
+		{
+			PyErr_Format(PyExc_Exception, "Could not open IFO %d", failed);
+			goto error;
+		}
+	}
+
+	self->numtitles = self->ifos[0]->tt_srpt->nr_of_srpts;
+
+	// Title sets already parsed by Open(parallel=N) may as well be flattened now
+	for (int i=1; i <= self->numifos; i++)
+	{
+		if (self->ifos[i] && _DVD_fillTitleSet(self, i, self->ifos[i]))
+		{
+			goto error;
+		}
+	}
+	memcpy(self->volumeid, volumeid, sizeof(volumeid));
+	memcpy(self->volumesetid, volumesetid, sizeof(volumesetid));
+
+	self->hasfingerprint = haveid;
+	if (haveid)
+	{
+		_DVD_fingerprint(self->ifos[0], discid, volumeblocks, self->fingerprint);
+	}
+
+	if (haveid && cachedir)
+	{
+		memset(&key, 0, sizeof(key));
+		memcpy(key.fingerprint, self->fingerprint, sizeof(key.fingerprint));
+
+		cachepath = _DVD_cachePath(cachedir, &key);
+		if (cachepath == NULL)
+		{
+			PyErr_NoMemory();
+			goto error;
+		}
+
+		int hit;
+		Py_BEGIN_ALLOW_THREADS
+		hit = !pydvd_cache_load(cachepath, &key, &self->table, &self->tablesize);
+		Py_END_ALLOW_THREADS
+
+		if (hit && self->table->numtitles == (uint32_t)self->numtitles && self->table->numifos == (uint32_t)self->numifos)
+		{
+			self->tablemapped = 1;
+			self->fromcache = 1;
+		}
+		else if (hit)
+		{
+			// Same key but a different structure, rebuild it
+			pydvd_cache_release(self->table, self->tablesize, 1);
+			self->table = NULL;
+			self->tablesize = 0;
+		}
+	}
+
+	// Setting dvd marks it as open, so do it last
+	self->dvd = dvd;
+
+	if (haveid && cachedir && !self->table)
+	{
+		// Cache miss: flatten the whole disc now and store it for next time
+		pydvd_table_t *tbl = _DVD_buildTable(self, &key);
+		if (tbl == NULL)
+		{
+			// Leave the disc open without a table, the cache is only an optimization
+			PyObject *type, *value, *tb;
+			PyErr_Fetch(&type, &value, &tb);
+			int warned = PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "Could not build metadata cache for %s: %S", path, value ? value : Py_None);
+			Py_XDECREF(type);
+			Py_XDECREF(value);
+			Py_XDECREF(tb);
+			if (warned < 0)
+			{
+				goto error;
+			}
+		}
+		else
+		{
+			int stored;
+			Py_BEGIN_ALLOW_THREADS
+			stored = !pydvd_cache_store(cachepath, tbl);
+			Py_END_ALLOW_THREADS
+
+			self->table = tbl;
+			self->tablesize = tbl->size;
+			self->tablemapped = 0;
+
+			if (!stored && PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "Could not write metadata cache %s: %s", cachepath, strerror(errno)) < 0)
+			{
+				goto error;
+			}
+		}
+	}
+
+	_DVD_unlock(self);
+	free(path);
+	free(cachepath);
+	Py_XDECREF(cachedirobj);
+
+	// return None for success
+	Py_INCREF(Py_None);
+	return Py_None;
+
+error:
+
+	// If zero was not moved into the ifos array, otherwise _DVD_closeIFOs() takes care of it
+	if (zero)
+	{
+		ifoClose(zero);
+	}
+	zero = NULL;
+
+	_DVD_freeTitleSets(self);
+	_DVD_closeIFOs(self);
+	_DVD_releaseTable(self);
+
+	// Close the dvd
+	if (dvd)
+	{
+		DVDClose(dvd);
+	}
+	self->dvd = NULL;
+
+	_DVD_unlock(self);
+	free(path);
+	free(cachepath);
+	Py_XDECREF(cachedirobj);
+
+	return NULL;
+}
+
+static PyObject*
+DVD_Close(DVD *self)
+{
+	_DVD_lock(self);
+
+	// Ensure not closed already, or never was open
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot close it");
+		return NULL;
+	}
+
+	// NB: leave path set
+
+	// Files must be closed before the reader; this does no I/O so the GIL is kept to walk the list
+	// Read-ahead threads read with the lock held, so none is mid-read; what they buffered is dropped so no stale
+	// block is served after Close(), and they are joined later as they may be waiting on the lock
+	for (Stream *stream = self->streams; stream; stream = stream->next)
+	{
+		if (stream->readahead)
+		{
+			pydvd_readahead_close(&stream->ra);
+			stream->readahead = 0;
+		}
+		if (stream->file)
+		{
+			DVDCloseFile(stream->file);
+			stream->file = NULL;
+		}
+	}
+
+	// Detach the handles while holding the lock so no getter sees them half closed
+	dvd_reader_t *dvd = self->dvd;
+	ifo_handle_t **ifos = self->ifos;
+	int numifos = self->numifos;
+	dvd_reader_t **readers = self->readers;
+	int numreaders = self->numreaders;
+
+	pydvd_table_t *table = self->table;
+	size_t tablesize = self->tablesize;
+	int tablemapped = self->tablemapped;
+
+	self->dvd = NULL;
+	self->ifos = NULL;
+	self->readers = NULL;
+	self->numreaders = 0;
+	self->table = NULL;
+	self->tablesize = 0;
+	self->tablemapped = 0;
+	self->fromcache = 0;
+	free(self->ifotick);
+	self->ifotick = NULL;
+	self->numresident = 0;
+	_DVD_freeTitleSets(self);
+
+	// Titles are of this disc, so the next one makes new ones
+	_Children_release(&self->titleobjs);
+
+	// Close ifos and the dvd
+	Py_BEGIN_ALLOW_THREADS
+	for (int i=0; i <= numifos; i++)
+	{
+		if (ifos[i])
+		{
+			ifoClose(ifos[i]);
+		}
+	}
+	free(ifos);
+
+	_DVD_closeReaders(readers, numreaders);
+	DVDClose(dvd);
+
+	pydvd_cache_release(table, tablesize, tablemapped);
+	pydvd_blockcache_empty(&self->blockcache);
+	Py_END_ALLOW_THREADS
+
+	_DVD_unlock(self);
+
+	// return None for success
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject*
+_DVD_makeTitle(PyObject *owner, int title, int *own)
+{
+	// Title @title of the DVD for its cache, see _Children_get()
+	DVD *self = (DVD*)owner;
+
+	// Get IFO number
+	if (_DVD_lockOpen(self))
+	{
+		return NULL;
+	}
+	int ifonum = self->ifos[0]->tt_srpt->title[title-1].title_set_nr;
+	_DVD_unlock(self);
+
+	PyObject *ret = _Title_create(self, ifonum, title);
+	*own = (ret && PyObject_TypeCheck(ret, self->state->TitleType) && ((Title*)ret)->dvd == self && ((Title*)ret)->titlenum == title);
+	return ret;
+}
+
+static PyObject*
+DVD_GetTitle(DVD *self, PyObject *const *args, Py_ssize_t nargs)
+{
+	// Ensure DVD is open before getting titles
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot get titles");
+		return NULL;
+	}
+
+	int title=0;
+
+	if (ParseIntArgs("GetTitle", args, nargs, 1, 1, &title))
+	{
+		return NULL;
+	}
+
+	// Bounds check
+	if (title < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Title must be non-negative (%d)", title);
+		return NULL;
+	}
+	if (title > self->numtitles)
+	{
+		PyErr_Format(PyExc_ValueError, "Title value too large (%d > %d)", title, self->numtitles);
+		return NULL;
+	}
+
+	return _Children_get(self, &self->titleobjs, self->numtitles, (PyObject*)self, title, _DVD_makeTitle);
+}
+
+static Py_ssize_t
+DVD_length(DVD *self)
+{
+	// len(dvd) is the number of titles, none while closed
+	if (!_DVD_getIsOpen(self))
+	{
+		return 0;
+	}
+
+	return self->numtitles;
+}
+
+static PyObject*
+DVD_item(DVD *self, Py_ssize_t i)
+{
+	// dvd[i] is title i+1
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot get titles");
+		return NULL;
+	}
+	if (i < 0 || i >= self->numtitles)
+	{
+		PyErr_SetString(PyExc_IndexError, "title index out of range");
+		return NULL;
+	}
+
+	return _Children_get(self, &self->titleobjs, self->numtitles, (PyObject*)self, (int)i+1, _DVD_makeTitle);
+}
+
+static PyObject*
+DVD_getTitles(DVD *self)
+{
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot get titles");
+		return NULL;
+	}
+
+	return _Children_view(self, &self->titleobjs, self->numtitles, (PyObject*)self, _DVD_makeTitle);
+}
+
+static PyObject*
+DVD_subscript(DVD *self, PyObject *key)
+{
+	return _Children_subscript((PyObject*)self, key, (lenfunc)DVD_length, (ssizeargfunc)DVD_item, (PyObject *(*)(PyObject*))DVD_getTitles);
+}
+
+static PyObject*
+DVD_iter(DVD *self)
+{
+	return _Children_iter((PyObject *(*)(PyObject*))DVD_getTitles, (PyObject*)self);
+}
+
+static PyObject*
+DVD_Detach(DVD *self)
+{
+	// Detaches every title so the disc can be closed (and ejected) while they are still in use
+	PyObject *titles = DVD_getTitles(self);
+	if (titles == NULL)
+	{
+		return NULL;
+	}
+
+	// Through the method so a TitleClass can extend it
+	for (Py_ssize_t i=0; i < PyTuple_GET_SIZE(titles); i++)
+	{
+		PyObject *ret = PyObject_CallMethod(PyTuple_GET_ITEM(titles, i), "Detach", NULL);
+		if (ret == NULL)
+		{
+			Py_DECREF(titles);
+			return NULL;
+		}
+		Py_DECREF(ret);
+	}
+
+	return titles;
+}
+
+static PyObject*
+DVD_OpenFile(DVD *self, PyObject *args, PyObject *kwds)
+{
+	int vts = 0;
+	int domain = DVD_READ_TITLE_VOBS;
+	int ringblocks = 512;
+	int readahead = 0;
+	static char *kwlist[] = {"vts", "domain", "ringblocks", "readahead", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "i|iip", kwlist, &vts, &domain, &ringblocks, &readahead))
+	{
+		return NULL;
+	}
+
+	if (!_DVD_getIsOpen(self))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot open file");
+		return NULL;
+	}
+	if (vts < 0 || vts > self->numifos)
+	{
+		PyErr_Format(PyExc_ValueError, "VTS out of range (%d not in 0 to %d)", vts, self->numifos);
+		return NULL;
+	}
+	if (domain < DVD_READ_INFO_FILE || domain > DVD_READ_TITLE_VOBS)
+	{
+		PyErr_Format(PyExc_ValueError, "Unknown domain (%d)", domain);
+		return NULL;
+	}
+
+	return _Stream_open(self, vts, (dvd_read_domain_t)domain, NULL, 0, ringblocks, readahead);
+}
+
+static pydvd_rescue_map_t*
+_DVD_getRescueMap(DVD *self, PyObject *args, PyObject *kwds, int withpath, PyObject **path)
+{
+	// Parses ([path,] vts, domain=READ_TITLE_VOBS) and returns the file's rescue map with the lock held
+	// On failure returns NULL with an exception set and the lock released
+	int vts = 0;
+	int domain = DVD_READ_TITLE_VOBS;
+	static char *kwlist[] = {"vts", "domain", NULL};
+	static char *pathkwlist[] = {"path", "vts", "domain", NULL};
+
+	if (withpath)
+	{
+		if (! PyArg_ParseTupleAndKeywords(args, kwds, "O&i|i", pathkwlist, PyUnicode_FSConverter, path, &vts, &domain))
+		{
+			return NULL;
+		}
+	}
+	else if (! PyArg_ParseTupleAndKeywords(args, kwds, "i|i", kwlist, &vts, &domain))
+	{
+		return NULL;
+	}
+
+	if (vts < 0 || vts > 99 || domain < DVD_READ_INFO_FILE || domain > DVD_READ_TITLE_VOBS)
+	{
+		PyErr_Format(PyExc_ValueError, "No such file (VTS %d domain %d)", vts, domain);
+		return NULL;
+	}
+
+	_DVD_lock(self);
+
+	uint32_t key = PYDVD_BLOCKCACHE_KEY(vts, domain);
+	for (int i=0; i < self->numrescuemaps; i++)
+	{
+		if (self->rescuemaps[i]->key == key)
+		{
+			return self->rescuemaps[i];
+		}
+	}
+
+	// None yet, the file's size is needed for one
+	if (!_DVD_getIsOpen(self) || vts > self->numifos)
+	{
+		_DVD_unlock(self);
+		PyErr_Format(PyExc_Exception, "No rescue map for VTS %d domain %d and the device is not open or has no such file", vts, domain);
+		return NULL;
+	}
+
+	ssize_t size = -1;
+	dvd_reader_t *reader = self->dvd;
+	pydvd_rescue_map_t *map = NULL;
+	Py_BEGIN_ALLOW_THREADS
+	dvd_file_t *file = DVDOpenFile(reader, vts, (dvd_read_domain_t)domain);
+	if (file)
+	{
+		size = DVDFileSize(file);
+		DVDCloseFile(file);
+	}
+	if (size >= 0)
+	{
+		map = _DVD_rescueMap(self, key, (uint32_t)size);
+	}
+	Py_END_ALLOW_THREADS
+
+	if (size < 0)
+	{
+		_DVD_unlock(self);
+		PyErr_Format(PyExc_Exception, "Could not open file for VTS %d domain %d", vts, domain);
+		return NULL;
+	}
+	if (map == NULL)
+	{
+		_DVD_unlock(self);
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	return map;
+}
+
+static PyObject*
+_RescueMap_runs(const pydvd_rescue_map_t *map)
+{
+	// Tuple of (first, blocks, status) runs
+	PyObject *ret = PyTuple_New(map->numruns);
+	if (ret)
+	{
+		for (int i=0; i < map->numruns; i++)
+		{
+			PyObject *r = Py_BuildValue("(IIC)", map->runs[i].first, map->runs[i].blocks, (int)map->runs[i].status);
+			if (r == NULL)
+			{
+				Py_CLEAR(ret);
+				break;
+			}
+			PyTuple_SET_ITEM(ret, i, r);
+		}
+	}
+	return ret;
+}
+
+static PyObject*
+DVD_RescueMap(DVD *self, PyObject *args, PyObject *kwds)
+{
+	pydvd_rescue_map_t *map = _DVD_getRescueMap(self, args, kwds, 0, NULL);
+	if (map == NULL)
+	{
+		return NULL;
+	}
+
+	PyObject *ret = _RescueMap_runs(map);
+
+	_DVD_unlock(self);
+	return ret;
+}
+
+static PyObject*
+DVD_WriteRescueMap(DVD *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *path = NULL;
+	pydvd_rescue_map_t *map = _DVD_getRescueMap(self, args, kwds, 1, &path);
+	if (map == NULL)
+	{
+		Py_XDECREF(path);
+		return NULL;
+	}
+
+	int ret;
+	Py_BEGIN_ALLOW_THREADS
+	ret = pydvd_rescue_write(map, PyBytes_AS_STRING(path));
+	Py_END_ALLOW_THREADS
+
+	_DVD_unlock(self);
+
+	if (ret)
+	{
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, PyBytes_AS_STRING(path));
+		Py_DECREF(path);
+		return NULL;
+	}
+	Py_DECREF(path);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject*
+DVD_ReadRescueMap(DVD *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *path = NULL;
+	pydvd_rescue_map_t *map = _DVD_getRescueMap(self, args, kwds, 1, &path);
+	if (map == NULL)
+	{
+		Py_XDECREF(path);
+		return NULL;
+	}
+
+	int ret;
+	Py_BEGIN_ALLOW_THREADS
+	ret = pydvd_rescue_read(map, PyBytes_AS_STRING(path));
+	Py_END_ALLOW_THREADS
+
+	_DVD_unlock(self);
+
+	if (ret)
+	{
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, PyBytes_AS_STRING(path));
+		Py_DECREF(path);
+		return NULL;
+	}
+	Py_DECREF(path);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Snapshot of the whole disc
+
+static PyStructSequence_Field DiscSnapshot_fields[] = {
+	{"Path", "Path of the DVD device"},
+	{"VolumeID", "Volume label read at Open()"},
+	{"VMGID", "VMG ID"},
+	{"ProviderID", "Provider ID"},
+	{"Fingerprint", "Fingerprint computed by Open(), or None"},
+	{"Titles", "Tuple of TitleSnapshot"},
+	{NULL}
+};
+
+static PyStructSequence_Desc DiscSnapshot_desc = {
+	"_dvdread.DiscSnapshot",
+	"Everything DVD.Snapshot() reads about a disc",
+	DiscSnapshot_fields,
+	6
+};
+
+static PyStructSequence_Field TitleSnapshot_fields[] = {
+	{"TitleNum", "Title number"},
+	{"PlaybackTime", "Playback time in milliseconds"},
+	{"PlaybackTimeFancy", "Playback time in HH:MM:SS.FF string format"},
+	{"AspectRatio", "Aspect ratio, \"4:3\" or \"16:9\""},
+	{"FrameRate", "Frame rate, \"25.00\", \"29.97\" or \"?\""},
+	{"Width", "Picture width in pixels"},
+	{"Height", "Picture height in pixels"},
+	{"NumberOfAngles", "Number of angles"},
+	{"Audios", "Tuple of AudioSnapshot"},
+	{"Chapters", "Tuple of ChapterSnapshot"},
+	{"Subpictures", "Tuple of SubpictureSnapshot"},
+	{NULL}
+};
+
+static PyStructSequence_Desc TitleSnapshot_desc = {
+	"_dvdread.TitleSnapshot",
+	"A title as read by DVD.Snapshot(), fields match the Title getters",
+	TitleSnapshot_fields,
+	11
+};
+
+static PyStructSequence_Field AudioSnapshot_fields[] = {
+	{"AudioNum", "Audio stream number"},
+	{"LangCode", "Two letter language code, or None"},
+	{"Language", "Language name"},
+	{"Format", "Audio format"},
+	{"SamplingRate", "Sampling rate"},
+	{NULL}
+};
+
+static PyStructSequence_Desc AudioSnapshot_desc = {
+	"_dvdread.AudioSnapshot",
+	"An audio stream as read by DVD.Snapshot(), fields match the Audio getters",
+	AudioSnapshot_fields,
+	5
+};
+
+static PyStructSequence_Field ChapterSnapshot_fields[] = {
+	{"ChapterNum", "Chapter number"},
+	{"StartCell", "First cell of the chapter"},
+	{"EndCell", "Last cell of the chapter"},
+	{"Length", "Length in milliseconds"},
+	{"LengthFancy", "Length in HH:MM:SS.FF string format"},
+	{NULL}
+};
+
+static PyStructSequence_Desc ChapterSnapshot_desc = {
+	"_dvdread.ChapterSnapshot",
+	"A chapter as read by DVD.Snapshot(), fields match the Chapter getters",
+	ChapterSnapshot_fields,
+	5
+};
+
+static PyStructSequence_Field SubpictureSnapshot_fields[] = {
+	{"SubpictureNum", "Subpicture stream number"},
+	{"LangCode", "Two letter language code, or None"},
+	{"Language", "Language name"},
+	{NULL}
+};
+
+static PyStructSequence_Desc SubpictureSnapshot_desc = {
+	"_dvdread.SubpictureSnapshot",
+	"A subpicture stream as read by DVD.Snapshot(), fields match the Subpicture getters",
+	SubpictureSnapshot_fields,
+	3
+};
+
+static PyObject*
+_Snapshot_new(PyTypeObject *type, PyObject **vals, int n)
+{
+	// Structseq of @type holding the @n references in @vals, which are released on failure (any may be NULL)
+	PyObject *ret = NULL;
+	for (int i=0; i < n; i++)
+	{
+		if (vals[i] == NULL)
+		{
+			goto fail;
+		}
+	}
+
+	ret = PyStructSequence_New(type);
+	if (ret == NULL)
+	{
+		goto fail;
+	}
+	for (int i=0; i < n; i++)
+	{
+		PyStructSequence_SET_ITEM(ret, i, vals[i]);
+	}
+	return ret;
+
+fail:
+	for (int i=0; i < n; i++)
+	{
+		Py_XDECREF(vals[i]);
+	}
+	return NULL;
+}
+
+static PyObject*
+_Snapshot_title(ModuleState_t *st, int titlenum, const _DVD_titlerecs_t *recs)
+{
+	const pydvd_title_t *t = recs->title;
+
+	int aspect = AspectRatioId(t->aspectratio);
+	int width = PictureWidth(t->picturesize);
+	int height = PictureHeight(t->videoformat);
+	if (aspect < 0 || width == 0 || height == 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Invalid picture size value (title %d)", titlenum);
+		return NULL;
+	}
+
+	PyObject *audios = PyTuple_New(t->numaudios);
+	PyObject *chapters = PyTuple_New(t->numchapters);
+	PyObject *subpictures = PyTuple_New(t->numsubpictures);
+	if (audios == NULL || chapters == NULL || subpictures == NULL)
+	{
+		goto fail;
+	}
+
+	for (int i=0; i < t->numaudios; i++)
+	{
+		const pydvd_audio_t *a = &recs->audios[i];
+		PyObject *vals[5];
+		vals[0] = PyLong_FromLong(i+1);
+		vals[1] = LangCodeToCode(st, a->lang_code);
+		vals[2] = LangCodeToName(st, a->lang_code);
+		vals[3] = SharedStr(st, AudioFormatId(a->format));
+		vals[4] = SharedStr(st, STR_48000);
+
+		PyObject *o = _Snapshot_new(st->AudioSnapshotType, vals, 5);
+		if (o == NULL)
+		{
+			goto fail;
+		}
+		PyTuple_SET_ITEM(audios, i, o);
+	}
+
+	for (int i=0; i < t->numchapters; i++)
+	{
+		const pydvd_chapter_t *c = &recs->chapters[i];
+		PyObject *vals[5];
+		vals[0] = PyLong_FromLong(i+1);
+		vals[1] = PyLong_FromLong(c->startcell);
+		vals[2] = PyLong_FromLong(c->endcell);
+		vals[3] = PyLong_FromLong(c->lenms);
+		vals[4] = dvdtimetofancy(c->lenms, c->framerate);
+
+		PyObject *o = _Snapshot_new(st->ChapterSnapshotType, vals, 5);
+		if (o == NULL)
+		{
+			goto fail;
+		}
+		PyTuple_SET_ITEM(chapters, i, o);
+	}
+
+	for (int i=0; i < t->numsubpictures; i++)
+	{
+		const pydvd_subpicture_t *s = &recs->subpictures[i];
+		PyObject *vals[3];
+		vals[0] = PyLong_FromLong(i+1);
+		vals[1] = LangCodeToCode(st, s->lang_code);
+		vals[2] = LangCodeToName(st, s->lang_code);
+
+		PyObject *o = _Snapshot_new(st->SubpictureSnapshotType, vals, 3);
+		if (o == NULL)
+		{
+			goto fail;
+		}
+		PyTuple_SET_ITEM(subpictures, i, o);
+	}
+
+	PyObject *vals[11];
+	vals[0] = PyLong_FromLong(titlenum);
+	vals[1] = PyLong_FromLong(t->playbackms);
+	vals[2] = dvdtimetofancy(t->playbackms, t->framerate);
+	vals[3] = SharedStr(st, aspect);
+	vals[4] = SharedStr(st, FrameRateId(t->framerate));
+	vals[5] = PyLong_FromLong(width);
+	vals[6] = PyLong_FromLong(height);
+	vals[7] = PyLong_FromLong(t->numangles);
+	vals[8] = audios;
+	vals[9] = chapters;
+	vals[10] = subpictures;
+	return _Snapshot_new(st->TitleSnapshotType, vals, 11);
+
+fail:
+	Py_XDECREF(audios);
+	Py_XDECREF(chapters);
+	Py_XDECREF(subpictures);
+	return NULL;
+}
+
+static PyObject*
+DVD_Snapshot(DVD *self)
+{
+	// Whole disc in one call straight from the title records, no Title, Audio, Chapter or Subpicture objects
+	// The lock is held throughout so everything comes from the same opening of the disc
+	_DVD_lock(self);
+	if (!_DVD_getIsOpen(self))
+	{
+		_DVD_unlock(self);
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot take a snapshot");
+		return NULL;
+	}
+
+	PyObject *titles = PyTuple_New(self->numtitles);
+	if (titles == NULL)
+	{
+		_DVD_unlock(self);
+		return NULL;
+	}
+
+	_DVD_titlerecs_t recs;
+	for (int t=1; t <= self->numtitles; t++)
+	{
+		PyObject *title = NULL;
+		if (_DVD_getTitleRecord(self, t, &recs) == 0)
+		{
+			title = _Snapshot_title(self->state, t, &recs);
+		}
+		if (title == NULL)
+		{
+			_DVD_unlock(self);
+			Py_DECREF(titles);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(titles, t-1, title);
+	}
+
+	PyObject *vals[6];
+	vals[0] = DVD_getPath(self);
+	vals[1] = DVD_getVolumeID(self);
+	vals[2] = DVD_GetVMGID(self);
+	vals[3] = DVD_GetProviderID(self);
+	vals[4] = DVD_GetFingerprint(self);
+	vals[5] = titles;
+	_DVD_unlock(self);
+
+	return _Snapshot_new(self->state->DiscSnapshotType, vals, 6);
+}
+
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Writing the disc as XML or JSON
+
+// Output is handed to the file in chunks of this many bytes
+#define _DVD_WRITE_CHUNK (64*1024)
+
+// Where WriteXML() and WriteJSON() flush to
+typedef struct {
+	int fd;                   // -1 to call @write instead
+	PyObject *write;          // Bound write() of a file-like object
+	int text;                 // @write takes str rather than bytes
+} _DVD_output_t;
+
+static int
+_DVD_flushOutput(void *arg, const char *buf, size_t len)
+{
+	// Writer flush function, called with the GIL held; returns non-zero with an exception set on failure
+	_DVD_output_t *out = (_DVD_output_t*)arg;
+
+	if (out->fd >= 0)
+	{
+		ssize_t w = 0;
+		int err = 0;
+		Py_BEGIN_ALLOW_THREADS
+		while (len)
+		{
+			w = write(out->fd, buf, len);
+			if (w < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				err = errno;
+				break;
+			}
+			buf += w;
+			len -= (size_t)w;
+		}
+		Py_END_ALLOW_THREADS
+
+		if (err)
+		{
+			errno = err;
+			PyErr_SetFromErrno(PyExc_OSError);
+			return -1;
+		}
+		return 0;
+	}
+
+	// Chunks end between characters as the writer only flushes after whole strings
+	PyObject *data;
+	if (out->text)
+	{
+		data = PyUnicode_DecodeUTF8(buf, len, "replace");
+	}
+	else
+	{
+		data = PyBytes_FromStringAndSize(buf, len);
+	}
+	if (data == NULL)
+	{
+		return -1;
+	}
+
+	PyObject *ret = PyObject_CallFunctionObjArgs(out->write, data, NULL);
+	Py_DECREF(data);
+	if (ret == NULL)
+	{
+		return -1;
+	}
+	Py_DECREF(ret);
+	return 0;
+}
+
+static void
+_DVD_writeIndent(pydvd_writer_t *w, int pretty, int depth)
+{
+	// Starts a line @depth tabs in when pretty printing
+	static const char tabs[] = "\t\t\t\t\t\t\t\t";
+	if (pretty)
+	{
+		pydvd_writer_put(w, "\n", 1);
+		pydvd_writer_put(w, tabs, depth);
+	}
+}
+
+static void
+_DVD_writeTitleXML(pydvd_writer_t *w, int pretty, int titlenum, const _DVD_titlerecs_t *recs)
+{
+	const pydvd_title_t *t = recs->title;
+	char fancy[64];
+	char code[4];
+
+	_DVD_writeIndent(w, pretty, 2);
+	pydvd_writer_printf(w, "<title idx=\"%d\">", titlenum);
+
+	dvdtimetofancystr(t->playbackms, t->framerate, fancy, sizeof(fancy));
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<length fancy=\"%s\">%u</length>", fancy, t->playbackms);
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<picture aspectratio=\"%s\" framerate=\"%s\" width=\"%d\" height=\"%d\" />", AspectRatioStr(t->aspectratio), FrameRateStr(t->framerate), PictureWidth(t->picturesize), PictureHeight(t->videoformat));
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<angle num=\"%d\" />", t->numangles);
+
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<audios num=\"%d\"%s>", t->numaudios, (t->numaudios ? "" : " /"));
+	for (int i=0; i < t->numaudios; i++)
+	{
+		const pydvd_audio_t *a = &recs->audios[i];
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_printf(w, "<audio idx=\"%d\"", i+1);
+		int codelen = LangCodeToUTF8(a->lang_code, code);
+		if (codelen >= 0)
+		{
+			pydvd_writer_puts(w, " langcode=\"");
+			pydvd_writer_xmln(w, code, codelen);
+			pydvd_writer_puts(w, "\"");
+		}
+		pydvd_writer_printf(w, " language=\"%s\" format=\"%s\" samplingrate=\"48000\" />", LangCodeToNameStr(a->lang_code), AudioFormatStr(a->format));
+	}
+	if (t->numaudios)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+		pydvd_writer_puts(w, "</audios>");
+	}
+
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<chapters num=\"%d\"%s>", t->numchapters, (t->numchapters ? "" : " /"));
+	for (int i=0; i < t->numchapters; i++)
+	{
+		const pydvd_chapter_t *c = &recs->chapters[i];
+		dvdtimetofancystr(c->lenms, c->framerate, fancy, sizeof(fancy));
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_printf(w, "<chapter idx=\"%d\">", i+1);
+		_DVD_writeIndent(w, pretty, 5);
+		pydvd_writer_printf(w, "<length fancy=\"%s\">%u</length>", fancy, c->lenms);
+		_DVD_writeIndent(w, pretty, 5);
+		pydvd_writer_printf(w, "<cells start=\"%d\" end=\"%d\" />", c->startcell, c->endcell);
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_puts(w, "</chapter>");
+	}
+	if (t->numchapters)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+		pydvd_writer_puts(w, "</chapters>");
+	}
+
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_printf(w, "<subpictures num=\"%d\"%s>", t->numsubpictures, (t->numsubpictures ? "" : " /"));
+	for (int i=0; i < t->numsubpictures; i++)
+	{
+		const pydvd_subpicture_t *s = &recs->subpictures[i];
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_printf(w, "<subpicture idx=\"%d\"", i+1);
+		int codelen = LangCodeToUTF8(s->lang_code, code);
+		if (codelen >= 0)
+		{
+			pydvd_writer_puts(w, " langcode=\"");
+			pydvd_writer_xmln(w, code, codelen);
+			pydvd_writer_puts(w, "\"");
+		}
+		pydvd_writer_printf(w, " language=\"%s\" />", LangCodeToNameStr(s->lang_code));
+	}
+	if (t->numsubpictures)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+		pydvd_writer_puts(w, "</subpictures>");
+	}
+
+	_DVD_writeIndent(w, pretty, 2);
+	pydvd_writer_puts(w, "</title>");
+}
+
+static void
+_DVD_writeKeyJSON(pydvd_writer_t *w, int pretty, int depth, int first, const char *key)
+{
+	// Separator before the next member (or element if @key is NULL) of an object or array
+	if (!first)
+	{
+		pydvd_writer_put(w, ",", 1);
+	}
+	_DVD_writeIndent(w, pretty, depth);
+	if (key)
+	{
+		pydvd_writer_printf(w, "\"%s\":%s", key, (pretty ? " " : ""));
+	}
+}
+
+static void
+_DVD_writeTitleJSON(pydvd_writer_t *w, int pretty, int titlenum, const _DVD_titlerecs_t *recs)
+{
+	const pydvd_title_t *t = recs->title;
+	char fancy[64];
+	char code[4];
+
+	pydvd_writer_put(w, "{", 1);
+	_DVD_writeKeyJSON(w, pretty, 3, 1, "idx");
+	pydvd_writer_printf(w, "%d", titlenum);
+
+	dvdtimetofancystr(t->playbackms, t->framerate, fancy, sizeof(fancy));
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "length");
+	pydvd_writer_printf(w, "%u", t->playbackms);
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "length_fancy");
+	pydvd_writer_json(w, fancy);
+
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "picture");
+	pydvd_writer_put(w, "{", 1);
+	_DVD_writeKeyJSON(w, pretty, 4, 1, "aspectratio");
+	pydvd_writer_json(w, AspectRatioStr(t->aspectratio));
+	_DVD_writeKeyJSON(w, pretty, 4, 0, "framerate");
+	pydvd_writer_json(w, FrameRateStr(t->framerate));
+	_DVD_writeKeyJSON(w, pretty, 4, 0, "width");
+	pydvd_writer_printf(w, "%d", PictureWidth(t->picturesize));
+	_DVD_writeKeyJSON(w, pretty, 4, 0, "height");
+	pydvd_writer_printf(w, "%d", PictureHeight(t->videoformat));
+	_DVD_writeIndent(w, pretty, 3);
+	pydvd_writer_put(w, "}", 1);
+
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "angles");
+	pydvd_writer_printf(w, "%d", t->numangles);
+
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "audios");
+	pydvd_writer_put(w, "[", 1);
+	for (int i=0; i < t->numaudios; i++)
+	{
+		const pydvd_audio_t *a = &recs->audios[i];
+		_DVD_writeKeyJSON(w, pretty, 4, i == 0, NULL);
+		pydvd_writer_put(w, "{", 1);
+		_DVD_writeKeyJSON(w, pretty, 5, 1, "idx");
+		pydvd_writer_printf(w, "%d", i+1);
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "langcode");
+		int codelen = LangCodeToUTF8(a->lang_code, code);
+		if (codelen >= 0)
+		{
+			pydvd_writer_jsonn(w, code, codelen);
+		}
+		else
+		{
+			pydvd_writer_puts(w, "null");
+		}
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "language");
+		pydvd_writer_json(w, LangCodeToNameStr(a->lang_code));
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "format");
+		pydvd_writer_json(w, AudioFormatStr(a->format));
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "samplingrate");
+		pydvd_writer_json(w, "48000");
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_put(w, "}", 1);
+	}
+	if (t->numaudios)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+	}
+	pydvd_writer_put(w, "]", 1);
+
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "chapters");
+	pydvd_writer_put(w, "[", 1);
+	for (int i=0; i < t->numchapters; i++)
+	{
+		const pydvd_chapter_t *c = &recs->chapters[i];
+		dvdtimetofancystr(c->lenms, c->framerate, fancy, sizeof(fancy));
+		_DVD_writeKeyJSON(w, pretty, 4, i == 0, NULL);
+		pydvd_writer_put(w, "{", 1);
+		_DVD_writeKeyJSON(w, pretty, 5, 1, "idx");
+		pydvd_writer_printf(w, "%d", i+1);
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "length");
+		pydvd_writer_printf(w, "%u", c->lenms);
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "length_fancy");
+		pydvd_writer_json(w, fancy);
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "cells");
+		pydvd_writer_put(w, "{", 1);
+		_DVD_writeKeyJSON(w, pretty, 6, 1, "start");
+		pydvd_writer_printf(w, "%d", c->startcell);
+		_DVD_writeKeyJSON(w, pretty, 6, 0, "end");
+		pydvd_writer_printf(w, "%d", c->endcell);
+		_DVD_writeIndent(w, pretty, 5);
+		pydvd_writer_put(w, "}", 1);
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_put(w, "}", 1);
+	}
+	if (t->numchapters)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+	}
+	pydvd_writer_put(w, "]", 1);
+
+	_DVD_writeKeyJSON(w, pretty, 3, 0, "subpictures");
+	pydvd_writer_put(w, "[", 1);
+	for (int i=0; i < t->numsubpictures; i++)
+	{
+		const pydvd_subpicture_t *s = &recs->subpictures[i];
+		_DVD_writeKeyJSON(w, pretty, 4, i == 0, NULL);
+		pydvd_writer_put(w, "{", 1);
+		_DVD_writeKeyJSON(w, pretty, 5, 1, "idx");
+		pydvd_writer_printf(w, "%d", i+1);
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "langcode");
+		int codelen = LangCodeToUTF8(s->lang_code, code);
+		if (codelen >= 0)
+		{
+			pydvd_writer_jsonn(w, code, codelen);
+		}
+		else
+		{
+			pydvd_writer_puts(w, "null");
+		}
+		_DVD_writeKeyJSON(w, pretty, 5, 0, "language");
+		pydvd_writer_json(w, LangCodeToNameStr(s->lang_code));
+		_DVD_writeIndent(w, pretty, 4);
+		pydvd_writer_put(w, "}", 1);
+	}
+	if (t->numsubpictures)
+	{
+		_DVD_writeIndent(w, pretty, 3);
+	}
+	pydvd_writer_put(w, "]", 1);
+
+	_DVD_writeIndent(w, pretty, 2);
+	pydvd_writer_put(w, "}", 1);
+}
+
+static PyObject*
+_DVD_nameTitleCase(PyObject *name)
+{
+	// Same as objects.DVD.GetNameTitleCase(): underscores to spaces and each word capitalized
+	PyObject *ret = NULL;
+	PyObject *space = PyUnicode_FromString(" ");
+	PyObject *spaced = NULL;
+	PyObject *words = NULL;
+
+	if (space == NULL)
+	{
+		return NULL;
+	}
+	spaced = PyObject_CallMethod(name, "replace", "ss", "_", " ");
+	if (spaced)
+	{
+		words = PyUnicode_Split(spaced, space, -1);
+	}
+	if (words)
+	{
+		Py_ssize_t n = PyList_GET_SIZE(words);
+		Py_ssize_t i;
+		for (i=0; i < n; i++)
+		{
+			PyObject *word = PyObject_CallMethod(PyList_GET_ITEM(words, i), "capitalize", NULL);
+			if (word == NULL)
+			{
+				break;
+			}
+			PyList_SetItem(words, i, word);
+		}
+		if (i == n)
+		{
+			ret = PyUnicode_Join(space, words);
+		}
+	}
+
+	Py_XDECREF(words);
+	Py_XDECREF(spaced);
+	Py_DECREF(space);
+	return ret;
+}
+
+static PyObject*
+_DVD_write(DVD *self, PyObject *args, PyObject *kwds, int json)
+{
+	// Body of WriteXML() and WriteJSON()
+	PyObject *fileobj = NULL;
+	int pretty = 1;
+	static char *kwlist[] = {"fileobj", "pretty", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &fileobj, &pretty))
+	{
+		return NULL;
+	}
+
+	_DVD_output_t out;
+	out.fd = -1;
+	out.write = NULL;
+	out.text = 0;
+	if (PyLong_Check(fileobj))
+	{
+		long fd = PyLong_AsLong(fileobj);
+		if (fd < 0 || fd > INT_MAX)
+		{
+			if (!PyErr_Occurred())
+			{
+				PyErr_Format(PyExc_ValueError, "Invalid file descriptor (%ld)", fd);
+			}
+			return NULL;
+		}
+		out.fd = (int)fd;
+	}
+	else
+	{
+		out.write = PyObject_GetAttrString(fileobj, "write");
+		if (out.write == NULL)
+		{
+			PyErr_Clear();
+			PyErr_SetString(PyExc_TypeError, "fileobj must be a file descriptor or have a write() method");
+			return NULL;
+		}
+
+		// Text files have an encoding, binary ones don't
+		out.text = PyObject_HasAttrString(fileobj, "encoding");
+	}
+
+	if (!_DVD_getIsOpen(self))
+	{
+		Py_XDECREF(out.write);
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot write it out");
+		return NULL;
+	}
+
+	// Strings of the disc as UTF-8, made once; everything else comes straight from the title records
+	PyObject *strs[5];
+	strs[0] = DVD_getPath(self);
+	strs[1] = DVD_getVolumeID(self);
+	strs[2] = (strs[1] ? _DVD_nameTitleCase(strs[1]) : NULL);
+	strs[3] = DVD_GetVMGID(self);
+	strs[4] = DVD_GetProviderID(self);
+	int ok = 1;
+	for (int i=0; i < 5; i++)
+	{
+		if (strs[i] && PyUnicode_Check(strs[i]))
+		{
+			PyObject *tmp = strs[i];
+			strs[i] = PyUnicode_AsEncodedString(tmp, "utf-8", "replace");
+			Py_DECREF(tmp);
+		}
+		if (strs[i] == NULL || !PyBytes_Check(strs[i]))
+		{
+			ok = 0;
+		}
+	}
+	if (!ok)
+	{
+		if (!PyErr_Occurred())
+		{
+			PyErr_SetString(PyExc_TypeError, "Path must be a string");
+		}
+		goto done;
+	}
+
+	// Keep Close() on another thread from freeing the records while writing
+	_DVD_lock(self);
+
+	// Every title checked before anything is written, which also fills their title sets
+	_DVD_titlerecs_t recs;
+	for (int t=1; t <= self->numtitles && ok; t++)
+	{
+		if (!_DVD_getIsOpen(self))
+		{
+			PyErr_SetString(PyExc_Exception, "Device not open, cannot write it out");
+			ok = 0;
+		}
+		else if (_DVD_getTitleRecord(self, t, &recs))
+		{
+			ok = 0;
+		}
+		else if (AspectRatioStr(recs.title->aspectratio) == NULL || PictureWidth(recs.title->picturesize) == 0 || PictureHeight(recs.title->videoformat) == 0)
+		{
+			PyErr_Format(PyExc_ValueError, "Invalid picture size value (title %d)", t);
+			ok = 0;
+		}
+	}
+	if (!ok)
+	{
+		_DVD_unlock(self);
+		goto done;
+	}
+
+	pydvd_writer_t w;
+	pydvd_writer_init(&w, _DVD_WRITE_CHUNK, _DVD_flushOutput, &out);
+
+	if (json)
+	{
+		static const char *keys[5] = {"device", "name", "name_fancy", "vmg_id", "provider_id"};
+		pydvd_writer_put(&w, "{", 1);
+		_DVD_writeKeyJSON(&w, pretty, 1, 1, "numtitles");
+		pydvd_writer_printf(&w, "%d", self->numtitles);
+		_DVD_writeKeyJSON(&w, pretty, 1, 0, "parser");
+		pydvd_writer_printf(&w, "\"pydvdread %d.%d\"", MAJOR_VERSION, MINOR_VERSION);
+		for (int i=0; i < 5; i++)
+		{
+			_DVD_writeKeyJSON(&w, pretty, 1, 0, keys[i]);
+			pydvd_writer_json(&w, PyBytes_AS_STRING(strs[i]));
+		}
+		_DVD_writeKeyJSON(&w, pretty, 1, 0, "titles");
+		pydvd_writer_put(&w, "[", 1);
+		for (int t=1; t <= self->numtitles && !w.failed; t++)
+		{
+			_DVD_getTitleRecord(self, t, &recs);
+			_DVD_writeKeyJSON(&w, pretty, 2, t == 1, NULL);
+			_DVD_writeTitleJSON(&w, pretty, t, &recs);
+		}
+		if (self->numtitles)
+		{
+			_DVD_writeIndent(&w, pretty, 1);
+		}
+		pydvd_writer_put(&w, "]", 1);
+		_DVD_writeIndent(&w, pretty, 0);
+		pydvd_writer_put(&w, "}", 1);
+	}
+	else
+	{
+		pydvd_writer_printf(&w, "<dvd numtitles=\"%d\" parser=\"pydvdread %d.%d\">", self->numtitles, MAJOR_VERSION, MINOR_VERSION);
+		_DVD_writeIndent(&w, pretty, 1);
+		pydvd_writer_puts(&w, "<device>");
+		pydvd_writer_xml(&w, PyBytes_AS_STRING(strs[0]));
+		pydvd_writer_puts(&w, "</device>");
+		_DVD_writeIndent(&w, pretty, 1);
+		pydvd_writer_puts(&w, "<name fancy=\"");
+		pydvd_writer_xml(&w, PyBytes_AS_STRING(strs[2]));
+		pydvd_writer_puts(&w, "\">");
+		pydvd_writer_xml(&w, PyBytes_AS_STRING(strs[1]));
+		pydvd_writer_puts(&w, "</name>");
+		_DVD_writeIndent(&w, pretty, 1);
+		pydvd_writer_puts(&w, "<vmg_id>");
+		pydvd_writer_xml(&w, PyBytes_AS_STRING(strs[3]));
+		pydvd_writer_puts(&w, "</vmg_id>");
+		_DVD_writeIndent(&w, pretty, 1);
+		pydvd_writer_puts(&w, "<provider_id>");
+		pydvd_writer_xml(&w, PyBytes_AS_STRING(strs[4]));
+		pydvd_writer_puts(&w, "</provider_id>");
+		_DVD_writeIndent(&w, pretty, 1);
+		pydvd_writer_puts(&w, (self->numtitles ? "<titles>" : "<titles />"));
+		for (int t=1; t <= self->numtitles && !w.failed; t++)
+		{
+			_DVD_getTitleRecord(self, t, &recs);
+			_DVD_writeTitleXML(&w, pretty, t, &recs);
+		}
+		if (self->numtitles)
+		{
+			_DVD_writeIndent(&w, pretty, 1);
+			pydvd_writer_puts(&w, "</titles>");
+		}
+		_DVD_writeIndent(&w, pretty, 0);
+		pydvd_writer_puts(&w, "</dvd>");
+	}
+	if (pretty)
+	{
+		pydvd_writer_put(&w, "\n", 1);
+	}
+
+	int failed = pydvd_writer_finish(&w);
+	_DVD_unlock(self);
+
+	// A failed flush has set the exception already
+	if (failed == PYDVD_WRITER_NOMEM)
+	{
+		PyErr_NoMemory();
+	}
+	ok = !failed;
+
+done:
+	for (int i=0; i < 5; i++)
+	{
+		Py_XDECREF(strs[i]);
+	}
+	Py_XDECREF(out.write);
+
+	if (!ok)
+	{
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject*
+DVD_WriteXML(DVD *self, PyObject *args, PyObject *kwds)
+{
+	return _DVD_write(self, args, kwds, 0);
+}
+
+static PyObject*
+DVD_WriteJSON(DVD *self, PyObject *args, PyObject *kwds)
+{
+	return _DVD_write(self, args, kwds, 1);
+}
+
+
+static PyMemberDef DVD_members[] = {
+	{"_path", T_OBJECT_EX, offsetof(DVD, path), 0, "Path of DVD device"},
+	{NULL}
+};
+
+static PyMethodDef DVD_methods[] = {
+	{"Open", (PyCFunction)DVD_Open, METH_VARARGS|METH_KEYWORDS, "Opens the device for reading; pass parallel=N to parse all title set IFOs up front on N threads, cachedir to keep parsed metadata in a cache directory"},
+	{"Close", (PyCFunction)DVD_Close, METH_NOARGS, "Closes the device"},
+	{"GetTitle", (PyCFunction)DVD_GetTitle, METH_FASTCALL, "Gets Title object for specified non-negative title number, the same object while it is alive until Close()"},
+	{"OpenFile", (PyCFunction)DVD_OpenFile, METH_VARARGS|METH_KEYWORDS, "Opens a title set file (domain is one of the READ_* constants, default READ_TITLE_VOBS) and returns a Stream of its blocks; readahead=True fills the ring on a thread"},
+	{"RescueMap", (PyCFunction)DVD_RescueMap, METH_VARARGS|METH_KEYWORDS, "Gets the (first block, number of blocks, status) runs of a file's rescue map, status being one of the ddrescue characters '?', '*', '-' or '+'"},
+	{"WriteRescueMap", (PyCFunction)DVD_WriteRescueMap, METH_VARARGS|METH_KEYWORDS, "Writes a file's rescue map to path as a ddrescue mapfile"},
+	{"ReadRescueMap", (PyCFunction)DVD_ReadRescueMap, METH_VARARGS|METH_KEYWORDS, "Replaces a file's rescue map with the ddrescue mapfile at path"},
+	{"Detach", (PyCFunction)DVD_Detach, METH_NOARGS, "Detaches every title (see Title.Detach()) and returns the tuple of them, which keeps working after Close()"},
+	{"Snapshot", (PyCFunction)DVD_Snapshot, METH_NOARGS, "Gets the whole disc as a DiscSnapshot of TitleSnapshot, AudioSnapshot, ChapterSnapshot and SubpictureSnapshot structseqs in one call"},
+	{"WriteXML", (PyCFunction)DVD_WriteXML, METH_VARARGS|METH_KEYWORDS, "Writes the disc out as XML in the layout of dvdread.DVDToXML() to a file descriptor or file-like object, a chunk at a time; pretty=False leaves out line breaks and indentation"},
+	{"WriteJSON", (PyCFunction)DVD_WriteJSON, METH_VARARGS|METH_KEYWORDS, "Writes the disc out as JSON with the same contents as WriteXML() to a file descriptor or file-like object, a chunk at a time; pretty=False leaves out line breaks and indentation"},
+	{NULL}
+};
+
+static PyGetSetDef DVD_getseters[] = {
+	{"IsOpen", (getter)DVD_getIsOpen, NULL, "Gets flag indicating if device is open or not", NULL},
+	{"Titles", (getter)DVD_getTitles, NULL, "Gets a tuple of all titles, the same objects GetTitle() returns", NULL},
+	{"Path", (getter)DVD_getPath, NULL, "Get the path to the DVD device", NULL},
+	{"VMGID", (getter)DVD_GetVMGID, NULL, "Gets the VMD ID", NULL},
+	{"ProviderID", (getter)DVD_GetProviderID, NULL, "Gets the Provider ID", NULL},
+	{"Fingerprint", (getter)DVD_GetFingerprint, NULL, "Gets the SHA-256 of the IFO files MD5 (as DVDDiscID()), VMG ID, provider ID and volume size computed by Open(), or None", NULL},
+	{"FingerprintHex", (getter)DVD_GetFingerprintHex, NULL, "Gets Fingerprint as a hex string", NULL},
+	{"NumberOfTitles", (getter)DVD_GetNumberOfTitles, NULL, "Gets the number of titles", NULL},
+	{"MaxResidentIFOs", (getter)DVD_getMaxResidentIFOs, (setter)DVD_setMaxResidentIFOs, "Gets or sets the maximum number of title set IFOs kept loaded (zero is unlimited)", NULL},
+	{"IFOsLoaded", (getter)DVD_getIFOsLoaded, NULL, "Gets the number of IFOs read from the disc since Open()", NULL},
+	{"IFOsResident", (getter)DVD_getIFOsResident, NULL, "Gets the number of IFOs currently loaded", NULL},
+	{"IFOsEvicted", (getter)DVD_getIFOsEvicted, NULL, "Gets the number of title set IFOs unloaded to stay within MaxResidentIFOs", NULL},
+	{"BlockCacheSize", (getter)DVD_getBlockCacheSize, (setter)DVD_setBlockCacheSize, "Gets or sets the bytes of recently read blocks kept in memory (zero, the default, is no cache); setting it empties the cache", NULL},
+	{"BlockCachePolicy", (getter)DVD_getBlockCachePolicy, (setter)DVD_setBlockCachePolicy, "Gets or sets which blocks the cache evicts, BLOCKCACHE_LRU or BLOCKCACHE_CLOCK; setting it empties the cache", NULL},
+	{"BlockCacheBlocks", (getter)DVD_getBlockCacheBlocks, NULL, "Gets the number of blocks in the cache", NULL},
+	{"BlockCacheHits", (getter)DVD_getBlockCacheHits, NULL, "Gets the number of blocks read from the cache since Open()", NULL},
+	{"BlockCacheMisses", (getter)DVD_getBlockCacheMisses, NULL, "Gets the number of blocks the cache read from the disc since Open()", NULL},
+	{"BlockCacheEvictions", (getter)DVD_getBlockCacheEvictions, NULL, "Gets the number of blocks dropped from the cache to stay within BlockCacheSize since Open()", NULL},
+	{"Rescue", (getter)DVD_getRescue, (setter)DVD_setRescue, "Gets or sets flag indicating if stream reads fill unreadable blocks and skip past bad regions instead of failing", NULL},
+	{"RescueFill", (getter)DVD_getRescueFill, (setter)DVD_setRescueFill, "Gets or sets what unreadable blocks read as in rescue mode, RESCUE_FILL_ZERO or RESCUE_FILL_PAD", NULL},
+	{"RescueFailures", (getter)DVD_getRescueFailures, NULL, "Gets the number of failed reads in rescue mode since Open()", NULL},
+	{"RescueFilled", (getter)DVD_getRescueFilled, NULL, "Gets the number of blocks filled instead of read in rescue mode since Open()", NULL},
+	{"FromCache", (getter)DVD_getFromCache, NULL, "Gets flag indicating if title metadata is being served from the cache directory passed to Open()", NULL},
+	{"VolumeID", (getter)DVD_getVolumeID, NULL, "Gets the volume label read at Open() (directory name for a VIDEO_TS directory)", NULL},
+	{"VolumeSetID", (getter)DVD_getVolumeSetID, NULL, "Gets the volume set ID read at Open()", NULL},
+	{NULL}
+};
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Administrative functions for Title
+
+static pgc_t*
+_Title_getPGC(Title *self, ifo_handle_t **ifo)
+{
+	// Resolves the title's program chain, loading the title set IFO if needed
+	// Called with the lock held; pointers are only valid until it is released or the next _DVD_getIFO() call
+	*ifo = _DVD_getIFO(self->dvd, self->ifonum);
+	if (*ifo == NULL)
+	{
+		return NULL;
+	}
+
+	return _ifo_getTitlePGC(self->dvd->ifos[0], *ifo, self->titlenum);
+}
+
+static int
+_Title_checkReadable(Title *self)
+{
+	// Returns zero if the title's copied data can be read, which needs the disc open unless Detach() was called,
+	// or -1 with an exception set
+	if (self->detached || _DVD_getIsOpen(self->dvd))
+	{
+		return 0;
+	}
+
+	PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+	return -1;
+}
+
+static int
+_Title_lockRecords(Title *self, _DVD_titlerecs_t *recs)
+{
+	// Takes the DVD's lock and points @recs at the title's records, its own copies once detached (which have no
+	// cell times), returns zero with the lock held or -1 with an exception set
+	if (self->detached)
+	{
+		_DVD_lock(self->dvd);
+		recs->title = &self->info;
+		recs->chapters = self->chapters;
+		recs->audios = self->audios;
+		recs->subpictures = self->subpictures;
+		recs->celltimes = NULL;
+		return 0;
+	}
+
+	if (_DVD_lockOpen(self->dvd))
+	{
+		return -1;
+	}
+	if (_DVD_getTitleRecord(self->dvd, self->titlenum, recs))
+	{
+		_DVD_unlock(self->dvd);
+		return -1;
+	}
+	return 0;
+}
+
+static PyObject*
+Title_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	Title *self;
+
+	self = (Title*)type->tp_alloc(type, 0);
+	if (self != NULL)
+	{
+		self->ifonum = 0;
+		self->titlenum = 0;
+
+		Py_INCREF(Py_None);Py_INCREF(Py_None);Py_INCREF(Py_None);
+		self->AudioClass = Py_None;
+		self->ChapterClass = Py_None;
+		self->SubpictureClass = Py_None;
+
+		self->dvd = NULL;
+
+		self->numangles = 0;
+		self->numaudios = 0;
+		self->numsubpictures = 0;
+		self->numchapters = 0;
+
+		memset(&self->info, 0, sizeof(self->info));
+
+		memset(&self->chapterobjs, 0, sizeof(_Children_t));
+		memset(&self->audioobjs, 0, sizeof(_Children_t));
+		memset(&self->subpictureobjs, 0, sizeof(_Children_t));
+		self->detached = 0;
+		self->chapters = NULL;
+		self->audios = NULL;
+		self->subpictures = NULL;
+	}
+
+	return (PyObject*)self;
+}
+
+static int
+_Title_fill(Title *self, DVD *dvd, int ifonum, int titlenum, PyObject *audioclass, PyObject *chapterclass, PyObject *subpictureclass)
+{
+	// Fills in @titlenum of @dvd, which has been bounds checked; the classes are borrowed
+	PyObject *tmp;
+
+	// Record comes from the cache table or the title set's records, so no getter touches the IFOs
+	_DVD_titlerecs_t recs;
+	if (_DVD_lockOpen(dvd))
+	{
+		return -1;
+	}
+	if (_DVD_getTitleRecord(dvd, titlenum, &recs))
+	{
+		_DVD_unlock(dvd);
+		return -1;
+	}
+	self->info = *recs.title;
+	_DVD_unlock(dvd);
+	self->ifonum = ifonum;
+	self->titlenum = titlenum;
+
+	self->numangles = self->info.numangles;
+	self->numchapters = self->info.numchapters;
+	self->numaudios = self->info.numaudios;
+	self->numsubpictures = self->info.numsubpictures;
+
+	// Assign DVD object
+	tmp = (PyObject*)self->dvd;
+	Py_INCREF(dvd);
+	self->dvd = dvd;
+	Py_CLEAR(tmp);
+
+	// AudioClass
+	tmp = self->AudioClass;
+	Py_INCREF(audioclass);
+	self->AudioClass = audioclass;
+	Py_CLEAR(tmp);
+
+	// ChapterClass
+	tmp = self->ChapterClass;
+	Py_INCREF(chapterclass);
+	self->ChapterClass = chapterclass;
+	Py_CLEAR(tmp);
+
+	// SubpictureClass
+	tmp = self->SubpictureClass;
+	Py_INCREF(subpictureclass);
+	self->SubpictureClass = subpictureclass;
+	Py_CLEAR(tmp);
+
+	return 0;
+}
+
+static int
+Title_init(Title *self, PyObject *args, PyObject *kwds)
+{
+	ModuleState_t *st = GetState(Py_TYPE(self));
+	if (st == NULL)
+	{
+		return -1;
+	}
+
+	PyObject *_dvd=NULL;
+	PyObject *audioclass=(PyObject*)st->AudioType, *chapterclass=(PyObject*)st->ChapterType, *subpictureclass=(PyObject*)st->SubpictureType;
+	int titlenum=0, ifonum=0;
+	static char *kwlist[] = {"DVD", "IFONum", "TitleNum", "AudioClass", "ChapterClass", "SubpictureClass", NULL};
+
+	// Parse arguments, the classes default to the plain types
+	if (! PyArg_ParseTupleAndKeywords(args,kwds, "Oii|OOO", kwlist, &_dvd, &ifonum, &titlenum, &audioclass, &chapterclass, &subpictureclass))
+	{
+		return -1;
+	}
+
+	// Ensure DVD is correct type
+	if (! PyObject_TypeCheck(_dvd, st->DvdType))
+	{
+		PyErr_SetString(PyExc_TypeError, "DVD incorrect type");
+		return -1;
+	}
+	DVD *dvd = (DVD*)_dvd;
+
+	// Bounds check on ifonum
+	if (ifonum < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "IFO number cannot be negative (%d)", ifonum);
+		return -1;
+	}
+	if (ifonum > dvd->numifos)
+	{
+		PyErr_Format(PyExc_ValueError, "IFO number is too large (%d > %d)", ifonum, dvd->numifos);
+		return -1;
+	}
+
+	// Bounds check on title
+	if (titlenum < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Title number cannot be negative (%d)", titlenum);
+		return -1;
+	}
+	if (titlenum > dvd->numtitles)
+	{
+		PyErr_Format(PyExc_ValueError, "Title number is too large (%d > %d)", titlenum, dvd->numtitles);
+		return -1;
+	}
+
+	return _Title_fill(self, dvd, ifonum, titlenum, audioclass, chapterclass, subpictureclass);
+}
+
+static void
+Title_dealloc(Title *self)
+{
+	// Children hold their title, so none are left to clear their slots
+	if (self->dvd)
+	{
+		_Children_forget(self->dvd, &self->dvd->titleobjs, self->titlenum, (PyObject*)self);
+	}
+	_Children_release(&self->chapterobjs);
+	_Children_release(&self->audioobjs);
+	_Children_release(&self->subpictureobjs);
+
+	free(self->chapters);
+	free(self->audios);
+	free(self->subpictures);
+	self->chapters = NULL;
+	self->audios = NULL;
+	self->subpictures = NULL;
+	self->detached = 0;
+
+	self->ifonum = 0;
+	self->titlenum = 0;
+
+	Py_CLEAR(self->dvd);
+	Py_CLEAR(self->AudioClass);
+	Py_CLEAR(self->ChapterClass);
+	Py_CLEAR(self->SubpictureClass);
+
+	self->numangles = 0;
+	self->numaudios = 0;
+	self->numsubpictures = 0;
+	self->numchapters = 0;
+
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
+
+static PyObject*
+_Title_create(DVD *dvd, int ifonum, int titlenum)
+{
+	// Title of the DVD's TitleClass for a bounds checked title number, filled in directly unless the class
+	// changes how it is constructed
+	ModuleState_t *st = dvd->state;
+	if (IsPlainSubtype(dvd->TitleClass, st->TitleType))
+	{
+		PyTypeObject *cls = (PyTypeObject*)dvd->TitleClass;
+		Title *title = (Title*)cls->tp_new(cls, NULL, NULL);
+		if (title && _Title_fill(title, dvd, ifonum, titlenum, (PyObject*)st->AudioType, (PyObject*)st->ChapterType, (PyObject*)st->SubpictureType))
+		{
+			Py_CLEAR(title);
+		}
+		return (PyObject*)title;
+	}
+
+	PyObject *args[3];
+	args[0] = (PyObject*)dvd;
+	args[1] = PyLong_FromLong(ifonum);
+	args[2] = PyLong_FromLong(titlenum);
+
+	PyObject *ret = NULL;
+	if (args[1] && args[2])
+	{
+		ret = PyObject_Vectorcall(dvd->TitleClass, args, 3, NULL);
+	}
+	Py_XDECREF(args[1]);
+	Py_XDECREF(args[2]);
+	return ret;
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for Title
+
+static PyObject*
+Title_getDVD(Title *self)
+{
+	Py_INCREF(self->dvd);
+	return (PyObject*)self->dvd;
+}
+
+static PyObject*
+Title_getTitleNum(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong((long)self->titlenum);
+}
+
+static PyObject*
+Title_getFrameRate(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+	return SharedStr(self->dvd->state, FrameRateId(self->info.framerate));
+}
+
+static PyObject*
+Title_getAspectRatio(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	int a = AspectRatioId(self->info.aspectratio);
+	if (a < 0)
+	{
+		PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
+		return NULL;
+	}
+	return SharedStr(self->dvd->state, a);
+}
+
+static PyObject*
+Title_getWidth(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	int w = PictureWidth(self->info.picturesize);
+	if (w == 0)
+	{
+		PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
+		return NULL;
+	}
+	return PyLong_FromLong(w);
+}
+
+static PyObject*
+Title_getHeight(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	int h = PictureHeight(self->info.videoformat);
+	if (h == 0)
+	{
+		PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
+		return NULL;
+	}
+	return PyLong_FromLong(h);
+}
+
+static PyObject*
+Title_getPlaybackTime(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong( self->info.playbackms );
+}
+
+static PyObject*
+Title_getPlaybackTimeFancy(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return dvdtimetofancy( self->info.playbackms, self->info.framerate );
+}
+
+static PyObject*
+Title_getNumberOfAngles(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong( self->numangles );
+}
+
+static PyObject*
+Title_getNumberOfAudios(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong( self->numaudios );
+}
+
+static PyObject*
+Title_getNumberOfSubpictures(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong( self->numsubpictures );
+}
+
+static PyObject*
+Title_getNumberOfChapters(Title *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong( self->numchapters );
+}
+
+
+
+
+static PyObject*
+_Title_callClass(PyObject *cls, Title *self, int num)
+{
+	// @cls(self, num) for a class that changes how it is constructed
+	PyObject *args[2];
+	args[0] = (PyObject*)self;
+	args[1] = PyLong_FromLong(num);
+	if (args[1] == NULL)
+	{
+		return NULL;
+	}
+
+	PyObject *ret = PyObject_Vectorcall(cls, args, 2, NULL);
+	Py_DECREF(args[1]);
+	return ret;
+}
+
+static PyObject*
+Title_GetAudio(Title *self, PyObject *const *args, Py_ssize_t nargs)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+	int audionum;
+
+	if (ParseIntArgs("GetAudio", args, nargs, 1, 1, &audionum))
+	{
+		return NULL;
+	}
+
+	// Bounds check
+	if (audionum < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Audio track must be positive (%d)", audionum);
+		return NULL;
+	}
+	if (audionum > self->numaudios)
+	{
+		PyErr_Format(PyExc_ValueError, "Audio track too large (%d > %d)", audionum, self->numaudios);
+		return NULL;
+	}
+
+	return _Children_get(self->dvd, &self->audioobjs, self->numaudios, (PyObject*)self, audionum, _Title_makeAudio);
+}
+
+static PyObject*
+_Title_makeAudio(PyObject *owner, int audionum, int *own)
+{
+	// Audio track @audionum of the title for its cache, see _Children_get()
+	Title *self = (Title*)owner;
+
+	if (!IsPlainSubtype(self->AudioClass, self->dvd->state->AudioType))
+	{
+		PyObject *ret = _Title_callClass(self->AudioClass, self, audionum);
+		*own = (ret && PyObject_TypeCheck(ret, self->dvd->state->AudioType) && ((Audio*)ret)->title == self && ((Audio*)ret)->audionum == audionum);
+		return ret;
+	}
+
+	// Fill in directly, already checked
+	PyTypeObject *cls = (PyTypeObject*)self->AudioClass;
+	Audio *audio = (Audio*)cls->tp_new(cls, NULL, NULL);
+	if (audio && _Audio_fill(audio, self, audionum))
+	{
+		Py_CLEAR(audio);
+	}
+	*own = 1;
+	return (PyObject*)audio;
+}
+
+static PyObject*
+Title_GetChapter(Title *self, PyObject *const *args, Py_ssize_t nargs)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	int chapternum;
+
+	if (ParseIntArgs("GetChapter", args, nargs, 1, 1, &chapternum))
+	{
+		return NULL;
+	}
+
+	// Bounds check
+	if (chapternum < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Chapter must be positive (%d)", chapternum);
+		return NULL;
+	}
+	if (chapternum > self->numchapters)
+	{
+		PyErr_Format(PyExc_ValueError, "Chapter track too large (%d > %d)", chapternum, self->numchapters);
+		return NULL;
+	}
+
+	return _Children_get(self->dvd, &self->chapterobjs, self->numchapters, (PyObject*)self, chapternum, _Title_makeChapter);
+}
+
+static PyObject*
+_Title_makeChapter(PyObject *owner, int chapternum, int *own)
+{
+	// Chapter @chapternum of the title for its cache, see _Children_get()
+	Title *self = (Title*)owner;
+
+	// Copied out as the records are only valid while the lock is held
+	_DVD_titlerecs_t recs;
+	if (_Title_lockRecords(self, &recs))
+	{
+		return NULL;
+	}
+	pydvd_chapter_t rec = recs.chapters[ chapternum-1 ];
+	const pydvd_chapter_t *chapter = &rec;
+	_DVD_unlock(self->dvd);
+
+	PyObject *lenfancy = dvdtimetofancy( chapter->lenms, chapter->framerate );
+	if (lenfancy == NULL)
+	{
+		return NULL;
+	}
+
+	PyObject *ret;
+	if (IsPlainSubtype(self->ChapterClass, self->dvd->state->ChapterType))
+	{
+		// Fill in directly, already checked
+		PyTypeObject *cls = (PyTypeObject*)self->ChapterClass;
+		ret = cls->tp_new(cls, NULL, NULL);
+		if (ret)
+		{
+			_Chapter_fill((Chapter*)ret, self, chapternum, chapter->startcell, chapter->endcell, chapter->lenms, lenfancy);
+		}
+	}
+	else
+	{
+		PyObject *args[6];
+		args[0] = (PyObject*)self;
+		args[1] = PyLong_FromLong(chapternum);
+		args[2] = PyLong_FromLong(chapter->startcell);
+		args[3] = PyLong_FromLong(chapter->endcell);
+		args[4] = PyLong_FromLong(chapter->lenms);
+		args[5] = lenfancy;
+
+		ret = NULL;
+		if (args[1] && args[2] && args[3] && args[4])
+		{
+			ret = PyObject_Vectorcall(self->ChapterClass, args, 6, NULL);
+		}
+		for (int i=1; i < 5; i++)
+		{
+			Py_XDECREF(args[i]);
+		}
+		*own = (ret && PyObject_TypeCheck(ret, self->dvd->state->ChapterType) && ((Chapter*)ret)->title == self && ((Chapter*)ret)->chapternum == chapternum);
+		Py_DECREF(lenfancy);
+		return ret;
+	}
+
+	*own = 1;
+	Py_DECREF(lenfancy);
+	return ret;
+}
+
+static PyObject*
+Title_GetSubpicture(Title *self, PyObject *const *args, Py_ssize_t nargs)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+
+	int subpicturenum;
+
+	if (ParseIntArgs("GetSubpicture", args, nargs, 1, 1, &subpicturenum))
+	{
+		return NULL;
+	}
+
+	// Bounds check
+	if (subpicturenum < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Subpicture track must be positive (%d)", subpicturenum);
+		return NULL;
+	}
+	if (subpicturenum > self->numsubpictures)
+	{
+		PyErr_Format(PyExc_ValueError, "Subpicture track too large (%d > %d)", subpicturenum, self->numsubpictures);
+		return NULL;
+	}
+
+	return _Children_get(self->dvd, &self->subpictureobjs, self->numsubpictures, (PyObject*)self, subpicturenum, _Title_makeSubpicture);
+}
+
+static PyObject*
+_Title_makeSubpicture(PyObject *owner, int subpicturenum, int *own)
+{
+	// Subpicture @subpicturenum of the title for its cache, see _Children_get()
+	Title *self = (Title*)owner;
+
+	if (!IsPlainSubtype(self->SubpictureClass, self->dvd->state->SubpictureType))
+	{
+		PyObject *ret = _Title_callClass(self->SubpictureClass, self, subpicturenum);
+		*own = (ret && PyObject_TypeCheck(ret, self->dvd->state->SubpictureType) && ((Subpicture*)ret)->title == self && ((Subpicture*)ret)->subpicturenum == subpicturenum);
+		return ret;
+	}
+
+	// Fill in directly, already checked
+	PyTypeObject *cls = (PyTypeObject*)self->SubpictureClass;
+	Subpicture *subpicture = (Subpicture*)cls->tp_new(cls, NULL, NULL);
+	if (subpicture && _Subpicture_fill(subpicture, self, subpicturenum))
+	{
+		Py_CLEAR(subpicture);
+	}
+	*own = 1;
+	return (PyObject*)subpicture;
+}
+
+
+
+
+static PyObject*
+_Title_view(Title *self, _Children_t *c, int count, _Children_make_t make)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+
+	return _Children_view(self->dvd, c, count, (PyObject*)self, make);
+}
+
+static PyObject*
+Title_getChapters(Title *self)
+{
+	return _Title_view(self, &self->chapterobjs, self->numchapters, _Title_makeChapter);
+}
+
+static PyObject*
+Title_getAudios(Title *self)
+{
+	return _Title_view(self, &self->audioobjs, self->numaudios, _Title_makeAudio);
+}
+
+static PyObject*
+Title_getSubpictures(Title *self)
+{
+	return _Title_view(self, &self->subpictureobjs, self->numsubpictures, _Title_makeSubpicture);
+}
+
+static PyObject*
+Title_getIsDetached(Title *self)
+{
+	return PyBool_FromLong(self->detached);
+}
+
+static PyObject*
+Title_Detach(Title *self)
+{
+	// Copies the title's chapter, audio and subpicture records while the disc is open, after which its children
+	// are made from the copies and nothing about the title needs the disc, so it keeps working after Close()
+	if (self->detached)
+	{
+		Py_INCREF(self);
+		return (PyObject*)self;
+	}
+
+	_DVD_titlerecs_t recs;
+	if (_DVD_lockOpen(self->dvd))
+	{
+		return NULL;
+	}
+	// Another thread may have got here first
+	if (self->detached)
+	{
+		_DVD_unlock(self->dvd);
+		Py_INCREF(self);
+		return (PyObject*)self;
+	}
+	if (_DVD_getTitleRecord(self->dvd, self->titlenum, &recs))
+	{
+		_DVD_unlock(self->dvd);
+		return NULL;
+	}
+
+	// At least one element each so that a NULL always means out of memory
+	pydvd_chapter_t *chapters = malloc(sizeof(pydvd_chapter_t) * (self->numchapters ? self->numchapters : 1));
+	pydvd_audio_t *audios = malloc(sizeof(pydvd_audio_t) * (self->numaudios ? self->numaudios : 1));
+	pydvd_subpicture_t *subpictures = malloc(sizeof(pydvd_subpicture_t) * (self->numsubpictures ? self->numsubpictures : 1));
+	if (!chapters || !audios || !subpictures)
+	{
+		_DVD_unlock(self->dvd);
+		free(chapters);
+		free(audios);
+		free(subpictures);
+		PyErr_NoMemory();
+		return NULL;
+	}
+	memcpy(chapters, recs.chapters, sizeof(pydvd_chapter_t) * self->numchapters);
+	memcpy(audios, recs.audios, sizeof(pydvd_audio_t) * self->numaudios);
+	memcpy(subpictures, recs.subpictures, sizeof(pydvd_subpicture_t) * self->numsubpictures);
+
+	self->chapters = chapters;
+	self->audios = audios;
+	self->subpictures = subpictures;
+	self->detached = 1;
+	_DVD_unlock(self->dvd);
+
+	Py_INCREF(self);
+	return (PyObject*)self;
+}
+
+static Py_ssize_t
+Title_length(Title *self)
+{
+	// A title is a sequence of its chapters
+	return self->numchapters;
+}
+
+static PyObject*
+Title_item(Title *self, Py_ssize_t i)
+{
+	// title[i] is chapter i+1
+	if (_Title_checkReadable(self))
+	{
+		return NULL;
+	}
+	if (i < 0 || i >= self->numchapters)
+	{
+		PyErr_SetString(PyExc_IndexError, "chapter index out of range");
+		return NULL;
+	}
+
+	return _Children_get(self->dvd, &self->chapterobjs, self->numchapters, (PyObject*)self, (int)i+1, _Title_makeChapter);
+}
+
+static PyObject*
+Title_subscript(Title *self, PyObject *key)
+{
+	return _Children_subscript((PyObject*)self, key, (lenfunc)Title_length, (ssizeargfunc)Title_item, (PyObject *(*)(PyObject*))Title_getChapters);
+}
+
+static PyObject*
+Title_iter(Title *self)
+{
+	return _Children_iter((PyObject *(*)(PyObject*))Title_getChapters, (PyObject*)self);
+}
+
+static PyMemberDef Title_members[] = {
+	{NULL}
+};
+
+static PyObject*
+_Title_openStream(Title *self, int startcell, int endcell, int angle, int ringblocks, int readahead)
+{
+	// Opens a stream over cells @startcell to @endcell (one based, inclusive) in playback order
+	// Only the cell of @angle is taken from each angle block
+	if (angle < 1 || angle > (self->numangles > 0 ? self->numangles : 1))
+	{
+		PyErr_Format(PyExc_ValueError, "Angle out of range (%d not in 1 to %d)", angle, self->numangles);
+		return NULL;
+	}
+
+	if (_DVD_lockOpen(self->dvd))
+	{
+		return NULL;
+	}
+
+	ifo_handle_t *ifo = NULL;
+	pgc_t *pgc = _Title_getPGC(self, &ifo);
+	if (pgc == NULL)
+	{
+		_DVD_unlock(self->dvd);
+		return NULL;
+	}
+
+	if (startcell < 1 || endcell > pgc->nr_of_cells || startcell > endcell)
+	{
+		_DVD_unlock(self->dvd);
+		PyErr_Format(PyExc_ValueError, "Cells %d to %d are not in the title (%d cells)", startcell, endcell, pgc->nr_of_cells);
+		return NULL;
+	}
+
+	// Copy out the cells to read as @pgc is only valid until the title set IFO is next touched
+	pydvd_cell_t *cells = (pydvd_cell_t*)malloc(sizeof(pydvd_cell_t) * (endcell - startcell + 1));
+	if (cells == NULL)
+	{
+		_DVD_unlock(self->dvd);
+		return PyErr_NoMemory();
+	}
+
+	int numcells = 0;
+	int i = startcell - 1;
+	while (i < endcell)
+	{
+		int cell = i;
+		int next = i + 1;
+
+		if (pgc->cell_playback[i].block_type == BLOCK_TYPE_ANGLE_BLOCK)
+		{
+			// One cell per angle up to the one marked last
+			int last = i;
+			while (last + 1 < pgc->nr_of_cells && pgc->cell_playback[last].block_mode != BLOCK_MODE_LAST_CELL)
+			{
+				last++;
+			}
+
+			if (i + angle - 1 <= last)
+			{
+				cell = i + angle - 1;
+			}
+			next = last + 1;
+		}
+
+		cells[numcells].first = pgc->cell_playback[cell].first_sector;
+		cells[numcells].last = pgc->cell_playback[cell].last_sector;
+		cells[numcells].interleaved = pgc->cell_playback[cell].interleaved;
+		numcells++;
+
+		i = next;
+	}
+	_DVD_unlock(self->dvd);
+
+	PyObject *ret = _Stream_open(self->dvd, self->ifonum, DVD_READ_TITLE_VOBS, cells, numcells, ringblocks, readahead);
+	free(cells);
+	return ret;
+}
+
+static PyObject*
+Title_OpenStream(Title *self, PyObject *args, PyObject *kwds)
+{
+	int startchapter = 1;
+	int endchapter = 0;
+	int angle = 1;
+	int ringblocks = 512;
+	int readahead = 0;
+	static char *kwlist[] = {"startchapter", "endchapter", "angle", "ringblocks", "readahead", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "|iiiip", kwlist, &startchapter, &endchapter, &angle, &ringblocks, &readahead))
+	{
+		return NULL;
+	}
+
+	if (!_DVD_getIsOpen(self->dvd))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		return NULL;
+	}
+
+	// Zero means through the last chapter
+	if (endchapter == 0)
+	{
+		endchapter = self->numchapters;
+	}
+	if (startchapter < 1 || endchapter > self->numchapters || startchapter > endchapter)
+	{
+		PyErr_Format(PyExc_ValueError, "Chapters %d to %d are not in the title (%d chapters)", startchapter, endchapter, self->numchapters);
+		return NULL;
+	}
+
+	_DVD_titlerecs_t recs;
+	if (_DVD_lockOpen(self->dvd))
+	{
+		return NULL;
+	}
+	if (_DVD_getTitleRecord(self->dvd, self->titlenum, &recs))
+	{
+		_DVD_unlock(self->dvd);
+		return NULL;
+	}
+	int startcell = recs.chapters[startchapter-1].startcell;
+	int endcell = recs.chapters[endchapter-1].endcell;
+	_DVD_unlock(self->dvd);
+
+	return _Title_openStream(self, startcell, endcell, angle, ringblocks, readahead);
+}
+
+static int
+_Title_timeArgs(Title *self, PyObject *args, PyObject *kwds, _DVD_titlerecs_t *recs, int *cell)
+{
+	// Parses (time, ticks=False) and finds the cell playing at that time by binary search of the cell starts
+	// Sets @cell to the cell number, returns zero with the lock held for reading @recs, or -1 with an exception set
+	long long time;
+	int ticks = 0;
+	static char *kwlist[] = {"time", "ticks", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "L|p", kwlist, &time, &ticks))
+	{
+		return -1;
+	}
+
+	if (_DVD_lockOpen(self->dvd))
+	{
+		return -1;
+	}
+
+	if (_DVD_getTitleRecord(self->dvd, self->titlenum, recs))
+	{
+		_DVD_unlock(self->dvd);
+		return -1;
+	}
+
+	const pydvd_celltime_t *cells = recs->celltimes;
+	int numcells = recs->title->numcells;
+	uint64_t end = (ticks ? cells[numcells].start90k : cells[numcells].startms);
+	if (time < 0 || (uint64_t)time >= end)
+	{
+		_DVD_unlock(self->dvd);
+		PyErr_Format(PyExc_ValueError, "Time %lld is not in the title (0 to %llu %s)", time, (unsigned long long)end, ticks ? "ticks" : "ms");
+		return -1;
+	}
+
+	// Last cell starting at or before @time; zero length cells are passed over to the one that plays
+	int lo = 0, hi = numcells - 1;
+	while (lo < hi)
+	{
+		int mid = (lo + hi + 1) / 2;
+		uint64_t start = (ticks ? cells[mid].start90k : cells[mid].startms);
+		if (start <= (uint64_t)time)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+
+	*cell = lo + 1;
+	return 0;
+}
+
+static PyObject*
+Title_CellAtTime(Title *self, PyObject *args, PyObject *kwds)
+{
+	_DVD_titlerecs_t recs;
+	int cell;
+	if (_Title_timeArgs(self, args, kwds, &recs, &cell))
+	{
+		return NULL;
+	}
+	_DVD_unlock(self->dvd);
+
+	return PyLong_FromLong((long)cell);
+}
+
+static PyObject*
+Title_ChapterAtTime(Title *self, PyObject *args, PyObject *kwds)
+{
+	_DVD_titlerecs_t recs;
+	int cell;
+	if (_Title_timeArgs(self, args, kwds, &recs, &cell))
+	{
+		return NULL;
+	}
+
+	// Chapters start at increasing cells, so take the last one starting at or before the cell
+	const pydvd_chapter_t *chapters = recs.chapters;
+	int lo = 0, hi = recs.title->numchapters - 1;
+	if (hi < 0 || chapters[0].startcell > cell)
+	{
+		_DVD_unlock(self->dvd);
+		PyErr_Format(PyExc_ValueError, "Cell %d is not in a chapter", cell);
+		return NULL;
+	}
+	while (lo < hi)
+	{
+		int mid = (lo + hi + 1) / 2;
+		if (chapters[mid].startcell <= cell)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+	_DVD_unlock(self->dvd);
+
+	return PyLong_FromLong((long)lo + 1);
+}
+
+static PyMethodDef Title_methods[] = {
+	{"CellAtTime", (PyCFunction)Title_CellAtTime, METH_VARARGS|METH_KEYWORDS, "Gets the number of the cell playing at the given time in milliseconds (or 90 kHz ticks with ticks=True) from the start of the title"},
+	{"ChapterAtTime", (PyCFunction)Title_ChapterAtTime, METH_VARARGS|METH_KEYWORDS, "Gets the number of the chapter playing at the given time in milliseconds (or 90 kHz ticks with ticks=True) from the start of the title"},
+	{"GetAudio", (PyCFunction)Title_GetAudio, METH_FASTCALL, "Gets the specified audio track of this title, the same object while it is alive"},
+	{"GetChapter", (PyCFunction)Title_GetChapter, METH_FASTCALL, "Gets the specified chapter of this title, the same object while it is alive"},
+	{"GetSubpicture", (PyCFunction)Title_GetSubpicture, METH_FASTCALL, "Gets the specified subpicture of this title, the same object while it is alive"},
+	{"Detach", (PyCFunction)Title_Detach, METH_NOARGS, "Copies the chapter, audio and subpicture records now so the title and its children keep working after Close(), returns the title"},
+	{"OpenStream", (PyCFunction)Title_OpenStream, METH_VARARGS|METH_KEYWORDS, "Opens a Stream of the title's cells in playback order, optionally from startchapter to endchapter and for a given angle"},
+	{NULL}
+};
+
+static PyGetSetDef Title_getseters[] = {
+	{"DVD", (getter)Title_getDVD, NULL, "Gets the DVD this title is associated with", NULL},
+	{"AspectRatio", (getter)Title_getAspectRatio, NULL, "Gets the aspect ratio", NULL},
+	{"FrameRate", (getter)Title_getFrameRate, NULL, "Gets the frame rate", NULL},
+	{"PlaybackTime", (getter)Title_getPlaybackTime, NULL, "Gets the playback time in milliseconds", NULL},
+	{"PlaybackTimeFancy", (getter)Title_getPlaybackTimeFancy, NULL, "Gets the playback time in fancy HH:MM:SS.FF string format", NULL},
+	{"TitleNum", (getter)Title_getTitleNum, NULL, "Gets the number associated with this Title", NULL},
+	{"Width", (getter)Title_getWidth, NULL, "Gets the width of the video in pixels", NULL},
+	{"Height", (getter)Title_getHeight, NULL, "Gets the height of the video in pixels", NULL},
+	{"NumberOfAngles", (getter)Title_getNumberOfAngles, NULL, "Gets the number of angles in this title", NULL},
+	{"NumberOfAudios", (getter)Title_getNumberOfAudios, NULL, "Gets the number of audio tracks in this title", NULL},
+	{"NumberOfChapters", (getter)Title_getNumberOfChapters, NULL, "Gets the number of chapters in this title", NULL},
+	{"NumberOfSubpictures", (getter)Title_getNumberOfSubpictures, NULL, "Gets the number of subpictures in this title", NULL},
+	{"Chapters", (getter)Title_getChapters, NULL, "Gets a tuple of all chapters, the same objects GetChapter() returns", NULL},
+	{"Audios", (getter)Title_getAudios, NULL, "Gets a tuple of all audio tracks, the same objects GetAudio() returns", NULL},
+	{"Subpictures", (getter)Title_getSubpictures, NULL, "Gets a tuple of all subpictures, the same objects GetSubpicture() returns", NULL},
+	{"IsDetached", (getter)Title_getIsDetached, NULL, "Gets flag indicating if Detach() was called, so the title can be read with the disc closed", NULL},
+	{NULL}
+};
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Administrative functions for Audio
+
+static PyObject*
+Audio_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	Audio *self;
+
+	self = (Audio*)type->tp_alloc(type, 0);
+	if (self != NULL)
+	{
+		self->audionum = 0;
+		memset(&self->audio, 0, sizeof(self->audio));
+
+		self->title = NULL;
+	}
+
+	return (PyObject*)self;
+}
+
+static int
+_Audio_fill(Audio *self, Title *title, int audionum)
+{
+	// Fills in audio track @audionum of @title, which has been bounds checked
+	PyObject *tmp;
+
+	_DVD_titlerecs_t recs;
+	if (_Title_lockRecords(title, &recs))
+	{
+		return -1;
+	}
+	self->audionum = audionum;
+	self->audio = recs.audios[ audionum-1 ];
+	_DVD_unlock(title->dvd);
+
+	// Assign Title object
+	tmp = (PyObject*)self->title;
+	Py_INCREF(title);
+	self->title = title;
+	Py_CLEAR(tmp);
+
+	return 0;
+}
+
+static int
+Audio_init(Audio *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *_title=NULL;
+	int audionum=0;
+	static char *kwlist[] = {"Title", "AudioNum", NULL};
+
+	// Parse arguments
+	if (! PyArg_ParseTupleAndKeywords(args,kwds, "Oi", kwlist, &_title, &audionum))
+	{
+		return -1;
+	}
+
+	// Ensure Title is correct type
+	ModuleState_t *st = GetState(Py_TYPE(self));
+	if (st == NULL)
+	{
+		return -1;
+	}
+	if (! PyObject_TypeCheck(_title, st->TitleType))
+	{
+		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
+		return -1;
+	}
+	Title *title = (Title*)_title;
+
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(title))
+	{
+		return -1;
+	}
+
+
+
+	// Bounds check on audionum
+	if (audionum < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Audio number cannot be negative (%d)", audionum);
+		return -1;
+	}
+	if (audionum > title->numaudios)
+	{
+		PyErr_Format(PyExc_ValueError, "Audio number is too large (%d > %d)", audionum, title->numaudios);
+		return -1;
+	}
+
+
+	if (audionum < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Audio number not found (%d)", audionum);
+		return -1;
+	}
+
+	return _Audio_fill(self, title, audionum);
+}
+
+static void
+Audio_dealloc(Audio *self)
+{
+	if (self->title)
+	{
+		_Children_forget(self->title->dvd, &self->title->audioobjs, self->audionum, (PyObject*)self);
+	}
+
+	self->audionum = 0;
+
+	Py_CLEAR(self->title);
+
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
+
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for Audio
+
+static PyObject*
+Audio_getTitle(Audio *self)
+{
+	Py_INCREF(self->title);
+	return (PyObject*)self->title;
+}
+
+static PyObject*
+Audio_getLangCode(Audio *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return LangCodeToCode(self->title->dvd->state, self->audio.lang_code);
+}
+
+static PyObject*
+Audio_getLangCode3(Audio *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return LangCodeToCode3(self->title->dvd->state, self->audio.lang_code);
+}
+
+static PyObject*
+Audio_getLanguage(Audio *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return LangCodeToName(self->title->dvd->state, self->audio.lang_code);
+}
+
+static PyObject*
+Audio_getFormat(Audio *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return SharedStr(self->title->dvd->state, AudioFormatId(self->audio.format));
+}
+
+static PyObject*
+Audio_getSamplingRate(Audio *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	// Apparently it's either 48kHz or 48kHz
+	return SharedStr(self->title->dvd->state, STR_48000);
+}
+
+
+
+
+
+static PyMemberDef Audio_members[] = {
+	{NULL}
+};
 
-	return PyUnicode_FromString(buf);
+static PyMethodDef Audio_methods[] = {
+	{NULL}
+};
+
+static PyGetSetDef Audio_getseters[] = {
+	{"Title", (getter)Audio_getTitle, NULL, "Gets the title this track is associated with", NULL},
+	{"Format", (getter)Audio_getFormat, NULL, "Gets the format", NULL},
+	{"LangCode", (getter)Audio_getLangCode, NULL, "Gets the language code", NULL},
+	{"LangCode3", (getter)Audio_getLangCode3, NULL, "Gets the ISO 639-2 (bibliographic) language code, or None if there is none", NULL},
+	{"Language", (getter)Audio_getLanguage, NULL, "Gets the language", NULL},
+	{"SamplingRate", (getter)Audio_getSamplingRate, NULL, "Gets the sampling rate", NULL},
+	{NULL}
+};
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Administrative functions for Chapter
+
+static PyObject*
+Chapter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	Chapter *self;
+
+	self = (Chapter*)type->tp_alloc(type, 0);
+	if (self != NULL)
+	{
+		self->chapternum = 0;
+
+		self->title = NULL;
+
+		self->startcell = 0;
+		self->endcell = 0;
+
+		self->lenms = 0;
+
+		Py_INCREF(Py_None);
+		self->lenfancy = Py_None;
+	}
+
+	return (PyObject*)self;
+}
+
+static void
+_Chapter_fill(Chapter *self, Title *title, int chapternum, int start, int end, long lenms, PyObject *lenfancy)
+{
+	// Fills in a bounds checked chapter of @title; @lenfancy is borrowed
+	PyObject *tmp;
+
+	self->chapternum = chapternum;
+	self->startcell = start;
+	self->endcell = end;
+	self->lenms = lenms;
+
+	// Assign fancy length
+	tmp = (PyObject*)self->lenfancy;
+	Py_INCREF(lenfancy);
+	self->lenfancy = lenfancy;
+	Py_CLEAR(tmp);
+
+	// Assign Title object
+	tmp = (PyObject*)self->title;
+	Py_INCREF(title);
+	self->title = title;
+	Py_CLEAR(tmp);
+}
+
+static int
+Chapter_init(Chapter *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *_title=NULL;
+	int chapternum=0, start=0, end=0;
+	long lenms=0;
+	PyObject *lenfancy=NULL;
+	static char *kwlist[] = {"Title", "ChapterNum", "StartCell", "EndCell", "LenMS", "LenFancy", NULL};
+
+	// Parse arguments
+	if (! PyArg_ParseTupleAndKeywords(args,kwds, "OiiilO", kwlist, &_title, &chapternum, &start, &end, &lenms, &lenfancy))
+	{
+		return -1;
+	}
+
+	// Ensure Title is correct type
+	ModuleState_t *st = GetState(Py_TYPE(self));
+	if (st == NULL)
+	{
+		return -1;
+	}
+	if (! PyObject_TypeCheck(_title, st->TitleType))
+	{
+		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
+		return -1;
+	}
+	Title *title = (Title*)_title;
+
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(title))
+	{
+		return -1;
+	}
+
+
+
+	// Bounds check on chapternum
+	if (chapternum < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Chapter number cannot be negative (%d)", chapternum);
+		return -1;
+	}
+	if (chapternum > title->numchapters)
+	{
+		PyErr_Format(PyExc_ValueError, "Chapter number is too large (%d > %d)", chapternum, title->numchapters);
+		return -1;
+	}
+
+	// Bounds check on start
+	if (start < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Start cell number cannot be negative (%d)", start);
+		return -1;
+	}
+
+	// Bounds check on end
+	if (end < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "End cell number cannot be negative (%d)", end);
+		return -1;
+	}
+
+	_Chapter_fill(self, title, chapternum, start, end, lenms, lenfancy);
+	return 0;
+}
+
+static void
+Chapter_dealloc(Chapter *self)
+{
+	if (self->title)
+	{
+		_Children_forget(self->title->dvd, &self->title->chapterobjs, self->chapternum, (PyObject*)self);
+	}
+
+	self->chapternum = 0;
+	self->startcell = 0;
+	self->endcell = 0;
+	self->lenms = 0;
+
+	Py_CLEAR(self->title);
+	Py_CLEAR(self->lenfancy);
+
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
+
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for Chapter
+
+static PyObject*
+Chapter_getTitle(Audio *self)
+{
+	Py_INCREF(self->title);
+	return (PyObject*)self->title;
 }
 
 static PyObject*
-DVD_GetProviderID(DVD *self)
+Chapter_getChapterNum(Chapter *self)
 {
-	if (!_DVD_getIsOpen(self))
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
 	{
-		PyErr_SetString(PyExc_AttributeError, "ProviderID: disc not open");
 		return NULL;
 	}
 
-	char buf[33];
-	strncpy(buf, self->ifos[0]->vmgi_mat->provider_identifier, 32);
-	buf[32] = '\0';
 
-	return PyUnicode_FromString(buf);
+	return PyLong_FromLong(self->chapternum);
 }
 
 static PyObject*
-DVD_GetNumberOfTitles(DVD *self)
+Chapter_getStartCell(Chapter *self)
 {
-	if (!_DVD_getIsOpen(self))
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong(self->startcell);
+}
+
+static PyObject*
+Chapter_getEndCell(Chapter *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong(self->endcell);
+}
+
+static PyObject*
+Chapter_getLength(Chapter *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	return PyLong_FromLong(self->lenms);
+}
+
+static PyObject*
+Chapter_getLengthFancy(Chapter *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
+	{
+		return NULL;
+	}
+
+
+	Py_INCREF(self->lenfancy);
+	return self->lenfancy;
+}
+
+
+
+
+
+static PyMemberDef Chapter_members[] = {
+	{NULL}
+};
+
+static PyObject*
+Chapter_OpenStream(Chapter *self, PyObject *args, PyObject *kwds)
+{
+	int angle = 1;
+	int ringblocks = 512;
+	int readahead = 0;
+	static char *kwlist[] = {"angle", "ringblocks", "readahead", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "|iip", kwlist, &angle, &ringblocks, &readahead))
 	{
-		PyErr_SetString(PyExc_AttributeError, "NumberOfTitles: disc not open");
 		return NULL;
 	}
 
-	return PyLong_FromLong((long)self->numtitles);
+	if (!_DVD_getIsOpen(self->title->dvd))
+	{
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		return NULL;
+	}
+
+	return _Title_openStream(self->title, self->startcell, self->endcell, angle, ringblocks, readahead);
+}
+
+static PyMethodDef Chapter_methods[] = {
+	{"OpenStream", (PyCFunction)Chapter_OpenStream, METH_VARARGS|METH_KEYWORDS, "Opens a Stream of the chapter's cells in playback order for a given angle"},
+	{NULL}
+};
+
+static PyGetSetDef Chapter_getseters[] = {
+	{"Title", (getter)Chapter_getTitle, NULL, "Gets the title this chapter is associated with", NULL},
+	{"ChapterNum", (getter)Chapter_getChapterNum, NULL, "Gets the chapter number", NULL},
+	{"StartCell", (getter)Chapter_getStartCell, NULL, "Gets the starting cell for this chapter", NULL},
+	{"EndCell", (getter)Chapter_getEndCell, NULL, "Gets the ending cell for this chapter", NULL},
+	{"Length", (getter)Chapter_getLength, NULL, "Gets the length of the chapter in milliseconds", NULL},
+	{"LengthFancy", (getter)Chapter_getLengthFancy, NULL, "Gets the length of the chapter in HH:MM:SS:FF string format", NULL},
+	{NULL}
+};
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Administrative functions for Subpicture
+
+static PyObject*
+Subpicture_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	Subpicture *self;
+
+	self = (Subpicture*)type->tp_alloc(type, 0);
+	if (self != NULL)
+	{
+		self->subpicturenum = 0;
+
+		self->title = NULL;
+
+		memset(&self->subpicture, 0, sizeof(self->subpicture));
+	}
+
+	return (PyObject*)self;
 }
 
-
-
-static PyObject*
-DVD_Open(DVD *self)
+static int
+_Subpicture_fill(Subpicture *self, Title *title, int subpicturenum)
 {
-	// Ensure not already open
-	if (_DVD_getIsOpen(self))
-	{
-		PyErr_SetString(PyExc_Exception, "Device is already open, first Close() it to re-open");
-		return NULL;
-	}
+	// Fills in subpicture @subpicturenum of @title, which has been bounds checked
+	PyObject *tmp;
 
-	// Ensure path is present
-	if (self->path == NULL)
+	_DVD_titlerecs_t recs;
+	if (_Title_lockRecords(title, &recs))
 	{
-		PyErr_SetString(PyExc_AttributeError, "_path");
-		return NULL;
+		return -1;
 	}
+	self->subpicturenum = subpicturenum;
+	self->subpicture = recs.subpictures[ subpicturenum-1 ];
+	_DVD_unlock(title->dvd);
 
+	// Assign Title object
+	tmp = (PyObject*)self->title;
+	Py_INCREF(title);
+	self->title = title;
+	Py_CLEAR(tmp);
 
-	// Open the DVD
-	char *path = PyUnicode_AsUTF8(self->path);
-	if (path == NULL)
-	{
-		// Not responsible for clearing char*
-		return NULL;
-	}
+	return 0;
+}
 
-	struct stat s;
-	if (stat(path, &s))
+static int
+Subpicture_init(Subpicture *self, PyObject *args, PyObject *kwds)
+{
+	PyObject *_title=NULL;
+	int subpicturenum=0;
+	static char *kwlist[] = {"Title", "SubpictureNum", NULL};
+
+	// Parse arguments
+	if (! PyArg_ParseTupleAndKeywords(args,kwds, "Oi", kwlist, &_title, &subpicturenum))
 	{
-		PyErr_SetString(PyExc_ValueError, "Device/file not found");
-		return NULL;
+		return -1;
 	}
 
-	// Open the DVD
-	self->dvd = DVDOpen(path);
-	if (self->dvd == NULL)
+	// Ensure Title is correct type
+	ModuleState_t *st = GetState(Py_TYPE(self));
+	if (st == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Could not open device");
-		return NULL;
+		return -1;
 	}
-
-	// Get the root IFO
-	ifo_handle_t *zero = ifoOpen(self->dvd, 0);
-	if (zero == NULL)
+	if (! PyObject_TypeCheck(_title, st->TitleType))
 	{
-		PyErr_SetString(PyExc_Exception, "Could not open IFO zero");
-		goto error;
+		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
+		return -1;
 	}
+	Title *title = (Title*)_title;
 
-	// Get number of IFOs and create pointer space for the ifo_handle_t pointers
-	self->numifos = zero->vts_atrt->nr_of_vtss;
-	self->ifos = (ifo_handle_t**)calloc(self->numifos+1, sizeof(ifo_handle_t*));
-	self->ifos[0] = zero;
-
-	// Get all IFOs
-	for (int i=1; i <= self->numifos; i++)
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(title))
 	{
-		self->ifos[i] = ifoOpen(self->dvd, i);
-		if (!self->ifos[i])
-		{
-			PyErr_Format(PyExc_Exception, "Could not open IFO %d", i);
-			goto error;
-		}
+		return -1;
 	}
 
-	self->numtitles = zero->tt_srpt->nr_of_srpts;
-
-	// return None for success
-	Py_INCREF(Py_None);
-	return Py_None;
 
-error:
 
-	// If zero was set but not the ifos array, otherwise next block will take care of zero by closing self->ifso[0]
-	if (zero && self->ifos == NULL)
+	// Bounds check on subpicturenum
+	if (subpicturenum < 0)
 	{
-		ifoClose(zero);
+		PyErr_Format(PyExc_ValueError, "Subpicture number cannot be negative (%d)", subpicturenum);
+		return -1;
 	}
-	zero = NULL;
-
-	if (self->ifos)
+	if (subpicturenum > title->numsubpictures)
 	{
-		// Close and null each open IFO
-		for (int i=0; i < self->numifos; i++)
-		{
-			if (self->ifos[i])
-			{
-				ifoClose(self->ifos[i]);
-				self->ifos[i] = NULL;
-			}
-		}
-		// Free the array
-		free(self->ifos);
+		PyErr_Format(PyExc_ValueError, "Subpicture number is too large (%d > %d)", subpicturenum, title->numsubpictures);
+		return -1;
 	}
-	self->ifos = NULL;
 
-	// Close the dvd
-	if (self->dvd)
+
+	if (subpicturenum < 1)
 	{
-		DVDClose(self->dvd);
+		PyErr_Format(PyExc_ValueError, "Subpicture number too large (%d > %d)", title->numsubpictures, subpicturenum);
+		return -1;
 	}
-	self->dvd = NULL;
 
-	return NULL;
+	return _Subpicture_fill(self, title, subpicturenum);
 }
 
-static PyObject*
-DVD_Close(DVD *self)
+static void
+Subpicture_dealloc(Subpicture *self)
 {
-	// Ensure not closed already, or never was open
-	if (!_DVD_getIsOpen(self))
+	if (self->title)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot close it");
-		return NULL;
+		_Children_forget(self->title->dvd, &self->title->subpictureobjs, self->subpicturenum, (PyObject*)self);
 	}
 
-	// NB: leave path set
+	self->subpicturenum = 0;
 
-	// Close ifos
-	if (self->ifos)
-	{
-		for (int i=0; i < self->numifos; i++)
-		{
-			if (self->ifos[i])
-			{
-				ifoClose(self->ifos[i]);
-				self->ifos[i] = NULL;
-			}
-		}
-		free(self->ifos);
-	}
-	self->ifos = NULL;
+	Py_CLEAR(self->title);
 
-	// Close and null the pointer
-	if (self->dvd)
-	{
-		DVDClose(self->dvd);
-	}
-	self->dvd = NULL;
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
 
-	// return None for success
-	Py_INCREF(Py_None);
-	return Py_None;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for Subpicture
+
+static PyObject*
+Subpicture_getTitle(Audio *self)
+{
+	Py_INCREF(self->title);
+	return (PyObject*)self->title;
 }
 
 static PyObject*
-DVD_GetTitle(DVD *self, PyObject *args)
+Subpicture_getLangCode(Subpicture *self)
 {
-	// Ensure DVD is open before getting titles
-	if (!_DVD_getIsOpen(self))
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot get titles");
 		return NULL;
 	}
 
-	int title=0;
 
-	if (! PyArg_ParseTuple(args, "i", &title))
-	{
-		return NULL;
-	}
+	return LangCodeToCode(self->title->dvd->state, self->subpicture.lang_code);
+}
 
-	// Bounds check
-	if (title < 1)
-	{
-		PyErr_Format(PyExc_ValueError, "Title must be non-negative (%d)", title);
-		return NULL;
-	}
-	if (title > self->numtitles)
+static PyObject*
+Subpicture_getLangCode3(Subpicture *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
 	{
-		PyErr_Format(PyExc_ValueError, "Title value too large (%d > %d)", title, self->numtitles);
 		return NULL;
 	}
 
-	// Get IFO number
-	int ifonum = self->ifos[0]->tt_srpt->title[title-1].title_set_nr;
 
-	PyObject *a = Py_BuildValue("Oii", self, ifonum, title);
-	if (a == NULL)
+	return LangCodeToCode3(self->title->dvd->state, self->subpicture.lang_code);
+}
+
+static PyObject*
+Subpicture_getLanguage(Subpicture *self)
+{
+	// Ensure device is open (or the title detached) to access it
+	if (_Title_checkReadable(self->title))
 	{
 		return NULL;
 	}
 
-	return PyObject_CallObject(self->TitleClass, a);
+
+	return LangCodeToName(self->title->dvd->state, self->subpicture.lang_code);
 }
 
 
 
 
-static PyMemberDef DVD_members[] = {
-	{"_path", T_OBJECT_EX, offsetof(DVD, path), 0, "Path of DVD device"},
+static PyMemberDef Subpicture_members[] = {
 	{NULL}
 };
 
-static PyMethodDef DVD_methods[] = {
-	{"Open", (PyCFunction)DVD_Open, METH_NOARGS, "Opens the device for reading"},
-	{"Close", (PyCFunction)DVD_Close, METH_NOARGS, "Closes the device"},
-	{"GetTitle", (PyCFunction)DVD_GetTitle, METH_VARARGS, "Gets Title object for specified non-negative title number"},
+static PyMethodDef Subpicture_methods[] = {
 	{NULL}
 };
 
-static PyGetSetDef DVD_getseters[] = {
-	{"IsOpen", (getter)DVD_getIsOpen, NULL, "Gets flag indicating if device is open or not", NULL},
-	{"Path", (getter)DVD_getPath, NULL, "Get the path to the DVD device", NULL},
-	{"VMGID", (getter)DVD_GetVMGID, NULL, "Gets the VMD ID", NULL},
-	{"ProviderID", (getter)DVD_GetProviderID, NULL, "Gets the Provider ID", NULL},
-	{"NumberOfTitles", (getter)DVD_GetNumberOfTitles, NULL, "Gets the number of titles", NULL},
+static PyGetSetDef Subpicture_getseters[] = {
+	{"Title", (getter)Subpicture_getTitle, NULL, "Gets the title this subpicture is associated with", NULL},
+	{"LangCode", (getter)Subpicture_getLangCode, NULL, "Gets the language code", NULL},
+	{"LangCode3", (getter)Subpicture_getLangCode3, NULL, "Gets the ISO 639-2 (bibliographic) language code, or None if there is none", NULL},
+	{"Language", (getter)Subpicture_getLanguage, NULL, "Gets the language", NULL},
 	{NULL}
 };
 
 // --------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------
-// Administrative functions for Title
+// Administrative functions for Stream
 
-static PyObject*
-Title_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+static int
+_Stream_addExtent(pydvd_extent_t **extents, int *numextents, int *size, uint32_t first, uint32_t blocks)
 {
-	Title *self;
+	// Appends a run of blocks, merging it with the previous one when contiguous; returns -1 if out of memory
+	pydvd_extent_t *prev = (*numextents ? &(*extents)[*numextents - 1] : NULL);
 
-	self = (Title*)type->tp_alloc(type, 0);
-	if (self != NULL)
+	if (prev && prev->first + prev->blocks == first)
 	{
-		self->ifonum = 0;
-		self->titlenum = 0;
-
-		Py_INCREF(Py_None);Py_INCREF(Py_None);Py_INCREF(Py_None);
-		self->AudioClass = Py_None;
-		self->ChapterClass = Py_None;
-		self->SubpictureClass = Py_None;
-
-		self->dvd = NULL;
-		self->ifo = NULL;
+		prev->blocks += blocks;
+		return 0;
+	}
 
-		self->numangles = 0;
-		self->numaudios = 0;
-		self->numsubpictures = 0;
-		self->numchapters = 0;
+	if (*numextents == *size)
+	{
+		int newsize = (*size ? *size * 2 : 16);
+		pydvd_extent_t *e = (pydvd_extent_t*)realloc(*extents, sizeof(pydvd_extent_t) * newsize);
+		if (e == NULL)
+		{
+			return -1;
+		}
+		*extents = e;
+		*size = newsize;
 	}
 
-	return (PyObject*)self;
+	pydvd_extent_t *e = &(*extents)[(*numextents)++];
+	e->first = first;
+	e->blocks = blocks;
+	e->offset = (prev ? prev->offset + prev->blocks : 0);
+	return 0;
 }
 
 static int
-Title_init(Title *self, PyObject *args, PyObject *kwds)
+_Stream_buildExtents(pydvd_blockcache_t *cache, uint32_t key, dvd_file_t *file, ssize_t filesize, const pydvd_cell_t *cells, int numcells, unsigned char *nav, pydvd_extent_t **extents, int *numextents)
 {
-	PyObject *_dvd=NULL, *audioclass=NULL, *chapterclass=NULL, *subpictureclass=NULL, *tmp;
-	int titlenum=0, ifonum=0;
-	static char *kwlist[] = {"DVD", "IFONum", "TitleNum", "AudioClass", "ChapterClass", "SubpictureClass", NULL};
+	// Turns @cells into runs of blocks, following the VOBU chain of interleaved cells so only one angle is read
+	// Does I/O without touching Python objects; returns 0, or -1 on a read error and -2 on bad cells or no memory
+	int capacity = 0;
 
-	// Parse arguments
-	if (! PyArg_ParseTupleAndKeywords(args,kwds, "OiiOOO", kwlist, &_dvd, &ifonum, &titlenum, &audioclass, &chapterclass, &subpictureclass))
+	if (numcells == 0)
 	{
-		return -1;
+		// Whole file
+		if (filesize > 0 && _Stream_addExtent(extents, numextents, &capacity, 0, (uint32_t)filesize))
+		{
+			return -2;
+		}
+		return 0;
 	}
 
-	// Ensure DVD is correct type
-	if (! PyObject_TypeCheck(_dvd, &DvdType))
+	for (int i=0; i < numcells; i++)
 	{
-		PyErr_SetString(PyExc_TypeError, "DVD incorrect type");
-		return -1;
-	}
-	DVD *dvd = (DVD*)_dvd;
+		uint32_t first = cells[i].first;
+		uint32_t last = cells[i].last;
 
-	// Bounds check on ifonum
-	if (ifonum < 0)
-	{
-		PyErr_Format(PyExc_ValueError, "IFO number cannot be negative (%d)", ifonum);
-		return -1;
+		if (first > last || (ssize_t)last >= filesize)
+		{
+			return -2;
+		}
+
+		if (!cells[i].interleaved)
+		{
+			if (_Stream_addExtent(extents, numextents, &capacity, first, last - first + 1))
+			{
+				return -2;
+			}
+			continue;
+		}
+
+		// Interleaved units of the other angles sit between this angle's VOBUs, so hop from nav pack to nav pack
+		uint32_t cur = first;
+		while (cur <= last)
+		{
+			if (pydvd_blockcache_read(cache, file, key, (int)cur, 1, nav) != 1)
+			{
+				return -1;
+			}
+
+			uint32_t len = last - cur + 1;
+			uint32_t next = last + 1;
+
+			// A NAV pack has the PCI and DSI private stream 2 packets
+			if (nav[41] == 0xbf && nav[1027] == 0xbf)
+			{
+				dsi_t dsi;
+				navRead_DSI(&dsi, nav + DSI_START_BYTE);
+
+				if (dsi.dsi_gi.vobu_ea + 1 < len)
+				{
+					len = dsi.dsi_gi.vobu_ea + 1;
+				}
+
+				if (dsi.vobu_sri.next_vobu != SRI_END_OF_CELL)
+				{
+					next = cur + (dsi.vobu_sri.next_vobu & 0x3fffffff);
+				}
+				else
+				{
+					next = cur + len;
+				}
+			}
+
+			if (_Stream_addExtent(extents, numextents, &capacity, cur, len))
+			{
+				return -2;
+			}
+
+			// Never go backwards
+			if (next <= cur)
+			{
+				break;
+			}
+			cur = next;
+		}
 	}
-	if (ifonum > dvd->numifos)
+
+	return 0;
+}
+
+static int
+_Stream_findExtent(const Stream *self, int from, int pos)
+{
+	// Index of the extent holding stream block @pos, starting from extent @from as reads are sequential
+	int i = from;
+	if (i < self->numextents && (uint32_t)pos >= self->extents[i].offset)
 	{
-		PyErr_Format(PyExc_ValueError, "IFO number is too large (%d > %d)", ifonum, dvd->numifos);
-		return -1;
+		while (i < self->numextents && (uint32_t)pos >= self->extents[i].offset + self->extents[i].blocks)
+		{
+			i++;
+		}
+		return i;
 	}
-	self->ifonum = ifonum;
 
-	// Bounds check on title
-	if (titlenum < 0)
+	int lo = 0, hi = self->numextents - 1;
+	while (lo < hi)
 	{
-		PyErr_Format(PyExc_ValueError, "Title number cannot be negative (%d)", titlenum);
-		return -1;
+		int mid = (lo + hi + 1) / 2;
+		if (self->extents[mid].offset <= (uint32_t)pos)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
 	}
-	if (titlenum > dvd->numtitles)
+	return lo;
+}
+
+static ssize_t
+_Stream_rescueRead(Stream *self, dvd_file_t *file, int block, int n, unsigned char *buf)
+{
+	// Rescue mode read of up to @n blocks from file block @block; always produces at least one block
+	// Blocks known to be bad and those being passed over after a failure are filled instead of read, and a
+	// failed read is recorded and filled, passing over twice as many blocks as last time when failures repeat
+	DVD *dvd = self->dvd;
+	uint32_t key = PYDVD_BLOCKCACHE_KEY(self->vts, self->domain);
+	pydvd_rescue_map_t *map = _DVD_rescueMap(dvd, key, (uint32_t)self->fileblocks);
+	int k;
+
+	if (self->rescueskip > 0)
 	{
-		PyErr_Format(PyExc_ValueError, "Title number is too large (%d > %d)", titlenum, dvd->numtitles);
-		return -1;
+		k = (n < self->rescueskip ? n : self->rescueskip);
+		self->rescueskip -= k;
+		goto fill;
 	}
-	self->titlenum = titlenum;
 
-	// Get ifo_handle_t* for ifonum
-	if (!dvd->ifos[ifonum])
+	if (map)
 	{
-		PyErr_Format(PyExc_ValueError, "Title %d to open IFO %d but IFO is not open", titlenum, ifonum);
-		return -1;
+		uint32_t end;
+		char status = pydvd_rescue_status(map, (uint32_t)block, &end);
+		if (status == PYDVD_RESCUE_BAD || status == PYDVD_RESCUE_UNTRIMMED)
+		{
+			k = ((uint32_t)n < end - (uint32_t)block ? n : (int)(end - (uint32_t)block));
+			goto fill;
+		}
 	}
-	self->ifo = dvd->ifos[ifonum];
-
-	// Assign DVD object
-	tmp = (PyObject*)self->dvd;
-	Py_INCREF(dvd);
-	self->dvd = dvd;
-	Py_CLEAR(tmp);
 
-	ifo_handle_t *zero = self->dvd->ifos[0];
+	k = (n < PYDVD_RESCUE_CHUNK ? n : PYDVD_RESCUE_CHUNK);
+	ssize_t r = pydvd_blockcache_read(&dvd->blockcache, file, key, block, (size_t)k, buf);
+	if (r > 0)
+	{
+		if (map)
+		{
+			pydvd_rescue_set(map, (uint32_t)block, (uint32_t)r, PYDVD_RESCUE_GOOD);
+		}
+		self->rescuefailures = 0;
+		return r;
+	}
 
+	if (map)
+	{
+		pydvd_rescue_set(map, (uint32_t)block, (uint32_t)k, (k == 1 ? PYDVD_RESCUE_BAD : PYDVD_RESCUE_UNTRIMMED));
+	}
+	dvd->rescuefailures++;
 
+	int shift = (self->rescuefailures < 12 ? self->rescuefailures : 12);
+	self->rescuefailures++;
+	self->rescueskip = (PYDVD_RESCUE_MINSKIP << shift < PYDVD_RESCUE_MAXSKIP ? PYDVD_RESCUE_MINSKIP << shift : PYDVD_RESCUE_MAXSKIP);
 
-	pgcit_t *vts_pgcit = self->ifo->vts_pgcit;
-	int vts_ttn = zero->tt_srpt->title[self->titlenum-1].vts_ttn;
-	int pgcidx = self->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
+fill:
+	pydvd_rescue_fill(buf, (size_t)k, dvd->rescuefill);
+	dvd->rescuefilled += k;
+	return k;
+}
 
-	// Cache these values since the struct constant isn't always correct
-	self->numangles = zero->tt_srpt->title[ titlenum-1 ].nr_of_angles;
-	self->numchapters = pgc->nr_of_programs;
-	self->numaudios = 0;
-	self->numsubpictures = 0;
+static int
+_Stream_readBlocks(Stream *self, dvd_file_t *file, int *ext, int pos, int n, unsigned char *buf, int *failed)
+{
+	// Reads @n blocks from stream block @pos into @buf, split at extent boundaries
+	// @ext is the extent to search from and is left at the one to read next; @failed is set to the file block
+	// that stopped the read, if any. Does I/O without touching Python objects, with the DVD lock held
+	int e = _Stream_findExtent(self, *ext, pos);
+	int got = 0;
 
-	// Reported doesn't always match wath the program says
-	for (int i=0; i < self->ifo->vtsi_mat->nr_of_vts_audio_streams; i++)
+	while (got < n && e < self->numextents)
 	{
-		if (pgc->audio_control[i] & 0x8000)
+		const pydvd_extent_t *x = &self->extents[e];
+		int within = pos - (int)x->offset;
+		int len = (int)x->blocks - within;
+		if (len > n - got)
 		{
-			self->numaudios++;
+			len = n - got;
 		}
-	}
-	for (int i=0; i < self->ifo->vtsi_mat->nr_of_vts_subp_streams; i++)
-	{
-		if (pgc->subp_control[i] & 0x80000000)
+
+		unsigned char *out = buf + (size_t)got * DVD_VIDEO_LB_LEN;
+		ssize_t r;
+		if (self->dvd->rescue)
 		{
-			self->numsubpictures++;
+			r = _Stream_rescueRead(self, file, (int)x->first + within, len, out);
+		}
+		else
+		{
+			r = pydvd_blockcache_read(&self->dvd->blockcache, file, PYDVD_BLOCKCACHE_KEY(self->vts, self->domain), (int)x->first + within, (size_t)len, out);
+		}
+		if (r <= 0)
+		{
+			*failed = (int)x->first + within;
+			break;
 		}
-	}
-
-	// AudioClass
-	tmp = self->AudioClass;
-	Py_INCREF(audioclass);
-	self->AudioClass = audioclass;
-	Py_CLEAR(tmp);
-
-	// ChapterClass
-	tmp = self->ChapterClass;
-	Py_INCREF(chapterclass);
-	self->ChapterClass = chapterclass;
-	Py_CLEAR(tmp);
 
-	// SubpictureClass
-	tmp = self->SubpictureClass;
-	Py_INCREF(subpictureclass);
-	self->SubpictureClass = subpictureclass;
-	Py_CLEAR(tmp);
+		got += (int)r;
+		pos += (int)r;
+		if (pos >= (int)(x->offset + x->blocks))
+		{
+			e++;
+		}
+	}
 
-	return 0;
+	*ext = e;
+	return got;
 }
 
-static void
-Title_dealloc(Title *self)
+static int
+_Stream_readAheadBlocks(void *arg, int pos, int blocks, unsigned char *buf, int *failed)
 {
-	self->ifonum = 0;
-	self->titlenum = 0;
-
-	Py_CLEAR(self->dvd);
-	Py_CLEAR(self->AudioClass);
-	Py_CLEAR(self->ChapterClass);
-	Py_CLEAR(self->SubpictureClass);
+	// Reads for the read-ahead thread, which has no GIL to drop so it takes the DVD lock directly
+	Stream *self = (Stream*)arg;
+	pthread_mutex_lock(&self->dvd->lock);
 
-	self->ifo = NULL;
+	// DVD.Close() closes the file with the lock held
+	if (self->file == NULL)
+	{
+		pthread_mutex_unlock(&self->dvd->lock);
+		*failed = PYDVD_READAHEAD_CLOSED;
+		return 0;
+	}
 
-	self->numangles = 0;
-	self->numaudios = 0;
-	self->numsubpictures = 0;
-	self->numchapters = 0;
+	int got = _Stream_readBlocks(self, self->file, &self->raextent, pos, blocks, buf, failed);
 
-	Py_TYPE(self)->tp_free((PyObject*)self);
+	pthread_mutex_unlock(&self->dvd->lock);
+	return got;
 }
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Interface stuff for Title
+static void
+_Stream_lockRead(Stream *self)
+{
+	// As _DVD_lock(), the holder may be waiting for the GIL
+	if (pthread_mutex_trylock(&self->readlock) != 0)
+	{
+		Py_BEGIN_ALLOW_THREADS
+		pthread_mutex_lock(&self->readlock);
+		Py_END_ALLOW_THREADS
+	}
+}
 
-static PyObject*
-Title_getDVD(Title *self)
+static void
+_Stream_unlockRead(Stream *self)
 {
-	return (PyObject*)self->dvd;
+	pthread_mutex_unlock(&self->readlock);
 }
 
-static PyObject*
-Title_getTitleNum(Title *self)
+static void
+_Stream_stopReadAhead(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	// Joins the thread even if the flag is off, as DVD.Close() turns it off and leaves the thread to be joined
+	// here; it must not be joined with the GIL held, the thread may be waiting on the DVD lock
+	self->readahead = 0;
+
+	pydvd_readahead_t *ra = &self->ra;
+	if (!ra->initialized)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		return;
 	}
 
-
-	return PyLong_FromLong((long)self->titlenum);
+	Py_BEGIN_ALLOW_THREADS
+	pydvd_readahead_stop(ra);
+	Py_END_ALLOW_THREADS
 }
 
-static PyObject*
-Title_getFrameRate(Title *self)
+static int
+_Stream_startReadAhead(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	// (Re)starts the read-ahead thread from the current position, returns -1 with an exception set on failure
+	if (self->file == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		// Don't leave an old thread running and the flag set
+		_Stream_stopReadAhead(self);
+		PyErr_SetString(PyExc_ValueError, "Stream is closed");
+		return -1;
 	}
 
+	int e;
+	pydvd_readahead_t *ra = &self->ra;
+	int pos = self->pos;
+	int blocks = self->blocks;
 
-	ifo_handle_t *zero = self->dvd->ifos[0];
+	// Restarting joins the old thread, which may be waiting on the DVD lock
+	Py_BEGIN_ALLOW_THREADS
+	e = pydvd_readahead_start(ra, pos, blocks);
+	Py_END_ALLOW_THREADS
 
-	pgcit_t *vts_pgcit = self->ifo->vts_pgcit;
-
-	int vts_ttn = zero->tt_srpt->title[self->titlenum-1].vts_ttn;
+	if (e)
+	{
+		self->readahead = 0;
+		errno = e;
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
 
-	int pgcidx = self->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
+	self->readahead = 1;
+	return 0;
+}
 
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
-	dvd_time_t *t = &pgc->playback_time;
+static PyObject*
+_Stream_open(DVD *dvd, int vts, dvd_read_domain_t domain, const pydvd_cell_t *cells, int numcells, int ringblocks, int readahead)
+{
+	// Opens @vts/@domain and returns a Stream over @cells in order (the whole file if @numcells is zero)
+	if (ringblocks < 1)
+	{
+		PyErr_Format(PyExc_ValueError, "Ring must be at least one block (%d)", ringblocks);
+		return NULL;
+	}
 
-	int f = t->frame_u >> 6;
-	if (f == 1)
+	PyTypeObject *type = dvd->state->StreamType;
+	Stream *self = (Stream*)type->tp_alloc(type, 0);
+	if (self == NULL)
 	{
-		return PyUnicode_FromString("25.00");
+		return NULL;
 	}
-	else if (f == 3)
+
+	int e = pthread_mutex_init(&self->hashlock, NULL);
+	if (e == 0)
 	{
-		return PyUnicode_FromString("29.97");
+		e = pthread_mutex_init(&self->readlock, NULL);
+		if (e)
+		{
+			pthread_mutex_destroy(&self->hashlock);
+		}
 	}
-	else
+	if (e)
 	{
-		return PyUnicode_FromString("?");
+		Py_TYPE(self)->tp_free((PyObject*)self);
+		Py_DECREF(type);
+		errno = e;
+		return PyErr_SetFromErrno(PyExc_OSError);
 	}
-}
+	self->hash = 0;
+	self->hasdigest = 0;
 
-static PyObject*
-Title_getAspectRatio(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	Py_INCREF(dvd);
+	self->dvd = dvd;
+	self->file = NULL;
+	self->vts = vts;
+	self->domain = (int)domain;
+	self->extents = NULL;
+	self->numextents = 0;
+	self->curextent = 0;
+	self->blocks = 0;
+	self->pos = 0;
+	self->fileblocks = 0;
+	self->rescueskip = 0;
+	self->rescuefailures = 0;
+	self->ringblocks = ringblocks;
+	self->ringpos = 0;
+	self->readahead = 0;
+	self->raextent = 0;
+
+	// Link first so dealloc can unlink and close on any error below; the list is walked by Close() under the lock
+	_DVD_lock(dvd);
+	self->prev = NULL;
+	self->next = dvd->streams;
+	if (dvd->streams)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		dvd->streams->prev = self;
 	}
+	dvd->streams = self;
+	_DVD_unlock(dvd);
 
+	// Aligned for O_DIRECT backed readers and so consumers can hand views straight to their own direct I/O
+	if (posix_memalign((void**)&self->ring, 4096, (size_t)ringblocks * DVD_VIDEO_LB_LEN))
+	{
+		self->ring = NULL;
+		Py_DECREF(self);
+		return PyErr_NoMemory();
+	}
 
-	char w = self->ifo->vtsi_mat->vts_video_attr.display_aspect_ratio;
-	switch(w)
+	// Reads of a quarter of the ring keep the drive busy while leaving room for the consumer, up to 1 MiB
+	int chunk = (ringblocks / 4 < PYDVD_READAHEAD_CHUNK ? ringblocks / 4 : PYDVD_READAHEAD_CHUNK);
+	e = pydvd_readahead_init(&self->ra, self->ring, ringblocks, chunk, _Stream_readAheadBlocks, self);
+	if (e)
 	{
-		case 0: return PyUnicode_FromString("4:3");
-		case 1: return PyUnicode_FromString("16:9");
-		case 3: return PyUnicode_FromString("16:9");
-		default:
-			PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
-			return NULL;
+		Py_DECREF(self);
+		errno = e;
+		return PyErr_SetFromErrno(PyExc_OSError);
 	}
-}
 
-static PyObject*
-Title_getWidth(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	_DVD_lock(dvd);
+
+	if (!_DVD_getIsOpen(dvd))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		_DVD_unlock(dvd);
+		Py_DECREF(self);
+		PyErr_SetString(PyExc_Exception, "Device not open, cannot open file");
 		return NULL;
 	}
 
-
-	char w = self->ifo->vtsi_mat->vts_video_attr.picture_size;
-	switch(w)
+	dvd_file_t *file;
+	ssize_t size = -1;
+	int ret = -2;
+	dvd_reader_t *reader = dvd->dvd;
+	pydvd_extent_t *extents = NULL;
+	int numextents = 0;
+	Py_BEGIN_ALLOW_THREADS
+	file = DVDOpenFile(reader, vts, domain);
+	if (file)
 	{
-		case 0: return PyLong_FromLong(720);
-		case 1: return PyLong_FromLong(704);
-		case 2: return PyLong_FromLong(352);
-		case 3: return PyLong_FromLong(352);
-		default:
-			PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
-			return NULL;
+		size = DVDFileSize(file);
+		if (size >= 0)
+		{
+			// Ring is scratch space for NAV packs until the first read
+			ret = _Stream_buildExtents(&dvd->blockcache, PYDVD_BLOCKCACHE_KEY(vts, domain), file, size, cells, numcells, self->ring, &extents, &numextents);
+		}
 	}
-}
+	Py_END_ALLOW_THREADS
 
-static PyObject*
-Title_getHeight(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	self->file = file;
+	self->fileblocks = (int)(size > 0 ? size : 0);
+	self->extents = extents;
+	self->numextents = numextents;
+	if (numextents)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		self->blocks = (int)(extents[numextents-1].offset + extents[numextents-1].blocks);
 	}
 
+	_DVD_unlock(dvd);
 
-	char h = self->ifo->vtsi_mat->vts_video_attr.video_format;
-	switch(h)
+	if (file == NULL || size < 0)
 	{
-		case 0: return PyLong_FromLong(480);
-		case 1: return PyLong_FromLong(576);
-		case 3: return PyLong_FromLong(576);
-		default:
-			PyErr_SetString(PyExc_ValueError, "Invalid picture size value");
-			return NULL;
+		Py_DECREF(self);
+		PyErr_Format(PyExc_Exception, "Could not open file for VTS %d domain %d", vts, (int)domain);
+		return NULL;
 	}
-}
-
-static PyObject*
-Title_getPlaybackTime(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	if (ret == -1)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		Py_DECREF(self);
+		PyErr_Format(PyExc_IOError, "Could not read NAV packs of VTS %d", vts);
+		return NULL;
+	}
+	if (ret)
+	{
+		Py_DECREF(self);
+		PyErr_Format(PyExc_ValueError, "Cells are outside of VTS %d (%zd blocks) or out of memory", vts, size);
 		return NULL;
 	}
 
+	if (readahead && _Stream_startReadAhead(self))
+	{
+		Py_DECREF(self);
+		return NULL;
+	}
 
-	ifo_handle_t *zero = self->dvd->ifos[0];
-
-	pgcit_t *vts_pgcit = self->ifo->vts_pgcit;
-
-	int vts_ttn = zero->tt_srpt->title[self->titlenum-1].vts_ttn;
-
-	int pgcidx = self->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
+	return (PyObject*)self;
+}
 
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
+static void
+_Stream_stopHash(Stream *self)
+{
+	// Waits for what was read to be hashed and stops the workers, the digest is kept
+	Py_BEGIN_ALLOW_THREADS
+	pthread_mutex_lock(&self->hashlock);
+	pydvd_hasher_stop(&self->hasher);
+	self->hash = 0;
+	pthread_mutex_unlock(&self->hashlock);
+	Py_END_ALLOW_THREADS
+}
 
-	return PyLong_FromLong( dvdtimetoms( &pgc->playback_time ) );
+static void
+_Stream_hash(Stream *self, int pos, const unsigned char *buf, int blocks)
+{
+	// Called without the GIL and with the read lock held, so blocks are fed in the order they were read, with
+	// @blocks blocks of the stream read from @pos
+	pthread_mutex_lock(&self->hashlock);
+	if (self->hash)
+	{
+		pydvd_hasher_feed(&self->hasher, (uint64_t)pos * DVD_VIDEO_LB_LEN, buf, (size_t)blocks * DVD_VIDEO_LB_LEN);
+	}
+	pthread_mutex_unlock(&self->hashlock);
 }
 
-static PyObject*
-Title_getPlaybackTimeFancy(Title *self)
+static void
+_Stream_closeFile(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	// Thread reads through the file
+	_Stream_stopReadAhead(self);
+	_Stream_stopHash(self);
+
+	// Taken under the lock as DVD.Close() may be closing it on another thread
+	_DVD_lock(self->dvd);
+	dvd_file_t *file = self->file;
+	self->file = NULL;
+	if (file)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		DVDCloseFile(file);
 	}
+	_DVD_unlock(self->dvd);
+}
+
+static void
+Stream_dealloc(Stream *self)
+{
+	if (self->dvd)
+	{
+		_Stream_closeFile(self);
 
+		// Unlink from the DVD
+		_DVD_lock(self->dvd);
+		if (self->prev)
+		{
+			self->prev->next = self->next;
+		}
+		else
+		{
+			self->dvd->streams = self->next;
+		}
+		if (self->next)
+		{
+			self->next->prev = self->prev;
+		}
+		_DVD_unlock(self->dvd);
+	}
+	Py_CLEAR(self->dvd);
 
-	ifo_handle_t *zero = self->dvd->ifos[0];
+	_Stream_stopHash(self);
+	pthread_mutex_destroy(&self->hashlock);
+	pthread_mutex_destroy(&self->readlock);
+	pydvd_readahead_destroy(&self->ra);
+	free(self->ring);
+	self->ring = NULL;
+	free(self->extents);
+	self->extents = NULL;
+
+	PyTypeObject *type = Py_TYPE(self);
+	type->tp_free((PyObject*)self);
+	Py_DECREF(type);
+}
 
-	pgcit_t *vts_pgcit = self->ifo->vts_pgcit;
+static int
+_Stream_readLocked(Stream *self, unsigned char *buf, int maxblocks, int *slot)
+{
+	// _Stream_read() with the read lock held
+	if (self->readahead)
+	{
+		int got;
+		int failed = -1;
+		int pos = self->pos;
+		pydvd_readahead_t *ra = &self->ra;
 
-	int vts_ttn = zero->tt_srpt->title[self->titlenum-1].vts_ttn;
+		Py_BEGIN_ALLOW_THREADS
+		if (buf)
+		{
+			got = pydvd_readahead_copy(ra, buf, maxblocks, &failed);
+			if (got > 0)
+			{
+				_Stream_hash(self, pos, buf, got);
+			}
+		}
+		else
+		{
+			got = pydvd_readahead_lend(ra, maxblocks, slot, &failed);
+			if (got > 0)
+			{
+				_Stream_hash(self, pos, ra->ring + (size_t)*slot * DVD_VIDEO_LB_LEN, got);
+			}
+		}
+		Py_END_ALLOW_THREADS
 
-	int pgcidx = self->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
+		if (got > 0)
+		{
+			self->pos += got;
+			return got;
+		}
+		if (failed == PYDVD_READAHEAD_CLOSED)
+		{
+			PyErr_SetString(PyExc_ValueError, "Stream is closed");
+			return -1;
+		}
+		if (failed >= 0)
+		{
+			PyErr_Format(PyExc_IOError, "Could not read block %d of VTS %d", failed, self->vts);
+			return -1;
+		}
+		if (failed != PYDVD_READAHEAD_STOPPED)
+		{
+			return 0;
+		}
+		// Another thread turned read-ahead off, read directly
+	}
 
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
+	_DVD_lock(self->dvd);
 
-	return dvdtimetofancy( dvdtimetoms( &pgc->playback_time ), (pgc->playback_time.frame_u >> 6) );
-}
+	// Checked under the lock as DVD.Close() detaches the file while holding it
+	if (self->file == NULL)
+	{
+		_DVD_unlock(self->dvd);
+		PyErr_SetString(PyExc_ValueError, "Stream is closed");
+		return -1;
+	}
 
-static PyObject*
-Title_getNumberOfAngles(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	int n = self->blocks - self->pos;
+	if (n > maxblocks)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		n = maxblocks;
+	}
+	if (n <= 0)
+	{
+		_DVD_unlock(self->dvd);
+		return 0;
 	}
 
+	if (buf == NULL)
+	{
+		// Views handed out must be contiguous, so start over rather than split a read across the end
+		if (n > self->ringblocks)
+		{
+			n = self->ringblocks;
+		}
+		if (self->ringpos + n > self->ringblocks)
+		{
+			self->ringpos = 0;
+		}
+		*slot = self->ringpos;
+		buf = self->ring + (size_t)self->ringpos * DVD_VIDEO_LB_LEN;
+	}
 
-	return PyLong_FromLong( self->numangles );
-}
+	dvd_file_t *file = self->file;
+	int pos = self->pos;
+	int ext = self->curextent;
+	int got;
+	int failed = -1;
 
-static PyObject*
-Title_getNumberOfAudios(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
-	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+	Py_BEGIN_ALLOW_THREADS
+	got = _Stream_readBlocks(self, file, &ext, pos, n, buf, &failed);
+	if (got > 0)
+	{
+		_Stream_hash(self, pos, buf, got);
 	}
+	Py_END_ALLOW_THREADS
 
+	self->pos = pos + got;
+	self->curextent = ext;
+	if (slot)
+	{
+		self->ringpos += got;
+	}
 
-	return PyLong_FromLong( self->numaudios );
-}
+	_DVD_unlock(self->dvd);
 
-static PyObject*
-Title_getNumberOfSubpictures(Title *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	// Hand back what was read before a failure; the next read will raise at the failing block
+	if (got == 0 && failed >= 0)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		PyErr_Format(PyExc_IOError, "Could not read block %d of VTS %d", failed, self->vts);
+		return -1;
 	}
 
+	return got;
+}
 
-	return PyLong_FromLong( self->numsubpictures );
+static int
+_Stream_read(Stream *self, unsigned char *buf, int maxblocks, int *slot)
+{
+	// Reads up to @maxblocks blocks at the current position into @buf, or into the ring if @buf is NULL
+	// Returns the number read (zero at the end) and for the ring the block index in @slot, or -1 with an exception set
+	_Stream_lockRead(self);
+	int got = _Stream_readLocked(self, buf, maxblocks, slot);
+	_Stream_unlockRead(self);
+	return got;
 }
 
-static PyObject*
-Title_getNumberOfChapters(Title *self)
+static long
+_Stream_retryBad(Stream *self, int fd, int passes, unsigned char *blk, int *err)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	// Rereads every block of the stream not yet read in rescue mode one at a time, writing those that read to
+	// @fd at their stream offset. Runs without the GIL, taking the DVD lock for each block.
+	// Returns the number recovered; @err is set to an errno value if writing failed, or -1 if the file closed
+	DVD *dvd = self->dvd;
+	uint32_t key = PYDVD_BLOCKCACHE_KEY(self->vts, self->domain);
+	long recovered = 0;
+
+	for (int pass=0; pass < passes; pass++)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
-	}
+		for (int i=0; i < self->numextents; i++)
+		{
+			const pydvd_extent_t *x = &self->extents[i];
+			uint32_t block = x->first;
+			uint32_t end = x->first + x->blocks;
 
+			while (block < end)
+			{
+				pthread_mutex_lock(&dvd->lock);
+				if (self->file == NULL)
+				{
+					pthread_mutex_unlock(&dvd->lock);
+					*err = -1;
+					return recovered;
+				}
+
+				pydvd_rescue_map_t *map = _DVD_rescueMap(dvd, key, (uint32_t)self->fileblocks);
+				if (map == NULL)
+				{
+					pthread_mutex_unlock(&dvd->lock);
+					*err = ENOMEM;
+					return recovered;
+				}
+
+				uint32_t runend;
+				if (pydvd_rescue_status(map, block, &runend) == PYDVD_RESCUE_GOOD)
+				{
+					pthread_mutex_unlock(&dvd->lock);
+					block = (runend < end ? runend : end);
+					continue;
+				}
+
+				ssize_t r = pydvd_blockcache_read(&dvd->blockcache, self->file, key, (int)block, 1, blk);
+				pydvd_rescue_set(map, block, 1, (r == 1 ? PYDVD_RESCUE_GOOD : PYDVD_RESCUE_BAD));
+				if (r != 1)
+				{
+					dvd->rescuefailures++;
+				}
+				pthread_mutex_unlock(&dvd->lock);
+
+				if (r == 1)
+				{
+					off_t off = (off_t)(x->offset + (block - x->first)) * DVD_VIDEO_LB_LEN;
+					ssize_t w;
+					do
+					{
+						w = pwrite(fd, blk, DVD_VIDEO_LB_LEN, off);
+					} while (w < 0 && errno == EINTR);
+					if (w != DVD_VIDEO_LB_LEN)
+					{
+						*err = (w < 0 ? errno : ENOSPC);
+						return recovered;
+					}
+					recovered++;
+				}
+
+				block++;
+			}
+		}
+	}
 
-	return PyLong_FromLong( self->numchapters );
+	return recovered;
 }
 
-
-
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Interface stuff for Stream
 
 static PyObject*
-Title_GetAudio(Title *self, PyObject *args)
+Stream_ReadInto(Stream *self, PyObject *const *args, Py_ssize_t nargs)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
-	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
-	}
-
-	int audionum;
+	Py_buffer view;
 
-	if (! PyArg_ParseTuple(args, "i", &audionum))
+	if (nargs != 1)
 	{
+		PyErr_Format(PyExc_TypeError, "ReadInto() takes exactly 1 argument (%zd given)", nargs);
 		return NULL;
 	}
-
-	// Bounds check
-	if (audionum < 1)
+	if (PyObject_GetBuffer(args[0], &view, PyBUF_WRITABLE) < 0)
 	{
-		PyErr_Format(PyExc_ValueError, "Audio track must be positive (%d)", audionum);
 		return NULL;
 	}
-	if (audionum > self->numaudios)
+
+	int maxblocks = (int)(view.len / DVD_VIDEO_LB_LEN < INT_MAX ? view.len / DVD_VIDEO_LB_LEN : INT_MAX);
+	if (maxblocks < 1)
 	{
-		PyErr_Format(PyExc_ValueError, "Audio track too large (%d > %d)", audionum, self->numaudios);
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "Buffer must hold at least one block (%zd < %d)", view.len, DVD_VIDEO_LB_LEN);
 		return NULL;
 	}
 
-	PyObject *a = Py_BuildValue("Oi", self, audionum);
-	if (a == NULL)
+	// Buffer stays exported until released, so it's safe to fill without the GIL
+	int got = _Stream_read(self, (unsigned char*)view.buf, maxblocks, NULL);
+	PyBuffer_Release(&view);
+	if (got < 0)
 	{
 		return NULL;
 	}
 
-	return PyObject_CallObject(self->AudioClass, a);
+	return PyLong_FromSsize_t((Py_ssize_t)got * DVD_VIDEO_LB_LEN);
 }
 
 static PyObject*
-Title_GetChapter(Title *self, PyObject *args)
+Stream_Read(Stream *self, PyObject *const *args, Py_ssize_t nargs)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	int blocks = -1;
+
+	if (ParseIntArgs("Read", args, nargs, 0, 1, &blocks))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
-
-
-	int chapternum;
-
-	if (! PyArg_ParseTuple(args, "i", &chapternum))
+	if (blocks < 0)
 	{
-		return NULL;
+		blocks = self->ringblocks;
 	}
 
-	// Bounds check
-	if (chapternum < 1)
+	int slot = 0;
+	int got = _Stream_read(self, NULL, blocks, &slot);
+	if (got < 0)
 	{
-		PyErr_Format(PyExc_ValueError, "Chapter must be positive (%d)", chapternum);
 		return NULL;
 	}
-	if (chapternum > self->numchapters)
+
+	// Slice of a memoryview over the ring keeps this stream (and so the ring) alive
+	PyObject *ring = PyMemoryView_FromObject((PyObject*)self);
+	if (ring == NULL)
 	{
-		PyErr_Format(PyExc_ValueError, "Chapter track too large (%d > %d)", chapternum, self->numchapters);
 		return NULL;
 	}
 
-	int startcell, endcell, lenms=0;
-	PyObject *lenfancy = NULL;
-
-
-	ifo_handle_t *zero = self->dvd->ifos[0];
-	pgcit_t *vts_pgcit = self->ifo->vts_pgcit;
-	int vts_ttn = zero->tt_srpt->title[self->titlenum-1].vts_ttn;
-	int pgcidx = self->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
-
-	// Start and end cells are easy
-	startcell = pgc->program_map[ chapternum-1 ];
+	PyObject *ret = PySequence_GetSlice(ring, (Py_ssize_t)slot * DVD_VIDEO_LB_LEN, (Py_ssize_t)(slot + got) * DVD_VIDEO_LB_LEN);
+	Py_DECREF(ring);
+	return ret;
+}
 
-	if (chapternum == self->numchapters)
-	{
-		endcell = pgc->nr_of_cells;
-	}
-	else
-	{
-		endcell = pgc->program_map[ chapternum-1 + 1] - 1;
-	}
+static PyObject*
+Stream_Seek(Stream *self, PyObject *const *args, Py_ssize_t nargs)
+{
+	int block = 0;
 
-	// It's possible that the endcell can be calculated to be negative...so just assume zero???
-	if (endcell < 0)
+	if (ParseIntArgs("Seek", args, nargs, 1, 1, &block))
 	{
-		endcell = 0;
+		return NULL;
 	}
-
-	// Length requires iterating over cells
-	lenms = 0;
-	for (int i=startcell; i <= endcell; i++)
+	if (block < 0 || block > self->blocks)
 	{
-		lenms += dvdtimetoms( &pgc->cell_playback[i-1].playback_time );
+		PyErr_Format(PyExc_ValueError, "Block out of range (%d not in 0 to %d)", block, self->blocks);
+		return NULL;
 	}
-	lenfancy = dvdtimetofancy( lenms, (pgc->cell_playback[startcell-1].playback_time.frame_u >> 6) );
 
-
-	PyObject *a = Py_BuildValue("OiiilO", self, chapternum, startcell, endcell, lenms, lenfancy);
-	if (a == NULL)
+	// Not while a read is using the position, and no read between moving it and restarting read-ahead
+	_Stream_lockRead(self);
+	_DVD_lock(self->dvd);
+	self->pos = block;
+	self->rescueskip = 0;
+	self->rescuefailures = 0;
+	_DVD_unlock(self->dvd);
+
+	// Buffered blocks are for the old position
+	int failed = (self->readahead && _Stream_startReadAhead(self));
+	_Stream_unlockRead(self);
+	if (failed)
 	{
 		return NULL;
 	}
 
-	return PyObject_CallObject(self->ChapterClass, a);
+	return PyLong_FromLong(block);
 }
 
 static PyObject*
-Title_GetSubpicture(Title *self, PyObject *args)
+Stream_RetryBad(Stream *self, PyObject *args, PyObject *kwds)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->dvd))
+	PyObject *out = NULL;
+	int passes = 1;
+	static char *kwlist[] = {"file", "passes", NULL};
+
+	if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|i", kwlist, &out, &passes))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
-
-
-	int subpicturenum;
-
-	if (! PyArg_ParseTuple(args, "i", &subpicturenum))
+	if (passes < 1)
 	{
+		PyErr_Format(PyExc_ValueError, "passes must be at least one (%d)", passes);
 		return NULL;
 	}
-
-	// Bounds check
-	if (subpicturenum < 1)
+	if (self->file == NULL)
 	{
-		PyErr_Format(PyExc_ValueError, "Subpicture track must be positive (%d)", subpicturenum);
+		PyErr_SetString(PyExc_ValueError, "Stream is closed");
 		return NULL;
 	}
-	if (subpicturenum > self->numsubpictures)
+
+	// Blocks are written underneath a Python file object, so push out what it has buffered first
+	if (!PyLong_Check(out) && PyObject_HasAttrString(out, "flush"))
 	{
-		PyErr_Format(PyExc_ValueError, "Subpicture track too large (%d > %d)", subpicturenum, self->numsubpictures);
-		return NULL;
+		PyObject *r = PyObject_CallMethod(out, "flush", NULL);
+		if (r == NULL)
+		{
+			return NULL;
+		}
+		Py_DECREF(r);
 	}
 
-	PyObject *a = Py_BuildValue("Oi", self, subpicturenum);
-	if (a == NULL)
+	int fd = PyObject_AsFileDescriptor(out);
+	if (fd < 0)
 	{
 		return NULL;
 	}
 
-	return PyObject_CallObject(self->SubpictureClass, a);
-}
-
-
-
+	unsigned char *blk;
+	if (posix_memalign((void**)&blk, 4096, DVD_VIDEO_LB_LEN))
+	{
+		return PyErr_NoMemory();
+	}
 
-static PyMemberDef Title_members[] = {
-	{NULL}
-};
+	long recovered;
+	int err = 0;
+	Py_BEGIN_ALLOW_THREADS
+	recovered = _Stream_retryBad(self, fd, passes, blk, &err);
+	Py_END_ALLOW_THREADS
 
-static PyMethodDef Title_methods[] = {
-	{"GetAudio", (PyCFunction)Title_GetAudio, METH_VARARGS, "Gets the specified audio track of this title"},
-	{"GetChapter", (PyCFunction)Title_GetChapter, METH_VARARGS, "Gets the specified chapter of this title"},
-	{"GetSubpicture", (PyCFunction)Title_GetSubpicture, METH_VARARGS, "Gets the specified subpicture of this title"},
-	{NULL}
-};
+	free(blk);
 
-static PyGetSetDef Title_getseters[] = {
-	{"DVD", (getter)Title_getDVD, NULL, "Gets the DVD this title is associated with", NULL},
-	{"AspectRatio", (getter)Title_getAspectRatio, NULL, "Gets the aspect ratio", NULL},
-	{"FrameRate", (getter)Title_getFrameRate, NULL, "Gets the frame rate", NULL},
-	{"PlaybackTime", (getter)Title_getPlaybackTime, NULL, "Gets the playback time in milliseconds", NULL},
-	{"PlaybackTimeFancy", (getter)Title_getPlaybackTimeFancy, NULL, "Gets the playback time in fancy HH:MM:SS.FF string format", NULL},
-	{"TitleNum", (getter)Title_getTitleNum, NULL, "Gets the number associated with this Title", NULL},
-	{"Width", (getter)Title_getWidth, NULL, "Gets the width of the video in pixels", NULL},
-	{"Height", (getter)Title_getHeight, NULL, "Gets the height of the video in pixels", NULL},
-	{"NumberOfAngles", (getter)Title_getNumberOfAngles, NULL, "Gets the number of angles in this title", NULL},
-	{"NumberOfAudios", (getter)Title_getNumberOfAudios, NULL, "Gets the number of audio tracks in this title", NULL},
-	{"NumberOfChapters", (getter)Title_getNumberOfChapters, NULL, "Gets the number of chapters in this title", NULL},
-	{"NumberOfSubpictures", (getter)Title_getNumberOfSubpictures, NULL, "Gets the number of subpictures in this title", NULL},
-	{NULL}
-};
+	if (err == -1)
+	{
+		PyErr_SetString(PyExc_ValueError, "Stream is closed");
+		return NULL;
+	}
+	if (err)
+	{
+		errno = err;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Administrative functions for Audio
+	return PyLong_FromLong(recovered);
+}
 
 static PyObject*
-Audio_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+Stream_Close(Stream *self)
 {
-	Audio *self;
-
-	self = (Audio*)type->tp_alloc(type, 0);
-	if (self != NULL)
-	{
-		self->audionum = 0;
-		self->audio = NULL;
+	_Stream_closeFile(self);
 
-		self->title = NULL;
-	}
+	Py_INCREF(Py_None);
+	return Py_None;
+}
 
+static PyObject*
+Stream_enter(Stream *self)
+{
+	Py_INCREF(self);
 	return (PyObject*)self;
 }
 
-static int
-Audio_init(Audio *self, PyObject *args, PyObject *kwds)
+static PyObject*
+Stream_exit(Stream *self, PyObject *const *args, Py_ssize_t nargs)
 {
-	PyObject *_title=NULL, *tmp;
-	int audionum=0;
-	static char *kwlist[] = {"Title", "AudioNum", NULL};
+	_Stream_closeFile(self);
 
-	// Parse arguments
-	if (! PyArg_ParseTupleAndKeywords(args,kwds, "Oi", kwlist, &_title, &audionum))
-	{
-		return -1;
-	}
+	// Don't suppress any exceptions
+	Py_INCREF(Py_False);
+	return Py_False;
+}
 
-	// Ensure Title is correct type
-	if (! PyObject_TypeCheck(_title, &TitleType))
-	{
-		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
-		return -1;
-	}
-	Title *title = (Title*)_title;
+static PyObject*
+Stream_getDVD(Stream *self)
+{
+	Py_INCREF(self->dvd);
+	return (PyObject*)self->dvd;
+}
 
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(title->dvd))
-	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return -1;
-	}
+static PyObject*
+Stream_getIsOpen(Stream *self)
+{
+	return PyBool_FromLong(self->file != NULL);
+}
 
+static PyObject*
+Stream_getVTS(Stream *self)
+{
+	return PyLong_FromLong(self->vts);
+}
 
+static PyObject*
+Stream_getDomain(Stream *self)
+{
+	return PyLong_FromLong(self->domain);
+}
 
-	// Bounds check on audionum
-	if (audionum < 0)
-	{
-		PyErr_Format(PyExc_ValueError, "Audio number cannot be negative (%d)", audionum);
-		return -1;
-	}
-	if (audionum > title->numaudios)
+static PyObject*
+Stream_getFirstBlock(Stream *self)
+{
+	return PyLong_FromLong(self->numextents ? (long)self->extents[0].first : 0);
+}
+
+static PyObject*
+Stream_getExtents(Stream *self)
+{
+	PyObject *ret = PyTuple_New(self->numextents);
+	if (ret == NULL)
 	{
-		PyErr_Format(PyExc_ValueError, "Audio number is too large (%d > %d)", audionum, title->numaudios);
-		return -1;
+		return NULL;
 	}
-	self->audionum = audionum;
-
-
-	ifo_handle_t *zero = title->dvd->ifos[0];
-	pgcit_t *vts_pgcit = title->ifo->vts_pgcit;
-	int vts_ttn = zero->tt_srpt->title[title->titlenum-1].vts_ttn;
-	int pgcidx = title->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
 
-	// Get audio_attr_t*
-	self->audio = NULL;
-	for (int i=0; i < title->ifo->vtsi_mat->nr_of_vts_audio_streams; i++)
+	for (int i=0; i < self->numextents; i++)
 	{
-		if (pgc->audio_control[i] & 0x8000)
+		PyObject *e = Py_BuildValue("(II)", self->extents[i].first, self->extents[i].blocks);
+		if (e == NULL)
 		{
-			audionum--;
-			if (audionum == 0)
-			{
-				self->audio = &title->ifo->vtsi_mat->vts_audio_attr[i];
-				break;
-			}
+			Py_DECREF(ret);
+			return NULL;
 		}
+		PyTuple_SET_ITEM(ret, i, e);
 	}
 
+	return ret;
+}
 
-
-	// Assign Title object
-	tmp = (PyObject*)self->title;
-	Py_INCREF(title);
-	self->title = title;
-	Py_CLEAR(tmp);
-
-	return 0;
+static PyObject*
+Stream_getBlocks(Stream *self)
+{
+	return PyLong_FromLong(self->blocks);
 }
 
-static void
-Audio_dealloc(Audio *self)
+static PyObject*
+Stream_getPosition(Stream *self)
 {
-	self->audionum = 0;
+	return PyLong_FromLong(self->pos);
+}
 
-	Py_CLEAR(self->title);
-	self->audio = NULL;
+static PyObject*
+Stream_getRingBlocks(Stream *self)
+{
+	return PyLong_FromLong(self->ringblocks);
+}
 
-	Py_TYPE(self)->tp_free((PyObject*)self);
+static PyObject*
+Stream_getReadAhead(Stream *self)
+{
+	return PyBool_FromLong(self->readahead);
 }
 
+static int
+Stream_setReadAhead(Stream *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
+	{
+		PyErr_SetString(PyExc_TypeError, "Cannot delete ReadAhead");
+		return -1;
+	}
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Interface stuff for Audio
+	int on = PyObject_IsTrue(value);
+	if (on < 0)
+	{
+		return -1;
+	}
 
-static PyObject*
-Audio_getTitle(Audio *self)
-{
-	return (PyObject*)self->title;
+	// Switched between reads, which either buffer from the position they leave or read it directly
+	int ret = 0;
+	_Stream_lockRead(self);
+	if (!on)
+	{
+		_Stream_stopReadAhead(self);
+	}
+	else if (!self->readahead)
+	{
+		ret = _Stream_startReadAhead(self);
+	}
+	_Stream_unlockRead(self);
+	return ret;
 }
 
+static PyStructSequence_Field ReadAheadStats_fields[] = {
+	{"Capacity", "Blocks the ring holds"},
+	{"Fill", "Blocks buffered ahead of the consumer"},
+	{"Reads", "Reads issued by the read-ahead thread"},
+	{"Blocks", "Blocks read by the read-ahead thread"},
+	{"ReadTime", "Seconds spent in reads"},
+	{"Stalls", "Times a read found the ring empty and waited for the drive"},
+	{"StallTime", "Seconds reads waited for the drive"},
+	{"FullWaits", "Times the read-ahead thread found the ring full and waited for the consumer"},
+	{"IdleTime", "Seconds the drive was left idle because the ring was full"},
+	{NULL}
+};
+
+static PyStructSequence_Desc ReadAheadStats_desc = {
+	"_dvdread.ReadAheadStats",
+	"Read-ahead counters of a Stream, cumulative across Seek() and ReadAhead being turned off and on",
+	ReadAheadStats_fields,
+	9
+};
+
 static PyObject*
-Audio_getLangCode(Audio *self)
+Stream_getReadAheadStats(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	pydvd_readahead_stats_t stats;
+	pydvd_readahead_t *ra = &self->ra;
+
+	// Brief lock, the thread only holds it between reads
+	Py_BEGIN_ALLOW_THREADS
+	pydvd_readahead_getstats(ra, &stats);
+	Py_END_ALLOW_THREADS
+
+	PyObject *ret = PyStructSequence_New(self->dvd->state->ReadAheadStatsType);
+	if (ret == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
 
-
-	char a = self->audio->lang_code >> 8;
-	char b = self->audio->lang_code & 0xFF;
-
-	// I guess this means "hidden" or something
-	if (a == -1 && b == -1)
+	PyObject *vals[9];
+	vals[0] = PyLong_FromLong(self->ringblocks);
+	vals[1] = PyLong_FromLong(stats.fill);
+	vals[2] = PyLong_FromUnsignedLongLong(stats.reads);
+	vals[3] = PyLong_FromUnsignedLongLong(stats.blocks);
+	vals[4] = PyFloat_FromDouble(stats.readtime);
+	vals[5] = PyLong_FromUnsignedLongLong(stats.stalls);
+	vals[6] = PyFloat_FromDouble(stats.stalltime);
+	vals[7] = PyLong_FromUnsignedLongLong(stats.fullwaits);
+	vals[8] = PyFloat_FromDouble(stats.idletime);
+
+	for (int i=0; i < 9; i++)
 	{
-		Py_INCREF(Py_None);
-		return Py_None;
+		if (vals[i] == NULL)
+		{
+			for (int j=0; j < 9; j++)
+			{
+				Py_XDECREF(vals[j]);
+			}
+			Py_DECREF(ret);
+			return NULL;
+		}
+	}
+	for (int i=0; i < 9; i++)
+	{
+		PyStructSequence_SET_ITEM(ret, i, vals[i]);
 	}
 
-	return PyUnicode_FromFormat("%c%c", a, b);
+	return ret;
 }
 
+static PyStructSequence_Field Digest_fields[] = {
+	{"Name", "VIDEO_TS file name, None for a whole image or stream"},
+	{"Offset", "Byte offset in the image or stream the digest starts at"},
+	{"Size", "Bytes hashed"},
+	{"SHA256", "SHA-256 digest as bytes"},
+	{"XXH64", "XXH64 digest (seed zero) as an integer"},
+	{NULL}
+};
+
+static PyStructSequence_Desc Digest_desc = {
+	"_dvdread.Digest",
+	"Digests computed while reading an image or stream",
+	Digest_fields,
+	5
+};
+
 static PyObject*
-Audio_getLanguage(Audio *self)
+_Digest_new(ModuleState_t *st, const pydvd_digest_t *d)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	// None if part of the range was skipped
+	if (d->broken)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	PyObject *ret = PyStructSequence_New(st->DigestType);
+	if (ret == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
 
+	PyObject *vals[5];
+	if (d->name[0])
+	{
+		vals[0] = PyUnicode_FromString(d->name);
+	}
+	else
+	{
+		Py_INCREF(Py_None);
+		vals[0] = Py_None;
+	}
+	vals[1] = PyLong_FromUnsignedLongLong(d->offset);
+	vals[2] = PyLong_FromUnsignedLongLong(d->hashed);
+	vals[3] = PyBytes_FromStringAndSize((const char*)d->sha256, sizeof(d->sha256));
+	vals[4] = PyLong_FromUnsignedLongLong(d->xxh64);
+
+	for (int i=0; i < 5; i++)
+	{
+		if (vals[i] == NULL)
+		{
+			for (int j=0; j < 5; j++)
+			{
+				Py_XDECREF(vals[j]);
+			}
+			Py_DECREF(ret);
+			return NULL;
+		}
+	}
+	for (int i=0; i < 5; i++)
+	{
+		PyStructSequence_SET_ITEM(ret, i, vals[i]);
+	}
 
-	return LangCodeToName(self->audio->lang_code);
+	return ret;
 }
 
 static PyObject*
-Audio_getFormat(Audio *self)
+Stream_getHash(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	return PyBool_FromLong(self->hash);
+}
+
+static int
+Stream_setHash(Stream *self, PyObject *value, void *closure)
+{
+	if (value == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		PyErr_SetString(PyExc_TypeError, "Cannot delete Hash");
+		return -1;
 	}
 
+	int on = PyObject_IsTrue(value);
+	if (on < 0)
+	{
+		return -1;
+	}
+
+	if (!on)
+	{
+		_Stream_stopHash(self);
+		return 0;
+	}
 
-	switch(self->audio->audio_format)
+	// Starts over from the current position, which no read moves meanwhile
+	_Stream_lockRead(self);
+	int pos = self->pos;
+	int e = 0;
+	Py_BEGIN_ALLOW_THREADS
+	pthread_mutex_lock(&self->hashlock);
+	if (!self->hash)
 	{
-		case 0: return PyUnicode_FromString("AC3");
-		case 2: return PyUnicode_FromString("MPEG1");
-		case 3: return PyUnicode_FromString("MPEG2");
-		case 4: return PyUnicode_FromString("LPCM");
-		case 5: return PyUnicode_FromString("SDDS");
-		case 6: return PyUnicode_FromString("DTS");
+		pydvd_digest_init(&self->digest, NULL, (uint64_t)pos * DVD_VIDEO_LB_LEN, UINT64_MAX);
+		e = pydvd_hasher_start(&self->hasher, &self->digest, 1);
+		self->hash = (e == 0);
+		self->hasdigest = (e == 0);
 	}
+	pthread_mutex_unlock(&self->hashlock);
+	Py_END_ALLOW_THREADS
+	_Stream_unlockRead(self);
 
-	return PyUnicode_FromString("?");
+	if (e)
+	{
+		errno = e;
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+	return 0;
 }
 
 static PyObject*
-Audio_getSamplingRate(Audio *self)
+Stream_getDigest(Stream *self)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	pydvd_digest_t d;
+	int has;
+
+	Py_BEGIN_ALLOW_THREADS
+	pthread_mutex_lock(&self->hashlock);
+	has = self->hasdigest;
+	if (has)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		pydvd_hasher_sync(&self->hasher);
+		pydvd_hasher_get(&self->hasher, 0, &d);
 	}
+	pthread_mutex_unlock(&self->hashlock);
+	Py_END_ALLOW_THREADS
 
+	if (!has)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+	return _Digest_new(self->dvd->state, &d);
+}
 
-	// Apparently it's either 48kHz or 48kHz
-	return PyUnicode_FromString("48000");
+static int
+Stream_getbuffer(Stream *self, Py_buffer *view, int flags)
+{
+	// Exports the whole ring read-only; Read() hands out slices of it
+	return PyBuffer_FillInfo(view, (PyObject*)self, self->ring, (Py_ssize_t)self->ringblocks * DVD_VIDEO_LB_LEN, 1, flags);
 }
 
+static PyMethodDef Stream_methods[] = {
+	{"ReadInto", (PyCFunction)Stream_ReadInto, METH_FASTCALL, "Reads as many whole blocks as fit into a writable buffer, returns the number of bytes read (zero at the end)"},
+	{"readinto", (PyCFunction)Stream_ReadInto, METH_FASTCALL, "Same as ReadInto()"},
+	{"Read", (PyCFunction)Stream_Read, METH_FASTCALL, "Reads up to the given number of blocks (default RingBlocks) and returns a read-only memoryview over the internal ring, overwritten by later reads once the ring wraps around (with ReadAhead, after the next read)"},
+	{"Seek", (PyCFunction)Stream_Seek, METH_FASTCALL, "Sets the block of the stream to read next"},
+	{"RetryBad", (PyCFunction)Stream_RetryBad, METH_VARARGS|METH_KEYWORDS, "Rereads the stream's blocks not yet read in rescue mode one at a time, over the given number of passes, writing those that read into file (object or descriptor) at their stream offset; returns the number recovered"},
+	{"Close", (PyCFunction)Stream_Close, METH_NOARGS, "Closes the file"},
+	{"__enter__", (PyCFunction)Stream_enter, METH_NOARGS, NULL},
+	{"__exit__", (PyCFunction)Stream_exit, METH_FASTCALL, NULL},
+	{NULL}
+};
 
+static PyGetSetDef Stream_getseters[] = {
+	{"DVD", (getter)Stream_getDVD, NULL, "Gets the DVD this stream reads from", NULL},
+	{"IsOpen", (getter)Stream_getIsOpen, NULL, "Gets flag indicating if the file is open (DVD.Close() closes it too)", NULL},
+	{"VTS", (getter)Stream_getVTS, NULL, "Gets the title set number", NULL},
+	{"Domain", (getter)Stream_getDomain, NULL, "Gets the file domain (one of the READ_* constants)", NULL},
+	{"FirstBlock", (getter)Stream_getFirstBlock, NULL, "Gets the block of the file the stream starts at", NULL},
+	{"Extents", (getter)Stream_getExtents, NULL, "Gets the (first block, number of blocks) runs of the file read in order", NULL},
+	{"Blocks", (getter)Stream_getBlocks, NULL, "Gets the number of blocks in the stream", NULL},
+	{"Position", (getter)Stream_getPosition, NULL, "Gets the block of the stream to be read next", NULL},
+	{"RingBlocks", (getter)Stream_getRingBlocks, NULL, "Gets the size in blocks of the ring Read() returns views of", NULL},
+	{"ReadAhead", (getter)Stream_getReadAhead, (setter)Stream_setReadAhead, "Gets or sets flag indicating if a thread keeps the ring filled ahead of reads", NULL},
+	{"ReadAheadStats", (getter)Stream_getReadAheadStats, NULL, "Gets the ReadAheadStats of the read-ahead thread", NULL},
+	{"Hash", (getter)Stream_getHash, (setter)Stream_setHash, "Gets or sets flag indicating if blocks read are hashed (SHA-256 and XXH64) on worker threads; setting it starts over from the current position", NULL},
+	{"Digest", (getter)Stream_getDigest, NULL, "Gets the Digest of the blocks read since Hash was set, None if never set or if the reads skipped around", NULL},
+	{NULL}
+};
 
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Fully define PyObject types now
+//
+// Made into heap types of each module object by its exec function
+
+static PyType_Slot DVD_slots[] = {
+	{Py_tp_dealloc, DVD_dealloc},
+	{Py_tp_iter, DVD_iter},
+	{Py_sq_length, DVD_length},
+	{Py_sq_item, DVD_item},
+	{Py_mp_length, DVD_length},
+	{Py_mp_subscript, DVD_subscript},
+	{Py_tp_doc, "Represents dvd_reader_t* from libdvdread"},
+	{Py_tp_methods, DVD_methods},
+	{Py_tp_members, DVD_members},
+	{Py_tp_getset, DVD_getseters},
+	{Py_tp_init, DVD_init},
+	{Py_tp_new, DVD_new},
+	{0, NULL}
+};
 
+static PyType_Spec DVD_spec = {
+	"_dvdread.DVD",
+	sizeof(DVD),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	DVD_slots
+};
 
-static PyMemberDef Audio_members[] = {
-	{NULL}
+static PyType_Slot Title_slots[] = {
+	{Py_tp_dealloc, Title_dealloc},
+	{Py_tp_iter, Title_iter},
+	{Py_sq_length, Title_length},
+	{Py_sq_item, Title_item},
+	{Py_mp_length, Title_length},
+	{Py_mp_subscript, Title_subscript},
+	{Py_tp_doc, "Represents a DVD title from libdvdread"},
+	{Py_tp_methods, Title_methods},
+	{Py_tp_members, Title_members},
+	{Py_tp_getset, Title_getseters},
+	{Py_tp_init, Title_init},
+	{Py_tp_new, Title_new},
+	{0, NULL}
 };
 
-static PyMethodDef Audio_methods[] = {
-	{NULL}
+static PyType_Spec Title_spec = {
+	"_dvdread.Title",
+	sizeof(Title),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	Title_slots
 };
 
-static PyGetSetDef Audio_getseters[] = {
-	{"Title", (getter)Audio_getTitle, NULL, "Gets the title this track is associated with", NULL},
-	{"Format", (getter)Audio_getFormat, NULL, "Gets the format", NULL},
-	{"LangCode", (getter)Audio_getLangCode, NULL, "Gets the language code", NULL},
-	{"Language", (getter)Audio_getLanguage, NULL, "Gets the language", NULL},
-	{"SamplingRate", (getter)Audio_getSamplingRate, NULL, "Gets the sampling rate", NULL},
-	{NULL}
+static PyType_Slot Audio_slots[] = {
+	{Py_tp_dealloc, Audio_dealloc},
+	{Py_tp_doc, "Audio(Title, AudioNum)\n--\n\nRepresents a DVD audio track from libdvdread"},
+	{Py_tp_methods, Audio_methods},
+	{Py_tp_members, Audio_members},
+	{Py_tp_getset, Audio_getseters},
+	{Py_tp_init, Audio_init},
+	{Py_tp_new, Audio_new},
+	{0, NULL}
 };
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Administrative functions for Chapter
+static PyType_Spec Audio_spec = {
+	"_dvdread.Audio",
+	sizeof(Audio),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	Audio_slots
+};
 
-static PyObject*
-Chapter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
-{
-	Chapter *self;
+static PyType_Slot Chapter_slots[] = {
+	{Py_tp_dealloc, Chapter_dealloc},
+	{Py_tp_doc, "Chapter(Title, ChapterNum, StartCell, EndCell, LenMS, LenFancy)\n--\n\nRepresents a DVD chapter from libdvdread"},
+	{Py_tp_methods, Chapter_methods},
+	{Py_tp_members, Chapter_members},
+	{Py_tp_getset, Chapter_getseters},
+	{Py_tp_init, Chapter_init},
+	{Py_tp_new, Chapter_new},
+	{0, NULL}
+};
 
-	self = (Chapter*)type->tp_alloc(type, 0);
-	if (self != NULL)
-	{
-		self->chapternum = 0;
+static PyType_Spec Chapter_spec = {
+	"_dvdread.Chapter",
+	sizeof(Chapter),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	Chapter_slots
+};
 
-		self->title = NULL;
+static PyType_Slot Subpicture_slots[] = {
+	{Py_tp_dealloc, Subpicture_dealloc},
+	{Py_tp_doc, "Subpicture(Title, SubpictureNum)\n--\n\nRepresents a DVD subpicture (aka subtitle) from libdvdread"},
+	{Py_tp_methods, Subpicture_methods},
+	{Py_tp_members, Subpicture_members},
+	{Py_tp_getset, Subpicture_getseters},
+	{Py_tp_init, Subpicture_init},
+	{Py_tp_new, Subpicture_new},
+	{0, NULL}
+};
 
-		self->startcell = 0;
-		self->endcell = 0;
+static PyType_Spec Subpicture_spec = {
+	"_dvdread.Subpicture",
+	sizeof(Subpicture),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+	Subpicture_slots
+};
 
-		self->lenms = 0;
+static PyType_Slot Stream_slots[] = {
+	{Py_tp_dealloc, Stream_dealloc},
+	{Py_tp_doc, "Represents dvd_file_t* from libdvdread, created by DVD.OpenFile() and Title.OpenStream()"},
+	{Py_tp_methods, Stream_methods},
+	{Py_tp_getset, Stream_getseters},
+	{Py_bf_getbuffer, Stream_getbuffer},
+	{0, NULL}
+};
+
+static PyType_Spec Stream_spec = {
+	"_dvdread.Stream",
+	sizeof(Stream),
+	0,
+	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_DISALLOW_INSTANTIATION,
+	Stream_slots
+};
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Volume descriptors
+
+static PyStructSequence_Field VolumeInfo_fields[] = {
+	{"VolumeID", "ISO9660 volume identifier, None if there is no ISO9660 file system"},
+	{"VolumeSetID", "ISO9660 volume set identifier"},
+	{"BlockSize", "ISO9660 logical block size"},
+	{"Blocks", "ISO9660 volume space size in blocks"},
+	{"Size", "Size of the image file or device in bytes, None if unknown"},
+	{"UDFLabel", "UDF logical volume identifier, None if there is no UDF file system"},
+	{"UDFVolumeSetID", "UDF volume set identifier"},
+	{"UDFUUID", "UUID derived from the UDF volume set identifier the same as blkid"},
+	{"UDFBlockSize", "UDF logical block size"},
+	{NULL}
+};
+
+static PyStructSequence_Desc VolumeInfo_desc = {
+	"_dvdread.VolumeInfo",
+	"Volume descriptor information read by ReadVolumeInfo()",
+	VolumeInfo_fields,
+	9
+};
 
+static PyObject*
+_VolumeInfo_string(int present, const char *str)
+{
+	if (!present)
+	{
 		Py_INCREF(Py_None);
-		self->lenfancy = Py_None;
+		return Py_None;
 	}
 
-	return (PyObject*)self;
+	return PyUnicode_DecodeUTF8(str, strlen(str), "replace");
 }
 
-static int
-Chapter_init(Chapter *self, PyObject *args, PyObject *kwds)
+static PyObject*
+_VolumeInfo_long(int present, unsigned long long val)
 {
-	PyObject *_title=NULL, *tmp;
-	int chapternum=0, start=0, end=0;
-	long lenms=0;
-	PyObject *lenfancy=NULL;
-	static char *kwlist[] = {"Title", "ChapterNum", "StartCell", "EndCell", "LenMS", "LenFancy", NULL};
-
-	// Parse arguments
-	if (! PyArg_ParseTupleAndKeywords(args,kwds, "OiiilO", kwlist, &_title, &chapternum, &start, &end, &lenms, &lenfancy))
+	if (!present)
 	{
-		return -1;
+		Py_INCREF(Py_None);
+		return Py_None;
 	}
 
-	// Ensure Title is correct type
-	if (! PyObject_TypeCheck(_title, &TitleType))
-	{
-		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
-		return -1;
-	}
-	Title *title = (Title*)_title;
+	return PyLong_FromUnsignedLongLong(val);
+}
 
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(title->dvd))
+static PyObject*
+ReadVolumeInfo(PyObject *module, PyObject *args)
+{
+	PyObject *opath = NULL;
+	if (!PyArg_ParseTuple(args, "O&", PyUnicode_FSConverter, &opath))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return -1;
+		return NULL;
 	}
 
+	pydvd_volume_t vol;
+	int ret;
 
+	Py_BEGIN_ALLOW_THREADS
+	ret = pydvd_volume_read(PyBytes_AS_STRING(opath), &vol);
+	Py_END_ALLOW_THREADS
 
-	// Bounds check on chapternum
-	if (chapternum < 0)
+	if (ret)
 	{
-		PyErr_Format(PyExc_ValueError, "Chapter number cannot be negative (%d)", chapternum);
-		return -1;
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, PyBytes_AS_STRING(opath));
+		Py_DECREF(opath);
+		return NULL;
 	}
-	if (chapternum > title->numchapters)
+	Py_DECREF(opath);
+
+	ModuleState_t *st = (ModuleState_t*)PyModule_GetState(module);
+	PyObject *ret_info = PyStructSequence_New(st->VolumeInfoType);
+	if (ret_info == NULL)
 	{
-		PyErr_Format(PyExc_ValueError, "Chapter number is too large (%d > %d)", chapternum, title->numchapters);
-		return -1;
+		return NULL;
 	}
-	self->chapternum = chapternum;
 
-	// Bounds check on start
-	if (start < 0)
+	PyObject *vals[9];
+	vals[0] = _VolumeInfo_string(vol.iso, vol.volumeid);
+	vals[1] = _VolumeInfo_string(vol.iso, vol.volumesetid);
+	vals[2] = _VolumeInfo_long(vol.iso, vol.blocksize);
+	vals[3] = _VolumeInfo_long(vol.iso, vol.blocks);
+	vals[4] = _VolumeInfo_long(vol.size != 0, vol.size);
+	vals[5] = _VolumeInfo_string(vol.udf, vol.udflabel);
+	vals[6] = _VolumeInfo_string(vol.udf, vol.udfvolumesetid);
+	vals[7] = _VolumeInfo_string(vol.udf && vol.udfuuid[0], vol.udfuuid);
+	vals[8] = _VolumeInfo_long(vol.udf, vol.udfblocksize);
+
+	for (int i=0; i < 9; i++)
 	{
-		PyErr_Format(PyExc_ValueError, "Start cell number cannot be negative (%d)", start);
-		return -1;
+		if (vals[i] == NULL)
+		{
+			for (int j=0; j < 9; j++)
+			{
+				Py_XDECREF(vals[j]);
+			}
+			Py_DECREF(ret_info);
+			return NULL;
+		}
 	}
-	self->startcell = start;
-
-	// Bounds check on end
-	if (end < 0)
+	for (int i=0; i < 9; i++)
 	{
-		PyErr_Format(PyExc_ValueError, "End cell number cannot be negative (%d)", end);
-		return -1;
+		PyStructSequence_SET_ITEM(ret_info, i, vals[i]);
 	}
-	self->endcell = end;
-
-	self->lenms = lenms;
-
-
-	// Assign fancy length
-	tmp = (PyObject*)self->lenfancy;
-	Py_INCREF(lenfancy);
-	self->lenfancy = lenfancy;
-	Py_CLEAR(tmp);
-
-
-	// Assign Title object
-	tmp = (PyObject*)self->title;
-	Py_INCREF(title);
-	self->title = title;
-	Py_CLEAR(tmp);
-
-	return 0;
-}
-
-static void
-Chapter_dealloc(Chapter *self)
-{
-	self->chapternum = 0;
-	self->startcell = 0;
-	self->endcell = 0;
-	self->lenms = 0;
-
-	Py_CLEAR(self->title);
-	Py_CLEAR(self->lenfancy);
 
-	Py_TYPE(self)->tp_free((PyObject*)self);
+	return ret_info;
 }
 
-
 // --------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------
-// Interface stuff for Chapter
+// Disc imaging
 
-static PyObject*
-Chapter_getTitle(Audio *self)
-{
-	return (PyObject*)self->title;
-}
+static PyStructSequence_Field ImageResult_fields[] = {
+	{"Copied", "Bytes copied by this call, zero if the image was already complete"},
+	{"Image", "Digest of the whole image"},
+	{"Files", "Tuple of the Digest of each VIDEO_TS file in the image, empty if it isn't a DVD"},
+	{NULL}
+};
+
+static PyStructSequence_Desc ImageResult_desc = {
+	"_dvdread.ImageResult",
+	"Outcome of CopyImage() with hash=True",
+	ImageResult_fields,
+	3
+};
 
 static PyObject*
-Chapter_getChapterNum(Chapter *self)
+_CopyImage_result(ModuleState_t *st, const pydvd_image_t *img)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	PyObject *ret = PyStructSequence_New(st->ImageResultType);
+	if (ret == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
 
+	PyObject *vals[3];
+	vals[0] = PyLong_FromUnsignedLongLong(img->done - img->start);
+	vals[1] = _Digest_new(st, &img->digests[0]);
+	vals[2] = PyTuple_New(img->numdigests - 1);
+	for (int i=1; vals[2] && i < img->numdigests; i++)
+	{
+		PyObject *d = _Digest_new(st, &img->digests[i]);
+		if (d == NULL)
+		{
+			Py_CLEAR(vals[2]);
+			break;
+		}
+		PyTuple_SET_ITEM(vals[2], i - 1, d);
+	}
 
-	return PyLong_FromLong(self->chapternum);
+	for (int i=0; i < 3; i++)
+	{
+		if (vals[i] == NULL)
+		{
+			for (int j=0; j < 3; j++)
+			{
+				Py_XDECREF(vals[j]);
+			}
+			Py_DECREF(ret);
+			return NULL;
+		}
+	}
+	for (int i=0; i < 3; i++)
+	{
+		PyStructSequence_SET_ITEM(ret, i, vals[i]);
+	}
+
+	return ret;
 }
 
-static PyObject*
-Chapter_getStartCell(Chapter *self)
+typedef struct {
+	PyObject *callback;
+	PyThreadState *state;
+} _CopyImage_progress_t;
+
+static int
+_CopyImage_progress(void *arg, uint64_t done, uint64_t total, double rate)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
-	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
-	}
+	// Called on the thread that released the GIL in CopyImage(), so take it back for the callback
+	_CopyImage_progress_t *p = (_CopyImage_progress_t*)arg;
 
+	PyEval_RestoreThread(p->state);
+	PyObject *ret = PyObject_CallFunction(p->callback, "KKd", (unsigned long long)done, (unsigned long long)total, rate);
+	Py_XDECREF(ret);
+	p->state = PyEval_SaveThread();
 
-	return PyLong_FromLong(self->startcell);
+	return ret == NULL;
 }
 
 static PyObject*
-Chapter_getEndCell(Chapter *self)
+CopyImage(PyObject *module, PyObject *args, PyObject *kwds)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	PyObject *inobj = NULL;
+	PyObject *outobj = NULL;
+	unsigned int blocksize = 2048;
+	unsigned long long blocks = 0;
+	Py_ssize_t chunksize = 2*1024*1024;
+	int direct = 0;
+	PyObject *progress = Py_None;
+	double interval = 1.0;
+	int hash = 0;
+	static char *kwlist[] = {"inpath", "outpath", "blocksize", "blocks", "chunksize", "direct", "progress", "interval", "hash", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O&|IKnpOdp", kwlist, PyUnicode_FSConverter, &inobj, PyUnicode_FSConverter, &outobj, &blocksize, &blocks, &chunksize, &direct, &progress, &interval, &hash))
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		Py_XDECREF(inobj);
+		Py_XDECREF(outobj);
 		return NULL;
 	}
 
-
-	return PyLong_FromLong(self->endcell);
-}
-
-static PyObject*
-Chapter_getLength(Chapter *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	if (blocksize == 0 || chunksize <= 0 || chunksize % blocksize != 0)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		Py_DECREF(inobj);
+		Py_DECREF(outobj);
+		PyErr_Format(PyExc_ValueError, "chunksize (%zd) must be a positive multiple of blocksize (%u)", chunksize, blocksize);
+		return NULL;
+	}
+	if (progress != Py_None && !PyCallable_Check(progress))
+	{
+		Py_DECREF(inobj);
+		Py_DECREF(outobj);
+		PyErr_SetString(PyExc_TypeError, "progress must be callable");
 		return NULL;
 	}
 
+	pydvd_image_t img;
+	memset(&img, 0, sizeof(img));
+	img.inpath = PyBytes_AS_STRING(inobj);
+	img.outpath = PyBytes_AS_STRING(outobj);
+	img.size = blocks * blocksize;
+	img.blocksize = blocksize;
+	img.chunksize = (size_t)chunksize;
+	img.direct = direct;
+	img.interval = interval;
+
+	_CopyImage_progress_t p;
+	p.callback = progress;
+	if (progress != Py_None)
+	{
+		img.progress = _CopyImage_progress;
+		img.progressarg = &p;
+	}
 
-	return PyLong_FromLong(self->lenms);
-}
+	p.state = PyEval_SaveThread();
+	int ret = 0;
+	if (hash && pydvd_image_files(img.inpath, &img.digests, &img.numdigests))
+	{
+		img.err = errno;
+		ret = -1;
+	}
+	if (ret == 0)
+	{
+		ret = pydvd_image_copy(&img);
+	}
+	PyEval_RestoreThread(p.state);
 
-static PyObject*
-Chapter_getLengthFancy(Chapter *self)
-{
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	if (ret)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
+		// A progress callback that raised has already set the exception
+		if (!PyErr_Occurred())
+		{
+			errno = img.err;
+			if (img.errpath)
+			{
+				PyErr_SetFromErrnoWithFilename(PyExc_OSError, img.errpath);
+			}
+			else
+			{
+				PyErr_SetFromErrno(PyExc_OSError);
+			}
+		}
+		free(img.digests);
+		Py_DECREF(inobj);
+		Py_DECREF(outobj);
 		return NULL;
 	}
 
+	Py_DECREF(inobj);
+	Py_DECREF(outobj);
 
-	Py_INCREF(self->lenfancy);
-	return self->lenfancy;
-}
-
-
+	if (hash)
+	{
+		PyObject *result = _CopyImage_result((ModuleState_t*)PyModule_GetState(module), &img);
+		free(img.digests);
+		return result;
+	}
 
+	// Bytes copied by this call, zero if the image was already complete
+	return PyLong_FromUnsignedLongLong(img.done - img.start);
+}
 
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Merging images
 
-static PyMemberDef Chapter_members[] = {
+static PyStructSequence_Field MergeResult_fields[] = {
+	{"Blocks", "Blocks in the merged image"},
+	{"Good", "Blocks read from one source or another"},
+	{"Bad", "Blocks no source could read, left as zeros"},
+	{"Sources", "MergeSource for each source, in the order given"},
 	{NULL}
 };
 
-static PyMethodDef Chapter_methods[] = {
-	{NULL}
+static PyStructSequence_Desc MergeResult_desc = {
+	"_dvdread.MergeResult",
+	"Outcome of MergeImages()",
+	MergeResult_fields,
+	4
 };
 
-static PyGetSetDef Chapter_getseters[] = {
-	{"Title", (getter)Chapter_getTitle, NULL, "Gets the title this chapter is associated with", NULL},
-	{"ChapterNum", (getter)Chapter_getChapterNum, NULL, "Gets the chapter number", NULL},
-	{"StartCell", (getter)Chapter_getStartCell, NULL, "Gets the starting cell for this chapter", NULL},
-	{"EndCell", (getter)Chapter_getEndCell, NULL, "Gets the ending cell for this chapter", NULL},
-	{"Length", (getter)Chapter_getLength, NULL, "Gets the length of the chapter in milliseconds", NULL},
-	{"LengthFancy", (getter)Chapter_getLengthFancy, NULL, "Gets the length of the chapter in HH:MM:SS:FF string format", NULL},
+static PyStructSequence_Field MergeSource_fields[] = {
+	{"Path", "Image file or device"},
+	{"Blocks", "Size of the source in blocks"},
+	{"DiscID", "DVDDiscID() of the source, None if its IFOs could not be read"},
+	{"Contributed", "Blocks of the merged image read from this source"},
+	{"Failed", "Blocks asked of this source that it did not hold or could not read"},
+	{"Map", "Tuple of (first, blocks, status) runs: '+' read, '-' not held or failed, '?' not needed"},
 	{NULL}
 };
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Administrative functions for Subpicture
+static PyStructSequence_Desc MergeSource_desc = {
+	"_dvdread.MergeSource",
+	"What one source of MergeImages() held",
+	MergeSource_fields,
+	6
+};
 
 static PyObject*
-Subpicture_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+_MergeImages_result(ModuleState_t *st, pydvd_merge_t *merge, PyObject **paths)
 {
-	Subpicture *self;
+	PyObject *sources = PyTuple_New(merge->numsources);
+	if (sources == NULL)
+	{
+		return NULL;
+	}
 
-	self = (Subpicture*)type->tp_alloc(type, 0);
-	if (self != NULL)
+	for (int i=0; i < merge->numsources; i++)
 	{
-		self->subpicturenum = 0;
+		pydvd_merge_source_t *src = &merge->sources[i];
+		PyObject *ret_src = PyStructSequence_New(st->MergeSourceType);
+		if (ret_src == NULL)
+		{
+			Py_DECREF(sources);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(sources, i, ret_src);
 
-		self->title = NULL;
+		PyObject *vals[6];
+		vals[0] = PyUnicode_DecodeFSDefault(PyBytes_AS_STRING(paths[i]));
+		vals[1] = PyLong_FromUnsignedLongLong(src->blocks);
+		if (src->hasdiscid)
+		{
+			vals[2] = PyBytes_FromStringAndSize((const char*)src->discid, sizeof(src->discid));
+		}
+		else
+		{
+			Py_INCREF(Py_None);
+			vals[2] = Py_None;
+		}
+		vals[3] = PyLong_FromUnsignedLongLong(src->contributed);
+		vals[4] = PyLong_FromUnsignedLongLong(src->failed);
+		vals[5] = _RescueMap_runs(src->map);
 
-		self->subpicture = NULL;
+		int bad = 0;
+		for (int j=0; j < 6; j++)
+		{
+			if (vals[j] == NULL)
+			{
+				bad = 1;
+				Py_INCREF(Py_None);
+				vals[j] = Py_None;
+			}
+			PyStructSequence_SET_ITEM(ret_src, j, vals[j]);
+		}
+		if (bad)
+		{
+			Py_DECREF(sources);
+			return NULL;
+		}
 	}
 
-	return (PyObject*)self;
-}
-
-static int
-Subpicture_init(Subpicture *self, PyObject *args, PyObject *kwds)
-{
-	PyObject *_title=NULL, *tmp;
-	int subpicturenum=0;
-	static char *kwlist[] = {"Title", "SubpictureNum", NULL};
-
-	// Parse arguments
-	if (! PyArg_ParseTupleAndKeywords(args,kwds, "Oi", kwlist, &_title, &subpicturenum))
+	PyObject *ret = PyStructSequence_New(st->MergeResultType);
+	if (ret == NULL)
 	{
-		return -1;
+		Py_DECREF(sources);
+		return NULL;
 	}
 
-	// Ensure Title is correct type
-	if (! PyObject_TypeCheck(_title, &TitleType))
+	PyObject *vals[3];
+	vals[0] = PyLong_FromUnsignedLongLong(merge->blocks);
+	vals[1] = PyLong_FromUnsignedLongLong(merge->good);
+	vals[2] = PyLong_FromUnsignedLongLong(merge->bad);
+	int bad = 0;
+	for (int j=0; j < 3; j++)
 	{
-		PyErr_SetString(PyExc_TypeError, "Title incorrect type");
-		return -1;
+		if (vals[j] == NULL)
+		{
+			bad = 1;
+			Py_INCREF(Py_None);
+			vals[j] = Py_None;
+		}
+		PyStructSequence_SET_ITEM(ret, j, vals[j]);
 	}
-	Title *title = (Title*)_title;
-
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(title->dvd))
+	PyStructSequence_SET_ITEM(ret, 3, sources);
+	if (bad)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return -1;
+		Py_DECREF(ret);
+		return NULL;
 	}
 
+	return ret;
+}
 
-
-	// Bounds check on subpicturenum
-	if (subpicturenum < 0)
+static PyObject*
+MergeImages(PyObject *module, PyObject *args, PyObject *kwds)
+{
+	PyObject *sourcesobj = NULL;
+	PyObject *outobj = NULL;
+	PyObject *mapobj = NULL;
+	unsigned int chunkblocks = PYDVD_MERGE_CHUNK;
+	int verify = 1;
+	static char *kwlist[] = {"sources", "outpath", "mappath", "chunkblocks", "verify", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO&|O&Ip", kwlist, &sourcesobj, PyUnicode_FSConverter, &outobj, PyUnicode_FSConverter, &mapobj, &chunkblocks, &verify))
 	{
-		PyErr_Format(PyExc_ValueError, "Subpicture number cannot be negative (%d)", subpicturenum);
-		return -1;
+		Py_XDECREF(outobj);
+		Py_XDECREF(mapobj);
+		return NULL;
 	}
-	if (subpicturenum > title->numsubpictures)
+
+	PyObject *seq = PySequence_Fast(sourcesobj, "sources must be a sequence of paths or (path, mapfile) tuples");
+	if (seq == NULL)
 	{
-		PyErr_Format(PyExc_ValueError, "Subpicture number is too large (%d > %d)", subpicturenum, title->numsubpictures);
-		return -1;
+		Py_DECREF(outobj);
+		Py_XDECREF(mapobj);
+		return NULL;
 	}
-	self->subpicturenum = subpicturenum;
 
+	Py_ssize_t num = PySequence_Fast_GET_SIZE(seq);
+	if (num < 1 || num > PYDVD_MERGE_MAXSOURCES || chunkblocks == 0)
+	{
+		Py_DECREF(seq);
+		Py_DECREF(outobj);
+		Py_XDECREF(mapobj);
+		PyErr_Format(PyExc_ValueError, "Need between 1 and %d sources and a positive chunkblocks", PYDVD_MERGE_MAXSOURCES);
+		return NULL;
+	}
 
-	ifo_handle_t *zero = title->dvd->ifos[0];
-	pgcit_t *vts_pgcit = title->ifo->vts_pgcit;
-	int vts_ttn = zero->tt_srpt->title[title->titlenum-1].vts_ttn;
-	int pgcidx = title->ifo->vts_ptt_srpt->title[vts_ttn - 1].ptt[0].pgcn - 1;
-	pgc_t *pgc = vts_pgcit->pgci_srp[ pgcidx ].pgc;
+	// Path and mapfile bytes of each source, kept until the merge is done
+	PyObject *paths[PYDVD_MERGE_MAXSOURCES] = {NULL};
+	PyObject *mappaths[PYDVD_MERGE_MAXSOURCES] = {NULL};
+	pydvd_merge_source_t sources[PYDVD_MERGE_MAXSOURCES];
+	memset(sources, 0, sizeof(sources));
 
-	// Find subpicture
-	int found = 0;
-	for (int i=0; i < title->ifo->vtsi_mat->nr_of_vts_subp_streams; i++)
+	PyObject *ret = NULL;
+	for (Py_ssize_t i=0; i < num; i++)
 	{
-		if (pgc->subp_control[i] & 0x80000000)
+		PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+		if (PyTuple_Check(item))
 		{
-			found++;
-			if (found == subpicturenum)
+			if (!PyArg_ParseTuple(item, "O&O&;sources must be paths or (path, mapfile) tuples", PyUnicode_FSConverter, &paths[i], PyUnicode_FSConverter, &mappaths[i]))
 			{
-				self->subpicture = title->ifo->vtsi_mat->vts_subp_attr;
-				break;
+				goto done;
 			}
+			sources[i].mappath = PyBytes_AS_STRING(mappaths[i]);
+		}
+		else if (!PyUnicode_FSConverter(item, &paths[i]))
+		{
+			goto done;
 		}
+		sources[i].path = PyBytes_AS_STRING(paths[i]);
+	}
+
+	pydvd_merge_t merge;
+	memset(&merge, 0, sizeof(merge));
+	merge.sources = sources;
+	merge.numsources = (int)num;
+	merge.outpath = PyBytes_AS_STRING(outobj);
+	merge.mappath = (mapobj ? PyBytes_AS_STRING(mapobj) : NULL);
+	merge.chunkblocks = chunkblocks;
+	merge.verify = verify;
+
+	int r;
+	Py_BEGIN_ALLOW_THREADS
+	r = pydvd_merge(&merge);
+	Py_END_ALLOW_THREADS
+
+	if (r == 0)
+	{
+		ret = _MergeImages_result((ModuleState_t*)PyModule_GetState(module), &merge, paths);
 	}
-	if (self->subpicture == NULL)
+	else if (merge.err == EXDEV)
 	{
-		PyErr_Format(PyExc_ValueError, "Subpicture number too large (%d > %d)", found, subpicturenum);
-		return -1;
+		PyErr_Format(PyExc_ValueError, "%s is not the same disc as %s", merge.errpath, sources[merge.mismatch].path);
 	}
+	else if (merge.err == EMEDIUMTYPE)
+	{
+		PyErr_Format(PyExc_ValueError, "Cannot identify the disc in %s, pass verify=False to merge it anyway", merge.errpath);
+	}
+	else
+	{
+		errno = merge.err;
+		if (merge.errpath)
+		{
+			PyErr_SetFromErrnoWithFilename(PyExc_OSError, merge.errpath);
+		}
+		else
+		{
+			PyErr_SetFromErrno(PyExc_OSError);
+		}
+	}
+	pydvd_merge_free(&merge);
 
-	// Assign Title object
-	tmp = (PyObject*)self->title;
-	Py_INCREF(title);
-	self->title = title;
-	Py_CLEAR(tmp);
-
-	return 0;
-}
-
-static void
-Subpicture_dealloc(Subpicture *self)
-{
-	self->subpicturenum = 0;
-
-	Py_CLEAR(self->title);
-
-	self->subpicture = NULL;
-
-	Py_TYPE(self)->tp_free((PyObject*)self);
+done:
+	for (Py_ssize_t i=0; i < num; i++)
+	{
+		Py_XDECREF(paths[i]);
+		Py_XDECREF(mappaths[i]);
+	}
+	Py_DECREF(seq);
+	Py_DECREF(outobj);
+	Py_XDECREF(mapobj);
+	return ret;
 }
 
-
 // --------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------
-// Interface stuff for Subpicture
+// Define the module
 
-static PyObject*
-Subpicture_getTitle(Audio *self)
-{
-	return (PyObject*)self->title;
-}
+static PyMethodDef DVDReadModuleMethods[] = {
+	{"ReadVolumeInfo", (PyCFunction)ReadVolumeInfo, METH_VARARGS, "Reads the ISO9660 and UDF volume descriptors of an image file or device and returns a VolumeInfo"},
+	{"CopyImage", (PyCFunction)CopyImage, METH_VARARGS|METH_KEYWORDS, "Copies a device or file to an image with large aligned reads, resuming an interrupted copy; progress(copied, total, rate) is called about every interval seconds. With hash=True returns an ImageResult with digests of the image and its VIDEO_TS files computed as it is copied"},
+	{"MergeImages", (PyCFunction)MergeImages, METH_VARARGS|METH_KEYWORDS, "Merges images or devices of the same disc into outpath, filling each bad extent from whichever source can read it; sources are paths or (path, mapfile) tuples and mappath gets the coverage map"},
+	{NULL, NULL, 0, NULL}
+};
 
-static PyObject*
-Subpicture_getLangCode(Subpicture *self)
+static int
+DvdReadmodule_traverse(PyObject *m, visitproc visit, void *arg)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	ModuleState_t *st = (ModuleState_t*)PyModule_GetState(m);
+	if (st == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
-		return NULL;
+		return 0;
 	}
 
+	Py_VISIT(st->DvdType);
+	Py_VISIT(st->TitleType);
+	Py_VISIT(st->AudioType);
+	Py_VISIT(st->ChapterType);
+	Py_VISIT(st->SubpictureType);
+	Py_VISIT(st->StreamType);
+	Py_VISIT(st->VolumeInfoType);
+	Py_VISIT(st->ReadAheadStatsType);
+	Py_VISIT(st->DigestType);
+	Py_VISIT(st->DiscSnapshotType);
+	Py_VISIT(st->TitleSnapshotType);
+	Py_VISIT(st->AudioSnapshotType);
+	Py_VISIT(st->ChapterSnapshotType);
+	Py_VISIT(st->SubpictureSnapshotType);
+	Py_VISIT(st->ImageResultType);
+	Py_VISIT(st->MergeResultType);
+	Py_VISIT(st->MergeSourceType);
+	Py_VISIT(st->LangByCode);
+	Py_VISIT(st->CodesByLang);
+	return 0;
+}
 
-	char a = self->subpicture->lang_code >> 8;
-	char b = self->subpicture->lang_code & 0xFF;
+static int
+DvdReadmodule_clear(PyObject *m)
+{
+	ModuleState_t *st = (ModuleState_t*)PyModule_GetState(m);
+	if (st == NULL)
+	{
+		return 0;
+	}
 
-	// I guess this means "hidden" or something
-	if (a == -1 && b == -1)
+	Py_CLEAR(st->DvdType);
+	Py_CLEAR(st->TitleType);
+	Py_CLEAR(st->AudioType);
+	Py_CLEAR(st->ChapterType);
+	Py_CLEAR(st->SubpictureType);
+	Py_CLEAR(st->StreamType);
+	Py_CLEAR(st->VolumeInfoType);
+	Py_CLEAR(st->ReadAheadStatsType);
+	Py_CLEAR(st->DigestType);
+	Py_CLEAR(st->DiscSnapshotType);
+	Py_CLEAR(st->TitleSnapshotType);
+	Py_CLEAR(st->AudioSnapshotType);
+	Py_CLEAR(st->ChapterSnapshotType);
+	Py_CLEAR(st->SubpictureSnapshotType);
+	Py_CLEAR(st->ImageResultType);
+	Py_CLEAR(st->MergeResultType);
+	Py_CLEAR(st->MergeSourceType);
+	for (int i=0; i < NUM_STRS; i++)
 	{
-		Py_INCREF(Py_None);
-		return Py_None;
+		Py_CLEAR(st->strs[i]);
+	}
+	for (int i=0; i < NUM_LANGUAGES; i++)
+	{
+		Py_CLEAR(st->langs[i][0]);
+		Py_CLEAR(st->langs[i][1]);
+		Py_CLEAR(st->langs[i][2]);
 	}
+	Py_CLEAR(st->LangByCode);
+	Py_CLEAR(st->CodesByLang);
+	return 0;
+}
 
-	return PyUnicode_FromFormat("%c%c", a, b);
+static void
+DvdReadmodule_free(void *m)
+{
+	DvdReadmodule_clear((PyObject*)m);
 }
 
-static PyObject*
-Subpicture_getLanguage(Subpicture *self)
+static PyTypeObject*
+_DvdReadmodule_addType(PyObject *m, const char *name, PyType_Spec *spec, PyStructSequence_Desc *desc)
 {
-	// Ensure device is open to access it
-	if (!_DVD_getIsOpen(self->title->dvd))
+	// Makes a type of the module from @spec, or a structseq from @desc, and adds it to the module as @name
+	// Returns a new reference, or NULL with an exception set
+	PyTypeObject *type;
+	if (spec)
+	{
+		type = (PyTypeObject*)PyType_FromModuleAndSpec(m, spec, NULL);
+	}
+	else
+	{
+		type = PyStructSequence_NewType(desc);
+	}
+	if (type == NULL)
 	{
-		PyErr_SetString(PyExc_Exception, "Device not open, cannot read from it");
 		return NULL;
 	}
 
-
-	return LangCodeToName(self->subpicture->lang_code);
+	if (PyModule_AddObjectRef(m, name, (PyObject*)type) < 0)
+	{
+		Py_DECREF(type);
+		return NULL;
+	}
+	return type;
 }
 
+static int
+DvdReadmodule_exec(PyObject *m)
+{
+	// Run for each module object, so every interpreter gets its own types and strings
+	ModuleState_t *st = (ModuleState_t*)PyModule_GetState(m);
+
+	// Strings the getters share
+	if (InitStrings(st) < 0) { return -1; }
+
+	// Make the types and add them to the module
+	if ((st->DvdType = _DvdReadmodule_addType(m, "DVD", &DVD_spec, NULL)) == NULL) { return -1; }
+	if ((st->TitleType = _DvdReadmodule_addType(m, "Title", &Title_spec, NULL)) == NULL) { return -1; }
+	if ((st->AudioType = _DvdReadmodule_addType(m, "Audio", &Audio_spec, NULL)) == NULL) { return -1; }
+	if ((st->ChapterType = _DvdReadmodule_addType(m, "Chapter", &Chapter_spec, NULL)) == NULL) { return -1; }
+	if ((st->SubpictureType = _DvdReadmodule_addType(m, "Subpicture", &Subpicture_spec, NULL)) == NULL) { return -1; }
+	if ((st->StreamType = _DvdReadmodule_addType(m, "Stream", &Stream_spec, NULL)) == NULL) { return -1; }
+#if PY_VERSION_HEX < 0x030A0000
+	st->StreamType->tp_new = NULL;
+#endif
+	if ((st->VolumeInfoType = _DvdReadmodule_addType(m, "VolumeInfo", NULL, &VolumeInfo_desc)) == NULL) { return -1; }
+	if ((st->ReadAheadStatsType = _DvdReadmodule_addType(m, "ReadAheadStats", NULL, &ReadAheadStats_desc)) == NULL) { return -1; }
+	if ((st->DigestType = _DvdReadmodule_addType(m, "Digest", NULL, &Digest_desc)) == NULL) { return -1; }
+	if ((st->DiscSnapshotType = _DvdReadmodule_addType(m, "DiscSnapshot", NULL, &DiscSnapshot_desc)) == NULL) { return -1; }
+	if ((st->TitleSnapshotType = _DvdReadmodule_addType(m, "TitleSnapshot", NULL, &TitleSnapshot_desc)) == NULL) { return -1; }
+	if ((st->AudioSnapshotType = _DvdReadmodule_addType(m, "AudioSnapshot", NULL, &AudioSnapshot_desc)) == NULL) { return -1; }
+	if ((st->ChapterSnapshotType = _DvdReadmodule_addType(m, "ChapterSnapshot", NULL, &ChapterSnapshot_desc)) == NULL) { return -1; }
+	if ((st->SubpictureSnapshotType = _DvdReadmodule_addType(m, "SubpictureSnapshot", NULL, &SubpictureSnapshot_desc)) == NULL) { return -1; }
+	if ((st->ImageResultType = _DvdReadmodule_addType(m, "ImageResult", NULL, &ImageResult_desc)) == NULL) { return -1; }
+	if ((st->MergeResultType = _DvdReadmodule_addType(m, "MergeResult", NULL, &MergeResult_desc)) == NULL) { return -1; }
+	if ((st->MergeSourceType = _DvdReadmodule_addType(m, "MergeSource", NULL, &MergeSource_desc)) == NULL) { return -1; }
+
+	if (PyModule_AddObjectRef(m, "LANGUAGES", st->LangByCode) < 0) { return -1; }
+	if (PyModule_AddObjectRef(m, "LANGUAGE_CODES", st->CodesByLang) < 0) { return -1; }
 
+	// Not sure of a better way to do this, but form a string containing the version
+	char v[32];
+	sprintf(v, "%d.%d", MAJOR_VERSION, MINOR_VERSION);
 
+	// Add the version as a string to the version
+	PyModule_AddStringConstant(m, "Version", v);
 
-static PyMemberDef Subpicture_members[] = {
-	{NULL}
-};
-
-static PyMethodDef Subpicture_methods[] = {
-	{NULL}
-};
-
-static PyGetSetDef Subpicture_getseters[] = {
-	{"Title", (getter)Subpicture_getTitle, NULL, "Gets the title this subpicture is associated with", NULL},
-	{"LangCode", (getter)Subpicture_getLangCode, NULL, "Gets the language code", NULL},
-	{"Language", (getter)Subpicture_getLanguage, NULL, "Gets the language", NULL},
-	{NULL}
-};
-
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Fully define PyObject types now
-
-static PyTypeObject DvdType = {
-	PyVarObject_HEAD_INIT(NULL, 0)
-	"_dvdread.DVD",            /* tp_name */
-	sizeof(DVD),               /* tp_basicsize */
-	0,                         /* tp_itemsize */
-	(destructor)DVD_dealloc,   /* tp_dealloc */
-	0,                         /* tp_print */
-	0,                         /* tp_getattr */
-	0,                         /* tp_setattr */
-	0,                         /* tp_reserved */
-	0,                         /* tp_repr */
-	0,                         /* tp_as_number */
-	0,                         /* tp_as_sequence */
-	0,                         /* tp_as_mapping */
-	0,                         /* tp_hash  */
-	0,                         /* tp_call */
-	0,                         /* tp_str */
-	0,                         /* tp_getattro */
-	0,                         /* tp_setattro */
-	0,                         /* tp_as_buffer */
-	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,               /* tp_flags */
-	"Represents dvd_reader_t* from libdvdread",           /* tp_doc */
-	0,                         /* tp_traverse */
-	0,                         /* tp_clear */
-	0,                         /* tp_richcompare */
-	0,                         /* tp_weaklistoffset */
-	0,                         /* tp_iter */
-	0,                         /* tp_iternext */
-	DVD_methods,               /* tp_methods */
-	DVD_members,               /* tp_members */
-	DVD_getseters,             /* tp_getset */
-	0,                         /* tp_base */
-	0,                         /* tp_dict */
-	0,                         /* tp_descr_get */
-	0,                         /* tp_descr_set */
-	0,                         /* tp_dictoffset */
-	(initproc)DVD_init,        /* tp_init */
-	0,                         /* tp_alloc */
-	DVD_new,                   /* tp_new */
-};
-
-static PyTypeObject TitleType = {
-	PyVarObject_HEAD_INIT(NULL, 0)
-	"_dvdread.Title",          /* tp_name */
-	sizeof(Title),             /* tp_basicsize */
-	0,                         /* tp_itemsize */
-	(destructor)Title_dealloc, /* tp_dealloc */
-	0,                         /* tp_print */
-	0,                         /* tp_getattr */
-	0,                         /* tp_setattr */
-	0,                         /* tp_reserved */
-	0,                         /* tp_repr */
-	0,                         /* tp_as_number */
-	0,                         /* tp_as_sequence */
-	0,                         /* tp_as_mapping */
-	0,                         /* tp_hash  */
-	0,                         /* tp_call */
-	0,                         /* tp_str */
-	0,                         /* tp_getattro */
-	0,                         /* tp_setattro */
-	0,                         /* tp_as_buffer */
-	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,               /* tp_flags */
-	"Represents a DVD title from libdvdread",             /* tp_doc */
-	0,                         /* tp_traverse */
-	0,                         /* tp_clear */
-	0,                         /* tp_richcompare */
-	0,                         /* tp_weaklistoffset */
-	0,                         /* tp_iter */
-	0,                         /* tp_iternext */
-	Title_methods,             /* tp_methods */
-	Title_members,             /* tp_members */
-	Title_getseters,           /* tp_getset */
-	0,                         /* tp_base */
-	0,                         /* tp_dict */
-	0,                         /* tp_descr_get */
-	0,                         /* tp_descr_set */
-	0,                         /* tp_dictoffset */
-	(initproc)Title_init,      /* tp_init */
-	0,                         /* tp_alloc */
-	Title_new,                 /* tp_new */
-};
+	// Domains for DVD.OpenFile()
+	PyModule_AddIntConstant(m, "READ_INFO_FILE", DVD_READ_INFO_FILE);
+	PyModule_AddIntConstant(m, "READ_INFO_BACKUP_FILE", DVD_READ_INFO_BACKUP_FILE);
+	PyModule_AddIntConstant(m, "READ_MENU_VOBS", DVD_READ_MENU_VOBS);
+	PyModule_AddIntConstant(m, "READ_TITLE_VOBS", DVD_READ_TITLE_VOBS);
 
-static PyTypeObject AudioType = {
-	PyVarObject_HEAD_INIT(NULL, 0)
-	"_dvdread.Audio",          /* tp_name */
-	sizeof(Audio),             /* tp_basicsize */
-	0,                         /* tp_itemsize */
-	(destructor)Audio_dealloc, /* tp_dealloc */
-	0,                         /* tp_print */
-	0,                         /* tp_getattr */
-	0,                         /* tp_setattr */
-	0,                         /* tp_reserved */
-	0,                         /* tp_repr */
-	0,                         /* tp_as_number */
-	0,                         /* tp_as_sequence */
-	0,                         /* tp_as_mapping */
-	0,                         /* tp_hash  */
-	0,                         /* tp_call */
-	0,                         /* tp_str */
-	0,                         /* tp_getattro */
-	0,                         /* tp_setattro */
-	0,                         /* tp_as_buffer */
-	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,               /* tp_flags */
-	"Represents a DVD audio track from libdvdread",             /* tp_doc */
-	0,                         /* tp_traverse */
-	0,                         /* tp_clear */
-	0,                         /* tp_richcompare */
-	0,                         /* tp_weaklistoffset */
-	0,                         /* tp_iter */
-	0,                         /* tp_iternext */
-	Audio_methods,             /* tp_methods */
-	Audio_members,             /* tp_members */
-	Audio_getseters,           /* tp_getset */
-	0,                         /* tp_base */
-	0,                         /* tp_dict */
-	0,                         /* tp_descr_get */
-	0,                         /* tp_descr_set */
-	0,                         /* tp_dictoffset */
-	(initproc)Audio_init,      /* tp_init */
-	0,                         /* tp_alloc */
-	Audio_new,                 /* tp_new */
-};
+	// Policies for DVD.BlockCachePolicy
+	PyModule_AddIntConstant(m, "BLOCKCACHE_LRU", PYDVD_BLOCKCACHE_LRU);
+	PyModule_AddIntConstant(m, "BLOCKCACHE_CLOCK", PYDVD_BLOCKCACHE_CLOCK);
 
-static PyTypeObject ChapterType = {
-	PyVarObject_HEAD_INIT(NULL, 0)
-	"_dvdread.Chapter",        /* tp_name */
-	sizeof(Chapter),           /* tp_basicsize */
-	0,                         /* tp_itemsize */
-	(destructor)Chapter_dealloc, /* tp_dealloc */
-	0,                         /* tp_print */
-	0,                         /* tp_getattr */
-	0,                         /* tp_setattr */
-	0,                         /* tp_reserved */
-	0,                         /* tp_repr */
-	0,                         /* tp_as_number */
-	0,                         /* tp_as_sequence */
-	0,                         /* tp_as_mapping */
-	0,                         /* tp_hash  */
-	0,                         /* tp_call */
-	0,                         /* tp_str */
-	0,                         /* tp_getattro */
-	0,                         /* tp_setattro */
-	0,                         /* tp_as_buffer */
-	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,               /* tp_flags */
-	"Represents a DVD chapter from libdvdread",           /* tp_doc */
-	0,                         /* tp_traverse */
-	0,                         /* tp_clear */
-	0,                         /* tp_richcompare */
-	0,                         /* tp_weaklistoffset */
-	0,                         /* tp_iter */
-	0,                         /* tp_iternext */
-	Chapter_methods,           /* tp_methods */
-	Chapter_members,           /* tp_members */
-	Chapter_getseters,         /* tp_getset */
-	0,                         /* tp_base */
-	0,                         /* tp_dict */
-	0,                         /* tp_descr_get */
-	0,                         /* tp_descr_set */
-	0,                         /* tp_dictoffset */
-	(initproc)Chapter_init,    /* tp_init */
-	0,                         /* tp_alloc */
-	Chapter_new,               /* tp_new */
-};
+	// Fills for DVD.RescueFill
+	PyModule_AddIntConstant(m, "RESCUE_FILL_ZERO", PYDVD_RESCUE_FILL_ZERO);
+	PyModule_AddIntConstant(m, "RESCUE_FILL_PAD", PYDVD_RESCUE_FILL_PAD);
 
-static PyTypeObject SubpictureType = {
-	PyVarObject_HEAD_INIT(NULL, 0)
-	"_dvdread.Subpicture",     /* tp_name */
-	sizeof(Subpicture),        /* tp_basicsize */
-	0,                         /* tp_itemsize */
-	(destructor)Subpicture_dealloc, /* tp_dealloc */
-	0,                         /* tp_print */
-	0,                         /* tp_getattr */
-	0,                         /* tp_setattr */
-	0,                         /* tp_reserved */
-	0,                         /* tp_repr */
-	0,                         /* tp_as_number */
-	0,                         /* tp_as_sequence */
-	0,                         /* tp_as_mapping */
-	0,                         /* tp_hash  */
-	0,                         /* tp_call */
-	0,                         /* tp_str */
-	0,                         /* tp_getattro */
-	0,                         /* tp_setattro */
-	0,                         /* tp_as_buffer */
-	Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,                                /* tp_flags */
-	"Represents a DVD subpicture (aka subtitle) from libdvdread",          /* tp_doc */
-	0,                         /* tp_traverse */
-	0,                         /* tp_clear */
-	0,                         /* tp_richcompare */
-	0,                         /* tp_weaklistoffset */
-	0,                         /* tp_iter */
-	0,                         /* tp_iternext */
-	Subpicture_methods,        /* tp_methods */
-	Subpicture_members,        /* tp_members */
-	Subpicture_getseters,      /* tp_getset */
-	0,                         /* tp_base */
-	0,                         /* tp_dict */
-	0,                         /* tp_descr_get */
-	0,                         /* tp_descr_set */
-	0,                         /* tp_dictoffset */
-	(initproc)Subpicture_init, /* tp_init */
-	0,                         /* tp_alloc */
-	Subpicture_new,            /* tp_new */
-};
+	// SHA-256 implementation picked for this CPU ("sha-ni" or "generic")
+	PyModule_AddStringConstant(m, "SHA256_IMPL", pydvd_sha256_impl());
 
-// --------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------
-// Define the module
+	return 0;
+}
 
-static PyMethodDef DVDReadModuleMethods[] = {
-	{NULL, NULL, 0, NULL}
+static PyModuleDef_Slot DvdReadmodule_slots[] = {
+	{Py_mod_exec, DvdReadmodule_exec},
+#ifdef Py_mod_multiple_interpreters
+	// Nothing is shared between module objects, so each interpreter can have its own GIL
+	{Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#ifdef Py_mod_gil
+	// Shared state of each DVD is guarded by its lock, so free-threaded builds can leave the GIL off
+	{Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+	{0, NULL}
 };
 
 static struct PyModuleDef DvdReadmodule = {
 	PyModuleDef_HEAD_INIT,
 	"_dvdread",
 	"Python wrapper for libdvdread4", // Doc
-	-1, // state in global vars
-	DVDReadModuleMethods
+	sizeof(ModuleState_t), // state per module object, see ModuleState_t
+	DVDReadModuleMethods,
+	DvdReadmodule_slots,
+	DvdReadmodule_traverse,
+	DvdReadmodule_clear,
+	DvdReadmodule_free
 };
 
 // Python expects a function named "PyInit_%s" % ModuleName, and since the module name is "_dvdread" there are two underscores
+// Multi-phase initialization: the module object is made and run through DvdReadmodule_exec() by the import system
 PyMODINIT_FUNC
 PyInit__dvdread(void)
 {
-	// Ready the types
-	if (PyType_Ready(&DvdType) < 0) { return NULL; }
-	if (PyType_Ready(&TitleType) < 0) { return NULL; }
-	if (PyType_Ready(&AudioType) < 0) { return NULL; }
-	if (PyType_Ready(&ChapterType) < 0) { return NULL; }
-	if (PyType_Ready(&SubpictureType) < 0) { return NULL; }
-
-	// Create the module defined in the struct above
-	PyObject *m = PyModule_Create(&DvdReadmodule);
-	if (m == NULL)
-	{
-		return NULL;
-	}
-
-	// Not sure of a better way to do this, but form a string containing the version
-	char v[32];
-	sprintf(v, "%d.%d", MAJOR_VERSION, MINOR_VERSION);
-
-	// Add the types to the module
-	Py_INCREF(&DvdType);
-	Py_INCREF(&TitleType);
-	Py_INCREF(&AudioType);
-	Py_INCREF(&ChapterType);
-	Py_INCREF(&SubpictureType);
-	PyModule_AddObject(m, "DVD", (PyObject*)&DvdType);
-	PyModule_AddObject(m, "Title", (PyObject*)&TitleType);
-	PyModule_AddObject(m, "Audio", (PyObject*)&AudioType);
-	PyModule_AddObject(m, "Chapter", (PyObject*)&ChapterType);
-	PyModule_AddObject(m, "Subpicture", (PyObject*)&SubpictureType);
-	// Add the version as a string to the version
-	PyModule_AddStringConstant(m, "Version", v);
-
-	// Return the module object
-	return m;
+	return PyModuleDef_Init(&DvdReadmodule);
 }
 
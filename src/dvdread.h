@@ -7,8 +7,502 @@
 
 #include <dvdread/dvd_reader.h>
 #include <dvdread/ifo_read.h>
+#include <dvdread/nav_read.h>
 
 #include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Heap types tied to their module (PyType_FromModuleAndSpec) and public vectorcall arrived in 3.9
+#if PY_VERSION_HEX < 0x03090000
+#error "Python 3.9 or later is required"
+#endif
+
+// Types only the module itself creates; before 3.10 tp_new is cleared after the type is made instead
+#ifndef Py_TPFLAGS_DISALLOW_INSTANTIATION
+#define Py_TPFLAGS_DISALLOW_INSTANTIATION 0
+#endif
+
+// Adds @value to the module without stealing the reference, arrived in 3.10
+#if PY_VERSION_HEX < 0x030A0000
+static inline int
+PyModule_AddObjectRef(PyObject *m, const char *name, PyObject *value)
+{
+	Py_XINCREF(value);
+	int ret = PyModule_AddObject(m, name, value);
+	if (ret < 0)
+	{
+		Py_XDECREF(value);
+	}
+	return ret;
+}
+#endif
+
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Flattened disc table
+//
+// Everything the Title/Audio/Chapter/Subpicture getters need, laid out as one block so it can be
+// written to and mmap'ed from a cache file as-is. Offsets are in bytes from the start of the header.
+// Stored in host byte order; a table written on a different byte order fails validation.
+
+#define PYDVD_TABLE_MAGIC "PYDVDTBL"
+#define PYDVD_TABLE_VERSION 4
+#define PYDVD_TABLE_BYTEORDER 0x01020304
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteorder;
+	uint32_t size;            // Total bytes including this header
+	uint32_t checksum;        // FNV-1a of everything after this header
+
+	// Disc this table was built from
+	uint8_t fingerprint[32];  // DVD.Fingerprint
+
+	uint32_t numifos;
+	uint32_t numtitles;
+	uint32_t numchapters;
+	uint32_t numaudios;
+	uint32_t numsubpictures;
+	uint32_t numcelltimes;
+
+	uint32_t titles;
+	uint32_t chapters;
+	uint32_t audios;
+	uint32_t subpictures;
+	uint32_t celltimes;       // Multiple of 8, see pydvd_celltime_t
+} pydvd_table_t;
+
+typedef struct {
+	uint16_t ifonum;
+	uint16_t numchapters;
+	uint8_t numangles;
+	uint8_t numaudios;
+	uint8_t numsubpictures;
+	uint8_t framerate;        // frame_u >> 6 of the title playback time
+	uint8_t aspectratio;      // video_attr_t display_aspect_ratio
+	uint8_t picturesize;      // video_attr_t picture_size
+	uint8_t videoformat;      // video_attr_t video_format
+	uint8_t zero_1;
+	uint32_t playbackms;
+	uint16_t numcells;        // Cells of the program chain, the title has one more cell time
+	uint16_t zero_2;
+
+	// Index of the title's first record in each of the arrays
+	uint32_t chapters;
+	uint32_t audios;
+	uint32_t subpictures;
+	uint32_t celltimes;
+} pydvd_title_t;
+
+typedef struct {
+	uint16_t startcell;
+	uint16_t endcell;
+	uint32_t lenms;
+	uint8_t framerate;        // frame_u >> 6 of the start cell
+	uint8_t zero_1[3];
+} pydvd_chapter_t;
+
+typedef struct {
+	uint16_t lang_code;
+	uint8_t format;           // audio_attr_t audio_format
+	uint8_t channels;         // audio_attr_t channels
+	uint8_t quantization;
+	uint8_t sample_frequency;
+	uint8_t zero_1[2];
+} pydvd_audio_t;
+
+typedef struct {
+	uint16_t lang_code;
+	uint8_t code_mode;
+	uint8_t zero_1;
+} pydvd_subpicture_t;
+
+typedef struct {
+	// Start of a cell from the start of the program chain, summed over the cells before it
+	// A title has numcells+1 of these, the last being the end of the chain, so any span is a subtraction
+	uint64_t start90k;        // 90 kHz ticks, exact for both frame rates
+	uint32_t startms;         // Milliseconds, the sum of dvdtimetoms() of the cells before it
+	uint32_t zero_1;
+} pydvd_celltime_t;
+
+#define PYDVD_TABLE_ARRAY(tbl, type, field) ((const type*)((const char*)(tbl) + (tbl)->field))
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Volume descriptors
+//
+// Strings are NUL terminated with trailing padding removed; UDF strings are UTF-8.
+
+typedef struct {
+	int iso;                  // Non-zero if an ISO9660 primary volume descriptor was found
+	int udf;                  // Non-zero if a UDF volume descriptor sequence was found
+
+	uint64_t size;            // Bytes in the image file or block device, zero if unknown
+
+	// ISO9660 primary volume descriptor
+	char volumeid[33];
+	char volumesetid[129];
+	uint32_t blocksize;
+	uint32_t blocks;          // Volume space size in blocks
+
+	// UDF primary and logical volume descriptors
+	char udflabel[128*3+1];   // Logical volume identifier, or volume identifier if empty
+	char udfvolumesetid[128*3+1];
+	char udfuuid[17];         // Derived from the volume set identifier as blkid does
+	uint32_t udfblocksize;
+} pydvd_volume_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Hashing
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t length;          // Bytes hashed
+	unsigned char buf[64];
+	size_t buflen;
+} pydvd_sha256_t;
+
+typedef struct {
+	uint64_t v[4];
+	uint64_t seed;
+	uint64_t length;
+	unsigned char buf[32];
+	size_t buflen;
+} pydvd_xxh64_t;
+
+// Bytes per slot of the hashing pipeline and slots in it
+#define PYDVD_HASH_SLOT (1024*1024)
+#define PYDVD_HASH_SLOTS 8
+
+// Workers: one runs SHA-256 and the other XXH64 over every digest
+#define PYDVD_HASH_WORKERS 2
+
+typedef struct {
+	char name[16];            // VIDEO_TS file name, empty for the whole input
+	uint64_t offset;          // Bytes of the input the digest covers
+	uint64_t size;            // UINT64_MAX for everything from @offset
+
+	// Results, updated as the workers go
+	uint64_t hashed;          // Bytes hashed so far
+	int broken;               // Part of the range was never fed, the digests are not of it
+	unsigned char sha256[32];
+	uint64_t xxh64;
+
+	// Worker state
+	pydvd_sha256_t sha;
+	pydvd_xxh64_t xxh;
+	uint64_t next[PYDVD_HASH_WORKERS];
+} pydvd_digest_t;
+
+typedef struct {
+	pydvd_digest_t *digests;
+	int numdigests;
+
+	unsigned char *slots;
+	uint64_t slotoffset[PYDVD_HASH_SLOTS];
+	size_t slotlen[PYDVD_HASH_SLOTS];
+
+	pthread_t threads[PYDVD_HASH_WORKERS];
+	pthread_mutex_t lock;     // Everything below and the results of @digests
+	pthread_cond_t cond;
+	int running;
+	int stop;
+	uint64_t head;            // Slots filled
+	uint64_t tails[PYDVD_HASH_WORKERS]; // Slots each worker is done with
+} pydvd_hasher_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Disc imaging
+
+// Called from the copying thread; returning non-zero stops the copy
+typedef int (*pydvd_image_progress_t)(void *arg, uint64_t done, uint64_t total, double rate);
+
+typedef struct {
+	const char *inpath;
+	const char *outpath;      // Journal is kept alongside as outpath + ".journal" until the copy completes
+	uint64_t size;            // Bytes to copy, zero for all of @inpath
+	uint32_t blocksize;
+	size_t chunksize;         // Bytes per read, a multiple of @blocksize
+	int direct;               // Use O_DIRECT where the file system allows it
+
+	pydvd_image_progress_t progress;
+	void *progressarg;
+	double interval;          // Seconds between progress calls
+	pydvd_digest_t *digests;  // Hashed as the image is written, including what a resumed copy already had
+	int numdigests;
+
+	// Results
+	uint64_t start;           // Offset the copy resumed from
+	uint64_t done;            // Offset copied up to
+	int err;                  // errno value of the failure
+	const char *errpath;      // Path @err applies to, NULL if neither
+} pydvd_image_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Read-ahead
+
+// Values of @failed other than a failing block
+#define PYDVD_READAHEAD_CLOSED -2   // Source went away (DVD closed)
+#define PYDVD_READAHEAD_STOPPED -3  // Stopped while a read waited on it
+
+// Most blocks per read (1 MiB)
+#define PYDVD_READAHEAD_CHUNK 512
+
+// Called from the read-ahead thread to read @blocks blocks from @pos; returns the number read and if it stopped
+// short because of an error sets @failed to the failing block (or PYDVD_READAHEAD_CLOSED)
+typedef int (*pydvd_readahead_read_t)(void *arg, int pos, int blocks, unsigned char *buf, int *failed);
+
+typedef struct {
+	uint64_t reads;           // Reads issued
+	uint64_t blocks;          // Blocks read
+	double readtime;          // Seconds spent in reads
+	uint64_t stalls;          // Times the consumer found the ring empty and waited
+	double stalltime;
+	uint64_t fullwaits;       // Times the thread found the ring full and waited (backpressure)
+	double idletime;          // Seconds the thread issued no reads because the ring was full
+	int fill;                 // Blocks buffered ahead of the consumer
+} pydvd_readahead_stats_t;
+
+typedef struct {
+	unsigned char *ring;
+	int ringblocks;
+	int chunkblocks;          // Most blocks per read
+	pydvd_readahead_read_t read;
+	void *readarg;
+
+	pthread_t thread;
+	pthread_mutex_t lock;     // Everything below
+	pthread_mutex_t control;  // Serializes start and stop
+	pthread_cond_t cond;
+	int initialized;
+	int running;
+	int stop;
+	int finished;             // Thread has exited, at @end, on a failure or when stopped
+	int failed;
+
+	int pos;                  // Next block the thread reads, up to @end
+	int end;
+	uint64_t head;
+	uint64_t tail;
+	int held;
+
+	pydvd_readahead_stats_t stats;
+} pydvd_readahead_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Block cache
+
+#define PYDVD_BLOCKCACHE_LRU 0
+#define PYDVD_BLOCKCACHE_CLOCK 1
+
+// Key of a file in the cache
+#define PYDVD_BLOCKCACHE_KEY(vts, domain) (((uint32_t)(vts) << 4) | (uint32_t)(domain))
+
+typedef struct {
+	uint32_t key;
+	uint32_t block;
+	int32_t hnext;            // Next entry in the same hash bucket
+	int32_t prev;             // Recency list for LRU, most recent first
+	int32_t next;
+	uint8_t ref;              // Reference bit for CLOCK
+} pydvd_blockcache_entry_t;
+
+typedef struct {
+	size_t bytes;             // Budget, zero to not cache
+	int policy;               // PYDVD_BLOCKCACHE_*
+	uint32_t capacity;        // Blocks that fit in @bytes
+
+	pydvd_blockcache_entry_t *entries;
+	unsigned char *data;      // Block of each entry
+	int32_t *buckets;
+	uint32_t numbuckets;
+	uint32_t count;
+	int32_t head;
+	int32_t tail;
+	uint32_t hand;
+
+	uint64_t hits;
+	uint64_t misses;          // Blocks read from the drive
+	uint64_t evictions;
+} pydvd_blockcache_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Rescue mode
+
+// Block status, as in GNU ddrescue mapfiles
+#define PYDVD_RESCUE_UNTRIED '?'
+#define PYDVD_RESCUE_UNTRIMMED '*'  // Failed as part of a multi-block read
+#define PYDVD_RESCUE_BAD '-'
+#define PYDVD_RESCUE_GOOD '+'
+
+// What unreadable blocks read as
+#define PYDVD_RESCUE_FILL_ZERO 0
+#define PYDVD_RESCUE_FILL_PAD 1     // Pack header and padding packet
+
+// Most blocks per read in rescue mode, so a failure condemns few good blocks
+#define PYDVD_RESCUE_CHUNK 16
+// Blocks passed over after a failure, doubling with each failure in a row
+#define PYDVD_RESCUE_MINSKIP 16
+#define PYDVD_RESCUE_MAXSKIP 65536
+
+typedef struct {
+	uint32_t first;
+	uint32_t blocks;
+	char status;
+} pydvd_rescue_run_t;
+
+typedef struct {
+	uint32_t key;             // PYDVD_BLOCKCACHE_KEY() of the file
+	uint32_t size;            // Blocks in the file
+	pydvd_rescue_run_t *runs;
+	int numruns;
+	int capacity;
+} pydvd_rescue_map_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Merging reads of one disc from several sources
+
+// One thread and one bit of a chunk's tried mask per source
+#define PYDVD_MERGE_MAXSOURCES 32
+
+// Blocks a source takes at a time (512 KiB)
+#define PYDVD_MERGE_CHUNK 256
+
+typedef struct {
+	const char *path;         // Image file or device
+	const char *mappath;      // ddrescue mapfile of what @path holds, NULL to go by holes and read errors
+
+	// Results
+	int hasdiscid;
+	unsigned char discid[16]; // DVDDiscID(), the MD5 of the IFO files
+	int hasvolume;
+	char volume[176];         // ISO9660 volume identifier, volume set identifier and size
+	uint32_t volumeblocks;
+	uint64_t blocks;          // Size of @path
+	uint64_t contributed;     // Blocks merged from this source
+	uint64_t failed;          // Blocks tried that it did not hold or could not read
+	pydvd_rescue_map_t *map;  // Blocks it was asked for: '+' read, '-' not held or failed, '?' not needed
+} pydvd_merge_source_t;
+
+typedef struct {
+	pydvd_merge_source_t *sources;
+	int numsources;
+	const char *outpath;
+	const char *mappath;      // Coverage map of @outpath written here, NULL for none
+	uint32_t chunkblocks;
+	int verify;               // Refuse sources that are not the same disc
+
+	// Results, the maps are freed by pydvd_merge_free()
+	uint64_t blocks;
+	uint64_t good;
+	uint64_t bad;             // Left as zeros in @outpath
+	pydvd_rescue_map_t *coverage;
+	int mismatch;             // With EXDEV, the source the one in @errpath differs from
+	int err;                  // errno value of the failure, EMEDIUMTYPE if a source can't be identified
+	const char *errpath;
+} pydvd_merge_t;
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Streaming output
+
+// Failures, the first one sticks
+#define PYDVD_WRITER_NOMEM 1
+#define PYDVD_WRITER_FLUSH 2        // Flush function failed
+
+// Called with each chunk of output; returning non-zero stops the writer
+typedef int (*pydvd_writer_flush_t)(void *arg, const char *buf, size_t len);
+
+typedef struct {
+	char *buf;
+	size_t len;
+	size_t capacity;
+	size_t chunk;             // Flush once this many bytes are buffered
+	pydvd_writer_flush_t flush;
+	void *flusharg;
+	int failed;               // PYDVD_WRITER_*
+} pydvd_writer_t;
+
+// src/cache.c
+uint32_t pydvd_table_checksum(const pydvd_table_t *tbl);
+int pydvd_table_validate(const pydvd_table_t *tbl, size_t size);
+int pydvd_cache_load(const char *path, const pydvd_table_t *key, pydvd_table_t **tbl, size_t *size);
+int pydvd_cache_store(const char *path, const pydvd_table_t *tbl);
+void pydvd_cache_release(pydvd_table_t *tbl, size_t size, int mapped);
+
+// src/volume.c
+int pydvd_volume_read(const char *path, pydvd_volume_t *vol);
+void pydvd_udf_dstring(const unsigned char *p, size_t len, char *out);
+int pydvd_fd_size(int fd, uint64_t *size);
+
+// src/hash.c
+const char* pydvd_sha256_impl(void);
+void pydvd_sha256_init(pydvd_sha256_t *ctx);
+void pydvd_sha256_update(pydvd_sha256_t *ctx, const unsigned char *data, size_t len);
+void pydvd_sha256_final(const pydvd_sha256_t *ctx, unsigned char *digest);
+void pydvd_xxh64_init(pydvd_xxh64_t *ctx, uint64_t seed);
+void pydvd_xxh64_update(pydvd_xxh64_t *ctx, const unsigned char *data, size_t len);
+uint64_t pydvd_xxh64_final(const pydvd_xxh64_t *ctx);
+void pydvd_digest_init(pydvd_digest_t *d, const char *name, uint64_t offset, uint64_t size);
+int pydvd_hasher_start(pydvd_hasher_t *h, pydvd_digest_t *digests, int numdigests);
+void pydvd_hasher_feed(pydvd_hasher_t *h, uint64_t offset, const unsigned char *data, size_t len);
+void pydvd_hasher_sync(pydvd_hasher_t *h);
+void pydvd_hasher_get(pydvd_hasher_t *h, int i, pydvd_digest_t *out);
+void pydvd_hasher_stop(pydvd_hasher_t *h);
+
+// src/imager.c
+int pydvd_image_copy(pydvd_image_t *img);
+int pydvd_image_files(const char *path, pydvd_digest_t **digests, int *numdigests);
+
+// src/blockcache.c
+void pydvd_blockcache_setup(pydvd_blockcache_t *c, size_t bytes, int policy);
+void pydvd_blockcache_empty(pydvd_blockcache_t *c);
+void pydvd_blockcache_resetstats(pydvd_blockcache_t *c);
+ssize_t pydvd_blockcache_read(pydvd_blockcache_t *c, dvd_file_t *file, uint32_t key, int block, size_t n, unsigned char *buf);
+
+// src/rescue.c
+pydvd_rescue_map_t* pydvd_rescue_new(uint32_t key, uint32_t size);
+void pydvd_rescue_free(pydvd_rescue_map_t *map);
+char pydvd_rescue_status(const pydvd_rescue_map_t *map, uint32_t block, uint32_t *end);
+int pydvd_rescue_set(pydvd_rescue_map_t *map, uint32_t first, uint32_t blocks, char status);
+void pydvd_rescue_fill(unsigned char *buf, size_t blocks, int mode);
+int pydvd_rescue_write(const pydvd_rescue_map_t *map, const char *path);
+int pydvd_rescue_read(pydvd_rescue_map_t *map, const char *path);
+
+// src/merge.c
+int pydvd_merge(pydvd_merge_t *m);
+void pydvd_merge_free(pydvd_merge_t *m);
+
+// src/readahead.c
+int pydvd_readahead_init(pydvd_readahead_t *ra, unsigned char *ring, int ringblocks, int chunkblocks, pydvd_readahead_read_t read, void *readarg);
+void pydvd_readahead_destroy(pydvd_readahead_t *ra);
+int pydvd_readahead_start(pydvd_readahead_t *ra, int pos, int end);
+void pydvd_readahead_stop(pydvd_readahead_t *ra);
+void pydvd_readahead_close(pydvd_readahead_t *ra);
+int pydvd_readahead_lend(pydvd_readahead_t *ra, int maxblocks, int *slot, int *failed);
+int pydvd_readahead_copy(pydvd_readahead_t *ra, unsigned char *buf, int maxblocks, int *failed);
+void pydvd_readahead_getstats(pydvd_readahead_t *ra, pydvd_readahead_stats_t *stats);
+
+// src/writer.c
+void pydvd_writer_init(pydvd_writer_t *w, size_t chunk, pydvd_writer_flush_t flush, void *flusharg);
+void pydvd_writer_put(pydvd_writer_t *w, const char *s, size_t n);
+void pydvd_writer_puts(pydvd_writer_t *w, const char *s);
+void pydvd_writer_printf(pydvd_writer_t *w, const char *fmt, ...);
+void pydvd_writer_xml(pydvd_writer_t *w, const char *s);
+void pydvd_writer_xmln(pydvd_writer_t *w, const char *s, size_t n);
+void pydvd_writer_json(pydvd_writer_t *w, const char *s);
+void pydvd_writer_jsonn(pydvd_writer_t *w, const char *s, size_t n);
+int pydvd_writer_finish(pydvd_writer_t *w);
 
 
 #endif // Py_DVDREADMODULE_H
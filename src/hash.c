@@ -0,0 +1,692 @@
+#include "dvdread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PYDVD_HASH_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Hashing
+//
+// SHA-256 (with the x86 SHA extensions when the CPU has them) and XXH64, and a pipeline that hashes data on
+// worker threads while the caller goes on reading. Data fed in is copied into a ring of slots; one worker runs
+// SHA-256 and the other XXH64 over each slot for every digest whose byte range it overlaps, so a whole image
+// and each file within it are hashed in the same pass. None of these touch Python objects.
+
+// --------------------------------------------------------------------------------
+// SHA-256
+
+static const uint32_t _pydvd_sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void
+_pydvd_sha256_generic(uint32_t *state, const unsigned char *data, size_t blocks)
+{
+	for ( ; blocks; blocks--, data += 64)
+	{
+		uint32_t w[64];
+		for (int i=0; i < 16; i++)
+		{
+			w[i] = ((uint32_t)data[i*4] << 24) | ((uint32_t)data[i*4+1] << 16) | ((uint32_t)data[i*4+2] << 8) | data[i*4+3];
+		}
+		for (int i=16; i < 64; i++)
+		{
+			uint32_t s0 = ROR32(w[i-15], 7) ^ ROR32(w[i-15], 18) ^ (w[i-15] >> 3);
+			uint32_t s1 = ROR32(w[i-2], 17) ^ ROR32(w[i-2], 19) ^ (w[i-2] >> 10);
+			w[i] = w[i-16] + s0 + w[i-7] + s1;
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+		for (int i=0; i < 64; i++)
+		{
+			uint32_t t1 = h + (ROR32(e, 6) ^ ROR32(e, 11) ^ ROR32(e, 25)) + ((e & f) ^ (~e & g)) + _pydvd_sha256_k[i] + w[i];
+			uint32_t t2 = (ROR32(a, 2) ^ ROR32(a, 13) ^ ROR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+}
+
+#ifdef PYDVD_HASH_SHANI
+__attribute__((target("sha,sse4.1,ssse3")))
+static void
+_pydvd_sha256_shani(uint32_t *state, const unsigned char *data, size_t blocks)
+{
+	// Four rounds per group of two SHA256RNDS2; the message schedule runs one group ahead in m[]
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	// State is held as ABEF and CDGH
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+	for ( ; blocks; blocks--, data += 64)
+	{
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+		__m128i m[4];
+
+		for (int g=0; g < 16; g++)
+		{
+			if (g < 4)
+			{
+				m[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + g*16)), mask);
+			}
+
+			__m128i msg = _mm_add_epi32(m[g & 3], _mm_loadu_si128((const __m128i*)&_pydvd_sha256_k[g*4]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+			if (g >= 3 && g <= 14)
+			{
+				__m128i *next = &m[(g + 1) & 3];
+				*next = _mm_add_epi32(*next, _mm_alignr_epi8(m[g & 3], m[(g - 1) & 3], 4));
+				*next = _mm_sha256msg2_epu32(*next, m[g & 3]);
+			}
+			state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+			if (g >= 1 && g <= 12)
+			{
+				m[(g - 1) & 3] = _mm_sha256msg1_epu32(m[(g - 1) & 3], m[g & 3]);
+			}
+		}
+
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	_mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xf0));
+	_mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+#endif
+
+typedef void (*_pydvd_sha256_blocks_t)(uint32_t *state, const unsigned char *data, size_t blocks);
+
+static _pydvd_sha256_blocks_t _pydvd_sha256_blocks = _pydvd_sha256_generic;
+static const char *_pydvd_sha256_name = "generic";
+static pthread_once_t _pydvd_sha256_once = PTHREAD_ONCE_INIT;
+
+static void
+_pydvd_sha256_detect(void)
+{
+#ifdef PYDVD_HASH_SHANI
+	unsigned int a, b, c, d;
+	if (!__get_cpuid(1, &a, &b, &c, &d) || !(c & bit_SSSE3) || !(c & bit_SSE4_1) || __get_cpuid_max(0, NULL) < 7)
+	{
+		return;
+	}
+
+	// CPUID.(EAX=7,ECX=0):EBX bit 29
+	__cpuid_count(7, 0, a, b, c, d);
+	if (b & (1u << 29))
+	{
+		_pydvd_sha256_blocks = _pydvd_sha256_shani;
+		_pydvd_sha256_name = "sha-ni";
+	}
+#endif
+}
+
+const char*
+pydvd_sha256_impl(void)
+{
+	// Name of the implementation picked for this CPU
+	pthread_once(&_pydvd_sha256_once, _pydvd_sha256_detect);
+	return _pydvd_sha256_name;
+}
+
+void
+pydvd_sha256_init(pydvd_sha256_t *ctx)
+{
+	static const uint32_t init[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+
+	pthread_once(&_pydvd_sha256_once, _pydvd_sha256_detect);
+	memcpy(ctx->state, init, sizeof(init));
+	ctx->length = 0;
+	ctx->buflen = 0;
+}
+
+void
+pydvd_sha256_update(pydvd_sha256_t *ctx, const unsigned char *data, size_t len)
+{
+	ctx->length += len;
+
+	if (ctx->buflen)
+	{
+		size_t n = (64 - ctx->buflen < len ? 64 - ctx->buflen : len);
+		memcpy(ctx->buf + ctx->buflen, data, n);
+		ctx->buflen += n;
+		data += n;
+		len -= n;
+		if (ctx->buflen < 64)
+		{
+			return;
+		}
+		_pydvd_sha256_blocks(ctx->state, ctx->buf, 1);
+		ctx->buflen = 0;
+	}
+
+	if (len >= 64)
+	{
+		_pydvd_sha256_blocks(ctx->state, data, len / 64);
+		data += len / 64 * 64;
+		len %= 64;
+	}
+
+	memcpy(ctx->buf, data, len);
+	ctx->buflen = len;
+}
+
+void
+pydvd_sha256_final(const pydvd_sha256_t *ctx, unsigned char *digest)
+{
+	// Digest of what was hashed so far into @digest (32 bytes); @ctx can go on being updated
+	uint32_t state[8];
+	unsigned char pad[128];
+	memcpy(state, ctx->state, sizeof(state));
+	memcpy(pad, ctx->buf, ctx->buflen);
+
+	size_t n = (ctx->buflen < 56 ? 64 : 128);
+	memset(pad + ctx->buflen, 0, n - ctx->buflen);
+	pad[ctx->buflen] = 0x80;
+
+	uint64_t bits = ctx->length * 8;
+	for (int i=0; i < 8; i++)
+	{
+		pad[n - 1 - i] = (unsigned char)(bits >> (i * 8));
+	}
+	_pydvd_sha256_blocks(state, pad, n / 64);
+
+	for (int i=0; i < 8; i++)
+	{
+		digest[i*4] = (unsigned char)(state[i] >> 24);
+		digest[i*4+1] = (unsigned char)(state[i] >> 16);
+		digest[i*4+2] = (unsigned char)(state[i] >> 8);
+		digest[i*4+3] = (unsigned char)state[i];
+	}
+}
+
+// --------------------------------------------------------------------------------
+// XXH64
+
+#define XXH_P1 11400714785074694791ULL
+#define XXH_P2 14029467366897019727ULL
+#define XXH_P3 1609587929392839161ULL
+#define XXH_P4 9650029242287828579ULL
+#define XXH_P5 2870177450012600261ULL
+
+#define ROL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static uint64_t
+_pydvd_xxh64_read64(const unsigned char *p)
+{
+	uint64_t v = 0;
+	for (int i=7; i >= 0; i--)
+	{
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+static uint32_t
+_pydvd_xxh64_read32(const unsigned char *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t
+_pydvd_xxh64_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_P2;
+	acc = ROL64(acc, 31);
+	return acc * XXH_P1;
+}
+
+static uint64_t
+_pydvd_xxh64_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= _pydvd_xxh64_round(0, val);
+	return acc * XXH_P1 + XXH_P4;
+}
+
+static void
+_pydvd_xxh64_stripes(uint64_t *v, const unsigned char *data, size_t stripes)
+{
+	// Four independent lanes, which the compiler keeps in registers
+	uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+	for ( ; stripes; stripes--, data += 32)
+	{
+		v1 = _pydvd_xxh64_round(v1, _pydvd_xxh64_read64(data));
+		v2 = _pydvd_xxh64_round(v2, _pydvd_xxh64_read64(data + 8));
+		v3 = _pydvd_xxh64_round(v3, _pydvd_xxh64_read64(data + 16));
+		v4 = _pydvd_xxh64_round(v4, _pydvd_xxh64_read64(data + 24));
+	}
+	v[0] = v1;
+	v[1] = v2;
+	v[2] = v3;
+	v[3] = v4;
+}
+
+void
+pydvd_xxh64_init(pydvd_xxh64_t *ctx, uint64_t seed)
+{
+	ctx->seed = seed;
+	ctx->v[0] = seed + XXH_P1 + XXH_P2;
+	ctx->v[1] = seed + XXH_P2;
+	ctx->v[2] = seed;
+	ctx->v[3] = seed - XXH_P1;
+	ctx->length = 0;
+	ctx->buflen = 0;
+}
+
+void
+pydvd_xxh64_update(pydvd_xxh64_t *ctx, const unsigned char *data, size_t len)
+{
+	ctx->length += len;
+
+	if (ctx->buflen)
+	{
+		size_t n = (32 - ctx->buflen < len ? 32 - ctx->buflen : len);
+		memcpy(ctx->buf + ctx->buflen, data, n);
+		ctx->buflen += n;
+		data += n;
+		len -= n;
+		if (ctx->buflen < 32)
+		{
+			return;
+		}
+		_pydvd_xxh64_stripes(ctx->v, ctx->buf, 1);
+		ctx->buflen = 0;
+	}
+
+	if (len >= 32)
+	{
+		_pydvd_xxh64_stripes(ctx->v, data, len / 32);
+		data += len / 32 * 32;
+		len %= 32;
+	}
+
+	memcpy(ctx->buf, data, len);
+	ctx->buflen = len;
+}
+
+uint64_t
+pydvd_xxh64_final(const pydvd_xxh64_t *ctx)
+{
+	// Digest of what was hashed so far; @ctx can go on being updated
+	uint64_t h;
+	if (ctx->length >= 32)
+	{
+		h = ROL64(ctx->v[0], 1) + ROL64(ctx->v[1], 7) + ROL64(ctx->v[2], 12) + ROL64(ctx->v[3], 18);
+		for (int i=0; i < 4; i++)
+		{
+			h = _pydvd_xxh64_merge(h, ctx->v[i]);
+		}
+	}
+	else
+	{
+		h = ctx->seed + XXH_P5;
+	}
+	h += ctx->length;
+
+	const unsigned char *p = ctx->buf;
+	size_t len = ctx->buflen;
+	for ( ; len >= 8; len -= 8, p += 8)
+	{
+		h ^= _pydvd_xxh64_round(0, _pydvd_xxh64_read64(p));
+		h = ROL64(h, 27) * XXH_P1 + XXH_P4;
+	}
+	if (len >= 4)
+	{
+		h ^= (uint64_t)_pydvd_xxh64_read32(p) * XXH_P1;
+		h = ROL64(h, 23) * XXH_P2 + XXH_P3;
+		len -= 4;
+		p += 4;
+	}
+	for ( ; len; len--, p++)
+	{
+		h ^= *p * XXH_P5;
+		h = ROL64(h, 11) * XXH_P1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_P2;
+	h ^= h >> 29;
+	h *= XXH_P3;
+	h ^= h >> 32;
+	return h;
+}
+
+// --------------------------------------------------------------------------------
+// Pipeline
+
+void
+pydvd_digest_init(pydvd_digest_t *d, const char *name, uint64_t offset, uint64_t size)
+{
+	// Digest of @size bytes of the input from @offset, named @name (NULL for none)
+	memset(d, 0, sizeof(pydvd_digest_t));
+	if (name)
+	{
+		snprintf(d->name, sizeof(d->name), "%s", name);
+	}
+	d->offset = offset;
+	d->size = size;
+
+	pydvd_sha256_init(&d->sha);
+	pydvd_xxh64_init(&d->xxh, 0);
+	for (int i=0; i < PYDVD_HASH_WORKERS; i++)
+	{
+		d->next[i] = offset;
+	}
+	pydvd_sha256_final(&d->sha, d->sha256);
+	d->xxh64 = pydvd_xxh64_final(&d->xxh);
+}
+
+static void
+_pydvd_hasher_slot(pydvd_hasher_t *h, int worker, uint64_t offset, const unsigned char *data, size_t len)
+{
+	// Hashes one slot into every digest it overlaps, then publishes their results
+	for (int i=0; i < h->numdigests; i++)
+	{
+		pydvd_digest_t *d = &h->digests[i];
+		uint64_t end = (d->size > UINT64_MAX - d->offset ? UINT64_MAX : d->offset + d->size);
+		uint64_t lo = (offset > d->offset ? offset : d->offset);
+		uint64_t hi = (offset + len < end ? offset + len : end);
+		if (lo >= hi)
+		{
+			continue;
+		}
+
+		// Anything but the next bytes in order means the digest can't be of the range any more
+		if (lo != d->next[worker])
+		{
+			pthread_mutex_lock(&h->lock);
+			d->broken = 1;
+			pthread_mutex_unlock(&h->lock);
+			d->next[worker] = UINT64_MAX;
+			continue;
+		}
+		d->next[worker] = hi;
+
+		const unsigned char *p = data + (lo - offset);
+		unsigned char sha256[32];
+		uint64_t xxh64 = 0;
+		if (worker == 0)
+		{
+			pydvd_sha256_update(&d->sha, p, (size_t)(hi - lo));
+			pydvd_sha256_final(&d->sha, sha256);
+		}
+		else
+		{
+			pydvd_xxh64_update(&d->xxh, p, (size_t)(hi - lo));
+			xxh64 = pydvd_xxh64_final(&d->xxh);
+		}
+
+		pthread_mutex_lock(&h->lock);
+		if (worker == 0)
+		{
+			memcpy(d->sha256, sha256, sizeof(sha256));
+			d->hashed = hi - d->offset;
+		}
+		else
+		{
+			d->xxh64 = xxh64;
+		}
+		pthread_mutex_unlock(&h->lock);
+	}
+}
+
+typedef struct {
+	pydvd_hasher_t *h;
+	int worker;
+} _pydvd_hasher_arg_t;
+
+static void*
+_pydvd_hasher_thread(void *arg)
+{
+	pydvd_hasher_t *h = ((_pydvd_hasher_arg_t*)arg)->h;
+	int worker = ((_pydvd_hasher_arg_t*)arg)->worker;
+	free(arg);
+
+	pthread_mutex_lock(&h->lock);
+	while (1)
+	{
+		while (h->tails[worker] == h->head && !h->stop)
+		{
+			pthread_cond_wait(&h->cond, &h->lock);
+		}
+		if (h->tails[worker] == h->head)
+		{
+			break;
+		}
+
+		// The slot stays put until every worker is past it
+		int slot = (int)(h->tails[worker] % PYDVD_HASH_SLOTS);
+		uint64_t offset = h->slotoffset[slot];
+		size_t len = h->slotlen[slot];
+		pthread_mutex_unlock(&h->lock);
+
+		_pydvd_hasher_slot(h, worker, offset, h->slots + (size_t)slot * PYDVD_HASH_SLOT, len);
+
+		pthread_mutex_lock(&h->lock);
+		h->tails[worker]++;
+		pthread_cond_broadcast(&h->cond);
+	}
+	pthread_mutex_unlock(&h->lock);
+
+	return NULL;
+}
+
+int
+pydvd_hasher_start(pydvd_hasher_t *h, pydvd_digest_t *digests, int numdigests)
+{
+	// Starts the workers for @digests, set up with pydvd_digest_init(); returns zero or an errno value
+	memset(h, 0, sizeof(pydvd_hasher_t));
+	h->digests = digests;
+	h->numdigests = numdigests;
+
+	h->slots = (unsigned char*)malloc((size_t)PYDVD_HASH_SLOTS * PYDVD_HASH_SLOT);
+	if (h->slots == NULL)
+	{
+		return ENOMEM;
+	}
+
+	int e = pthread_mutex_init(&h->lock, NULL);
+	if (e)
+	{
+		free(h->slots);
+		h->slots = NULL;
+		return e;
+	}
+	e = pthread_cond_init(&h->cond, NULL);
+	if (e)
+	{
+		pthread_mutex_destroy(&h->lock);
+		free(h->slots);
+		h->slots = NULL;
+		return e;
+	}
+
+	int started = 0;
+	for ( ; started < PYDVD_HASH_WORKERS; started++)
+	{
+		_pydvd_hasher_arg_t *arg = (_pydvd_hasher_arg_t*)malloc(sizeof(_pydvd_hasher_arg_t));
+		if (arg == NULL)
+		{
+			e = ENOMEM;
+			break;
+		}
+		arg->h = h;
+		arg->worker = started;
+
+		e = pthread_create(&h->threads[started], NULL, _pydvd_hasher_thread, arg);
+		if (e)
+		{
+			free(arg);
+			break;
+		}
+	}
+
+	if (e)
+	{
+		pthread_mutex_lock(&h->lock);
+		h->stop = 1;
+		pthread_cond_broadcast(&h->cond);
+		pthread_mutex_unlock(&h->lock);
+		for (int i=0; i < started; i++)
+		{
+			pthread_join(h->threads[i], NULL);
+		}
+		pthread_cond_destroy(&h->cond);
+		pthread_mutex_destroy(&h->lock);
+		free(h->slots);
+		h->slots = NULL;
+		return e;
+	}
+
+	h->running = 1;
+	return 0;
+}
+
+void
+pydvd_hasher_feed(pydvd_hasher_t *h, uint64_t offset, const unsigned char *data, size_t len)
+{
+	// Queues @len bytes found at @offset of the input, waiting while the workers are a whole ring behind
+	// Copied under the lock so feeds from several threads don't share a slot
+	if (!h->running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&h->lock);
+	while (len)
+	{
+		uint64_t tail = h->tails[0];
+		for (int i=1; i < PYDVD_HASH_WORKERS; i++)
+		{
+			tail = (h->tails[i] < tail ? h->tails[i] : tail);
+		}
+		if (h->head - tail >= PYDVD_HASH_SLOTS)
+		{
+			pthread_cond_wait(&h->cond, &h->lock);
+			continue;
+		}
+
+		int slot = (int)(h->head % PYDVD_HASH_SLOTS);
+		size_t n = (len < PYDVD_HASH_SLOT ? len : PYDVD_HASH_SLOT);
+		memcpy(h->slots + (size_t)slot * PYDVD_HASH_SLOT, data, n);
+		h->slotoffset[slot] = offset;
+		h->slotlen[slot] = n;
+		h->head++;
+		pthread_cond_broadcast(&h->cond);
+
+		offset += n;
+		data += n;
+		len -= n;
+	}
+	pthread_mutex_unlock(&h->lock);
+}
+
+void
+pydvd_hasher_sync(pydvd_hasher_t *h)
+{
+	// Waits for the workers to hash everything fed so far, so the results cover it
+	if (!h->running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&h->lock);
+	uint64_t head = h->head;
+	for (int i=0; i < PYDVD_HASH_WORKERS; i++)
+	{
+		while (h->tails[i] < head)
+		{
+			pthread_cond_wait(&h->cond, &h->lock);
+		}
+	}
+	pthread_mutex_unlock(&h->lock);
+}
+
+void
+pydvd_hasher_get(pydvd_hasher_t *h, int i, pydvd_digest_t *out)
+{
+	// Consistent copy of the results of digest @i as far as the workers have got; the worker state is not
+	// copied as the workers update it outside the lock
+	const pydvd_digest_t *d = &h->digests[i];
+	memset(out, 0, sizeof(pydvd_digest_t));
+	memcpy(out->name, d->name, sizeof(out->name));
+	out->offset = d->offset;
+	out->size = d->size;
+
+	if (h->running)
+	{
+		pthread_mutex_lock(&h->lock);
+	}
+	out->hashed = d->hashed;
+	out->broken = d->broken;
+	memcpy(out->sha256, d->sha256, sizeof(out->sha256));
+	out->xxh64 = d->xxh64;
+	if (h->running)
+	{
+		pthread_mutex_unlock(&h->lock);
+	}
+}
+
+void
+pydvd_hasher_stop(pydvd_hasher_t *h)
+{
+	// Finishes hashing what was fed and stops the workers; the results stay in the digests
+	if (!h->running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&h->lock);
+	h->stop = 1;
+	pthread_cond_broadcast(&h->cond);
+	pthread_mutex_unlock(&h->lock);
+
+	for (int i=0; i < PYDVD_HASH_WORKERS; i++)
+	{
+		pthread_join(h->threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&h->cond);
+	pthread_mutex_destroy(&h->lock);
+	free(h->slots);
+	h->slots = NULL;
+	h->running = 0;
+}
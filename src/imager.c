@@ -0,0 +1,662 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dvdread/dvd_udf.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Disc imaging
+//
+// Copies a device (or any file) to an image with one thread reading large aligned chunks while the calling thread
+// writes the previous ones. Progress is recorded in a small journal next to the image so an interrupted copy
+// resumes from exactly the last byte known to be on disk. Digests are fed each chunk as it is written, so the
+// image and its VIDEO_TS files are hashed without another pass. None of these touch Python objects.
+
+// O_DIRECT needs buffers, lengths and offsets aligned to the device's logical block size; 4096 covers all of them
+#define PYDVD_IMAGE_ALIGN 4096
+#define PYDVD_IMAGE_BUFFERS 2
+
+// Data is flushed and the journal advanced at least this often
+#define PYDVD_IMAGE_SYNCBYTES (64*1024*1024)
+
+#define PYDVD_JOURNAL_MAGIC "PYDVDJNL"
+#define PYDVD_JOURNAL_VERSION 1
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t blocksize;
+	uint64_t size;            // Total bytes being copied
+	uint64_t offset;          // Bytes from the start of the image known to be on disk
+	uint32_t checksum;        // FNV-1a of the fields above
+	uint32_t zero_1;
+} pydvd_journal_t;
+
+typedef struct {
+	unsigned char *data;
+	uint64_t offset;
+	size_t len;
+	int full;
+} _pydvd_image_buf_t;
+
+typedef struct {
+	pydvd_image_t *img;
+	int infd;
+	size_t chunksize;
+
+	_pydvd_image_buf_t bufs[PYDVD_IMAGE_BUFFERS];
+
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+
+	// Set by the writer to make the reader give up early
+	int stop;
+	// Set by the reader when it can't fill the next buffer
+	int readerr;
+	int finished;
+} _pydvd_image_ctx_t;
+
+static uint32_t
+_pydvd_journal_checksum(const pydvd_journal_t *j)
+{
+	const unsigned char *p = (const unsigned char*)j;
+	const unsigned char *end = (const unsigned char*)&j->checksum;
+
+	uint32_t h = 2166136261u;
+	for ( ; p < end; p++)
+	{
+		h ^= *p;
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+static int
+_pydvd_journal_read(const char *path, const pydvd_image_t *img, uint64_t *offset)
+{
+	// Returns zero with the resume point in @offset if @path is a valid journal for the copy described by @img
+	int fd = open(path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	pydvd_journal_t j;
+	ssize_t n = pread(fd, &j, sizeof(j), 0);
+	close(fd);
+
+	if (n != (ssize_t)sizeof(j)
+		|| memcmp(j.magic, PYDVD_JOURNAL_MAGIC, sizeof(j.magic)) != 0
+		|| j.version != PYDVD_JOURNAL_VERSION
+		|| j.checksum != _pydvd_journal_checksum(&j)
+		|| j.blocksize != img->blocksize
+		|| j.size != img->size
+		|| j.offset > j.size
+		|| j.offset % j.blocksize != 0)
+	{
+		return -1;
+	}
+
+	*offset = j.offset;
+	return 0;
+}
+
+static int
+_pydvd_journal_write(int fd, const pydvd_image_t *img, uint64_t offset)
+{
+	// Overwrites the journal in place; it is small enough to be written atomically by a single sector write
+	pydvd_journal_t j;
+	memset(&j, 0, sizeof(j));
+	memcpy(j.magic, PYDVD_JOURNAL_MAGIC, sizeof(j.magic));
+	j.version = PYDVD_JOURNAL_VERSION;
+	j.blocksize = img->blocksize;
+	j.size = img->size;
+	j.offset = offset;
+	j.checksum = _pydvd_journal_checksum(&j);
+
+	if (pwrite(fd, &j, sizeof(j), 0) != (ssize_t)sizeof(j))
+	{
+		if (errno == 0)
+		{
+			errno = EIO;
+		}
+		return -1;
+	}
+
+	return fdatasync(fd);
+}
+
+static ssize_t
+_pydvd_image_io(int fd, unsigned char *buf, size_t len, uint64_t offset, int writing)
+{
+	// Full length pread/pwrite, returns bytes transferred (short only at end of file) or -1 with errno set
+	// An O_DIRECT descriptor is switched to buffered I/O if the kernel refuses an unaligned tail or resume point
+	size_t done = 0;
+
+	while (done < len)
+	{
+		ssize_t n;
+		if (writing)
+		{
+			n = pwrite(fd, buf + done, len - done, (off_t)(offset + done));
+		}
+		else
+		{
+			n = pread(fd, buf + done, len - done, (off_t)(offset + done));
+		}
+
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+#ifdef O_DIRECT
+			int flags = fcntl(fd, F_GETFL);
+			if (errno == EINVAL && flags >= 0 && (flags & O_DIRECT))
+			{
+				if (fcntl(fd, F_SETFL, flags & ~O_DIRECT) == 0)
+				{
+					continue;
+				}
+				errno = EINVAL;
+			}
+#endif
+			return -1;
+		}
+		if (n == 0)
+		{
+			break;
+		}
+		done += (size_t)n;
+	}
+
+	return (ssize_t)done;
+}
+
+static void*
+_pydvd_image_reader(void *arg)
+{
+	_pydvd_image_ctx_t *ctx = (_pydvd_image_ctx_t*)arg;
+	pydvd_image_t *img = ctx->img;
+
+	uint64_t offset = img->start;
+	int i = 0;
+
+	while (offset < img->size)
+	{
+		_pydvd_image_buf_t *buf = &ctx->bufs[i];
+
+		// Wait for the writer to drain this buffer
+		pthread_mutex_lock(&ctx->lock);
+		while (buf->full && !ctx->stop)
+		{
+			pthread_cond_wait(&ctx->cond, &ctx->lock);
+		}
+		int stop = ctx->stop;
+		pthread_mutex_unlock(&ctx->lock);
+		if (stop)
+		{
+			break;
+		}
+
+		size_t len = ctx->chunksize;
+		if ((uint64_t)len > img->size - offset)
+		{
+			len = (size_t)(img->size - offset);
+		}
+
+		ssize_t n = _pydvd_image_io(ctx->infd, buf->data, len, offset, 0);
+		if (n != (ssize_t)len)
+		{
+			// Short read means the input is smaller than it was said to be
+			pthread_mutex_lock(&ctx->lock);
+			ctx->readerr = (n < 0 ? errno : EIO);
+			pthread_cond_broadcast(&ctx->cond);
+			pthread_mutex_unlock(&ctx->lock);
+			return NULL;
+		}
+
+		pthread_mutex_lock(&ctx->lock);
+		buf->offset = offset;
+		buf->len = len;
+		buf->full = 1;
+		pthread_cond_broadcast(&ctx->cond);
+		pthread_mutex_unlock(&ctx->lock);
+
+		offset += len;
+		i = (i + 1) % PYDVD_IMAGE_BUFFERS;
+	}
+
+	pthread_mutex_lock(&ctx->lock);
+	ctx->finished = 1;
+	pthread_cond_broadcast(&ctx->cond);
+	pthread_mutex_unlock(&ctx->lock);
+
+	return NULL;
+}
+
+static double
+_pydvd_image_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+_pydvd_image_fail(pydvd_image_t *img, const char *path, int err)
+{
+	if (img->err == 0)
+	{
+		img->err = err;
+		img->errpath = path;
+	}
+	return -1;
+}
+
+static int
+_pydvd_image_hashExisting(pydvd_image_t *img, pydvd_hasher_t *hasher, uint64_t upto, size_t chunksize)
+{
+	// Feeds the first @upto bytes of the image, which a resumed copy doesn't read again, to @hasher
+	if (upto == 0 || !hasher->running)
+	{
+		return 0;
+	}
+
+	unsigned char *buf = (unsigned char*)malloc(chunksize);
+	if (buf == NULL)
+	{
+		return _pydvd_image_fail(img, NULL, ENOMEM);
+	}
+
+	int fd = open(img->outpath, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+	{
+		free(buf);
+		return _pydvd_image_fail(img, img->outpath, errno);
+	}
+
+	int ret = 0;
+	for (uint64_t offset=0; offset < upto; )
+	{
+		size_t len = ((uint64_t)chunksize < upto - offset ? chunksize : (size_t)(upto - offset));
+		ssize_t n = _pydvd_image_io(fd, buf, len, offset, 0);
+		if (n != (ssize_t)len)
+		{
+			ret = _pydvd_image_fail(img, img->outpath, n < 0 ? errno : EIO);
+			break;
+		}
+		pydvd_hasher_feed(hasher, offset, buf, len);
+		offset += len;
+	}
+
+	close(fd);
+	free(buf);
+	return ret;
+}
+
+int
+pydvd_image_copy(pydvd_image_t *img)
+{
+	// Copies img->size bytes (all of the input if zero) of img->inpath to img->outpath, resuming a previous copy
+	// Returns zero on success; otherwise -1 with img->err and img->errpath saying what failed
+	// img->err is ECANCELED if the progress callback asked to stop
+	img->err = 0;
+	img->errpath = NULL;
+	img->start = 0;
+	img->done = 0;
+
+	if (img->blocksize == 0 || img->chunksize == 0 || img->chunksize % img->blocksize != 0)
+	{
+		return _pydvd_image_fail(img, NULL, EINVAL);
+	}
+
+	// Round the chunk up to the alignment so O_DIRECT reads of whole chunks stay aligned
+	size_t chunksize = (img->chunksize + PYDVD_IMAGE_ALIGN - 1) / PYDVD_IMAGE_ALIGN * PYDVD_IMAGE_ALIGN;
+	chunksize = chunksize / img->blocksize * img->blocksize;
+
+	int flags = 0;
+#ifdef O_DIRECT
+	if (img->direct)
+	{
+		flags = O_DIRECT;
+	}
+#endif
+
+	_pydvd_image_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.img = img;
+	ctx.chunksize = chunksize;
+	ctx.infd = -1;
+
+	int outfd = -1;
+	int journalfd = -1;
+	int threaded = 0;
+	char *journalpath = NULL;
+	pthread_t reader;
+
+	pydvd_hasher_t hasher;
+	memset(&hasher, 0, sizeof(hasher));
+
+	ctx.infd = open(img->inpath, O_RDONLY|O_CLOEXEC|flags);
+	if (ctx.infd < 0 && flags && errno == EINVAL)
+	{
+		// File system doesn't do O_DIRECT
+		ctx.infd = open(img->inpath, O_RDONLY|O_CLOEXEC);
+	}
+	if (ctx.infd < 0)
+	{
+		_pydvd_image_fail(img, img->inpath, errno);
+		goto done;
+	}
+
+	if (img->size == 0)
+	{
+		if (pydvd_fd_size(ctx.infd, &img->size))
+		{
+			_pydvd_image_fail(img, img->inpath, errno);
+			goto done;
+		}
+		img->size = img->size / img->blocksize * img->blocksize;
+	}
+
+	if (img->numdigests)
+	{
+		int e = pydvd_hasher_start(&hasher, img->digests, img->numdigests);
+		if (e)
+		{
+			_pydvd_image_fail(img, NULL, e);
+			goto done;
+		}
+	}
+
+	// Work out where to resume from
+	size_t len = strlen(img->outpath);
+	journalpath = (char*)malloc(len + 9);
+	if (journalpath == NULL)
+	{
+		_pydvd_image_fail(img, NULL, ENOMEM);
+		goto done;
+	}
+	memcpy(journalpath, img->outpath, len);
+	memcpy(journalpath + len, ".journal", 9);
+
+	uint64_t outsize = 0;
+	int outexists = 0;
+	{
+		struct stat s;
+		if (stat(img->outpath, &s) == 0)
+		{
+			outexists = 1;
+			outsize = (uint64_t)s.st_size;
+		}
+	}
+
+	uint64_t start = 0;
+	if (_pydvd_journal_read(journalpath, img, &start) == 0)
+	{
+		// Journal only ever trails the data, but the image may have been truncated since
+		if (start > outsize)
+		{
+			start = outsize / img->blocksize * img->blocksize;
+		}
+	}
+	else if (outexists)
+	{
+		// Image from an older copy without a journal: whole blocks present are trusted
+		if (outsize >= img->size)
+		{
+			img->start = img->size;
+			img->done = img->size;
+			_pydvd_image_hashExisting(img, &hasher, img->size, chunksize);
+			goto done;
+		}
+		start = outsize / img->blocksize * img->blocksize;
+	}
+
+	img->start = start;
+	img->done = start;
+
+	if (_pydvd_image_hashExisting(img, &hasher, start, chunksize))
+	{
+		goto done;
+	}
+
+	outfd = open(img->outpath, O_WRONLY|O_CREAT|O_CLOEXEC|flags, 0644);
+	if (outfd < 0 && flags && errno == EINVAL)
+	{
+		outfd = open(img->outpath, O_WRONLY|O_CREAT|O_CLOEXEC, 0644);
+	}
+	if (outfd < 0)
+	{
+		_pydvd_image_fail(img, img->outpath, errno);
+		goto done;
+	}
+
+	journalfd = open(journalpath, O_WRONLY|O_CREAT|O_CLOEXEC, 0644);
+	if (journalfd < 0 || _pydvd_journal_write(journalfd, img, start))
+	{
+		_pydvd_image_fail(img, journalpath, errno);
+		goto done;
+	}
+
+	for (int i=0; i < PYDVD_IMAGE_BUFFERS; i++)
+	{
+		if (posix_memalign((void**)&ctx.bufs[i].data, PYDVD_IMAGE_ALIGN, chunksize))
+		{
+			ctx.bufs[i].data = NULL;
+			_pydvd_image_fail(img, NULL, ENOMEM);
+			goto done;
+		}
+	}
+
+	pthread_mutex_init(&ctx.lock, NULL);
+	pthread_cond_init(&ctx.cond, NULL);
+
+	int e = pthread_create(&reader, NULL, _pydvd_image_reader, &ctx);
+	if (e)
+	{
+		pthread_cond_destroy(&ctx.cond);
+		pthread_mutex_destroy(&ctx.lock);
+		_pydvd_image_fail(img, NULL, e);
+		goto done;
+	}
+	threaded = 1;
+
+	// Write buffers in order as the reader fills them
+	double began = _pydvd_image_now();
+	double lastreport = began;
+	uint64_t lastdone = start;
+	uint64_t synced = start;
+	int i = 0;
+
+	while (img->done < img->size)
+	{
+		_pydvd_image_buf_t *buf = &ctx.bufs[i];
+
+		pthread_mutex_lock(&ctx.lock);
+		while (!buf->full && !ctx.readerr && !ctx.finished)
+		{
+			pthread_cond_wait(&ctx.cond, &ctx.lock);
+		}
+		int full = buf->full;
+		int readerr = ctx.readerr;
+		pthread_mutex_unlock(&ctx.lock);
+
+		if (!full)
+		{
+			_pydvd_image_fail(img, img->inpath, readerr ? readerr : EIO);
+			break;
+		}
+
+		// Copied for hashing first so the workers hash it while it's written
+		pydvd_hasher_feed(&hasher, buf->offset, buf->data, buf->len);
+
+		ssize_t n = _pydvd_image_io(outfd, buf->data, buf->len, buf->offset, 1);
+		if (n != (ssize_t)buf->len)
+		{
+			_pydvd_image_fail(img, img->outpath, n < 0 ? errno : ENOSPC);
+			break;
+		}
+		img->done = buf->offset + buf->len;
+
+		pthread_mutex_lock(&ctx.lock);
+		buf->full = 0;
+		pthread_cond_broadcast(&ctx.cond);
+		pthread_mutex_unlock(&ctx.lock);
+
+		i = (i + 1) % PYDVD_IMAGE_BUFFERS;
+
+		// Make what's written durable before the journal claims it
+		if (img->done - synced >= PYDVD_IMAGE_SYNCBYTES)
+		{
+			if (fdatasync(outfd))
+			{
+				_pydvd_image_fail(img, img->outpath, errno);
+				break;
+			}
+			if (_pydvd_journal_write(journalfd, img, img->done))
+			{
+				_pydvd_image_fail(img, journalpath, errno);
+				break;
+			}
+			synced = img->done;
+		}
+
+		double now = _pydvd_image_now();
+		if (img->progress && (now - lastreport >= img->interval || img->done == img->size))
+		{
+			double rate = (now > lastreport ? (img->done - lastdone) / (now - lastreport) : 0.0);
+			if (img->progress(img->progressarg, img->done, img->size, rate))
+			{
+				_pydvd_image_fail(img, NULL, ECANCELED);
+				break;
+			}
+			lastreport = now;
+			lastdone = img->done;
+		}
+	}
+
+	// Stop the reader if the copy ended early
+	pthread_mutex_lock(&ctx.lock);
+	ctx.stop = 1;
+	pthread_cond_broadcast(&ctx.cond);
+	pthread_mutex_unlock(&ctx.lock);
+
+done:
+	if (threaded)
+	{
+		pthread_join(reader, NULL);
+		pthread_cond_destroy(&ctx.cond);
+		pthread_mutex_destroy(&ctx.lock);
+	}
+	pydvd_hasher_stop(&hasher);
+
+	if (outfd >= 0)
+	{
+		// Whatever was written before stopping counts for the next resume, once it's on disk
+		if (fdatasync(outfd))
+		{
+			_pydvd_image_fail(img, img->outpath, errno);
+		}
+		else if (img->err && journalfd >= 0)
+		{
+			_pydvd_journal_write(journalfd, img, img->done);
+		}
+		close(outfd);
+	}
+	if (journalfd >= 0)
+	{
+		close(journalfd);
+		if (img->err == 0)
+		{
+			unlink(journalpath);
+		}
+	}
+
+	if (ctx.infd >= 0)
+	{
+		close(ctx.infd);
+	}
+	for (int i=0; i < PYDVD_IMAGE_BUFFERS; i++)
+	{
+		free(ctx.bufs[i].data);
+	}
+	free(journalpath);
+
+	return img->err ? -1 : 0;
+}
+
+static int
+_pydvd_image_addFile(dvd_reader_t *dvd, const char *name, pydvd_digest_t *digests, int *numdigests)
+{
+	// Adds a digest for /VIDEO_TS/@name if the disc has it, returns non-zero if it does
+	char path[32];
+	uint32_t size = 0;
+	snprintf(path, sizeof(path), "/VIDEO_TS/%s", name);
+
+	uint32_t lb = UDFFindFile(dvd, path, &size);
+	if (lb == 0)
+	{
+		return 0;
+	}
+
+	pydvd_digest_init(&digests[(*numdigests)++], name, (uint64_t)lb * DVD_VIDEO_LB_LEN, size);
+	return 1;
+}
+
+int
+pydvd_image_files(const char *path, pydvd_digest_t **digests, int *numdigests)
+{
+	// Digests for all of @path and for each VIDEO_TS file on it (DVD-Video files are contiguous extents), in
+	// directory order; just the first if it isn't a DVD. Returns zero, or -1 with errno set.
+	// VIDEO_TS.{BUP,IFO,VOB} and for up to 99 title sets VTS_nn_0.{BUP,IFO,VOB} and VTS_nn_1-9.VOB
+	pydvd_digest_t *d = (pydvd_digest_t*)malloc(sizeof(pydvd_digest_t) * (1 + 3 + 99 * 12));
+	if (d == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+
+	int n = 0;
+	pydvd_digest_init(&d[n++], NULL, 0, UINT64_MAX);
+
+	dvd_reader_t *dvd = DVDOpen(path);
+	if (dvd)
+	{
+		_pydvd_image_addFile(dvd, "VIDEO_TS.BUP", d, &n);
+		_pydvd_image_addFile(dvd, "VIDEO_TS.IFO", d, &n);
+		_pydvd_image_addFile(dvd, "VIDEO_TS.VOB", d, &n);
+
+		// Title sets are numbered from 1 without gaps
+		for (int vts=1; vts <= 99; vts++)
+		{
+			char name[16];
+			snprintf(name, sizeof(name), "VTS_%02d_0.BUP", vts);
+			_pydvd_image_addFile(dvd, name, d, &n);
+			snprintf(name, sizeof(name), "VTS_%02d_0.IFO", vts);
+			if (!_pydvd_image_addFile(dvd, name, d, &n))
+			{
+				break;
+			}
+			for (int i=0; i <= 9; i++)
+			{
+				snprintf(name, sizeof(name), "VTS_%02d_%d.VOB", vts, i);
+				_pydvd_image_addFile(dvd, name, d, &n);
+			}
+		}
+
+		DVDClose(dvd);
+	}
+
+	*digests = d;
+	*numdigests = n;
+	return 0;
+}
@@ -0,0 +1,685 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Merging reads of one disc from several sources
+//
+// Every source (drive or image) gets a thread that takes chunks of the disc it hasn't tried and that no source
+// has completed, reads the blocks still missing and writes those it could read into the merged image. A chunk
+// one source couldn't finish is picked up by the others in turn, so each bad extent is filled from whichever
+// source can read it. Threads start at evenly spaced points of the disc so all the drives keep busy.
+//
+// A source holds the '+' blocks of its ddrescue mapfile if one is given, otherwise whatever is not a hole in
+// an image file and reads without error. None of these touch Python objects.
+
+// Per block state in the merged image
+#define PYDVD_MERGE_UNTRIED 0
+#define PYDVD_MERGE_GOOD 1
+#define PYDVD_MERGE_FAILED 2
+
+typedef struct _pydvd_merge_ctx_t _pydvd_merge_ctx_t;
+
+typedef struct {
+	_pydvd_merge_ctx_t *ctx;
+	pydvd_merge_source_t *src;
+	int index;
+	int fd;
+	pydvd_rescue_map_t *avail; // From the source's mapfile, NULL to go by holes and read errors
+	int sparse;               // Regular file, so SEEK_DATA/SEEK_HOLE tell what was never written
+	pthread_t thread;
+} _pydvd_merge_worker_t;
+
+struct _pydvd_merge_ctx_t {
+	pydvd_merge_t *m;
+	int outfd;
+	uint32_t numchunks;
+
+	// Written only by the thread holding the block's chunk
+	uint8_t *state;
+
+	pthread_mutex_t lock;     // Everything below
+	pthread_cond_t cond;
+	uint32_t *tried;          // Bit per source
+	uint8_t *busy;
+	uint8_t *complete;
+	int err;
+	const char *errpath;
+};
+
+static int
+_pydvd_merge_fail(pydvd_merge_t *m, const char *path, int err)
+{
+	if (m->err == 0)
+	{
+		m->err = err;
+		m->errpath = path;
+	}
+	return -1;
+}
+
+static void
+_pydvd_merge_identify(pydvd_merge_source_t *src)
+{
+	// DVDDiscID() is the MD5 of the IFO files, as good a fingerprint as the disc has; the ISO9660 volume
+	// descriptor also has to agree, and is all there is for a source whose IFOs don't read
+	dvd_reader_t *dvd = DVDOpen(src->path);
+	if (dvd)
+	{
+		src->hasdiscid = (DVDDiscID(dvd, src->discid) == 0);
+		DVDClose(dvd);
+	}
+
+	pydvd_volume_t vol;
+	if (pydvd_volume_read(src->path, &vol) == 0 && vol.iso && vol.blocksize == DVD_VIDEO_LB_LEN)
+	{
+		src->hasvolume = 1;
+		src->volumeblocks = vol.blocks;
+		snprintf(src->volume, sizeof(src->volume), "%s/%s/%u", vol.volumeid, vol.volumesetid, vol.blocks);
+	}
+}
+
+static int
+_pydvd_merge_verify(pydvd_merge_t *m)
+{
+	// Every source must be identifiable and agree with the others on whatever they can both be identified by
+	for (int i=0; i < m->numsources; i++)
+	{
+		pydvd_merge_source_t *a = &m->sources[i];
+		if (!a->hasdiscid && !a->hasvolume)
+		{
+			return _pydvd_merge_fail(m, a->path, EMEDIUMTYPE);
+		}
+
+		for (int j=0; j < i; j++)
+		{
+			pydvd_merge_source_t *b = &m->sources[j];
+			if ((a->hasdiscid && b->hasdiscid && memcmp(a->discid, b->discid, sizeof(a->discid)) != 0)
+				|| (a->hasvolume && b->hasvolume && strcmp(a->volume, b->volume) != 0))
+			{
+				m->mismatch = j;
+				return _pydvd_merge_fail(m, a->path, EXDEV);
+			}
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t
+_pydvd_merge_held(_pydvd_merge_worker_t *w, uint64_t block, uint32_t n, int *held)
+{
+	// Length of the run of at most @n blocks from @block that the source either does or doesn't hold (@held)
+	*held = 0;
+	if (block >= w->src->blocks)
+	{
+		return n;
+	}
+	if (block + n > w->src->blocks)
+	{
+		n = (uint32_t)(w->src->blocks - block);
+	}
+
+	if (w->avail)
+	{
+		uint32_t end;
+		char status = pydvd_rescue_status(w->avail, (uint32_t)block, &end);
+		*held = (status == PYDVD_RESCUE_GOOD);
+		return (end - (uint32_t)block < n ? end - (uint32_t)block : n);
+	}
+
+	*held = 1;
+	if (w->sparse)
+	{
+		off_t off = (off_t)(block * DVD_VIDEO_LB_LEN);
+		off_t data = lseek(w->fd, off, SEEK_DATA);
+		if (data < 0 && errno == ENXIO)
+		{
+			// Hole to the end of the file
+			*held = 0;
+			return n;
+		}
+		if (data > off)
+		{
+			// Only whole blocks of hole count, a block partly written is read and its hole is zeros
+			uint64_t len = ((uint64_t)data - (uint64_t)off) / DVD_VIDEO_LB_LEN;
+			if (len)
+			{
+				*held = 0;
+				return (len < n ? (uint32_t)len : n);
+			}
+			data = off;
+		}
+		if (data == off)
+		{
+			off_t hole = lseek(w->fd, off, SEEK_HOLE);
+			if (hole > off)
+			{
+				uint64_t len = ((uint64_t)hole - (uint64_t)off + DVD_VIDEO_LB_LEN - 1) / DVD_VIDEO_LB_LEN;
+				return (len < n ? (uint32_t)len : n);
+			}
+		}
+		// The file system can't tell, so read it
+	}
+
+	return n;
+}
+
+static int
+_pydvd_merge_pread(int fd, unsigned char *buf, size_t len, off_t off)
+{
+	// Returns zero if all of @len bytes were read
+	size_t got = 0;
+	while (got < len)
+	{
+		ssize_t n = pread(fd, buf + got, len - got, off + (off_t)got);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		if (n == 0)
+		{
+			errno = EIO;
+			return -1;
+		}
+		got += (size_t)n;
+	}
+	return 0;
+}
+
+static int
+_pydvd_merge_pwrite(int fd, const unsigned char *buf, size_t len, off_t off)
+{
+	size_t put = 0;
+	while (put < len)
+	{
+		ssize_t n = pwrite(fd, buf + put, len - put, off + (off_t)put);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		put += (size_t)n;
+	}
+	return 0;
+}
+
+static void
+_pydvd_merge_mark(_pydvd_merge_worker_t *w, uint64_t block, uint32_t n, int good)
+{
+	_pydvd_merge_ctx_t *ctx = w->ctx;
+	if (good)
+	{
+		memset(ctx->state + block, PYDVD_MERGE_GOOD, n);
+		w->src->contributed += n;
+	}
+	else
+	{
+		memset(ctx->state + block, PYDVD_MERGE_FAILED, n);
+		w->src->failed += n;
+	}
+
+	// Out of memory only loses detail in the source's own map
+	pydvd_rescue_set(w->src->map, (uint32_t)block, n, good ? PYDVD_RESCUE_GOOD : PYDVD_RESCUE_BAD);
+}
+
+static int
+_pydvd_merge_take(_pydvd_merge_worker_t *w, unsigned char *buf, uint64_t block, uint32_t n)
+{
+	// Reads blocks @block to @block+@n from the source into the merged image, block by block if the whole
+	// run doesn't read; returns zero, or -1 if writing the image failed
+	_pydvd_merge_ctx_t *ctx = w->ctx;
+	off_t off = (off_t)(block * DVD_VIDEO_LB_LEN);
+
+	if (_pydvd_merge_pread(w->fd, buf, (size_t)n * DVD_VIDEO_LB_LEN, off) == 0)
+	{
+		if (_pydvd_merge_pwrite(ctx->outfd, buf, (size_t)n * DVD_VIDEO_LB_LEN, off))
+		{
+			return -1;
+		}
+		_pydvd_merge_mark(w, block, n, 1);
+		return 0;
+	}
+
+	for (uint32_t i=0; i < n; i++)
+	{
+		off_t o = off + (off_t)i * DVD_VIDEO_LB_LEN;
+		if (_pydvd_merge_pread(w->fd, buf, DVD_VIDEO_LB_LEN, o) == 0)
+		{
+			if (_pydvd_merge_pwrite(ctx->outfd, buf, DVD_VIDEO_LB_LEN, o))
+			{
+				return -1;
+			}
+			_pydvd_merge_mark(w, block + i, 1, 1);
+		}
+		else
+		{
+			_pydvd_merge_mark(w, block + i, 1, 0);
+		}
+	}
+
+	return 0;
+}
+
+static int
+_pydvd_merge_chunk(_pydvd_merge_worker_t *w, unsigned char *buf, uint32_t chunk, int *complete)
+{
+	// Fills what the source can of the blocks of @chunk not merged yet; returns as _pydvd_merge_take()
+	_pydvd_merge_ctx_t *ctx = w->ctx;
+	uint64_t first = (uint64_t)chunk * ctx->m->chunkblocks;
+	uint64_t end = first + ctx->m->chunkblocks;
+	if (end > ctx->m->blocks)
+	{
+		end = ctx->m->blocks;
+	}
+
+	*complete = 1;
+	uint64_t b = first;
+	while (b < end)
+	{
+		if (ctx->state[b] == PYDVD_MERGE_GOOD)
+		{
+			b++;
+			continue;
+		}
+
+		uint64_t e = b + 1;
+		while (e < end && ctx->state[e] != PYDVD_MERGE_GOOD)
+		{
+			e++;
+		}
+
+		while (b < e)
+		{
+			int held;
+			uint32_t n = _pydvd_merge_held(w, b, (uint32_t)(e - b), &held);
+			if (held)
+			{
+				if (_pydvd_merge_take(w, buf, b, n))
+				{
+					return -1;
+				}
+			}
+			else
+			{
+				_pydvd_merge_mark(w, b, n, 0);
+			}
+			b += n;
+		}
+	}
+
+	for (b=first; b < end; b++)
+	{
+		if (ctx->state[b] != PYDVD_MERGE_GOOD)
+		{
+			*complete = 0;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static void*
+_pydvd_merge_thread(void *arg)
+{
+	_pydvd_merge_worker_t *w = (_pydvd_merge_worker_t*)arg;
+	_pydvd_merge_ctx_t *ctx = w->ctx;
+	uint32_t bit = 1u << w->index;
+
+	unsigned char *buf = (unsigned char*)malloc((size_t)ctx->m->chunkblocks * DVD_VIDEO_LB_LEN);
+
+	pthread_mutex_lock(&ctx->lock);
+	if (buf == NULL && ctx->err == 0)
+	{
+		ctx->err = ENOMEM;
+	}
+
+	uint32_t next = (uint32_t)((uint64_t)ctx->numchunks * w->index / ctx->m->numsources);
+	while (ctx->err == 0)
+	{
+		// Next chunk along that this source hasn't tried and no source has completed; if there are none but
+		// another source is busy with one, it may leave work for this one
+		int64_t found = -1;
+		int waiting = 0;
+		for (uint32_t k=0; k < ctx->numchunks; k++)
+		{
+			uint32_t c = (next + k) % ctx->numchunks;
+			if (ctx->complete[c] || (ctx->tried[c] & bit))
+			{
+				continue;
+			}
+			if (ctx->busy[c])
+			{
+				waiting = 1;
+				continue;
+			}
+			found = c;
+			break;
+		}
+
+		if (found < 0)
+		{
+			if (!waiting)
+			{
+				break;
+			}
+			pthread_cond_wait(&ctx->cond, &ctx->lock);
+			continue;
+		}
+
+		uint32_t c = (uint32_t)found;
+		ctx->busy[c] = 1;
+		ctx->tried[c] |= bit;
+		next = c + 1;
+		pthread_mutex_unlock(&ctx->lock);
+
+		int complete;
+		int ret = _pydvd_merge_chunk(w, buf, c, &complete);
+		int e = errno;
+
+		pthread_mutex_lock(&ctx->lock);
+		ctx->busy[c] = 0;
+		ctx->complete[c] = (uint8_t)complete;
+		if (ret && ctx->err == 0)
+		{
+			ctx->err = e;
+			ctx->errpath = ctx->m->outpath;
+		}
+		pthread_cond_broadcast(&ctx->cond);
+	}
+
+	pthread_cond_broadcast(&ctx->cond);
+	pthread_mutex_unlock(&ctx->lock);
+
+	free(buf);
+	return NULL;
+}
+
+static int
+_pydvd_merge_open(pydvd_merge_t *m, _pydvd_merge_worker_t *w)
+{
+	// Opens the source, finds its size and loads its mapfile
+	pydvd_merge_source_t *src = w->src;
+	w->fd = open(src->path, O_RDONLY);
+	if (w->fd < 0)
+	{
+		return _pydvd_merge_fail(m, src->path, errno);
+	}
+
+	struct stat st;
+	if (fstat(w->fd, &st))
+	{
+		return _pydvd_merge_fail(m, src->path, errno);
+	}
+
+	uint64_t size;
+	if (S_ISREG(st.st_mode))
+	{
+		size = (uint64_t)st.st_size;
+		w->sparse = 1;
+	}
+	else if (pydvd_fd_size(w->fd, &size))
+	{
+		return _pydvd_merge_fail(m, src->path, errno);
+	}
+	src->blocks = size / DVD_VIDEO_LB_LEN;
+
+	return 0;
+}
+
+int
+pydvd_merge(pydvd_merge_t *m)
+{
+	// Merges the sources into @outpath, returns zero or -1 with @err and @errpath set
+	// Blocks no source could read are left as zeros and marked bad in the coverage map
+	if (m->numsources < 1 || m->numsources > PYDVD_MERGE_MAXSOURCES || m->chunkblocks == 0)
+	{
+		return _pydvd_merge_fail(m, NULL, EINVAL);
+	}
+
+	_pydvd_merge_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.m = m;
+	ctx.outfd = -1;
+
+	_pydvd_merge_worker_t *workers = (_pydvd_merge_worker_t*)calloc((size_t)m->numsources, sizeof(_pydvd_merge_worker_t));
+	if (workers == NULL)
+	{
+		return _pydvd_merge_fail(m, NULL, ENOMEM);
+	}
+	for (int i=0; i < m->numsources; i++)
+	{
+		workers[i].ctx = &ctx;
+		workers[i].src = &m->sources[i];
+		workers[i].index = i;
+		workers[i].fd = -1;
+	}
+
+	int ret = -1;
+	int started = 0;
+	int locked = 0;
+
+	// Size is the ISO9660 volume if any source has it, else the largest source
+	m->blocks = 0;
+	for (int i=0; i < m->numsources; i++)
+	{
+		_pydvd_merge_identify(&m->sources[i]);
+		if (_pydvd_merge_open(m, &workers[i]))
+		{
+			goto done;
+		}
+		if (m->sources[i].volumeblocks > m->blocks)
+		{
+			m->blocks = m->sources[i].volumeblocks;
+		}
+	}
+	if (m->blocks == 0)
+	{
+		for (int i=0; i < m->numsources; i++)
+		{
+			if (m->sources[i].blocks > m->blocks)
+			{
+				m->blocks = m->sources[i].blocks;
+			}
+		}
+	}
+	if (m->blocks == 0)
+	{
+		_pydvd_merge_fail(m, m->sources[0].path, EINVAL);
+		goto done;
+	}
+	if (m->blocks > UINT32_MAX)
+	{
+		_pydvd_merge_fail(m, m->sources[0].path, EFBIG);
+		goto done;
+	}
+
+	if (m->verify && _pydvd_merge_verify(m))
+	{
+		goto done;
+	}
+
+	for (int i=0; i < m->numsources; i++)
+	{
+		pydvd_merge_source_t *src = &m->sources[i];
+		src->map = pydvd_rescue_new((uint32_t)i, (uint32_t)m->blocks);
+		if (src->map == NULL)
+		{
+			_pydvd_merge_fail(m, NULL, ENOMEM);
+			goto done;
+		}
+
+		if (src->mappath)
+		{
+			workers[i].avail = pydvd_rescue_new((uint32_t)i, (uint32_t)m->blocks);
+			if (workers[i].avail == NULL)
+			{
+				_pydvd_merge_fail(m, NULL, ENOMEM);
+				goto done;
+			}
+			if (pydvd_rescue_read(workers[i].avail, src->mappath))
+			{
+				_pydvd_merge_fail(m, src->mappath, errno);
+				goto done;
+			}
+		}
+	}
+
+	// Blocks never written read back as zeros
+	ctx.outfd = open(m->outpath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (ctx.outfd < 0 || ftruncate(ctx.outfd, (off_t)(m->blocks * DVD_VIDEO_LB_LEN)))
+	{
+		_pydvd_merge_fail(m, m->outpath, errno);
+		goto done;
+	}
+
+	ctx.numchunks = (uint32_t)((m->blocks + m->chunkblocks - 1) / m->chunkblocks);
+	ctx.state = (uint8_t*)calloc((size_t)m->blocks, 1);
+	ctx.tried = (uint32_t*)calloc(ctx.numchunks, sizeof(uint32_t));
+	ctx.busy = (uint8_t*)calloc(ctx.numchunks, 1);
+	ctx.complete = (uint8_t*)calloc(ctx.numchunks, 1);
+	if (ctx.state == NULL || ctx.tried == NULL || ctx.busy == NULL || ctx.complete == NULL)
+	{
+		_pydvd_merge_fail(m, NULL, ENOMEM);
+		goto done;
+	}
+
+	int e = pthread_mutex_init(&ctx.lock, NULL);
+	if (e == 0)
+	{
+		e = pthread_cond_init(&ctx.cond, NULL);
+		if (e)
+		{
+			pthread_mutex_destroy(&ctx.lock);
+		}
+	}
+	if (e)
+	{
+		_pydvd_merge_fail(m, NULL, e);
+		goto done;
+	}
+	locked = 1;
+
+	for (; started < m->numsources; started++)
+	{
+		e = pthread_create(&workers[started].thread, NULL, _pydvd_merge_thread, &workers[started]);
+		if (e)
+		{
+			pthread_mutex_lock(&ctx.lock);
+			ctx.err = e;
+			pthread_cond_broadcast(&ctx.cond);
+			pthread_mutex_unlock(&ctx.lock);
+			break;
+		}
+	}
+	for (int i=0; i < started; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+	}
+	if (ctx.err)
+	{
+		_pydvd_merge_fail(m, ctx.errpath, ctx.err);
+		goto done;
+	}
+
+	if (fsync(ctx.outfd))
+	{
+		_pydvd_merge_fail(m, m->outpath, errno);
+		goto done;
+	}
+
+	m->coverage = pydvd_rescue_new(UINT32_MAX, (uint32_t)m->blocks);
+	if (m->coverage == NULL)
+	{
+		_pydvd_merge_fail(m, NULL, ENOMEM);
+		goto done;
+	}
+
+	m->good = 0;
+	m->bad = 0;
+	uint64_t b = 0;
+	while (b < m->blocks)
+	{
+		int good = (ctx.state[b] == PYDVD_MERGE_GOOD);
+		uint64_t end = b + 1;
+		while (end < m->blocks && (ctx.state[end] == PYDVD_MERGE_GOOD) == good)
+		{
+			end++;
+		}
+
+		if (pydvd_rescue_set(m->coverage, (uint32_t)b, (uint32_t)(end - b), good ? PYDVD_RESCUE_GOOD : PYDVD_RESCUE_BAD))
+		{
+			_pydvd_merge_fail(m, NULL, ENOMEM);
+			goto done;
+		}
+		if (good)
+		{
+			m->good += end - b;
+		}
+		else
+		{
+			m->bad += end - b;
+		}
+		b = end;
+	}
+
+	if (m->mappath && pydvd_rescue_write(m->coverage, m->mappath))
+	{
+		_pydvd_merge_fail(m, m->mappath, errno);
+		goto done;
+	}
+
+	ret = 0;
+
+done:
+	if (ctx.outfd >= 0 && close(ctx.outfd) && ret == 0)
+	{
+		ret = _pydvd_merge_fail(m, m->outpath, errno);
+	}
+	if (locked)
+	{
+		pthread_cond_destroy(&ctx.cond);
+		pthread_mutex_destroy(&ctx.lock);
+	}
+	for (int i=0; i < m->numsources; i++)
+	{
+		if (workers[i].fd >= 0)
+		{
+			close(workers[i].fd);
+		}
+		pydvd_rescue_free(workers[i].avail);
+	}
+	free(workers);
+	free(ctx.state);
+	free(ctx.tried);
+	free(ctx.busy);
+	free(ctx.complete);
+	return ret;
+}
+
+void
+pydvd_merge_free(pydvd_merge_t *m)
+{
+	// Frees the maps left in @m by pydvd_merge(), whether or not it succeeded
+	for (int i=0; i < m->numsources; i++)
+	{
+		pydvd_rescue_free(m->sources[i].map);
+		m->sources[i].map = NULL;
+	}
+	pydvd_rescue_free(m->coverage);
+	m->coverage = NULL;
+}
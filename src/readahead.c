@@ -0,0 +1,322 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <time.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Read-ahead ring
+//
+// A thread keeps reading the blocks after the consumer's position into a ring until it is full, so the drive
+// sees a steady stream of requests while the consumer works through what is already buffered.
+// None of these touch Python objects so they can be called with the GIL released.
+//
+// @head and @tail count every block put into and taken out of the ring; a block's slot is its count modulo
+// the ring size. Blocks lent out by pydvd_readahead_lend() stay in the ring (@held) until the next call.
+
+static double
+_pydvd_readahead_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void*
+_pydvd_readahead_thread(void *arg)
+{
+	pydvd_readahead_t *ra = (pydvd_readahead_t*)arg;
+
+	pthread_mutex_lock(&ra->lock);
+	while (!ra->stop)
+	{
+		int remain = ra->end - ra->pos;
+		if (remain <= 0)
+		{
+			break;
+		}
+
+		int want = (remain < ra->chunkblocks ? remain : ra->chunkblocks);
+		int free = ra->ringblocks - (int)(ra->head - ra->tail);
+
+		// Backpressure: wait for the consumer to make room for a whole chunk rather than trickle single blocks
+		if (free < want)
+		{
+			ra->stats.fullwaits++;
+			double t = _pydvd_readahead_now();
+			pthread_cond_wait(&ra->cond, &ra->lock);
+			ra->stats.idletime += _pydvd_readahead_now() - t;
+			continue;
+		}
+
+		// Don't wrap within a read so lent out views stay contiguous
+		int slot = (int)(ra->head % (uint64_t)ra->ringblocks);
+		int n = (want < ra->ringblocks - slot ? want : ra->ringblocks - slot);
+		int pos = ra->pos;
+		pthread_mutex_unlock(&ra->lock);
+
+		// Slots between @head and @head+@n are only touched by this thread
+		int failed = -1;
+		double t = _pydvd_readahead_now();
+		int got = ra->read(ra->readarg, pos, n, ra->ring + (size_t)slot * DVD_VIDEO_LB_LEN, &failed);
+		double took = _pydvd_readahead_now() - t;
+
+		pthread_mutex_lock(&ra->lock);
+		ra->stats.reads++;
+		ra->stats.readtime += took;
+		if (got > 0)
+		{
+			ra->head += (uint64_t)got;
+			ra->pos += got;
+			ra->stats.blocks += (uint64_t)got;
+			pthread_cond_broadcast(&ra->cond);
+		}
+		if (failed != -1 || got <= 0)
+		{
+			ra->failed = (failed != -1 ? failed : PYDVD_READAHEAD_CLOSED);
+			break;
+		}
+	}
+
+	ra->finished = 1;
+	pthread_cond_broadcast(&ra->cond);
+	pthread_mutex_unlock(&ra->lock);
+
+	return NULL;
+}
+
+int
+pydvd_readahead_init(pydvd_readahead_t *ra, unsigned char *ring, int ringblocks, int chunkblocks, pydvd_readahead_read_t read, void *readarg)
+{
+	// Returns zero, or an errno value if the lock could not be created
+	memset(ra, 0, sizeof(pydvd_readahead_t));
+	ra->ring = ring;
+	ra->ringblocks = ringblocks;
+	ra->chunkblocks = (chunkblocks < 1 ? 1 : (chunkblocks > ringblocks ? ringblocks : chunkblocks));
+	ra->read = read;
+	ra->readarg = readarg;
+	ra->failed = -1;
+
+	// Reads before the first start find it stopped
+	ra->stop = 1;
+	ra->finished = 1;
+
+	int e = pthread_mutex_init(&ra->lock, NULL);
+	if (e)
+	{
+		return e;
+	}
+	e = pthread_mutex_init(&ra->control, NULL);
+	if (e)
+	{
+		pthread_mutex_destroy(&ra->lock);
+		return e;
+	}
+	e = pthread_cond_init(&ra->cond, NULL);
+	if (e)
+	{
+		pthread_mutex_destroy(&ra->control);
+		pthread_mutex_destroy(&ra->lock);
+		return e;
+	}
+
+	ra->initialized = 1;
+	return 0;
+}
+
+void
+pydvd_readahead_destroy(pydvd_readahead_t *ra)
+{
+	if (!ra->initialized)
+	{
+		return;
+	}
+
+	pydvd_readahead_stop(ra);
+	pthread_cond_destroy(&ra->cond);
+	pthread_mutex_destroy(&ra->control);
+	pthread_mutex_destroy(&ra->lock);
+	ra->initialized = 0;
+}
+
+static void
+_pydvd_readahead_stop(pydvd_readahead_t *ra)
+{
+	// With @control held
+	if (!ra->running)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&ra->lock);
+	ra->stop = 1;
+	pthread_cond_broadcast(&ra->cond);
+	pthread_mutex_unlock(&ra->lock);
+
+	pthread_join(ra->thread, NULL);
+
+	pthread_mutex_lock(&ra->lock);
+	ra->running = 0;
+	ra->head = 0;
+	ra->tail = 0;
+	ra->held = 0;
+	pthread_mutex_unlock(&ra->lock);
+}
+
+int
+pydvd_readahead_start(pydvd_readahead_t *ra, int pos, int end)
+{
+	// (Re)starts reading blocks @pos up to @end into an empty ring, returns zero or an errno value
+	pthread_mutex_lock(&ra->control);
+	_pydvd_readahead_stop(ra);
+
+	pthread_mutex_lock(&ra->lock);
+	ra->pos = pos;
+	ra->end = end;
+	ra->head = 0;
+	ra->tail = 0;
+	ra->held = 0;
+	ra->stop = 0;
+	ra->finished = 0;
+	ra->failed = -1;
+	pthread_mutex_unlock(&ra->lock);
+
+	int e = pthread_create(&ra->thread, NULL, _pydvd_readahead_thread, ra);
+	if (e == 0)
+	{
+		ra->running = 1;
+	}
+	pthread_mutex_unlock(&ra->control);
+	return e;
+}
+
+void
+pydvd_readahead_stop(pydvd_readahead_t *ra)
+{
+	// Stops the thread and discards the ring; the read in flight, if any, finishes first
+	// Start and stop may be called from different threads, @control keeps them from joining twice
+	pthread_mutex_lock(&ra->control);
+	_pydvd_readahead_stop(ra);
+	pthread_mutex_unlock(&ra->control);
+}
+
+void
+pydvd_readahead_close(pydvd_readahead_t *ra)
+{
+	// Tells the thread to stop and drops the blocks it buffered without waiting for it, as it may be blocked on
+	// a lock the caller holds; reads then find it stopped. The thread is joined by the next start or stop
+	pthread_mutex_lock(&ra->lock);
+	ra->stop = 1;
+	ra->head = ra->tail + (uint64_t)ra->held;
+	pthread_cond_broadcast(&ra->cond);
+	pthread_mutex_unlock(&ra->lock);
+}
+
+static int
+_pydvd_readahead_wait(pydvd_readahead_t *ra, int *failed)
+{
+	// With the lock held, returns the blocks ready past those lent out, waiting for at least one
+	// Zero means the end was reached or the thread stopped, with @failed set as it left it
+	// Lent out blocks are given back on every pass as another consumer may borrow some while this one waits
+	int stalled = 0;
+	double t = 0;
+	for (;;)
+	{
+		if (ra->held)
+		{
+			ra->tail += (uint64_t)ra->held;
+			ra->held = 0;
+			pthread_cond_broadcast(&ra->cond);
+		}
+
+		if (ra->head != ra->tail || ra->finished)
+		{
+			break;
+		}
+
+		if (!stalled)
+		{
+			stalled = 1;
+			ra->stats.stalls++;
+			t = _pydvd_readahead_now();
+		}
+		pthread_cond_wait(&ra->cond, &ra->lock);
+	}
+	if (stalled)
+	{
+		ra->stats.stalltime += _pydvd_readahead_now() - t;
+	}
+
+	*failed = (ra->stop ? PYDVD_READAHEAD_STOPPED : ra->failed);
+	return (int)(ra->head - ra->tail);
+}
+
+int
+pydvd_readahead_lend(pydvd_readahead_t *ra, int maxblocks, int *slot, int *failed)
+{
+	// Lends up to @maxblocks contiguous blocks of the ring starting at block @slot until the next call
+	// Returns the number lent, zero at the end or on failure (@failed is the failing block or PYDVD_READAHEAD_*)
+	pthread_mutex_lock(&ra->lock);
+
+	int n = _pydvd_readahead_wait(ra, failed);
+	int s = (int)(ra->tail % (uint64_t)ra->ringblocks);
+	if (n > ra->ringblocks - s)
+	{
+		n = ra->ringblocks - s;
+	}
+	if (n > maxblocks)
+	{
+		n = maxblocks;
+	}
+
+	ra->held = n;
+	*slot = s;
+
+	pthread_mutex_unlock(&ra->lock);
+	return n;
+}
+
+int
+pydvd_readahead_copy(pydvd_readahead_t *ra, unsigned char *buf, int maxblocks, int *failed)
+{
+	// Copies up to @maxblocks blocks out of the ring into @buf, returns as pydvd_readahead_lend()
+	// Copied under the lock so a concurrent lend() cannot hand out the same blocks; the thread only waits on
+	// it to publish a finished read
+	pthread_mutex_lock(&ra->lock);
+
+	int n = _pydvd_readahead_wait(ra, failed);
+	if (n > maxblocks)
+	{
+		n = maxblocks;
+	}
+
+	int s = (int)(ra->tail % (uint64_t)ra->ringblocks);
+	int first = (n < ra->ringblocks - s ? n : ra->ringblocks - s);
+	memcpy(buf, ra->ring + (size_t)s * DVD_VIDEO_LB_LEN, (size_t)first * DVD_VIDEO_LB_LEN);
+	if (n > first)
+	{
+		memcpy(buf + (size_t)first * DVD_VIDEO_LB_LEN, ra->ring, (size_t)(n - first) * DVD_VIDEO_LB_LEN);
+	}
+
+	ra->tail += (uint64_t)n;
+	pthread_cond_broadcast(&ra->cond);
+
+	pthread_mutex_unlock(&ra->lock);
+	return n;
+}
+
+void
+pydvd_readahead_getstats(pydvd_readahead_t *ra, pydvd_readahead_stats_t *stats)
+{
+	// Consistent copy of the counters; @fill is what is buffered ahead of the consumer
+	if (!ra->initialized)
+	{
+		memset(stats, 0, sizeof(pydvd_readahead_stats_t));
+		return;
+	}
+
+	pthread_mutex_lock(&ra->lock);
+	*stats = ra->stats;
+	stats->fill = (ra->running ? (int)(ra->head - ra->tail) - ra->held : 0);
+	pthread_mutex_unlock(&ra->lock);
+}
@@ -0,0 +1,363 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Rescue maps
+//
+// State of every block of one file as a sorted list of runs that cover it end to end, using the GNU ddrescue
+// status characters: '?' untried, '*' failed as part of a larger read, '-' failed on its own, '+' read.
+// Mapfiles are written in ddrescue's format with byte positions relative to the start of the file.
+// None of these touch Python objects so they can be called with the GIL released.
+
+pydvd_rescue_map_t*
+pydvd_rescue_new(uint32_t key, uint32_t size)
+{
+	// Map of @size blocks, all untried; NULL if out of memory
+	pydvd_rescue_map_t *map = (pydvd_rescue_map_t*)calloc(1, sizeof(pydvd_rescue_map_t));
+	if (map == NULL)
+	{
+		return NULL;
+	}
+
+	map->key = key;
+	map->size = size;
+	map->capacity = 16;
+	map->runs = (pydvd_rescue_run_t*)malloc(sizeof(pydvd_rescue_run_t) * map->capacity);
+	if (map->runs == NULL)
+	{
+		free(map);
+		return NULL;
+	}
+
+	if (size)
+	{
+		map->runs[0].first = 0;
+		map->runs[0].blocks = size;
+		map->runs[0].status = PYDVD_RESCUE_UNTRIED;
+		map->numruns = 1;
+	}
+
+	return map;
+}
+
+void
+pydvd_rescue_free(pydvd_rescue_map_t *map)
+{
+	if (map)
+	{
+		free(map->runs);
+		free(map);
+	}
+}
+
+static int
+_pydvd_rescue_find(const pydvd_rescue_map_t *map, uint32_t block)
+{
+	// Index of the run holding @block, which must be within the map
+	int lo = 0, hi = map->numruns - 1;
+	while (lo < hi)
+	{
+		int mid = (lo + hi + 1) / 2;
+		if (map->runs[mid].first <= block)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+	return lo;
+}
+
+char
+pydvd_rescue_status(const pydvd_rescue_map_t *map, uint32_t block, uint32_t *end)
+{
+	// Status of @block, with @end set to the first block past its run
+	if (block >= map->size)
+	{
+		*end = UINT32_MAX;
+		return PYDVD_RESCUE_UNTRIED;
+	}
+
+	const pydvd_rescue_run_t *r = &map->runs[_pydvd_rescue_find(map, block)];
+	*end = r->first + r->blocks;
+	return r->status;
+}
+
+static void
+_pydvd_rescue_remove(pydvd_rescue_map_t *map, int i)
+{
+	memmove(&map->runs[i], &map->runs[i+1], sizeof(pydvd_rescue_run_t) * (map->numruns - i - 1));
+	map->numruns--;
+}
+
+static void
+_pydvd_rescue_split(pydvd_rescue_map_t *map, int i, uint32_t at)
+{
+	// Splits run @i so a new run starts at @at, there must be room for one more run
+	pydvd_rescue_run_t *r = &map->runs[i];
+	memmove(&map->runs[i+1], r, sizeof(pydvd_rescue_run_t) * (map->numruns - i));
+	map->numruns++;
+
+	map->runs[i+1].first = at;
+	map->runs[i+1].blocks = r->first + r->blocks - at;
+	r->blocks = at - r->first;
+}
+
+int
+pydvd_rescue_set(pydvd_rescue_map_t *map, uint32_t first, uint32_t blocks, char status)
+{
+	// Sets blocks @first to @first+@blocks to @status, returns zero or -1 if out of memory
+	if (blocks == 0 || first >= map->size)
+	{
+		return 0;
+	}
+	if ((uint64_t)first + blocks > map->size)
+	{
+		blocks = map->size - first;
+	}
+	uint32_t end = first + blocks;
+
+	// Nothing to do when it is already so, the common case of rereading
+	int i = _pydvd_rescue_find(map, first);
+	if (map->runs[i].status == status && map->runs[i].first + map->runs[i].blocks >= end)
+	{
+		return 0;
+	}
+
+	if (map->numruns + 2 > map->capacity)
+	{
+		int capacity = map->capacity * 2;
+		pydvd_rescue_run_t *runs = (pydvd_rescue_run_t*)realloc(map->runs, sizeof(pydvd_rescue_run_t) * capacity);
+		if (runs == NULL)
+		{
+			return -1;
+		}
+		map->runs = runs;
+		map->capacity = capacity;
+	}
+
+	if (map->runs[i].first < first)
+	{
+		_pydvd_rescue_split(map, i, first);
+		i++;
+	}
+
+	int j = _pydvd_rescue_find(map, end - 1);
+	if (map->runs[j].first + map->runs[j].blocks > end)
+	{
+		_pydvd_rescue_split(map, j, end);
+	}
+
+	// Runs @i to @j are exactly the range now, replace them with one
+	map->runs[i].blocks = blocks;
+	map->runs[i].status = status;
+	if (j > i)
+	{
+		memmove(&map->runs[i+1], &map->runs[j+1], sizeof(pydvd_rescue_run_t) * (map->numruns - j - 1));
+		map->numruns -= j - i;
+	}
+
+	if (i + 1 < map->numruns && map->runs[i+1].status == status)
+	{
+		map->runs[i].blocks += map->runs[i+1].blocks;
+		_pydvd_rescue_remove(map, i + 1);
+	}
+	if (i > 0 && map->runs[i-1].status == status)
+	{
+		map->runs[i-1].blocks += map->runs[i].blocks;
+		_pydvd_rescue_remove(map, i);
+	}
+
+	return 0;
+}
+
+void
+pydvd_rescue_fill(unsigned char *buf, size_t blocks, int mode)
+{
+	// Fills blocks that could not be read: zeros, or an MPEG-2 pack header (SCR zero, DVD mux rate) followed by
+	// a padding packet so demuxers step over them
+	if (mode != PYDVD_RESCUE_FILL_PAD)
+	{
+		memset(buf, 0, blocks * DVD_VIDEO_LB_LEN);
+		return;
+	}
+
+	static const unsigned char pack[20] = {
+		0x00, 0x00, 0x01, 0xba, 0x44, 0x00, 0x04, 0x00, 0x04, 0x01, 0x01, 0x89, 0xc3, 0xf8,
+		0x00, 0x00, 0x01, 0xbe, (DVD_VIDEO_LB_LEN - 20) >> 8, (DVD_VIDEO_LB_LEN - 20) & 0xff
+	};
+
+	for (size_t i=0; i < blocks; i++)
+	{
+		unsigned char *b = buf + i * DVD_VIDEO_LB_LEN;
+		memcpy(b, pack, sizeof(pack));
+		memset(b + sizeof(pack), 0xff, DVD_VIDEO_LB_LEN - sizeof(pack));
+	}
+}
+
+int
+pydvd_rescue_write(const pydvd_rescue_map_t *map, const char *path)
+{
+	// Writes @map as a ddrescue mapfile to @path, replacing it atomically; returns zero or -1 with errno set
+	size_t len = strlen(path);
+	char *tmp = (char*)malloc(len + 5);
+	if (tmp == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	memcpy(tmp, path, len);
+	memcpy(tmp + len, ".tmp", 5);
+
+	FILE *f = fopen(tmp, "w");
+	if (f == NULL)
+	{
+		int e = errno;
+		free(tmp);
+		errno = e;
+		return -1;
+	}
+
+	// Overall status: finished when all is read, retrying when only failures are left
+	char current = PYDVD_RESCUE_GOOD;
+	for (int i=0; i < map->numruns; i++)
+	{
+		if (map->runs[i].status == PYDVD_RESCUE_UNTRIED)
+		{
+			current = PYDVD_RESCUE_UNTRIED;
+			break;
+		}
+		if (map->runs[i].status != PYDVD_RESCUE_GOOD)
+		{
+			current = PYDVD_RESCUE_BAD;
+		}
+	}
+
+	fprintf(f, "# Mapfile. Created by pydvdread\n");
+	fprintf(f, "# current_pos  current_status  current_pass\n");
+	fprintf(f, "0x%08llX     %c               1\n", 0ULL, current);
+	fprintf(f, "#      pos        size  status\n");
+	for (int i=0; i < map->numruns; i++)
+	{
+		const pydvd_rescue_run_t *r = &map->runs[i];
+		fprintf(f, "0x%08llX  0x%08llX  %c\n", (unsigned long long)r->first * DVD_VIDEO_LB_LEN, (unsigned long long)r->blocks * DVD_VIDEO_LB_LEN, r->status);
+	}
+
+	int bad = ferror(f);
+	if (fflush(f) || fsync(fileno(f)))
+	{
+		bad = 1;
+	}
+	int e = errno;
+	if (fclose(f))
+	{
+		bad = 1;
+		e = errno;
+	}
+	if (bad || rename(tmp, path))
+	{
+		e = (bad ? e : errno);
+		unlink(tmp);
+		free(tmp);
+		errno = e;
+		return -1;
+	}
+
+	free(tmp);
+	return 0;
+}
+
+int
+pydvd_rescue_read(pydvd_rescue_map_t *map, const char *path)
+{
+	// Replaces the contents of @map with the ddrescue mapfile at @path; returns zero or -1 with errno set
+	// (EINVAL if it is not a mapfile). Partial blocks count as not read.
+	FILE *f = fopen(path, "r");
+	if (f == NULL)
+	{
+		return -1;
+	}
+
+	if (pydvd_rescue_set(map, 0, map->size, PYDVD_RESCUE_UNTRIED))
+	{
+		fclose(f);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	char line[256];
+	int sawcurrent = 0;
+	int ret = 0;
+	while (fgets(line, sizeof(line), f))
+	{
+		if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+		{
+			continue;
+		}
+
+		// First line of data is the current position and status, the rest are blocks
+		if (!sawcurrent)
+		{
+			sawcurrent = 1;
+			continue;
+		}
+
+		unsigned long long pos, size;
+		char status;
+		if (sscanf(line, "%lli %lli %c", &pos, &size, &status) != 3)
+		{
+			errno = EINVAL;
+			ret = -1;
+			break;
+		}
+
+		uint64_t first = pos / DVD_VIDEO_LB_LEN;
+		uint64_t end = (pos + size + DVD_VIDEO_LB_LEN - 1) / DVD_VIDEO_LB_LEN;
+		char st;
+		if (status == '+')
+		{
+			// Only whole blocks are read
+			first = (pos + DVD_VIDEO_LB_LEN - 1) / DVD_VIDEO_LB_LEN;
+			end = (pos + size) / DVD_VIDEO_LB_LEN;
+			st = PYDVD_RESCUE_GOOD;
+		}
+		else if (status == '-')
+		{
+			st = PYDVD_RESCUE_BAD;
+		}
+		else if (status == '*' || status == '/')
+		{
+			st = PYDVD_RESCUE_UNTRIMMED;
+		}
+		else
+		{
+			continue;
+		}
+
+		if (first < end && first < map->size)
+		{
+			if (pydvd_rescue_set(map, (uint32_t)first, (uint32_t)(end - first < map->size ? end - first : map->size), st))
+			{
+				errno = ENOMEM;
+				ret = -1;
+				break;
+			}
+		}
+	}
+
+	if (ret == 0 && !sawcurrent)
+	{
+		errno = EINVAL;
+		ret = -1;
+	}
+
+	fclose(f);
+	return ret;
+}
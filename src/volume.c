@@ -0,0 +1,366 @@
+#include "dvdread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// ISO9660 and UDF volume descriptors
+//
+// Reads just enough of the volume descriptors to identify a disc, without mounting it or calling out to
+// isoinfo/blkid/blockdev. None of these touch Python objects so they can be called with the GIL released.
+
+#define PYDVD_SECTOR 2048
+
+// ISO9660 descriptors start at sector 16 and are terminated by a type 255 descriptor
+#define ISO_FIRST_SECTOR 16
+#define ISO_MAX_DESCRIPTORS 32
+
+// UDF anchor volume descriptor pointer is at sector 256 (or the last sector, or 256 before the last)
+#define UDF_ANCHOR_SECTOR 256
+#define UDF_MAX_DESCRIPTORS 64
+
+#define UDF_TAG_PVD 1
+#define UDF_TAG_AVDP 2
+#define UDF_TAG_LVD 6
+#define UDF_TAG_TD 8
+
+static uint16_t
+_le16(const unsigned char *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t
+_le32(const unsigned char *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int
+_pydvd_volume_readSector(int fd, uint64_t sector, unsigned char *buf)
+{
+	// Returns zero if the full sector was read
+	off_t off = (off_t)(sector * PYDVD_SECTOR);
+	size_t got = 0;
+
+	while (got < PYDVD_SECTOR)
+	{
+		ssize_t n = pread(fd, buf + got, PYDVD_SECTOR - got, off + (off_t)got);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		if (n == 0)
+		{
+			errno = EIO;
+			return -1;
+		}
+		got += (size_t)n;
+	}
+
+	return 0;
+}
+
+static void
+_pydvd_volume_isoString(const unsigned char *p, size_t len, char *out)
+{
+	// Copies a space padded ISO9660 string, trailing spaces removed, @out must hold @len+1 bytes
+	memcpy(out, p, len);
+	out[len] = '\0';
+
+	while (len > 0 && (out[len-1] == ' ' || out[len-1] == '\0'))
+	{
+		out[--len] = '\0';
+	}
+}
+
+void
+pydvd_udf_dstring(const unsigned char *p, size_t len, char *out)
+{
+	// Decodes a UDF dstring of field size @len into UTF-8, @out must hold 3*@len+1 bytes
+	// The last byte of the field is the used length including the compression ID in the first byte
+	size_t used = p[len-1];
+	char *o = out;
+
+	if (used > 1 && used < len && (p[0] == 8 || p[0] == 16))
+	{
+		size_t step = (p[0] == 8 ? 1 : 2);
+		for (size_t i=1; i + step <= used; i += step)
+		{
+			uint16_t c = (step == 1 ? p[i] : (uint16_t)((p[i] << 8) | p[i+1]));
+			if (c < 0x80)
+			{
+				*o++ = (char)c;
+			}
+			else if (c < 0x800)
+			{
+				*o++ = (char)(0xC0 | (c >> 6));
+				*o++ = (char)(0x80 | (c & 0x3F));
+			}
+			else
+			{
+				*o++ = (char)(0xE0 | (c >> 12));
+				*o++ = (char)(0x80 | ((c >> 6) & 0x3F));
+				*o++ = (char)(0x80 | (c & 0x3F));
+			}
+		}
+	}
+	*o = '\0';
+
+	while (o > out && (o[-1] == ' ' || o[-1] == '\0'))
+	{
+		*--o = '\0';
+	}
+}
+
+static int
+_pydvd_volume_udfTag(const unsigned char *buf, uint64_t sector)
+{
+	// Returns the tag identifier of the descriptor in @buf, or -1 if it is not a valid tag for @sector
+	unsigned char sum = 0;
+	for (int i=0; i < 16; i++)
+	{
+		if (i != 4)
+		{
+			sum += buf[i];
+		}
+	}
+
+	if (sum != buf[4] || _le32(buf + 12) != (uint32_t)sector)
+	{
+		return -1;
+	}
+
+	return _le16(buf);
+}
+
+static void
+_pydvd_volume_udfUUID(const char *volsetid, char *uuid)
+{
+	// Same derivation of a 16 character UUID from the volume set identifier as blkid
+	size_t len = strlen(volsetid);
+	if (len < 8)
+	{
+		uuid[0] = '\0';
+		return;
+	}
+
+	int nonhex = 16;
+	for (int i=0; i < 16; i++)
+	{
+		char c = volsetid[i];
+		if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+		{
+			nonhex = i;
+			break;
+		}
+	}
+
+	const unsigned char *v = (const unsigned char*)volsetid;
+	if (nonhex < 8)
+	{
+		snprintf(uuid, 17, "%02x%02x%02x%02x%02x%02x%02x%02x", v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+	}
+	else if (nonhex < 16)
+	{
+		for (int i=0; i < 8; i++)
+		{
+			uuid[i] = (char)((v[i] >= 'A' && v[i] <= 'F') ? v[i] + 32 : v[i]);
+		}
+		snprintf(uuid + 8, 9, "%02x%02x%02x%02x", v[8], v[9], v[10], v[11]);
+	}
+	else
+	{
+		for (int i=0; i < 16; i++)
+		{
+			uuid[i] = (char)((v[i] >= 'A' && v[i] <= 'F') ? v[i] + 32 : v[i]);
+		}
+		uuid[16] = '\0';
+	}
+}
+
+static void
+_pydvd_volume_readISO(int fd, unsigned char *buf, pydvd_volume_t *vol)
+{
+	for (int i=0; i < ISO_MAX_DESCRIPTORS; i++)
+	{
+		if (_pydvd_volume_readSector(fd, ISO_FIRST_SECTOR + i, buf))
+		{
+			return;
+		}
+
+		// Not an ISO9660 descriptor; UDF only discs have BEA01/NSR0x here instead
+		if (memcmp(buf + 1, "CD001", 5) != 0)
+		{
+			return;
+		}
+
+		if (buf[0] == 255)
+		{
+			return;
+		}
+		else if (buf[0] == 1)
+		{
+			vol->iso = 1;
+			_pydvd_volume_isoString(buf + 40, 32, vol->volumeid);
+			_pydvd_volume_isoString(buf + 190, 128, vol->volumesetid);
+			vol->blocks = _le32(buf + 80);
+			vol->blocksize = _le16(buf + 128);
+			return;
+		}
+	}
+}
+
+static void
+_pydvd_volume_readUDF(int fd, unsigned char *buf, pydvd_volume_t *vol)
+{
+	// Try the anchor at 256, then the last sector and 256 before it
+	uint64_t anchors[3] = {UDF_ANCHOR_SECTOR, 0, 0};
+	uint64_t last = vol->size / PYDVD_SECTOR;
+	if (last > UDF_ANCHOR_SECTOR)
+	{
+		anchors[1] = last - 1;
+		anchors[2] = last - 1 - UDF_ANCHOR_SECTOR;
+	}
+
+	uint32_t vdslen = 0, vdsloc = 0;
+	for (int i=0; i < 3 && anchors[i]; i++)
+	{
+		if (_pydvd_volume_readSector(fd, anchors[i], buf) == 0 && _pydvd_volume_udfTag(buf, anchors[i]) == UDF_TAG_AVDP)
+		{
+			vdslen = _le32(buf + 16);
+			vdsloc = _le32(buf + 20);
+			break;
+		}
+	}
+	if (vdslen == 0)
+	{
+		return;
+	}
+
+	// Walk the main volume descriptor sequence for the primary and logical volume descriptors
+	char volumeid[32*3+1] = "";
+	char label[128*3+1] = "";
+	uint32_t count = vdslen / PYDVD_SECTOR;
+	if (count > UDF_MAX_DESCRIPTORS)
+	{
+		count = UDF_MAX_DESCRIPTORS;
+	}
+
+	for (uint32_t i=0; i < count; i++)
+	{
+		uint64_t sector = (uint64_t)vdsloc + i;
+		if (_pydvd_volume_readSector(fd, sector, buf))
+		{
+			break;
+		}
+
+		int tag = _pydvd_volume_udfTag(buf, sector);
+		if (tag == UDF_TAG_PVD)
+		{
+			vol->udf = 1;
+			pydvd_udf_dstring(buf + 24, 32, volumeid);
+			pydvd_udf_dstring(buf + 72, 128, vol->udfvolumesetid);
+		}
+		else if (tag == UDF_TAG_LVD)
+		{
+			vol->udf = 1;
+			vol->udfblocksize = _le32(buf + 212);
+			pydvd_udf_dstring(buf + 84, 128, label);
+		}
+		else if (tag == UDF_TAG_TD || tag < 0)
+		{
+			break;
+		}
+	}
+
+	if (!vol->udf)
+	{
+		return;
+	}
+
+	// Logical volume identifier is the label, it's not limited to 32 characters like the volume identifier
+	strcpy(vol->udflabel, label[0] ? label : volumeid);
+	_pydvd_volume_udfUUID(vol->udfvolumesetid, vol->udfuuid);
+}
+
+int
+pydvd_fd_size(int fd, uint64_t *size)
+{
+	// Size in bytes of the regular file or block device open as @fd, zero if it can't be known
+	// Returns -1 with errno set if @fd could not be stat'ed
+	*size = 0;
+
+	struct stat s;
+	if (fstat(fd, &s))
+	{
+		return -1;
+	}
+
+	if (S_ISREG(s.st_mode))
+	{
+		*size = (uint64_t)s.st_size;
+	}
+#ifdef BLKGETSIZE64
+	else if (S_ISBLK(s.st_mode))
+	{
+		uint64_t sz = 0;
+		if (ioctl(fd, BLKGETSIZE64, &sz) == 0)
+		{
+			*size = sz;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+int
+pydvd_volume_read(const char *path, pydvd_volume_t *vol)
+{
+	// Fills @vol from the ISO9660 and UDF descriptors of the device or image at @path
+	// Returns zero on success, -1 with errno set if @path could not be read
+	// Succeeding does not mean either file system was found, check vol->iso and vol->udf
+	memset(vol, 0, sizeof(pydvd_volume_t));
+
+	int fd = open(path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	if (pydvd_fd_size(fd, &vol->size))
+	{
+		int e = errno;
+		close(fd);
+		errno = e;
+		return -1;
+	}
+
+	unsigned char *buf = (unsigned char*)malloc(PYDVD_SECTOR);
+	if (buf == NULL)
+	{
+		close(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	_pydvd_volume_readISO(fd, buf, vol);
+	_pydvd_volume_readUDF(fd, buf, vol);
+
+	free(buf);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,215 @@
+#include "dvdread.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Streaming output
+//
+// Text is appended to a growable buffer that is handed to the flush function every time it passes @chunk bytes,
+// so output of any size is written with one buffer of about that size. The first failure (out of memory, or the
+// flush function returning non-zero) sticks and makes everything after it do nothing, so callers only check
+// the result of pydvd_writer_finish(). Only the flush function may touch Python objects.
+
+void
+pydvd_writer_init(pydvd_writer_t *w, size_t chunk, pydvd_writer_flush_t flush, void *flusharg)
+{
+	memset(w, 0, sizeof(pydvd_writer_t));
+	w->chunk = chunk;
+	w->flush = flush;
+	w->flusharg = flusharg;
+}
+
+static int
+_pydvd_writer_reserve(pydvd_writer_t *w, size_t n)
+{
+	// Returns zero once there is room for @n more bytes and a NUL
+	if (w->len + n + 1 <= w->capacity)
+	{
+		return 0;
+	}
+
+	size_t capacity = (w->capacity ? w->capacity : w->chunk + 256);
+	while (capacity < w->len + n + 1)
+	{
+		capacity *= 2;
+	}
+
+	char *buf = (char*)realloc(w->buf, capacity);
+	if (buf == NULL)
+	{
+		w->failed = PYDVD_WRITER_NOMEM;
+		return -1;
+	}
+	w->buf = buf;
+	w->capacity = capacity;
+	return 0;
+}
+
+static void
+_pydvd_writer_flush(pydvd_writer_t *w)
+{
+	if (w->len && !w->failed)
+	{
+		if (w->flush(w->flusharg, w->buf, w->len))
+		{
+			w->failed = PYDVD_WRITER_FLUSH;
+		}
+	}
+	w->len = 0;
+}
+
+static void
+_pydvd_writer_wrote(pydvd_writer_t *w)
+{
+	if (w->len >= w->chunk)
+	{
+		_pydvd_writer_flush(w);
+	}
+}
+
+void
+pydvd_writer_put(pydvd_writer_t *w, const char *s, size_t n)
+{
+	if (w->failed || _pydvd_writer_reserve(w, n))
+	{
+		return;
+	}
+
+	memcpy(w->buf + w->len, s, n);
+	w->len += n;
+	_pydvd_writer_wrote(w);
+}
+
+void
+pydvd_writer_puts(pydvd_writer_t *w, const char *s)
+{
+	pydvd_writer_put(w, s, strlen(s));
+}
+
+void
+pydvd_writer_printf(pydvd_writer_t *w, const char *fmt, ...)
+{
+	if (w->failed || _pydvd_writer_reserve(w, 64))
+	{
+		return;
+	}
+
+	va_list ap;
+	va_start(ap, fmt);
+	int n = vsnprintf(w->buf + w->len, w->capacity - w->len, fmt, ap);
+	va_end(ap);
+
+	// Didn't fit, make room and format again
+	if (n >= 0 && (size_t)n >= w->capacity - w->len)
+	{
+		if (_pydvd_writer_reserve(w, (size_t)n))
+		{
+			return;
+		}
+		va_start(ap, fmt);
+		n = vsnprintf(w->buf + w->len, w->capacity - w->len, fmt, ap);
+		va_end(ap);
+	}
+	if (n < 0)
+	{
+		return;
+	}
+
+	w->len += (size_t)n;
+	_pydvd_writer_wrote(w);
+}
+
+void
+pydvd_writer_xml(pydvd_writer_t *w, const char *s)
+{
+	pydvd_writer_xmln(w, s, strlen(s));
+}
+
+void
+pydvd_writer_xmln(pydvd_writer_t *w, const char *s, size_t n)
+{
+	// @n bytes of UTF-8 escaped for element text and double quoted attribute values
+	// Control characters other than tab, newline and carriage return can't appear in XML 1.0 at all, so are dropped
+	const char *end = s + n;
+	const char *run = s;
+	for (; s < end; s++)
+	{
+		const char *esc;
+		switch(*s)
+		{
+			case '&': esc = "&amp;"; break;
+			case '<': esc = "&lt;"; break;
+			case '>': esc = "&gt;"; break;
+			case '"': esc = "&quot;"; break;
+			case '\'': esc = "&apos;"; break;
+			case '\t': esc = "&#9;"; break;
+			case '\n': esc = "&#10;"; break;
+			case '\r': esc = "&#13;"; break;
+			default:
+				if ((unsigned char)*s >= 0x20)
+				{
+					continue;
+				}
+				esc = "";
+				break;
+		}
+		pydvd_writer_put(w, run, s - run);
+		pydvd_writer_puts(w, esc);
+		run = s + 1;
+	}
+	pydvd_writer_put(w, run, s - run);
+}
+
+void
+pydvd_writer_json(pydvd_writer_t *w, const char *s)
+{
+	pydvd_writer_jsonn(w, s, strlen(s));
+}
+
+void
+pydvd_writer_jsonn(pydvd_writer_t *w, const char *s, size_t n)
+{
+	// @n bytes of UTF-8 as a quoted JSON string, control characters (NUL included) escaped
+	pydvd_writer_put(w, "\"", 1);
+
+	const char *end = s + n;
+	const char *run = s;
+	for (; s < end; s++)
+	{
+		unsigned char c = (unsigned char)*s;
+		if (c >= 0x20 && c != '"' && c != '\\')
+		{
+			continue;
+		}
+
+		pydvd_writer_put(w, run, s - run);
+		switch(c)
+		{
+			case '"': pydvd_writer_puts(w, "\\\""); break;
+			case '\\': pydvd_writer_puts(w, "\\\\"); break;
+			case '\n': pydvd_writer_puts(w, "\\n"); break;
+			case '\r': pydvd_writer_puts(w, "\\r"); break;
+			case '\t': pydvd_writer_puts(w, "\\t"); break;
+			default: pydvd_writer_printf(w, "\\u%04x", c); break;
+		}
+		run = s + 1;
+	}
+	pydvd_writer_put(w, run, s - run);
+
+	pydvd_writer_put(w, "\"", 1);
+}
+
+int
+pydvd_writer_finish(pydvd_writer_t *w)
+{
+	// Flushes what is left and frees the buffer; returns zero or the PYDVD_WRITER_* failure
+	_pydvd_writer_flush(w);
+
+	free(w->buf);
+	w->buf = NULL;
+	w->capacity = 0;
+	return w->failed;
+}
@@ -0,0 +1,41 @@
+// Subset of libdvdread's dvd_reader.h that the module uses, for building against the test stub
+#ifndef LIBDVDREAD_DVD_READER_H
+#define LIBDVDREAD_DVD_READER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define DVD_VIDEO_LB_LEN 2048
+
+typedef struct dvd_reader_s dvd_reader_t;
+typedef struct dvd_file_s dvd_file_t;
+
+typedef enum
+{
+	DVD_READ_INFO_FILE,
+	DVD_READ_INFO_BACKUP_FILE,
+	DVD_READ_MENU_VOBS,
+	DVD_READ_TITLE_VOBS
+} dvd_read_domain_t;
+
+typedef struct
+{
+	off_t size;
+	int nr_parts;
+	off_t parts_size[9];
+} dvd_stat_t;
+
+dvd_reader_t *DVDOpen(const char *);
+void DVDClose(dvd_reader_t *);
+dvd_file_t *DVDOpenFile(dvd_reader_t *, int, dvd_read_domain_t);
+void DVDCloseFile(dvd_file_t *);
+ssize_t DVDReadBlocks(dvd_file_t *, int, size_t, unsigned char *);
+int32_t DVDFileSeek(dvd_file_t *, int32_t);
+ssize_t DVDReadBytes(dvd_file_t *, void *, size_t);
+ssize_t DVDFileSize(dvd_file_t *);
+int DVDFileStat(dvd_reader_t *, int, dvd_read_domain_t, dvd_stat_t *);
+int DVDDiscID(dvd_reader_t *, unsigned char *);
+int DVDUDFVolumeInfo(dvd_reader_t *, char *, unsigned int, unsigned char *, unsigned int);
+int DVDISOVolumeInfo(dvd_reader_t *, char *, unsigned int, unsigned char *, unsigned int);
+
+#endif
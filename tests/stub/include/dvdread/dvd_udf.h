@@ -0,0 +1,10 @@
+// Subset of libdvdread's dvd_udf.h that the module uses, for building against the test stub
+#ifndef LIBDVDREAD_DVD_UDF_H
+#define LIBDVDREAD_DVD_UDF_H
+
+#include <stdint.h>
+#include "dvd_reader.h"
+
+uint32_t UDFFindFile(dvd_reader_t *, const char *, uint32_t *);
+
+#endif
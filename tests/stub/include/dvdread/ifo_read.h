@@ -0,0 +1,10 @@
+// Subset of libdvdread's ifo_read.h that the module uses, for building against the test stub
+#ifndef LIBDVDREAD_IFO_READ_H
+#define LIBDVDREAD_IFO_READ_H
+
+#include "ifo_types.h"
+
+ifo_handle_t *ifoOpen(dvd_reader_t *, int);
+void ifoClose(ifo_handle_t *);
+
+#endif
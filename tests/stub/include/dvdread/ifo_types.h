@@ -0,0 +1,237 @@
+// Subset of libdvdread's ifo_types.h that the module uses, for building against the test stub
+// The structures keep libdvdread's field names but not its packing, the stub fills them itself
+#ifndef LIBDVDREAD_IFO_TYPES_H
+#define LIBDVDREAD_IFO_TYPES_H
+
+#include <inttypes.h>
+#include "dvd_reader.h"
+
+typedef struct
+{
+	uint8_t hour;
+	uint8_t minute;
+	uint8_t second;
+	uint8_t frame_u;
+} dvd_time_t;
+
+typedef struct
+{
+	unsigned int mpeg_version : 2;
+	unsigned int video_format : 2;
+	unsigned int display_aspect_ratio : 2;
+	unsigned int permitted_df : 2;
+	unsigned int line21_cc_1 : 1;
+	unsigned int line21_cc_2 : 1;
+	unsigned int unknown1 : 1;
+	unsigned int bit_rate : 1;
+	unsigned int picture_size : 2;
+	unsigned int letterboxed : 1;
+	unsigned int film_mode : 1;
+} video_attr_t;
+
+typedef struct
+{
+	unsigned int audio_format : 3;
+	unsigned int multichannel_extension : 1;
+	unsigned int lang_type : 2;
+	unsigned int application_mode : 2;
+	unsigned int quantization : 2;
+	unsigned int sample_frequency : 2;
+	unsigned int unknown1 : 1;
+	unsigned int channels : 3;
+	uint16_t lang_code;
+	uint8_t lang_extension;
+	uint8_t code_extension;
+	uint8_t unknown3;
+} audio_attr_t;
+
+typedef struct
+{
+	unsigned int code_mode : 3;
+	unsigned int zero1 : 3;
+	unsigned int type : 2;
+	uint8_t zero2;
+	uint16_t lang_code;
+	uint8_t lang_extension;
+	uint8_t code_extension;
+} subp_attr_t;
+
+#define BLOCK_TYPE_NONE         0x0
+#define BLOCK_TYPE_ANGLE_BLOCK  0x1
+
+#define BLOCK_MODE_NOT_IN_BLOCK 0x0
+#define BLOCK_MODE_FIRST_CELL   0x1
+#define BLOCK_MODE_IN_BLOCK     0x2
+#define BLOCK_MODE_LAST_CELL    0x3
+
+typedef struct
+{
+	unsigned int block_mode : 2;
+	unsigned int block_type : 2;
+	unsigned int seamless_play : 1;
+	unsigned int interleaved : 1;
+	unsigned int stc_discontinuity : 1;
+	unsigned int seamless_angle : 1;
+	unsigned int zero_1 : 1;
+	unsigned int playback_mode : 1;
+	unsigned int restricted : 1;
+	unsigned int cell_type : 5;
+	uint8_t still_time;
+	uint8_t cell_cmd_nr;
+	dvd_time_t playback_time;
+	uint32_t first_sector;
+	uint32_t first_ilvu_end_sector;
+	uint32_t last_vobu_start_sector;
+	uint32_t last_sector;
+} cell_playback_t;
+
+typedef struct
+{
+	uint16_t vob_id_nr;
+	uint8_t zero_1;
+	uint8_t cell_nr;
+} cell_position_t;
+
+typedef uint8_t pgc_program_map_t;
+
+typedef struct
+{
+	uint16_t zero_1;
+	uint8_t nr_of_programs;
+	uint8_t nr_of_cells;
+	dvd_time_t playback_time;
+	uint32_t prohibited_ops;
+	uint16_t audio_control[8];
+	uint32_t subp_control[32];
+	uint16_t next_pgc_nr;
+	uint16_t prev_pgc_nr;
+	uint16_t goup_pgc_nr;
+	uint8_t pg_playback_mode;
+	uint8_t still_time;
+	uint32_t palette[16];
+	void *command_tbl;
+	pgc_program_map_t *program_map;
+	cell_playback_t *cell_playback;
+	cell_position_t *cell_position;
+	int ref_count;
+} pgc_t;
+
+typedef struct
+{
+	uint8_t entry_id;
+	unsigned int block_mode : 2;
+	unsigned int block_type : 2;
+	unsigned int zero_1 : 4;
+	uint16_t ptl_id_mask;
+	uint32_t pgc_start_byte;
+	pgc_t *pgc;
+} pgci_srp_t;
+
+typedef struct
+{
+	uint16_t nr_of_pgci_srp;
+	uint16_t zero_1;
+	uint32_t last_byte;
+	pgci_srp_t *pgci_srp;
+	int ref_count;
+} pgcit_t;
+
+typedef struct
+{
+	char vmg_identifier[12];
+	uint32_t vmg_last_sector;
+	uint16_t nr_of_title_sets;
+	char provider_identifier[32];
+} vmgi_mat_t;
+
+typedef struct
+{
+	uint8_t pb_ty;
+	uint8_t nr_of_angles;
+	uint16_t nr_of_ptts;
+	uint16_t parental_id;
+	uint8_t title_set_nr;
+	uint8_t vts_ttn;
+	uint32_t title_set_sector;
+} title_info_t;
+
+typedef struct
+{
+	uint16_t nr_of_srpts;
+	uint16_t zero_1;
+	uint32_t last_byte;
+	title_info_t *title;
+} tt_srpt_t;
+
+typedef struct
+{
+	uint16_t pgcn;
+	uint16_t pgn;
+} ptt_info_t;
+
+typedef struct
+{
+	uint16_t nr_of_ptts;
+	ptt_info_t *ptt;
+} ttu_t;
+
+typedef struct
+{
+	uint16_t nr_of_srpts;
+	uint16_t zero_1;
+	uint32_t last_byte;
+	ttu_t *title;
+	uint32_t *ttu_offset;
+} vts_ptt_srpt_t;
+
+typedef struct
+{
+	uint32_t last_byte;
+	uint32_t vts_cat;
+} vts_attributes_t;
+
+typedef struct
+{
+	uint16_t nr_of_vtss;
+	uint16_t zero_1;
+	uint32_t last_byte;
+	vts_attributes_t *vts;
+	uint32_t *vts_atrt_offsets;
+} vts_atrt_t;
+
+typedef struct
+{
+	char vts_identifier[12];
+	uint32_t vts_last_sector;
+	uint32_t vtsi_last_sector;
+	uint32_t vtstt_vobs;
+	video_attr_t vts_video_attr;
+	uint8_t zero_22;
+	uint8_t nr_of_vts_audio_streams;
+	audio_attr_t vts_audio_attr[8];
+	uint8_t zero_23[17];
+	uint8_t nr_of_vts_subp_streams;
+	subp_attr_t vts_subp_attr[32];
+} vtsi_mat_t;
+
+typedef struct
+{
+	dvd_file_t *file;
+	vmgi_mat_t *vmgi_mat;
+	tt_srpt_t *tt_srpt;
+	pgc_t *first_play_pgc;
+	void *ptl_mait;
+	vts_atrt_t *vts_atrt;
+	void *txtdt_mgi;
+	void *pgci_ut;
+	void *menu_c_adt;
+	void *menu_vobu_admap;
+	vtsi_mat_t *vtsi_mat;
+	vts_ptt_srpt_t *vts_ptt_srpt;
+	pgcit_t *vts_pgcit;
+	void *vts_tmapt;
+	void *vts_c_adt;
+	void *vts_vobu_admap;
+} ifo_handle_t;
+
+#endif
@@ -0,0 +1,10 @@
+// Subset of libdvdread's nav_read.h that the module uses, for building against the test stub
+#ifndef LIBDVDREAD_NAV_READ_H
+#define LIBDVDREAD_NAV_READ_H
+
+#include "ifo_types.h"
+#include "nav_types.h"
+
+void navRead_DSI(dsi_t *, unsigned char *);
+
+#endif
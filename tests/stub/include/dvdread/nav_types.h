@@ -0,0 +1,65 @@
+// Subset of libdvdread's nav_types.h that the module uses, for building against the test stub
+// The structures keep libdvdread's field names but not its packing, the stub fills them itself
+#ifndef LIBDVDREAD_NAV_TYPES_H
+#define LIBDVDREAD_NAV_TYPES_H
+
+#include <inttypes.h>
+#include "ifo_types.h"
+
+#define DSI_START_BYTE 1031
+#define SRI_END_OF_CELL 0x3fffffff
+
+typedef struct
+{
+	uint32_t nv_pck_scr;
+	uint32_t nv_pck_lbn;
+	uint32_t vobu_ea;
+	uint32_t vobu_1stref_ea;
+	uint32_t vobu_2ndref_ea;
+	uint32_t vobu_3rdref_ea;
+	uint16_t vobu_vob_idn;
+	uint8_t zero1;
+	uint8_t vobu_c_idn;
+	dvd_time_t c_eltm;
+} dsi_gi_t;
+
+typedef struct
+{
+	uint16_t category;
+	uint32_t ilvu_ea;
+	uint32_t ilvu_sa;
+	uint16_t size;
+	uint32_t vob_v_s_s_ptm;
+	uint32_t vob_v_e_e_ptm;
+} sml_pbi_t;
+
+typedef struct
+{
+	uint32_t address;
+	uint16_t size;
+} sml_agl_data_t;
+
+typedef struct
+{
+	sml_agl_data_t data[9];
+} sml_agli_t;
+
+typedef struct
+{
+	uint32_t next_video;
+	uint32_t fwda[19];
+	uint32_t next_vobu;
+	uint32_t prev_vobu;
+	uint32_t bwda[19];
+	uint32_t prev_video;
+} vobu_sri_t;
+
+typedef struct
+{
+	dsi_gi_t dsi_gi;
+	sml_pbi_t sml_pbi;
+	sml_agli_t sml_agli;
+	vobu_sri_t vobu_sri;
+} dsi_t;
+
+#endif
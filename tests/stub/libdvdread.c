@@ -0,0 +1,509 @@
+// Stub of the parts of libdvdread the module uses, so the tests can run without a disc
+//
+// Any existing path opens as a disc of STUBDVD_VTS (default 4) title sets with two titles each. Title VOBs are
+// 1000 blocks, every other file 10. Block b of title set v starts with a pack header, then v and b (16 bits,
+// little endian) in bytes 4 to 6, and the rest of it is (v*31 + b) & 0xff. Title set 2 title 1 has a two angle
+// interleaved block, title set 1 title 1 a plain angle block.
+//
+// Faults and delays come from the environment, read on every call so a test can change them between reads:
+//   STUBDVD_BAD, STUBDVD_BADLEN  reads of blocks BAD to BAD+BADLEN-1 (BADLEN default 1) of any file fail
+//   STUBDVD_READ_US              microseconds each DVDReadBlocks() call takes
+//   STUBDVD_IFO_US               microseconds each ifoOpen() call takes
+//   STUBDVD_FAILIFO              ifoOpen() of this title set fails
+//   STUBDVD_DISCID               DVDDiscID() is this string repeated rather than derived from the path
+//   STUBDVD_LANG                 hex lang_code of every title set's first audio stream
+
+#include <dvdread/dvd_reader.h>
+#include <dvdread/dvd_udf.h>
+#include <dvdread/ifo_read.h>
+#include <dvdread/nav_read.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct dvd_reader_s
+{
+	char path[4096];
+	int nvts;
+	int fd;
+};
+
+struct dvd_file_s
+{
+	dvd_reader_t *dvd;
+	int vts;
+	dvd_read_domain_t domain;
+	int pos;
+};
+
+// Number of successful ifoOpen() calls, for tests of lazy loading
+int stub_ifoopen_count = 0;
+
+static int
+_stub_env(const char *name, int def)
+{
+	const char *s = getenv(name);
+	return (s ? atoi(s) : def);
+}
+
+// Takes the delay in microseconds of the variable @name; usleep(0) still costs tens of microseconds, so none is
+// called without one
+static void
+_stub_delay(const char *name)
+{
+	int us = _stub_env(name, 0);
+	if (us > 0)
+	{
+		usleep(us);
+	}
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Reader and files
+
+dvd_reader_t*
+DVDOpen(const char *path)
+{
+	struct stat st;
+	if (stat(path, &st))
+	{
+		return NULL;
+	}
+
+	dvd_reader_t *d = (dvd_reader_t*)calloc(1, sizeof(dvd_reader_t));
+	strncpy(d->path, path, sizeof(d->path) - 1);
+	d->nvts = _stub_env("STUBDVD_VTS", 4);
+	d->fd = (S_ISDIR(st.st_mode) ? -1 : open(path, O_RDONLY));
+	return d;
+}
+
+void
+DVDClose(dvd_reader_t *d)
+{
+	if (d->fd >= 0)
+	{
+		close(d->fd);
+	}
+
+	// Poisoned so a use after close shows up
+	memset(d, 0xab, sizeof(dvd_reader_t));
+	free(d);
+}
+
+dvd_file_t*
+DVDOpenFile(dvd_reader_t *d, int vts, dvd_read_domain_t domain)
+{
+	if (vts < 0 || vts > d->nvts)
+	{
+		return NULL;
+	}
+
+	dvd_file_t *f = (dvd_file_t*)calloc(1, sizeof(dvd_file_t));
+	f->dvd = d;
+	f->vts = vts;
+	f->domain = domain;
+	return f;
+}
+
+void
+DVDCloseFile(dvd_file_t *f)
+{
+	if (f == NULL)
+	{
+		return;
+	}
+
+	// Closing a file after its reader hits the poison
+	if (f->dvd->nvts < 0)
+	{
+		abort();
+	}
+	free(f);
+}
+
+ssize_t
+DVDFileSize(dvd_file_t *f)
+{
+	return (f->domain == DVD_READ_TITLE_VOBS ? 1000 : 10);
+}
+
+int
+DVDFileStat(dvd_reader_t *d, int vts, dvd_read_domain_t domain, dvd_stat_t *st)
+{
+	memset(st, 0, sizeof(dvd_stat_t));
+	st->size = 1000 * DVD_VIDEO_LB_LEN;
+	st->nr_parts = 1;
+	st->parts_size[0] = st->size;
+	return 0;
+}
+
+ssize_t
+DVDReadBlocks(dvd_file_t *f, int offset, size_t blocks, unsigned char *buf)
+{
+	int bad = _stub_env("STUBDVD_BAD", -1);
+	int badlen = _stub_env("STUBDVD_BADLEN", 1);
+	ssize_t size = DVDFileSize(f);
+
+	if (offset < 0)
+	{
+		return -1;
+	}
+	if (offset >= size)
+	{
+		return 0;
+	}
+	if ((ssize_t)offset + (ssize_t)blocks > size)
+	{
+		blocks = (size_t)(size - offset);
+	}
+
+	for (size_t i=0; i < blocks; i++)
+	{
+		int b = offset + (int)i;
+		unsigned char *blk = buf + i * DVD_VIDEO_LB_LEN;
+
+		// Like a drive, the whole read fails
+		if (bad >= 0 && b >= bad && b < bad + badlen)
+		{
+			return -1;
+		}
+
+		memset(blk, (f->vts * 31 + b) & 0xff, DVD_VIDEO_LB_LEN);
+		memcpy(blk, "\x00\x00\x01\xba", 4);
+		blk[4] = (unsigned char)f->vts;
+		blk[5] = (unsigned char)(b & 0xff);
+		blk[6] = (unsigned char)((b >> 8) & 0xff);
+
+		// NAV packs of the interleaved angle block, one every ten blocks from 40 to 110
+		if (f->vts == 2 && f->domain == DVD_READ_TITLE_VOBS && b >= 40 && b < 120 && (b - 40) % 10 == 0)
+		{
+			blk[41] = 0xbf;
+			blk[1027] = 0xbf;
+		}
+	}
+
+	_stub_delay("STUBDVD_READ_US");
+	return (ssize_t)blocks;
+}
+
+int32_t
+DVDFileSeek(dvd_file_t *f, int32_t offset)
+{
+	f->pos = offset;
+	return offset;
+}
+
+ssize_t
+DVDReadBytes(dvd_file_t *f, void *buf, size_t size)
+{
+	memset(buf, 0, size);
+	return (ssize_t)size;
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// Disc identity
+
+int
+DVDDiscID(dvd_reader_t *d, unsigned char *md5)
+{
+	const char *id = getenv("STUBDVD_DISCID");
+	for (int i=0; i < 16; i++)
+	{
+		md5[i] = (unsigned char)(id ? id[i % strlen(id)] : d->path[i % 8] * (i + 1) + d->nvts);
+	}
+	return 0;
+}
+
+static int
+_stub_readPVD(dvd_reader_t *d, unsigned char *pvd)
+{
+	// ISO9660 primary volume descriptor of an image file, at block 16
+	if (d->fd < 0)
+	{
+		return -1;
+	}
+	if (pread(d->fd, pvd, DVD_VIDEO_LB_LEN, 16 * DVD_VIDEO_LB_LEN) != DVD_VIDEO_LB_LEN)
+	{
+		return -1;
+	}
+	if (memcmp(pvd + 1, "CD001", 5))
+	{
+		return -1;
+	}
+	return 0;
+}
+
+int
+DVDISOVolumeInfo(dvd_reader_t *d, char *volid, unsigned int volid_size, unsigned char *volsetid, unsigned int volsetid_size)
+{
+	unsigned char pvd[DVD_VIDEO_LB_LEN];
+	if (_stub_readPVD(d, pvd))
+	{
+		return -1;
+	}
+
+	if (volid && volid_size)
+	{
+		unsigned int n = (volid_size - 1 < 32 ? volid_size - 1 : 32);
+		memcpy(volid, pvd + 40, n);
+		volid[n] = 0;
+	}
+	if (volsetid && volsetid_size)
+	{
+		memcpy(volsetid, pvd + 190, (volsetid_size < 128 ? volsetid_size : 128));
+	}
+	return 0;
+}
+
+int
+DVDUDFVolumeInfo(dvd_reader_t *d, char *volid, unsigned int volid_size, unsigned char *volsetid, unsigned int volsetid_size)
+{
+	return -1;
+}
+
+uint32_t
+UDFFindFile(dvd_reader_t *d, const char *filename, uint32_t *size)
+{
+	static const struct
+	{
+		const char *name;
+		uint32_t lb;
+		uint32_t size;
+	} files[] = {
+		{"/VIDEO_TS/VIDEO_TS.IFO", 300, 10 * DVD_VIDEO_LB_LEN},
+		{"/VIDEO_TS/VIDEO_TS.BUP", 310, 10 * DVD_VIDEO_LB_LEN},
+		{"/VIDEO_TS/VTS_01_0.IFO", 320, 5 * DVD_VIDEO_LB_LEN + 100},
+		{"/VIDEO_TS/VTS_01_1.VOB", 400, 700 * DVD_VIDEO_LB_LEN},
+		{"/VIDEO_TS/VTS_02_0.IFO", 1150, 0}
+	};
+
+	for (size_t i=0; i < sizeof(files) / sizeof(files[0]); i++)
+	{
+		if (!strcmp(files[i].name, filename))
+		{
+			*size = files[i].size;
+			return files[i].lb;
+		}
+	}
+	return 0;
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// IFOs
+
+static void
+_stub_setTime(dvd_time_t *t, int seconds, int frames)
+{
+	// BCD time at 25 fps
+	t->hour = 0;
+	t->minute = (uint8_t)((((seconds / 60) / 10) << 4) | ((seconds / 60) % 10));
+	t->second = (uint8_t)((((seconds % 60) / 10) << 4) | ((seconds % 60) % 10));
+	t->frame_u = (uint8_t)((frames << 6) | 0x12);
+}
+
+static void
+_stub_openVMG(dvd_reader_t *d, ifo_handle_t *h)
+{
+	h->vmgi_mat = (vmgi_mat_t*)calloc(1, sizeof(vmgi_mat_t));
+	memcpy(h->vmgi_mat->vmg_identifier, "DVDVIDEO-VMG", 12);
+	memcpy(h->vmgi_mat->provider_identifier, "STUB PROVIDER", 13);
+
+	h->vts_atrt = (vts_atrt_t*)calloc(1, sizeof(vts_atrt_t));
+	h->vts_atrt->nr_of_vtss = (uint16_t)d->nvts;
+
+	h->tt_srpt = (tt_srpt_t*)calloc(1, sizeof(tt_srpt_t));
+	h->tt_srpt->nr_of_srpts = (uint16_t)(d->nvts * 2);
+	h->tt_srpt->title = (title_info_t*)calloc(d->nvts * 2, sizeof(title_info_t));
+	for (int i=0; i < d->nvts * 2; i++)
+	{
+		h->tt_srpt->title[i].title_set_nr = (uint8_t)(i / 2 + 1);
+		h->tt_srpt->title[i].vts_ttn = (uint8_t)(i % 2 + 1);
+		h->tt_srpt->title[i].nr_of_angles = (uint8_t)(1 + (i == 0));
+	}
+}
+
+static void
+_stub_openVTS(ifo_handle_t *h, int vts)
+{
+	const char *lang = getenv("STUBDVD_LANG");
+
+	vtsi_mat_t *mat = (vtsi_mat_t*)calloc(1, sizeof(vtsi_mat_t));
+	h->vtsi_mat = mat;
+	mat->vts_video_attr.display_aspect_ratio = (vts % 2 ? 3 : 0);
+	mat->vts_video_attr.video_format = vts % 2;
+	mat->nr_of_vts_audio_streams = 3;
+	mat->vts_audio_attr[0].lang_code = (lang ? (uint16_t)strtol(lang, NULL, 16) : ('e' << 8) | 'n');
+	mat->vts_audio_attr[1].lang_code = ('f' << 8) | 'r';
+	mat->vts_audio_attr[1].audio_format = 6;
+	mat->vts_audio_attr[2].lang_code = ('d' << 8) | 'e';
+	mat->nr_of_vts_subp_streams = 3;
+	mat->vts_subp_attr[0].lang_code = ('e' << 8) | 's';
+	mat->vts_subp_attr[1].lang_code = ('j' << 8) | 'a';
+	mat->vts_subp_attr[2].lang_code = ('z' << 8) | 'h';
+
+	h->vts_ptt_srpt = (vts_ptt_srpt_t*)calloc(1, sizeof(vts_ptt_srpt_t));
+	h->vts_ptt_srpt->nr_of_srpts = 2;
+	h->vts_ptt_srpt->title = (ttu_t*)calloc(2, sizeof(ttu_t));
+	h->vts_pgcit = (pgcit_t*)calloc(1, sizeof(pgcit_t));
+	h->vts_pgcit->nr_of_pgci_srp = 2;
+	h->vts_pgcit->pgci_srp = (pgci_srp_t*)calloc(2, sizeof(pgci_srp_t));
+
+	// Title t plays PGC t+1, of 5+3t+vts cells of 40 blocks from block 500t
+	for (int t=0; t < 2; t++)
+	{
+		ttu_t *ttu = &h->vts_ptt_srpt->title[t];
+		ttu->nr_of_ptts = 1;
+		ttu->ptt = (ptt_info_t*)calloc(1, sizeof(ptt_info_t));
+		ttu->ptt[0].pgcn = (uint16_t)(t + 1);
+
+		pgc_t *p = (pgc_t*)calloc(1, sizeof(pgc_t));
+		h->vts_pgcit->pgci_srp[t].pgc = p;
+
+		int ncells = 5 + t * 3 + vts;
+		int nprog = 3 + t;
+		p->nr_of_cells = (uint8_t)ncells;
+		p->nr_of_programs = (uint8_t)nprog;
+		p->audio_control[0] = 0x8000;
+		p->audio_control[1] = 0x8000;
+		p->audio_control[2] = (t ? 0x8000 : 0);
+		// Subpictures es and ja, then ja and zh, so numbering has to skip the streams a title leaves out
+		p->subp_control[0] = (t ? 0 : 0x80000000);
+		p->subp_control[1] = 0x80000000;
+		p->subp_control[2] = (t ? 0x80000000 : 0);
+
+		p->program_map = (pgc_program_map_t*)calloc(nprog, 1);
+		for (int i=0; i < nprog; i++)
+		{
+			p->program_map[i] = (uint8_t)(1 + i * (ncells / nprog));
+		}
+
+		int total = 0;
+		p->cell_playback = (cell_playback_t*)calloc(ncells, sizeof(cell_playback_t));
+		for (int c=0; c < ncells; c++)
+		{
+			_stub_setTime(&p->cell_playback[c].playback_time, 10 + c * 7, 3);
+			total += 10 + c * 7;
+			p->cell_playback[c].first_sector = (uint32_t)(c * 40 + t * 500);
+			p->cell_playback[c].last_sector = (uint32_t)(c * 40 + t * 500 + 39);
+		}
+		_stub_setTime(&p->playback_time, total, 3);
+
+		if (t == 0 && (vts == 1 || vts == 2))
+		{
+			cell_playback_t *a = &p->cell_playback[1];
+			cell_playback_t *b = &p->cell_playback[2];
+			a->block_type = BLOCK_TYPE_ANGLE_BLOCK;
+			a->block_mode = BLOCK_MODE_FIRST_CELL;
+			b->block_type = BLOCK_TYPE_ANGLE_BLOCK;
+			b->block_mode = BLOCK_MODE_LAST_CELL;
+
+			// Angle 1 VOBUs at 40, 60, 80 and 100 and angle 2 at 50, 70, 90 and 110, ten blocks each
+			if (vts == 2)
+			{
+				a->interleaved = 1;
+				b->interleaved = 1;
+				a->first_sector = 40;
+				a->last_sector = 109;
+				b->first_sector = 50;
+				b->last_sector = 119;
+			}
+		}
+	}
+}
+
+ifo_handle_t*
+ifoOpen(dvd_reader_t *d, int vts)
+{
+	if (vts < 0 || vts > d->nvts)
+	{
+		return NULL;
+	}
+	if (_stub_env("STUBDVD_FAILIFO", -1) == vts)
+	{
+		return NULL;
+	}
+
+	_stub_delay("STUBDVD_IFO_US");
+	__sync_fetch_and_add(&stub_ifoopen_count, 1);
+
+	ifo_handle_t *h = (ifo_handle_t*)calloc(1, sizeof(ifo_handle_t));
+	h->file = DVDOpenFile(d, vts, DVD_READ_INFO_FILE);
+	if (vts == 0)
+	{
+		_stub_openVMG(d, h);
+	}
+	else
+	{
+		_stub_openVTS(h, vts);
+	}
+	return h;
+}
+
+void
+ifoClose(ifo_handle_t *h)
+{
+	if (h == NULL)
+	{
+		return;
+	}
+
+	DVDCloseFile(h->file);
+	if (h->vmgi_mat)
+	{
+		free(h->vmgi_mat);
+		free(h->vts_atrt);
+		free(h->tt_srpt->title);
+		free(h->tt_srpt);
+	}
+	if (h->vtsi_mat)
+	{
+		for (int t=0; t < 2; t++)
+		{
+			pgc_t *p = h->vts_pgcit->pgci_srp[t].pgc;
+			free(p->program_map);
+			free(p->cell_playback);
+			free(p);
+			free(h->vts_ptt_srpt->title[t].ptt);
+		}
+		free(h->vts_pgcit->pgci_srp);
+		free(h->vts_pgcit);
+		free(h->vts_ptt_srpt->title);
+		free(h->vts_ptt_srpt);
+		free(h->vtsi_mat);
+	}
+
+	memset(h, 0xcd, sizeof(ifo_handle_t));
+	free(h);
+}
+
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+// NAV packs
+
+void
+navRead_DSI(dsi_t *dsi, unsigned char *buf)
+{
+	// Only the interleaved angle block of title set 2 has VOBUs that chain, to the next of its angle 20 on
+	unsigned char *blk = buf - DSI_START_BYTE;
+	int b = blk[5] | (blk[6] << 8);
+
+	memset(dsi, 0, sizeof(dsi_t));
+	dsi->vobu_sri.next_vobu = SRI_END_OF_CELL;
+	dsi->dsi_gi.nv_pck_lbn = (uint32_t)b;
+
+	if (blk[4] == 2 && b >= 40 && b < 120)
+	{
+		dsi->dsi_gi.vobu_ea = 9;
+		if (b + 20 < 120)
+		{
+			dsi->vobu_sri.next_vobu = 0x80000000u | 20;
+		}
+	}
+}
@@ -0,0 +1,133 @@
+"""
+Builds the module against the stub libdvdread in tests/stub so tests (and bench/) run without a disc or drive.
+
+The stub and the module are compiled once per process into a temporary directory, removed at exit.
+Set PYDVD_TEST_BUILD to a directory to build there instead and keep the result, and PYDVD_TEST_TREE to build the
+module from another checkout (to compare revisions; the stub always comes from this one).
+See tests/stub/libdvdread.c for the disc it pretends to be and the STUBDVD_* variables that inject faults.
+"""
+
+import atexit
+import contextlib
+import ctypes
+import importlib
+import os
+import shutil
+import subprocess
+import sys
+import sysconfig
+import tempfile
+
+TOP = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+STUB = os.path.join(TOP, 'tests', 'stub')
+
+# Block size of everything
+BLOCK = 2048
+
+_built = None
+
+def Build(top=TOP):
+	"""
+	Builds the stub and the module from the tree at @top (default this one) into a directory and returns it.
+	The directory holds libdvdread.so and lib/_dvdread*.so.
+	"""
+
+	outdir = os.environ.get('PYDVD_TEST_BUILD')
+	if outdir:
+		os.makedirs(outdir, exist_ok=True)
+	else:
+		outdir = tempfile.mkdtemp(prefix='pydvdread-test-')
+		atexit.register(shutil.rmtree, outdir, True)
+
+	cc = os.environ.get('CC') or sysconfig.get_config_var('CC').split()[0]
+	inc = os.path.join(STUB, 'include')
+	subprocess.check_call([cc, '-shared', '-fPIC', '-O1', '-g', '-std=gnu99', '-I' + inc, os.path.join(STUB, 'libdvdread.c'), '-o', os.path.join(outdir, 'libdvdread.so')])
+
+	env = dict(os.environ)
+	env['CFLAGS'] = '-I%s -g -O1 %s' % (inc, env.get('CFLAGS', ''))
+	env['LDFLAGS'] = '-L%s -Wl,-rpath,%s %s' % (outdir, outdir, env.get('LDFLAGS', ''))
+	subprocess.check_call([sys.executable, '-W', 'ignore', 'setup.py', '-q', 'build_ext', '-f', '-b', os.path.join(outdir, 'lib'), '-t', os.path.join(outdir, 'tmp')], cwd=top, env=env, stdout=subprocess.DEVNULL)
+
+	return outdir
+
+def Load():
+	"""
+	Builds this tree against the stub if it hasn't been yet and returns the _dvdread module.
+	"""
+
+	global _built
+
+	if _built is None:
+		_built = Build(os.environ.get('PYDVD_TEST_TREE') or TOP)
+		sys.path.insert(0, os.path.join(_built, 'lib'))
+
+	return importlib.import_module('_dvdread')
+
+def StubLibrary():
+	"""
+	Returns the stub libdvdread loaded with ctypes, for its stub_ifoopen_count.
+	"""
+
+	Load()
+	return ctypes.CDLL(os.path.join(_built, 'libdvdread.so'))
+
+@contextlib.contextmanager
+def StubEnv(**kwargs):
+	"""
+	Sets STUBDVD_* variables (given without the prefix, None to unset) for the duration of a with block.
+	The stub reads them on every call so they take effect at once.
+	"""
+
+	old = {}
+	for k,v in kwargs.items():
+		k = 'STUBDVD_' + k
+		old[k] = os.environ.get(k)
+		if v is None:
+			os.environ.pop(k, None)
+		else:
+			os.environ[k] = str(v)
+
+	try:
+		yield
+	finally:
+		for k,v in old.items():
+			if v is None:
+				os.environ.pop(k, None)
+			else:
+				os.environ[k] = v
+
+def StubBlock(vts, block):
+	"""
+	Returns the bytes the stub reads for @block of title set @vts's title VOBs.
+	"""
+
+	b = bytearray([(vts*31 + block) & 0xff]) * BLOCK
+	b[0:7] = bytes([0, 0, 1, 0xba, vts, block & 0xff, (block >> 8) & 0xff])
+	if vts == 2 and 40 <= block < 120 and (block - 40) % 10 == 0:
+		b[41] = 0xbf
+		b[1027] = 0xbf
+	return bytes(b)
+
+def MakeImage(path, blocks, volid='PYDVD_TEST'):
+	"""
+	Writes an image of @blocks blocks to @path: an ISO9660 primary volume descriptor of @volid at block 16 and
+	every other block filled with its own number plus one, so none reads as zeros. Returns the contents.
+	"""
+
+	data = bytearray()
+	for i in range(blocks):
+		data += (i + 1).to_bytes(4, 'little') * (BLOCK // 4)
+
+	# Both byte orders of the volume size and block size
+	pvd = bytearray(BLOCK)
+	pvd[0:6] = b'\x01CD001'
+	pvd[40:72] = volid.encode('ascii').ljust(32)
+	pvd[80:84] = blocks.to_bytes(4, 'little')
+	pvd[84:88] = blocks.to_bytes(4, 'big')
+	pvd[128:130] = BLOCK.to_bytes(2, 'little')
+	pvd[130:132] = BLOCK.to_bytes(2, 'big')
+	data[16*BLOCK:17*BLOCK] = pvd
+
+	with open(path, 'wb') as f:
+		f.write(data)
+	return bytes(data)
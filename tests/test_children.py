@@ -0,0 +1,137 @@
+"""
+Titles, chapters, audios and subpictures handed out again while they are alive, and what they hold on to.
+"""
+
+import gc
+import inspect
+import os
+import sys
+import tempfile
+import unittest
+
+import support
+
+_dvdread = support.Load()
+
+class MyAudio(_dvdread.Audio):
+	# Constructed through the class rather than filled in directly
+	def __init__(self, title, audionum):
+		super().__init__(title, audionum)
+		self.made = True
+
+class MyTitle(_dvdread.Title):
+	def __init__(self, dvd, ifonum, titlenum):
+		super().__init__(dvd, ifonum, titlenum, AudioClass=MyAudio)
+
+class ChildrenTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.path = os.path.join(cls.tmp.name, 'disc.iso')
+		support.MakeImage(cls.path, 32)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	def _open(self, **kw):
+		dvd = _dvdread.DVD(self.path, **kw)
+		dvd.Open()
+		self.addCleanup(lambda: dvd.IsOpen and dvd.Close())
+		return dvd
+
+	def test_SameWhileAlive(self):
+		dvd = self._open()
+		t = dvd.GetTitle(3)
+		self.assertIs(dvd.GetTitle(3), t)
+		self.assertIs(dvd[2], t)
+		self.assertIs(dvd.Titles[2], t)
+		self.assertIs(list(dvd)[2], t)
+
+		c = t.GetChapter(2)
+		self.assertIs(t.GetChapter(2), c)
+		self.assertIs(t[1], c)
+		self.assertIs(t.Chapters[1], c)
+		a = t.GetAudio(1)
+		self.assertIs(t.Audios[0], a)
+		s = t.GetSubpicture(2)
+		self.assertIs(t.Subpictures[1], s)
+		self.assertIs(c.Title, t)
+
+	def test_ThroughClass(self):
+		dvd = self._open(TitleClass=MyTitle)
+		t = dvd.GetTitle(1)
+		self.assertIsInstance(t, MyTitle)
+		a = t.GetAudio(2)
+		self.assertTrue(a.made)
+		self.assertIs(t.GetAudio(2), a)
+		self.assertEqual(a.LangCode, t.Audios[1].LangCode)
+
+	def test_Constructors(self):
+		# The package classes have no __init__ of their own, so these are the arguments they take
+		for cls, params in ((_dvdread.Audio, 'Title, AudioNum'), (_dvdread.Subpicture, 'Title, SubpictureNum'),
+				(_dvdread.Chapter, 'Title, ChapterNum, StartCell, EndCell, LenMS, LenFancy')):
+			sub = type('Sub' + cls.__name__, (cls,), {})
+			self.assertEqual(str(inspect.signature(sub)), '(%s)' % params)
+
+		dvd = self._open()
+		t = dvd.GetTitle(2)
+		a = _dvdread.Audio(Title=t, AudioNum=3)
+		self.assertEqual(a.LangCode, t.GetAudio(3).LangCode)
+		self.assertEqual(_dvdread.Subpicture(t, 2).LangCode, t.GetSubpicture(2).LangCode)
+		c = _dvdread.Chapter(t, 1, 1, 2, 1500, '00:00:01.500')
+		self.assertEqual((c.StartCell, c.EndCell, c.Length), (1, 2, 1500))
+		with self.assertRaises(TypeError):
+			_dvdread.Audio(t)
+
+	def test_NotTracked(self):
+		# Nothing refers back to a child, so none needs the cycle collector
+		dvd = self._open()
+		t = dvd.GetTitle(1)
+		for obj in (dvd, t, t.GetChapter(1), t.GetAudio(1), t.GetSubpicture(1)):
+			self.assertFalse(gc.is_tracked(obj), type(obj).__name__)
+
+	def test_NoCycles(self):
+		# Children only hold their parents, so dropping them gives every reference back without the collector
+		dvd = self._open()
+		gc.disable()
+		self.addCleanup(gc.enable)
+		before = sys.getrefcount(dvd)
+		for t in dvd.Titles:
+			t.Chapters, t.Audios, t.Subpictures
+		t = None
+		self.assertEqual(sys.getrefcount(dvd), before)
+
+		t = dvd.GetTitle(2)
+		before = sys.getrefcount(t)
+		a = t.GetAudio(3)
+		a = t.Audios[2]
+		self.assertEqual(sys.getrefcount(t), before + 1)
+		a = None
+		self.assertEqual(sys.getrefcount(t), before)
+
+	def test_OutlivesClose(self):
+		dvd = self._open()
+		t = dvd.GetTitle(2)
+		c = t.GetChapter(1)
+		dvd.Close()
+
+		# Still there, but only readable with the disc open (see test_detach)
+		self.assertIs(c.Title, t)
+		with self.assertRaisesRegex(Exception, 'not open'):
+			c.Length
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.PlaybackTime
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.GetChapter(1)
+
+		# Reopening makes new titles rather than handing out those of the disc that was open
+		dvd.Open()
+		t2 = dvd.GetTitle(2)
+		self.assertIsNot(t2, t)
+		self.assertIs(dvd.GetTitle(2), t2)
+		self.assertIsNot(t2.GetChapter(1), c)
+		self.assertIs(t.GetChapter(1), c)
+
+if __name__ == '__main__':
+	unittest.main()
@@ -0,0 +1,109 @@
+"""
+Title.Detach() and DVD.Detach(): reading titles and their children after Close().
+"""
+
+import os
+import tempfile
+import unittest
+
+import support
+
+_dvdread = support.Load()
+
+class MyAudio(_dvdread.Audio):
+	# Constructed through the class rather than filled in directly
+	def __init__(self, title, audionum):
+		super().__init__(title, audionum)
+
+class MyTitle(_dvdread.Title):
+	def __init__(self, dvd, ifonum, titlenum):
+		super().__init__(dvd, ifonum, titlenum, AudioClass=MyAudio)
+
+def Describe(t):
+	# Everything the getters give about a title and its children
+	return (
+		t.TitleNum, t.PlaybackTime, t.PlaybackTimeFancy, t.FrameRate, t.AspectRatio, t.NumberOfAngles,
+		[(c.Length, c.LengthFancy, c.StartCell, c.EndCell) for c in t.Chapters],
+		[(a.LangCode, a.LangCode3, a.Language, a.Format, a.SamplingRate) for a in t.Audios],
+		[(s.LangCode, s.LangCode3, s.Language) for s in t.Subpictures],
+	)
+
+class DetachTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.path = os.path.join(cls.tmp.name, 'disc.iso')
+		support.MakeImage(cls.path, 32)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	def _open(self, **kw):
+		dvd = _dvdread.DVD(self.path, **kw)
+		dvd.Open()
+		self.addCleanup(lambda: dvd.IsOpen and dvd.Close())
+		return dvd
+
+	def test_Title(self):
+		dvd = self._open()
+		t = dvd.GetTitle(3)
+		want = Describe(t)
+		self.assertFalse(t.IsDetached)
+		self.assertIs(t.Detach(), t)
+		self.assertTrue(t.IsDetached)
+		self.assertIs(t.Detach(), t)
+		dvd.Close()
+
+		# Children made after Close() come from the title's copies
+		self.assertEqual(Describe(t), want)
+		self.assertEqual(t.GetAudio(2).LangCode, want[7][1][0])
+		self.assertEqual(t.GetSubpicture(1).Language, want[8][0][2])
+		self.assertEqual(t[0].Length, want[6][0][0])
+		self.assertEqual(len(t), len(want[6]))
+
+		# Reading the disc still needs it open
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.OpenStream()
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.CellAtTime(0)
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.GetChapter(1).OpenStream()
+
+	def test_NotDetached(self):
+		dvd = self._open()
+		t = dvd.GetTitle(2)
+		a = t.GetAudio(1)
+		dvd.Close()
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.PlaybackTime
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.GetAudio(1)
+		with self.assertRaisesRegex(Exception, 'not open'):
+			a.LangCode
+		with self.assertRaisesRegex(Exception, 'not open'):
+			t.Detach()
+
+	def test_DVD(self):
+		dvd = self._open(TitleClass=MyTitle)
+		want = [Describe(t) for t in dvd]
+		titles = dvd.Detach()
+		self.assertEqual(len(titles), dvd.NumberOfTitles)
+		dvd.Close()
+
+		self.assertTrue(all(t.IsDetached for t in titles))
+		self.assertEqual([Describe(t) for t in titles], want)
+		self.assertIsInstance(titles[0].GetAudio(1), MyAudio)
+
+	def test_Reopen(self):
+		# A detached title stays with the disc it came from
+		dvd = self._open()
+		t = dvd.GetTitle(1).Detach()
+		dvd.Close()
+		dvd.Open()
+		self.assertIsNot(dvd.GetTitle(1), t)
+		self.assertEqual(Describe(t), Describe(dvd.GetTitle(1)))
+		self.assertIs(t.GetAudio(1).Title, t)
+
+if __name__ == '__main__':
+	unittest.main()
@@ -0,0 +1,174 @@
+"""
+MergeImages() over sparse partial images of one disc.
+"""
+
+import os
+import tempfile
+import unittest
+
+import support
+
+_dvdread = support.Load()
+BLOCK = support.BLOCK
+
+# Disc size; holes are whole 4 KiB file system blocks so the file system keeps them as holes
+BLOCKS = 1024
+
+class MergeTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.ref = support.MakeImage(cls._path('disc.iso'), BLOCKS)
+
+		# Holes only mean something where SEEK_HOLE sees them
+		probe = cls._path('probe')
+		with open(probe, 'wb') as f:
+			f.truncate(1 << 20)
+		with open(probe, 'rb') as f:
+			cls.sparse = (os.lseek(f.fileno(), 0, os.SEEK_HOLE) == 0)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	@classmethod
+	def _path(cls, name):
+		return os.path.join(cls.tmp.name, name)
+
+	def setUp(self):
+		if not self.sparse:
+			self.skipTest('temporary directory has no sparse files')
+
+		env = support.StubEnv(DISCID='same disc')
+		env.__enter__()
+		self.addCleanup(env.__exit__, None, None, None)
+
+	def _image(self, name, holes, blocks=BLOCKS):
+		# Writes the disc's first @blocks blocks leaving (first, blocks) @holes unwritten
+		path = self._path(name)
+		missing = set()
+		for first, n in holes:
+			missing.update(range(first, first + n))
+
+		with open(path, 'wb') as f:
+			f.truncate(blocks*BLOCK)
+			b = 0
+			while b < blocks:
+				if b in missing:
+					b += 1
+					continue
+				e = b
+				while e < blocks and e not in missing:
+					e += 1
+				f.seek(b*BLOCK)
+				f.write(self.ref[b*BLOCK:e*BLOCK])
+				b = e
+
+		return path
+
+	def _mapfile(self, path):
+		with open(path) as f:
+			return [l for l in f.read().splitlines() if not l.startswith('#')]
+
+	def _assertSource(self, src, holes):
+		# What a source says it read is what it has, and its counts agree with its map
+		for first, n, status in src.Map:
+			if status == '+':
+				for hfirst, hn in holes:
+					self.assertFalse(first < hfirst + hn and hfirst < first + n, '%s read %d+%d from a hole' % (src.Path, first, n))
+		self.assertEqual(sum(n for first, n, status in src.Map if status == '+'), src.Contributed)
+		self.assertEqual(sum(n for first, n, status in src.Map if status == '-'), src.Failed)
+		self.assertEqual(sum(n for first, n, status in src.Map), BLOCKS)
+
+	def test_FillsHoles(self):
+		holes = [
+			[(300, 100), (900, 50)],
+			[(350, 100), (1000, 24)],
+			[(0, 350), (880, 144)],
+		]
+		paths = [self._image('src%d' % i, h) for i, h in enumerate(holes)]
+		out = self._path('merged')
+		mapfile = self._path('merged.map')
+
+		r = _dvdread.MergeImages(paths, out, mapfile, chunkblocks=64)
+		self.assertEqual((r.Blocks, r.Good, r.Bad), (BLOCKS, BLOCKS, 0))
+		self.assertEqual(sum(s.Contributed for s in r.Sources), BLOCKS)
+		for src, h in zip(r.Sources, holes):
+			self.assertEqual(src.Blocks, BLOCKS)
+			self.assertEqual(src.DiscID, r.Sources[0].DiscID)
+			self._assertSource(src, h)
+
+		# The third source can only have given what is outside its holes
+		self.assertGreater(r.Sources[2].Contributed, 0)
+		self.assertLessEqual(r.Sources[2].Contributed, BLOCKS - 350 - 144)
+
+		with open(out, 'rb') as f:
+			self.assertEqual(f.read(), self.ref)
+		self.assertEqual(self._mapfile(mapfile), [
+			'0x00000000     +               1',
+			'0x00000000  0x00200000  +',
+		])
+
+	def test_HoleInEvery(self):
+		holes = [[(500, 10)], [(504, 10)]]
+		paths = [self._image('src%d' % i, h) for i, h in enumerate(holes)]
+		out = self._path('merged')
+		mapfile = self._path('merged.map')
+
+		r = _dvdread.MergeImages(paths, out, mapfile, chunkblocks=64)
+		self.assertEqual((r.Blocks, r.Good, r.Bad), (BLOCKS, BLOCKS - 6, 6))
+		for src, h in zip(r.Sources, holes):
+			self._assertSource(src, h)
+
+		with open(out, 'rb') as f:
+			data = f.read()
+		self.assertEqual(data[:504*BLOCK], self.ref[:504*BLOCK])
+		self.assertEqual(data[504*BLOCK:510*BLOCK], bytes(6*BLOCK))
+		self.assertEqual(data[510*BLOCK:], self.ref[510*BLOCK:])
+		self.assertEqual(self._mapfile(mapfile), [
+			'0x00000000     -               1',
+			'0x00000000  0x000FC000  +',
+			'0x000FC000  0x00003000  -',
+			'0x000FF000  0x00101000  +',
+		])
+
+	def test_Truncated(self):
+		# Size comes from the volume descriptor, so the tail a short image lacks is read from the other
+		a = self._image('short', [], blocks=800)
+		b = self._image('holed', [(64, 64)])
+
+		r = _dvdread.MergeImages([a, b], self._path('merged'), chunkblocks=64)
+		self.assertEqual((r.Blocks, r.Good, r.Bad), (BLOCKS, BLOCKS, 0))
+		self.assertEqual(r.Sources[0].Blocks, 800)
+		self.assertGreaterEqual(r.Sources[1].Contributed, BLOCKS - 800)
+		with open(self._path('merged'), 'rb') as f:
+			self.assertEqual(f.read(), self.ref)
+
+	def test_SourceMapfile(self):
+		# A mapfile overrides what the image file holds: only its '+' blocks are taken
+		full = self._image('full', [])
+		srcmap = self._path('full.map')
+		with open(srcmap, 'w') as f:
+			f.write('# Mapfile\n0x0 + 1\n0x0 0x%X +\n0x%X 0x%X -\n' % (600*BLOCK, 600*BLOCK, (BLOCKS - 600)*BLOCK))
+
+		r = _dvdread.MergeImages([(full, srcmap)], self._path('merged'), chunkblocks=64)
+		self.assertEqual((r.Good, r.Bad), (600, BLOCKS - 600))
+		self.assertEqual(r.Sources[0].Map, ((0, 600, '+'), (600, BLOCKS - 600, '-')))
+		with open(self._path('merged'), 'rb') as f:
+			data = f.read()
+		self.assertEqual(data[:600*BLOCK], self.ref[:600*BLOCK])
+		self.assertEqual(data[600*BLOCK:], bytes((BLOCKS - 600)*BLOCK))
+
+	def test_Mismatch(self):
+		a = self._image('a', [(64, 64)])
+		other = self._path('other')
+		support.MakeImage(other, BLOCKS, volid='OTHER_DISC')
+
+		with self.assertRaises(ValueError):
+			_dvdread.MergeImages([a, other], self._path('merged'))
+
+		r = _dvdread.MergeImages([a, other], self._path('merged'), verify=False)
+		self.assertEqual((r.Blocks, r.Bad), (BLOCKS, 0))
+
+if __name__ == '__main__':
+	unittest.main()
@@ -0,0 +1,78 @@
+"""
+Audio and subpicture records of each title, read from the IFOs, by Snapshot() and from a cache directory.
+"""
+
+import os
+import struct
+import tempfile
+import unittest
+
+import support
+
+_dvdread = support.Load()
+
+# What the stub's title sets enable: the first title of each all but the last audio stream and subpictures es
+# and ja, the second every audio stream and subpictures ja and zh
+AUDIOS = [['en', 'fr'], ['en', 'fr', 'de']]
+SUBPICTURES = [[('es', 'Espanol'), ('ja', 'Japanese')], [('ja', 'Japanese'), ('zh', 'Chinese')]]
+
+class RecordsTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.path = os.path.join(cls.tmp.name, 'disc.iso')
+		support.MakeImage(cls.path, 32)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	def _open(self, **kw):
+		dvd = _dvdread.DVD(self.path)
+		dvd.Open(**kw)
+		self.addCleanup(lambda: dvd.IsOpen and dvd.Close())
+		return dvd
+
+	def _check(self, dvd):
+		self.assertEqual(dvd.NumberOfTitles, 8)
+		for t in dvd:
+			which = (t.TitleNum - 1) % 2
+			self.assertEqual([a.LangCode for a in t.Audios], AUDIOS[which], t.TitleNum)
+			self.assertEqual([(s.LangCode, s.Language) for s in t.Subpictures], SUBPICTURES[which], t.TitleNum)
+			self.assertEqual(t.GetSubpicture(2).LangCode, SUBPICTURES[which][1][0])
+
+		for t in dvd.Snapshot().Titles:
+			which = (t.TitleNum - 1) % 2
+			self.assertEqual([a.LangCode for a in t.Audios], AUDIOS[which], t.TitleNum)
+			self.assertEqual([(s.LangCode, s.Language) for s in t.Subpictures], SUBPICTURES[which], t.TitleNum)
+			self.assertEqual([s.SubpictureNum for s in t.Subpictures], [1, 2])
+
+	def test_IFOs(self):
+		self._check(self._open())
+
+	def test_Cache(self):
+		cachedir = os.path.join(self.tmp.name, 'cache')
+		dvd = self._open(cachedir=cachedir)
+		self.assertFalse(dvd.FromCache)
+		self._check(dvd)
+		dvd.Close()
+
+		dvd.Open(cachedir=cachedir)
+		self.assertTrue(dvd.FromCache)
+		self._check(dvd)
+		dvd.Close()
+
+		# A table of an older version may hold wrong records, so it is rebuilt rather than used
+		names = os.listdir(cachedir)
+		self.assertEqual(len(names), 1)
+		with open(os.path.join(cachedir, names[0]), 'r+b') as f:
+			f.seek(8)
+			version, = struct.unpack('=I', f.read(4))
+			f.seek(8)
+			f.write(struct.pack('=I', version - 1))
+		dvd.Open(cachedir=cachedir)
+		self.assertFalse(dvd.FromCache)
+		self._check(dvd)
+
+if __name__ == '__main__':
+	unittest.main()
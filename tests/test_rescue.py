@@ -0,0 +1,168 @@
+"""
+Rescue mode reads against bad blocks injected by the stub libdvdread.
+"""
+
+import os
+import tempfile
+import unittest
+
+import support
+
+_dvdread = support.Load()
+BLOCK = support.BLOCK
+
+# Title set 1's title VOBs, read whole
+VTS = 1
+BLOCKS = 1000
+
+class RescueTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.path = os.path.join(cls.tmp.name, 'disc.iso')
+		support.MakeImage(cls.path, 32)
+		cls.ref = b''.join(support.StubBlock(VTS, b) for b in range(BLOCKS))
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	def setUp(self):
+		self.dvd = _dvdread.DVD(self.path)
+		self.dvd.Open()
+		self.dvd.Rescue = True
+
+	def tearDown(self):
+		self.dvd.Close()
+
+	def _read(self, s):
+		out = bytearray()
+		buf = bytearray(BLOCK*BLOCKS)
+		while True:
+			n = s.ReadInto(buf)
+			if n == 0:
+				break
+			out += buf[:n]
+		return bytes(out)
+
+	def _copy(self):
+		with self.dvd.OpenFile(VTS) as s:
+			return self._read(s)
+
+	def _assertBlocks(self, data, first, end, expected):
+		for b in range(first, end):
+			self.assertEqual(data[b*BLOCK:(b+1)*BLOCK], expected(b), 'block %d' % b)
+
+	def test_NoRescue(self):
+		self.dvd.Rescue = False
+		with support.StubEnv(BAD=100, BADLEN=3), self.dvd.OpenFile(VTS) as s:
+			with self.assertRaises(Exception):
+				self._read(s)
+
+	def test_MapAndFill(self):
+		# Reads are 16 blocks so the one holding 100-102 fails as a whole, and the next 16 are passed over
+		with support.StubEnv(BAD=100, BADLEN=3):
+			data = self._copy()
+
+		self.assertEqual(len(data), BLOCKS*BLOCK)
+		self.assertEqual(self.dvd.RescueMap(VTS), ((0, 96, '+'), (96, 16, '*'), (112, 16, '?'), (128, 872, '+')))
+		self.assertEqual(self.dvd.RescueFailures, 1)
+		self.assertEqual(self.dvd.RescueFilled, 32)
+
+		self.assertEqual(data[:96*BLOCK], self.ref[:96*BLOCK])
+		self.assertEqual(data[96*BLOCK:128*BLOCK], bytes(32*BLOCK))
+		self.assertEqual(data[128*BLOCK:], self.ref[128*BLOCK:])
+
+	def test_ExponentialSkip(self):
+		# Failures in a row pass over 16, 32, 64 then 128 blocks until a read past the bad region succeeds
+		with support.StubEnv(BAD=100, BADLEN=200):
+			data = self._copy()
+
+		self.assertEqual(self.dvd.RescueMap(VTS), (
+			(0, 96, '+'),
+			(96, 16, '*'), (112, 16, '?'),
+			(128, 16, '*'), (144, 32, '?'),
+			(176, 16, '*'), (192, 64, '?'),
+			(256, 16, '*'), (272, 128, '?'),
+			(400, 600, '+')
+		))
+		self.assertEqual(self.dvd.RescueFailures, 4)
+		self.assertEqual(self.dvd.RescueFilled, 304)
+		self.assertEqual(data[:96*BLOCK], self.ref[:96*BLOCK])
+		self.assertEqual(data[96*BLOCK:400*BLOCK], bytes(304*BLOCK))
+		self.assertEqual(data[400*BLOCK:], self.ref[400*BLOCK:])
+
+	def test_SkipResets(self):
+		# A good read in between starts the skip at 16 again
+		with self.dvd.OpenFile(VTS) as s:
+			with support.StubEnv(BAD=100):
+				self.assertEqual(s.ReadInto(bytearray(160*BLOCK)), 160*BLOCK)
+			with support.StubEnv(BAD=200):
+				self._read(s)
+
+		self.assertEqual(self.dvd.RescueMap(VTS), ((0, 96, '+'), (96, 16, '*'), (112, 16, '?'), (128, 64, '+'), (192, 16, '*'), (208, 16, '?'), (224, 776, '+')))
+		self.assertEqual(self.dvd.RescueFailures, 2)
+
+	def test_PadFill(self):
+		self.dvd.RescueFill = _dvdread.RESCUE_FILL_PAD
+		with support.StubEnv(BAD=100):
+			data = self._copy()
+
+		pad = bytes.fromhex('000001ba4400040004010189c3f8000001be07ec') + b'\xff'*(BLOCK - 20)
+		self._assertBlocks(data, 96, 128, lambda b: pad)
+		self._assertBlocks(data, 128, 130, lambda b: support.StubBlock(VTS, b))
+
+	def test_Mapfile(self):
+		with support.StubEnv(BAD=100, BADLEN=3):
+			self._copy()
+
+		path = os.path.join(self.tmp.name, 'vts1.map')
+		self.dvd.WriteRescueMap(path, VTS)
+		with open(path) as f:
+			lines = [l for l in f.read().splitlines() if not l.startswith('#')]
+		self.assertEqual(lines, [
+			'0x00000000     ?               1',
+			'0x00000000  0x00030000  +',
+			'0x00030000  0x00008000  *',
+			'0x00038000  0x00008000  ?',
+			'0x00040000  0x001B4000  +',
+		])
+
+		# Blocks a loaded map knows are bad are filled without reading them, even though they read now
+		dvd = _dvdread.DVD(self.path)
+		dvd.Open()
+		try:
+			dvd.Rescue = True
+			dvd.ReadRescueMap(path, VTS)
+			self.assertEqual(dvd.RescueMap(VTS), self.dvd.RescueMap(VTS))
+
+			with dvd.OpenFile(VTS) as s:
+				data = self._read(s)
+			self.assertEqual(dvd.RescueMap(VTS), ((0, 96, '+'), (96, 16, '*'), (112, 888, '+')))
+			self.assertEqual(dvd.RescueFailures, 0)
+			self.assertEqual(dvd.RescueFilled, 16)
+			self.assertEqual(data[96*BLOCK:112*BLOCK], bytes(16*BLOCK))
+			self.assertEqual(data[112*BLOCK:], self.ref[112*BLOCK:])
+		finally:
+			dvd.Close()
+
+	def test_RetryBad(self):
+		with tempfile.TemporaryFile() as f, self.dvd.OpenFile(VTS) as s:
+			with support.StubEnv(BAD=100, BADLEN=3):
+				f.write(self._read(s))
+
+				# Single block rereads recover everything around the three that still fail, on the first pass
+				self.assertEqual(s.RetryBad(f, passes=2), 29)
+				self.assertEqual(self.dvd.RescueMap(VTS), ((0, 100, '+'), (100, 3, '-'), (103, 897, '+')))
+				self.assertEqual(self.dvd.RescueFailures, 1 + 3*2)
+
+			# Then the last three when the drive gets them, patched into the copy in place
+			self.assertEqual(s.RetryBad(f.fileno()), 3)
+			self.assertEqual(self.dvd.RescueMap(VTS), ((0, BLOCKS, '+'),))
+			self.assertEqual(s.RetryBad(f), 0)
+
+			f.seek(0)
+			self.assertEqual(f.read(), self.ref)
+
+if __name__ == '__main__':
+	unittest.main()
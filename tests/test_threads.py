@@ -0,0 +1,256 @@
+"""
+Getters, Open()/Close() and Stream reads racing on one DVD from several threads.
+
+Runs on GIL and free-threaded builds alike; on a free-threaded build the module must also leave the GIL off.
+PYDVD_STRESS_SECONDS sets how long each race runs (default 2).
+"""
+
+import faulthandler
+import os
+import re
+import sys
+import sysconfig
+import tempfile
+import threading
+import time
+import unittest
+
+import support
+
+_dvdread = support.Load()
+BLOCK = support.BLOCK
+
+SECONDS = float(os.environ.get('PYDVD_STRESS_SECONDS', '2'))
+
+# What racing a Close() may raise; anything else (or a crash or hang) is a bug
+EXPECTED = re.compile(r'not open|Stream is closed')
+
+def FreeThreaded():
+	return bool(sysconfig.get_config_var('Py_GIL_DISABLED'))
+
+def GILEnabled():
+	return getattr(sys, '_is_gil_enabled', lambda: True)()
+
+class Race:
+	"""
+	Runs workers on threads until told to stop, counting passes they complete and exceptions they raise.
+	"""
+
+	def __init__(self):
+		self.stop = threading.Event()
+		self.lock = threading.Lock()
+		self.passes = {}
+		self.errors = {}
+		self.threads = []
+
+	def Add(self, name, fn):
+		def run():
+			while not self.stop.is_set():
+				try:
+					fn()
+				except Exception as e:
+					key = (name, type(e).__name__, str(e))
+					with self.lock:
+						self.errors[key] = self.errors.get(key, 0) + 1
+				else:
+					with self.lock:
+						self.passes[name] = self.passes.get(name, 0) + 1
+
+		# Daemon so a thread that never returns fails the test rather than hanging the interpreter at exit
+		self.threads.append(threading.Thread(target=run, name=name, daemon=True))
+
+	def Run(self, seconds):
+		# A thread stuck holding the GIL would stop this one too, so the watchdog runs without it and kills the
+		# process, dumping every thread's stack
+		faulthandler.dump_traceback_later(seconds + 60, exit=True)
+		try:
+			for t in self.threads:
+				t.start()
+			time.sleep(seconds)
+			self.stop.set()
+
+			deadline = time.monotonic() + 30
+			for t in self.threads:
+				t.join(max(0, deadline - time.monotonic()))
+		finally:
+			faulthandler.cancel_dump_traceback_later()
+
+		return [t.name for t in self.threads if t.is_alive()]
+
+class ThreadTest(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.tmp = tempfile.TemporaryDirectory()
+		cls.path = os.path.join(cls.tmp.name, 'disc.iso')
+		support.MakeImage(cls.path, 32)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.tmp.cleanup()
+
+	def setUp(self):
+		# Switch threads as often as possible where there is a GIL to switch
+		interval = sys.getswitchinterval()
+		sys.setswitchinterval(1e-6)
+		self.addCleanup(sys.setswitchinterval, interval)
+
+	def _run(self, race):
+		hung = race.Run(SECONDS)
+		self.assertEqual(hung, [], 'threads still running (GIL %s)' % ('on' if GILEnabled() else 'off'))
+
+		unexpected = {k: v for k, v in race.errors.items() if not EXPECTED.search(k[2])}
+		self.assertEqual(unexpected, {})
+
+	def test_GILStaysOff(self):
+		if not FreeThreaded():
+			self.skipTest('not a free-threaded build')
+		self.assertFalse(GILEnabled(), 'importing _dvdread enabled the GIL')
+
+	def test_OneDVD(self):
+		dvd = _dvdread.DVD(self.path)
+		dvd.MaxResidentIFOs = 1
+		dvd.Open()
+		self.addCleanup(lambda: dvd.IsOpen and dvd.Close())
+
+		def getters():
+			for i in range(1, dvd.NumberOfTitles + 1):
+				t = dvd.GetTitle(i)
+				t.PlaybackTime
+				t.AspectRatio
+				t.ChapterAtTime(0)
+				t.GetChapter(1).Length
+				t.GetAudio(1).LangCode
+				t.GetSubpicture(2).Language
+				self.assertEqual(len(t.Chapters), t.NumberOfChapters)
+			dvd.VMGID
+			dvd.ProviderID
+			dvd.FingerprintHex
+			dvd.Snapshot()
+
+		def titles():
+			# Iterating a DVD while it closes under it
+			for t in dvd:
+				t.Audios[0].Language
+
+		def openclose():
+			try:
+				dvd.Close()
+			finally:
+				dvd.Open()
+			time.sleep(0.002)
+
+		def reader(readahead):
+			def read():
+				buf = bytearray(64*BLOCK)
+				with dvd.OpenFile(1, readahead=readahead) as s:
+					while s.ReadInto(buf):
+						pass
+			return read
+
+		def title():
+			with dvd.GetTitle(3).OpenStream(readahead=True) as s:
+				while s.Read(16):
+					pass
+
+		race = Race()
+		for i in range(3):
+			race.Add('getters%d' % i, getters)
+		race.Add('titles', titles)
+		race.Add('openclose', openclose)
+		race.Add('reader', reader(False))
+		race.Add('readahead', reader(True))
+		race.Add('title', title)
+		self._run(race)
+
+		# Everything got some work done between closes, not just errors
+		for name in ('getters0', 'titles', 'openclose'):
+			self.assertGreater(race.passes.get(name, 0), 0, name)
+
+	def test_SharedStream(self):
+		# Getters and Seek() on a stream another thread reads, with read-ahead switched on and off under it
+		dvd = _dvdread.DVD(self.path)
+		dvd.Open()
+		self.addCleanup(dvd.Close)
+		s = dvd.OpenFile(1, readahead=True)
+		self.addCleanup(s.Close)
+
+		buf = bytearray(32*BLOCK)
+		def read():
+			if s.ReadInto(buf) == 0:
+				s.Seek(0)
+
+		def poke():
+			s.ReadAheadStats
+			s.Position
+			s.ReadAhead = not s.ReadAhead
+
+		race = Race()
+		race.Add('read', read)
+		race.Add('poke', poke)
+		self._run(race)
+		self.assertGreater(race.passes.get('read', 0), 0)
+
+	def test_SharedHashedStream(self):
+		# Readers sharing a hashed read-ahead stream each get the next blocks, so between them they read it all
+		# once and it hashes the same as reading it alone
+		dvd = _dvdread.DVD(self.path)
+		dvd.Open()
+		self.addCleanup(dvd.Close)
+
+		def digest(threads):
+			s = dvd.OpenFile(1, readahead=True)
+			s.Hash = True
+			total = []
+			def read():
+				buf = bytearray(8*BLOCK)
+				n = 0
+				while True:
+					got = s.ReadInto(buf)
+					if got == 0:
+						break
+					n += got
+				total.append(n)
+
+			workers = [threading.Thread(target=read) for i in range(threads)]
+			for t in workers:
+				t.start()
+			for t in workers:
+				t.join()
+			d = s.Digest
+			size = s.Blocks
+			s.Close()
+			self.assertEqual(sum(total), size*BLOCK)
+			self.assertIsNotNone(d, 'blocks hashed out of order')
+			return (d.SHA256, d.XXH64)
+
+		want = digest(1)
+		for i in range(20):
+			self.assertEqual(digest(4), want)
+
+	def test_ManyDVDs(self):
+		# Separate DVD objects share nothing, each thread scans its own
+		def scan():
+			dvd = _dvdread.DVD(self.path)
+			dvd.Open(parallel=2)
+			try:
+				total = sum(dvd.GetTitle(i).PlaybackTime for i in range(1, dvd.NumberOfTitles + 1))
+				with dvd.OpenFile(2) as s:
+					n = 0
+					while True:
+						got = len(s.Read(128))
+						if got == 0:
+							break
+						n += got
+			finally:
+				dvd.Close()
+			self.assertEqual(n, 1000*BLOCK)
+			return total
+
+		race = Race()
+		for i in range(4):
+			race.Add('scan%d' % i, scan)
+		self._run(race)
+		self.assertEqual(race.errors, {})
+
+if __name__ == '__main__':
+	unittest.main()